@@ -3,6 +3,8 @@
 #include "src/support/kernels/ExactKernel.h"
 #include "src/support/kernels/P3MKernel.h"
 #include "src/support/kernels/Compact.h"
+#include "src/support/kernels/RadialKernel.h"
+#include "src/support/kernels/NystromKernel.h"
 
 #ifdef USE_CUDA
 #include "src/support/kernels/CUDAExactKernel.h"
@@ -29,7 +31,11 @@ enum {
   RUN_CUDA,
 #endif
   RUN_P3M,
-  RUN_COMPACT
+  RUN_COMPACT,
+  RUN_GAUSSIAN,
+  RUN_CAUCHY,
+  RUN_WENDLAND,
+  RUN_NYSTROM
 };
 
 namespace tear_up {
@@ -83,6 +89,10 @@ static ExactKernel<ScalarType, 3> *get_implementation(const size_t type) {
 #endif
     case RUN_P3M:return new P3MKernel<ScalarType, 3>();
     case RUN_COMPACT:return new Compact<ScalarType, 3>();
+    case RUN_GAUSSIAN:return new GaussianKernel<ScalarType, 3>();
+    case RUN_CAUCHY:return new CauchyKernel<ScalarType, 3>();
+    case RUN_WENDLAND:return new WendlandKernel<ScalarType, 3>();
+    case RUN_NYSTROM:return new NystromKernel<ScalarType, 3>();
     default:assert(0);
   }
 }
@@ -241,6 +251,32 @@ void Evaluate_Kernel_Matrix(benchmark::State &state) {
   }
 }
 
+/// Interleaved copies of point sets, as sent to the CUDA kernels : through a vector, and as a row-major matrix.
+void Interleave_Vectorise(benchmark::State &state) {
+  auto X = tear_up::generate_random_matrix(state.range(0), 3);
+
+  while (state.KeepRunning()) {
+    benchmark::DoNotOptimize(X.vectorise_row_wise());
+  }
+}
+
+void Interleave_RowMajor(benchmark::State &state) {
+  auto X = tear_up::generate_random_matrix(state.range(0), 3);
+
+  while (state.KeepRunning()) {
+    benchmark::DoNotOptimize(X.row_major());
+  }
+}
+
+void Interleave_RoundTrip(benchmark::State &state) {
+  auto X = tear_up::generate_random_matrix(state.range(0), 3);
+  const RowMajorMatrix<ScalarType> interleaved = X.row_major();
+
+  while (state.KeepRunning()) {
+    benchmark::DoNotOptimize(MatrixType(interleaved.view()));
+  }
+}
+
 
 // Declare ranges
 #define BASIC_BENCHMARK_EVALUATE_KERNEL(x, y) \
@@ -249,11 +285,17 @@ void Evaluate_Kernel_Matrix(benchmark::State &state) {
     BENCHMARK(x)->ArgPair(1<<12, y)->ArgPair(1<<14, y)->ArgPair(1<<16, y)->Unit(benchmark::kMillisecond);
 #define BASIC_BENCHMARK_TEST_SMALL(x, y) \
     BENCHMARK(x)->ArgPair(1<<8, y)->ArgPair(1<<10, y)->ArgPair(1<<12, y)->Unit(benchmark::kMillisecond);
+#define BASIC_BENCHMARK_INTERLEAVE(x) \
+    BENCHMARK(x)->Arg(1<<12)->Arg(1<<16)->Arg(1<<20)->Unit(benchmark::kMicrosecond);
 
 // Run tests
 BASIC_BENCHMARK_TEST_SMALL(ConvolveGradient_kernel, RUN_EXACT);
 BASIC_BENCHMARK_TEST_SMALL(ConvolveGradient_kernel, RUN_COMPACT);
+BASIC_BENCHMARK_TEST_SMALL(ConvolveGradient_kernel, RUN_GAUSSIAN);
+BASIC_BENCHMARK_TEST_SMALL(ConvolveGradient_kernel, RUN_CAUCHY);
+BASIC_BENCHMARK_TEST_SMALL(ConvolveGradient_kernel, RUN_WENDLAND);
 BASIC_BENCHMARK_TEST(ConvolveGradient_kernel, RUN_P3M);
+BASIC_BENCHMARK_TEST(ConvolveGradient_kernel, RUN_NYSTROM);
 #ifdef USE_CUDA
 BASIC_BENCHMARK_TEST(ConvolveGradient_kernel, RUN_CUDA);
 #endif
@@ -270,15 +312,25 @@ BASIC_BENCHMARK_EVALUATE_KERNEL(Evaluate_Kernel_Vector, RUN_COMPACT);
 
 
 BASIC_BENCHMARK_TEST_SMALL(Convolve_kernel, RUN_EXACT);
+BASIC_BENCHMARK_TEST_SMALL(Convolve_kernel, RUN_GAUSSIAN);
+BASIC_BENCHMARK_TEST_SMALL(Convolve_kernel, RUN_CAUCHY);
+BASIC_BENCHMARK_TEST_SMALL(Convolve_kernel, RUN_WENDLAND);
 BASIC_BENCHMARK_TEST(Convolve_kernel, RUN_P3M);
+BASIC_BENCHMARK_TEST(Convolve_kernel, RUN_NYSTROM);
 #ifdef USE_CUDA
 BASIC_BENCHMARK_TEST(Convolve_kernel, RUN_CUDA);
 #endif
 
 BASIC_BENCHMARK_TEST_SMALL(ConvolveHessian_kernel, RUN_EXACT);
+BASIC_BENCHMARK_TEST_SMALL(ConvolveHessian_kernel, RUN_GAUSSIAN);
 BASIC_BENCHMARK_TEST(ConvolveHessian_kernel, RUN_P3M);
+BASIC_BENCHMARK_TEST(ConvolveHessian_kernel, RUN_NYSTROM);
 #ifdef USE_CUDA
 BASIC_BENCHMARK_TEST(ConvolveHessian_kernel, RUN_CUDA);
 #endif
 
+BASIC_BENCHMARK_INTERLEAVE(Interleave_Vectorise);
+BASIC_BENCHMARK_INTERLEAVE(Interleave_RowMajor);
+BASIC_BENCHMARK_INTERLEAVE(Interleave_RoundTrip);
+
 BENCHMARK_MAIN();
@@ -0,0 +1,506 @@
+/***************************************************************************************
+*                                                                                      *
+*                                     Deformetrica                                     *
+*                                                                                      *
+*    Copyright Inria and the University of Utah.  All rights reserved. This file is    *
+*    distributed under the terms of the Inria Non-Commercial License Agreement.        *
+*                                                                                      *
+*                                                                                      *
+****************************************************************************************/
+
+/// End-to-end benchmarks of the deformations, attachments and models. Every benchmark is parameterised by a
+/// number of points (or voxels), a kernel type and a number of threads, and builds its inputs in-process from
+/// fixed seeds : two runs of the suite measure exactly the same computations.
+
+#include "benchmark/benchmark_api.h"
+#include "src/core/model_tools/deformations/Diffeos.h"
+#include "src/core/models/atlases/DeterministicAtlas.h"
+#include "src/core/observations/data_sets/CrossSectionalDataSet.h"
+#include "src/core/observations/deformable_objects/DeformableMultiObject.h"
+#include "src/core/observations/deformable_objects/geometries/landmarks/Landmark.h"
+#include "src/core/observations/deformable_objects/geometries/landmarks/PointCloud.h"
+#include "src/core/observations/deformable_objects/geometries/landmarks/OrientedPolyLine.h"
+#include "src/core/observations/deformable_objects/geometries/landmarks/NonOrientedPolyLine.h"
+#include "src/core/observations/deformable_objects/geometries/landmarks/OrientedSurfaceMesh.h"
+#include "src/core/observations/deformable_objects/geometries/landmarks/NonOrientedSurfaceMesh.h"
+#include "src/core/observations/deformable_objects/geometries/images/SSDImage.h"
+#include "src/core/observations/deformable_objects/geometries/images/LCCImage.h"
+#include "src/core/observations/deformable_objects/geometries/images/EQLAImage.h"
+#include "src/core/observations/deformable_objects/geometries/images/MutualInformationImage.h"
+#include "src/support/kernels/KernelFactory.h"
+#include "src/support/utilities/GeneralSettings.h"
+
+#include "itkImageRegionIteratorWithIndex.h"
+#include "vtkCellArray.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
+#include "vtkSphereSource.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+#include "LinearAlgebra.h"
+
+using namespace def::algebra;
+
+const unsigned int Dimension = 3;
+
+typedef Diffeos<ScalarType, Dimension> DiffeosType;
+typedef DeterministicAtlas<ScalarType, Dimension> DeterministicAtlasType;
+typedef CrossSectionalDataSet<ScalarType, Dimension> DataSetType;
+typedef DeformableMultiObject<ScalarType, Dimension> DeformableMultiObjectType;
+typedef AbstractGeometry<ScalarType, Dimension> AbstractGeometryType;
+typedef std::vector<std::shared_ptr<AbstractGeometryType>> AbstractGeometryListType;
+typedef KernelFactory<ScalarType, Dimension> KernelFactoryType;
+
+typedef Landmark<ScalarType, Dimension> LandmarkType;
+typedef PointCloud<ScalarType, Dimension> PointCloudType;
+typedef OrientedPolyLine<ScalarType, Dimension> OrientedPolyLineType;
+typedef NonOrientedPolyLine<ScalarType, Dimension> NonOrientedPolyLineType;
+typedef OrientedSurfaceMesh<ScalarType, Dimension> OrientedSurfaceMeshType;
+typedef NonOrientedSurfaceMesh<ScalarType, Dimension> NonOrientedSurfaceMeshType;
+typedef SSDImage<ScalarType, Dimension> SSDImageType;
+typedef LCCImage<ScalarType, Dimension> LCCImageType;
+typedef EQLAImage<ScalarType, Dimension> EQLAImageType;
+typedef MutualInformationImage<ScalarType, Dimension> MutualInformationImageType;
+typedef itk::Image<ScalarType, Dimension> ImageType;
+
+/// Gives access to the integration steps which Diffeos::Update() chains.
+class BenchmarkDiffeos : public DiffeosType {
+ public:
+  using DiffeosType::Shoot;
+  using DiffeosType::FlowLandmarkPointsTrajectory;
+};
+
+/// Kernel width of the deformations and attachments, for shapes of radius 10.
+const ScalarType kernel_width = 5;
+const unsigned int number_of_time_points = 10;
+const unsigned int number_of_subjects = 4;
+
+namespace tear_up {
+
+static MatrixType generate_random_matrix(const unsigned int rows, const unsigned int cols,
+                                         const ScalarType scale, const unsigned int seed) {
+  std::mt19937 generator(seed);
+  std::uniform_real_distribution<ScalarType> uniform(-scale, scale);
+
+  MatrixType tmp(rows, cols);
+  for (unsigned int i = 0; i < rows; ++i)
+    for (unsigned int j = 0; j < cols; ++j)
+      tmp(i, j) = uniform(generator);
+
+  return tmp;
+}
+
+static void deform_points(vtkPolyData *polyData, const ScalarType amplitude) {
+  vtkPoints *points = polyData->GetPoints();
+  for (vtkIdType i = 0; i < points->GetNumberOfPoints(); ++i) {
+    double p[3];
+    points->GetPoint(i, p);
+    p[0] += amplitude * std::sin(p[1] / 3.0);
+    p[1] += amplitude * std::cos(p[2] / 4.0);
+    p[2] += amplitude * std::sin(p[0] / 5.0);
+    points->SetPoint(i, p);
+  }
+}
+
+/// Triangulated sphere of about \e nbPoints vertices.
+static vtkSmartPointer<vtkPolyData> generate_surface(const unsigned int nbPoints, const ScalarType amplitude) {
+  const int resolution = std::max(4, (int) std::ceil(std::sqrt((double) nbPoints)) + 1);
+  vtkSmartPointer<vtkSphereSource> sphere = vtkSmartPointer<vtkSphereSource>::New();
+  sphere->SetRadius(10.0);
+  sphere->SetThetaResolution(resolution);
+  sphere->SetPhiResolution(resolution);
+  sphere->Update();
+
+  vtkSmartPointer<vtkPolyData> polyData = vtkSmartPointer<vtkPolyData>::New();
+  polyData->DeepCopy(sphere->GetOutput());
+  deform_points(polyData, amplitude);
+  return polyData;
+}
+
+/// Helix of \e nbPoints vertices, made of segments.
+static vtkSmartPointer<vtkPolyData> generate_curve(const unsigned int nbPoints, const ScalarType amplitude) {
+  vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+  vtkSmartPointer<vtkCellArray> lines = vtkSmartPointer<vtkCellArray>::New();
+  for (unsigned int i = 0; i < nbPoints; ++i) {
+    const double t = 4.0 * M_PI * i / nbPoints;
+    points->InsertNextPoint(10.0 * std::cos(t), 10.0 * std::sin(t), 1.5 * t - 10.0);
+    if (i > 0) {
+      vtkIdType segment[2] = {(vtkIdType) i - 1, (vtkIdType) i};
+      lines->InsertNextCell(2, segment);
+    }
+  }
+
+  vtkSmartPointer<vtkPolyData> polyData = vtkSmartPointer<vtkPolyData>::New();
+  polyData->SetPoints(points);
+  polyData->SetLines(lines);
+  deform_points(polyData, amplitude);
+  return polyData;
+}
+
+/// Cubic image of about \e nbVoxels voxels, with a gaussian blob shifted by \e shift voxels from the center.
+static ImageType::Pointer generate_image(const unsigned int nbVoxels, const ScalarType shift) {
+  const unsigned int side = std::max(8u, (unsigned int) std::round(std::cbrt((double) nbVoxels)));
+  ImageType::SizeType size;
+  size.Fill(side);
+  ImageType::RegionType region;
+  region.SetSize(size);
+
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions(region);
+  image->Allocate();
+
+  const double center = 0.5 * side + shift, sigma = 0.2 * side;
+  itk::ImageRegionIteratorWithIndex<ImageType> it(image, region);
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it) {
+    double squaredDistance = 0.0;
+    for (unsigned int d = 0; d < Dimension; ++d) {
+      const double x = it.GetIndex()[d] - center;
+      squaredDistance += x * x;
+    }
+    it.Set(std::exp(-squaredDistance / (2.0 * sigma * sigma)));
+  }
+  return image;
+}
+
+static void set_geometry_kernel(LandmarkType &object, const KernelEnumType kernelType) {}
+
+template<class GeometryType>
+static void set_geometry_kernel(GeometryType &object, const KernelEnumType kernelType) {
+  object.SetKernelType(kernelType);
+  object.SetKernelWidth(kernel_width);
+}
+
+template<class GeometryType>
+static std::shared_ptr<GeometryType> generate_landmark(vtkPolyData *polyData, const KernelEnumType kernelType) {
+  std::shared_ptr<GeometryType> object = std::make_shared<GeometryType>();
+  object->SetPolyData(polyData);
+  set_geometry_kernel(*object, kernelType);
+  object->Update();
+  return object;
+}
+
+static void set_image_kernel(LCCImageType &object) { object.SetLCCKernelWidth(kernel_width); }
+static void set_image_kernel(EQLAImageType &object) { object.SetEQLAKernelWidth(kernel_width); }
+
+template<class GeometryType>
+static void set_image_kernel(GeometryType &object) {}
+
+template<class GeometryType>
+static std::shared_ptr<GeometryType> generate_image_object(ImageType *image) {
+  std::shared_ptr<GeometryType> object = std::make_shared<GeometryType>();
+  object->SetImage(image);
+  set_image_kernel(*object);
+  object->Update();
+  return object;
+}
+
+static std::shared_ptr<DeformableMultiObjectType> generate_multi_object(std::shared_ptr<AbstractGeometryType> object) {
+  AbstractGeometryListType objectList(1);
+  objectList[0] = object;
+  std::shared_ptr<DeformableMultiObjectType> multiObject = std::make_shared<DeformableMultiObjectType>();
+  multiObject->SetObjectList(objectList);
+  multiObject->Update();
+  return multiObject;
+}
+
+/// Domain enclosing the generated shapes.
+static MatrixType shapes_domain() {
+  MatrixType domain(Dimension, 2, 0.0);
+  for (unsigned int d = 0; d < Dimension; ++d) {
+    domain(d, 0) = -12.0;
+    domain(d, 1) = 12.0;
+  }
+  return domain;
+}
+
+/// Sets the number of threads and the kernel factory (P3M grids) for a domain, returned enlarged by the padding.
+static MatrixType setup_run(const benchmark::State &state, MatrixType domain) {
+  def::utils::settings.number_of_threads = state.range(2);
+
+  for (unsigned int d = 0; d < Dimension; ++d) {
+    domain(d, 0) -= 2 * kernel_width;
+    domain(d, 1) += 2 * kernel_width;
+  }
+  KernelFactoryType::SetDataDomain(domain);
+  KernelFactoryType::SetWorkingSpacingRatio(0.2);
+  KernelFactoryType::SetPaddingFactor(3 * kernel_width);
+  return domain;
+}
+
+/// Geodesic of state.range(0) control points, deforming a sphere of as many points.
+static std::shared_ptr<BenchmarkDiffeos> generate_diffeos(const benchmark::State &state) {
+  const unsigned int nbPoints = state.range(0);
+  std::shared_ptr<DeformableMultiObjectType> object
+      = generate_multi_object(generate_landmark<LandmarkType>(generate_surface(nbPoints, 0.0), Exact));
+  const MatrixType domain = setup_run(state, object->GetBoundingBox());
+
+  std::shared_ptr<BenchmarkDiffeos> diffeos = std::make_shared<BenchmarkDiffeos>();
+  diffeos->SetKernelType((KernelEnumType) state.range(1));
+  diffeos->SetKernelWidth(kernel_width);
+  diffeos->SetNumberOfTimePoints(number_of_time_points);
+  diffeos->SetPaddingFactor(3 * kernel_width);
+  diffeos->SetStartPositions(generate_random_matrix(nbPoints, Dimension, 10.0, 1));
+  diffeos->SetStartMomentas(generate_random_matrix(nbPoints, Dimension, 0.1, 2));
+  diffeos->SetDeformableMultiObject(object);
+  diffeos->SetDataDomain(domain);
+  diffeos->Update();
+  return diffeos;
+}
+
+/// Deterministic atlas of the template and targets, with its dataset and null initial momenta.
+static std::shared_ptr<DeterministicAtlasType> generate_atlas(
+    const benchmark::State &state,
+    std::shared_ptr<DeformableMultiObjectType> templateObject,
+    const std::vector<std::shared_ptr<DeformableMultiObjectType>> &targets,
+    const ScalarType deformationKernelWidth,
+    DataSetType &dataSet, LinearVariablesMapType &indRER) {
+  const MatrixType domain = setup_run(state, templateObject->GetBoundingBox());
+
+  std::shared_ptr<DiffeosType> diffeos = std::make_shared<DiffeosType>();
+  diffeos->SetKernelType((KernelEnumType) state.range(1));
+  diffeos->SetKernelWidth(deformationKernelWidth);
+  diffeos->SetNumberOfTimePoints(number_of_time_points);
+  diffeos->SetPaddingFactor(3 * kernel_width);
+  diffeos->SetDataDomain(domain);
+
+  std::shared_ptr<DeterministicAtlasType> atlas = std::make_shared<DeterministicAtlasType>();
+  atlas->SetRKHSNormForRegularization();
+  atlas->SetDataSigmaSquared(VectorType(1, 0.1));
+  atlas->SetDiffeos(diffeos);
+  atlas->SetTemplate(templateObject);
+  atlas->SetCPSpacing(deformationKernelWidth);
+  atlas->SetSmoothingKernelWidth(deformationKernelWidth);
+  atlas->SetNumberOfThreads(state.range(2));
+  atlas->Update();
+
+  dataSet.SetDeformableMultiObjects(targets);
+  dataSet.Update();
+
+  std::vector<MatrixType> momentas(targets.size());
+  for (unsigned int s = 0; s < targets.size(); ++s)
+    momentas[s] = generate_random_matrix(atlas->GetControlPoints().rows(), Dimension, 0.1, 10 + s);
+  indRER["Momenta"] = momentas;
+
+  return atlas;
+}
+
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Deformations :
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void Diffeos_Shoot(benchmark::State &state) {
+  auto diffeos = tear_up::generate_diffeos(state);
+
+  while (state.KeepRunning()) {
+    diffeos->Shoot();
+  }
+}
+
+void Diffeos_FlowLandmarkPointsTrajectory(benchmark::State &state) {
+  auto diffeos = tear_up::generate_diffeos(state);
+
+  while (state.KeepRunning()) {
+    diffeos->FlowLandmarkPointsTrajectory();
+  }
+}
+
+void Diffeos_IntegrateAdjointEquations(benchmark::State &state) {
+  auto diffeos = tear_up::generate_diffeos(state);
+  MatrixType landmarkPointsGradient = tear_up::generate_random_matrix(
+      diffeos->GetDeformableMultiObject()->GetNumberOfLandmarkPoints(), Dimension, 1.0, 3);
+  MatrixType imagePointsGradient;
+
+  while (state.KeepRunning()) {
+    diffeos->IntegrateAdjointEquations(landmarkPointsGradient, imagePointsGradient);
+  }
+}
+
+void Diffeos_ParallelTransport(benchmark::State &state) {
+  auto diffeos = tear_up::generate_diffeos(state);
+  const MatrixType momenta = tear_up::generate_random_matrix(state.range(0), Dimension, 0.1, 4);
+  std::vector<ScalarType> targetTimes(number_of_time_points);
+  for (unsigned int t = 0; t < number_of_time_points; ++t)
+    targetTimes[t] = t / (ScalarType) (number_of_time_points - 1);
+
+  while (state.KeepRunning()) {
+    MatrixListType velocities;
+    benchmark::DoNotOptimize(
+        diffeos->ParallelTransport(momenta, diffeos->GetStartPositions(), 0.0, targetTimes, velocities));
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Attachments :
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+template<class GeometryType, bool IsCurve>
+void ComputeMatch_landmark(benchmark::State &state) {
+  tear_up::setup_run(state, tear_up::shapes_domain());
+  const KernelEnumType kernelType = (KernelEnumType) state.range(1);
+  auto generate = IsCurve ? tear_up::generate_curve : tear_up::generate_surface;
+  auto source = tear_up::generate_landmark<GeometryType>(generate(state.range(0), 0.0), kernelType);
+  auto target = tear_up::generate_landmark<GeometryType>(generate(state.range(0), 1.0), kernelType);
+
+  while (state.KeepRunning()) {
+    benchmark::DoNotOptimize(source->ComputeMatch(target));
+  }
+}
+
+template<class GeometryType, bool IsCurve>
+void ComputeMatchGradient_landmark(benchmark::State &state) {
+  tear_up::setup_run(state, tear_up::shapes_domain());
+  const KernelEnumType kernelType = (KernelEnumType) state.range(1);
+  auto generate = IsCurve ? tear_up::generate_curve : tear_up::generate_surface;
+  auto source = tear_up::generate_landmark<GeometryType>(generate(state.range(0), 0.0), kernelType);
+  auto target = tear_up::generate_landmark<GeometryType>(generate(state.range(0), 1.0), kernelType);
+
+  while (state.KeepRunning()) {
+    benchmark::DoNotOptimize(source->ComputeMatchGradient(target));
+  }
+}
+
+template<class GeometryType>
+void ComputeMatch_image(benchmark::State &state) {
+  tear_up::setup_run(state, tear_up::shapes_domain());
+  auto source = tear_up::generate_image_object<GeometryType>(tear_up::generate_image(state.range(0), 0.0));
+  auto target = tear_up::generate_image_object<GeometryType>(tear_up::generate_image(state.range(0), 1.5));
+
+  while (state.KeepRunning()) {
+    benchmark::DoNotOptimize(source->ComputeMatch(target));
+  }
+}
+
+template<class GeometryType>
+void ComputeMatchGradient_image(benchmark::State &state) {
+  tear_up::setup_run(state, tear_up::shapes_domain());
+  auto source = tear_up::generate_image_object<GeometryType>(tear_up::generate_image(state.range(0), 0.0));
+  auto target = tear_up::generate_image_object<GeometryType>(tear_up::generate_image(state.range(0), 1.5));
+
+  while (state.KeepRunning()) {
+    benchmark::DoNotOptimize(source->ComputeMatchGradient(target));
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Models :
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/// One gradient evaluation of a deterministic atlas of oriented surface meshes.
+void DeterministicAtlas_Gradient_meshes(benchmark::State &state) {
+  const KernelEnumType kernelType = (KernelEnumType) state.range(1);
+  auto templateObject = tear_up::generate_multi_object(tear_up::generate_landmark<OrientedSurfaceMeshType>(
+      tear_up::generate_surface(state.range(0), 0.0), kernelType));
+  std::vector<std::shared_ptr<DeformableMultiObjectType>> targets(number_of_subjects);
+  for (unsigned int s = 0; s < number_of_subjects; ++s)
+    targets[s] = tear_up::generate_multi_object(tear_up::generate_landmark<OrientedSurfaceMeshType>(
+        tear_up::generate_surface(state.range(0), 0.5 * (s + 1)), kernelType));
+
+  DataSetType dataSet;
+  LinearVariableMapType popRER, popGrad;
+  LinearVariablesMapType indRER, indGrad;
+  auto atlas = tear_up::generate_atlas(state, templateObject, targets, kernel_width, dataSet, indRER);
+
+  while (state.KeepRunning()) {
+    atlas->ComputeCompleteLogLikelihoodGradient(&dataSet, popRER, indRER, popGrad, indGrad);
+  }
+}
+
+/// One gradient evaluation of a deterministic atlas of images, with the sum of squared differences attachment.
+void DeterministicAtlas_Gradient_images(benchmark::State &state) {
+  auto templateObject = tear_up::generate_multi_object(
+      tear_up::generate_image_object<SSDImageType>(tear_up::generate_image(state.range(0), 0.0)));
+  std::vector<std::shared_ptr<DeformableMultiObjectType>> targets(number_of_subjects);
+  for (unsigned int s = 0; s < number_of_subjects; ++s)
+    targets[s] = tear_up::generate_multi_object(
+        tear_up::generate_image_object<SSDImageType>(tear_up::generate_image(state.range(0), 0.5 * (s + 1))));
+
+  /// The deformation kernel spans a quarter of the image side.
+  const ScalarType imageKernelWidth = 0.25 * std::cbrt((double) state.range(0));
+
+  DataSetType dataSet;
+  LinearVariableMapType popRER, popGrad;
+  LinearVariablesMapType indRER, indGrad;
+  auto atlas = tear_up::generate_atlas(state, templateObject, targets, imageKernelWidth, dataSet, indRER);
+
+  while (state.KeepRunning()) {
+    atlas->ComputeCompleteLogLikelihoodGradient(&dataSet, popRER, indRER, popGrad, indGrad);
+  }
+}
+
+
+// Declare ranges : (number of points, kernel type, number of threads).
+static void PointsKernelsThreads(benchmark::internal::Benchmark *b) {
+  for (int threads : {1, 4})
+    for (int kernel : {Exact, P3M, COMPACT})
+      for (int points = 1 << 8; points <= 1 << 12; points <<= 2)
+        b->Args({points, kernel, threads});
+#ifdef USE_CUDA
+  for (int threads : {1, 4})
+    for (int points = 1 << 8; points <= 1 << 12; points <<= 2)
+      b->Args({points, CUDAExact, threads});
+#endif
+}
+
+/// The attachments of the images and landmarks do not use kernels : only the exact kernel type is run.
+static void VoxelsThreads(benchmark::internal::Benchmark *b) {
+  for (int threads : {1, 4})
+    for (int voxels = 1 << 12; voxels <= 1 << 18; voxels <<= 3)
+      b->Args({voxels, Exact, threads});
+}
+
+static void PointsThreads(benchmark::internal::Benchmark *b) {
+  for (int threads : {1, 4})
+    for (int points = 1 << 8; points <= 1 << 12; points <<= 2)
+      b->Args({points, Exact, threads});
+}
+
+#define MODEL_BENCHMARK(x, ranges) \
+    BENCHMARK(x)->Apply(ranges)->Unit(benchmark::kMillisecond);
+#define MODEL_BENCHMARK_TEMPLATE(x, type, ranges) \
+    BENCHMARK_TEMPLATE(x, type)->Apply(ranges)->Unit(benchmark::kMillisecond);
+#define MODEL_BENCHMARK_TEMPLATE2(x, type, curve, ranges) \
+    BENCHMARK_TEMPLATE2(x, type, curve)->Apply(ranges)->Unit(benchmark::kMillisecond);
+
+// Run tests
+MODEL_BENCHMARK(Diffeos_Shoot, PointsKernelsThreads);
+MODEL_BENCHMARK(Diffeos_FlowLandmarkPointsTrajectory, PointsKernelsThreads);
+MODEL_BENCHMARK(Diffeos_IntegrateAdjointEquations, PointsKernelsThreads);
+MODEL_BENCHMARK(Diffeos_ParallelTransport, PointsKernelsThreads);
+
+MODEL_BENCHMARK_TEMPLATE2(ComputeMatch_landmark, LandmarkType, false, PointsThreads);
+MODEL_BENCHMARK_TEMPLATE2(ComputeMatch_landmark, PointCloudType, false, PointsKernelsThreads);
+MODEL_BENCHMARK_TEMPLATE2(ComputeMatch_landmark, OrientedPolyLineType, true, PointsKernelsThreads);
+MODEL_BENCHMARK_TEMPLATE2(ComputeMatch_landmark, NonOrientedPolyLineType, true, PointsKernelsThreads);
+MODEL_BENCHMARK_TEMPLATE2(ComputeMatch_landmark, OrientedSurfaceMeshType, false, PointsKernelsThreads);
+MODEL_BENCHMARK_TEMPLATE2(ComputeMatch_landmark, NonOrientedSurfaceMeshType, false, PointsKernelsThreads);
+
+MODEL_BENCHMARK_TEMPLATE2(ComputeMatchGradient_landmark, LandmarkType, false, PointsThreads);
+MODEL_BENCHMARK_TEMPLATE2(ComputeMatchGradient_landmark, PointCloudType, false, PointsKernelsThreads);
+MODEL_BENCHMARK_TEMPLATE2(ComputeMatchGradient_landmark, OrientedPolyLineType, true, PointsKernelsThreads);
+MODEL_BENCHMARK_TEMPLATE2(ComputeMatchGradient_landmark, NonOrientedPolyLineType, true, PointsKernelsThreads);
+MODEL_BENCHMARK_TEMPLATE2(ComputeMatchGradient_landmark, OrientedSurfaceMeshType, false, PointsKernelsThreads);
+MODEL_BENCHMARK_TEMPLATE2(ComputeMatchGradient_landmark, NonOrientedSurfaceMeshType, false, PointsKernelsThreads);
+
+MODEL_BENCHMARK_TEMPLATE(ComputeMatch_image, SSDImageType, VoxelsThreads);
+MODEL_BENCHMARK_TEMPLATE(ComputeMatch_image, LCCImageType, VoxelsThreads);
+MODEL_BENCHMARK_TEMPLATE(ComputeMatch_image, EQLAImageType, VoxelsThreads);
+MODEL_BENCHMARK_TEMPLATE(ComputeMatch_image, MutualInformationImageType, VoxelsThreads);
+
+MODEL_BENCHMARK_TEMPLATE(ComputeMatchGradient_image, SSDImageType, VoxelsThreads);
+MODEL_BENCHMARK_TEMPLATE(ComputeMatchGradient_image, LCCImageType, VoxelsThreads);
+MODEL_BENCHMARK_TEMPLATE(ComputeMatchGradient_image, EQLAImageType, VoxelsThreads);
+MODEL_BENCHMARK_TEMPLATE(ComputeMatchGradient_image, MutualInformationImageType, VoxelsThreads);
+
+MODEL_BENCHMARK(DeterministicAtlas_Gradient_meshes, PointsKernelsThreads);
+MODEL_BENCHMARK(DeterministicAtlas_Gradient_images, VoxelsThreads);
+
+BENCHMARK_MAIN();
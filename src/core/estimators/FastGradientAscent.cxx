@@ -11,6 +11,8 @@
 
 
 #include "FastGradientAscent.h"
+#include "Profiler.h"
+#include "AsyncOutputWriter.h"
 
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -132,6 +134,8 @@ FastGradientAscent<ScalarType, Dimension>
 
     bool foundMin = false;
     for (unsigned int li = 0; li < m_MaxLineSearchIterations; li++) {
+      DEF_PROFILE_SCOPE("FastGradientAscent::LineSearchStep");
+      DEF_PROFILE_COUNT("FastGradientAscent::LineSearchSteps", 1);
       if (!(iter % Superclass::m_PrintEveryNIters)) {
         k = 0;
         std::cout << "Step size  = ";
@@ -252,15 +256,22 @@ FastGradientAscent<ScalarType, Dimension>
     lsqRef = newLogLikelihoodTerms.sum();
 
     /// Displays information about the current state of the algorithm.
-    if (!(iter % Superclass::m_PrintEveryNIters)) { Print(); }
+    if (!(iter % Superclass::m_PrintEveryNIters)) {
+      Print();
+      DEF_PROFILE_SUMMARY(iter);
+    }
     if (!(iter % Superclass::m_SaveEveryNIters)) {
+      DEF_PROFILE_SCOPE("FastGradientAscent::Write");
       Superclass::m_StatisticalModel->SetFixedEffects(fixedEffects);
       Superclass::m_StatisticalModel->Write(Superclass::m_DataSet,
                                             Superclass::m_PopulationRER, Superclass::m_IndividualRER);
       Superclass::m_StatisticalModel->SetFixedEffects(auxFixedEffects);
     }
-    Superclass::m_StatisticalModel->ComputeCompleteLogLikelihoodGradient(
-        Superclass::m_DataSet, auxPopRER, auxIndRER, popGrad, indGrad, gradSqNorms);
+    {
+      DEF_PROFILE_SCOPE("FastGradientAscent::ComputeGradient");
+      Superclass::m_StatisticalModel->ComputeCompleteLogLikelihoodGradient(
+          Superclass::m_DataSet, auxPopRER, auxIndRER, popGrad, indGrad, gradSqNorms);
+    }
 
     ScalarType deltaF_cur = m_LogLikelihoodTermsHistory[iter - 1].sum() - m_LogLikelihoodTermsHistory[iter].sum();
     ScalarType deltaF_ref = m_LogLikelihoodTermsHistory[iterRef].sum() - m_LogLikelihoodTermsHistory[iter].sum();
@@ -272,6 +283,7 @@ FastGradientAscent<ScalarType, Dimension>
 
     /* SERIALIZATION */
     if (def::utils::settings.save_state && !(iter % Superclass::m_SaveEveryNIters)) {
+      DEF_PROFILE_SCOPE("FastGradientAscent::SaveState");
       deformation_state << computation_end_state << iter << freezeDirectionCounter << tau
                         << step << gradSqNorms << m_LogLikelihoodTermsHistory
                         << fixedEffects << auxFixedEffects
@@ -287,6 +299,7 @@ FastGradientAscent<ScalarType, Dimension>
   std::cout << "Write output files ...";
   Superclass::m_StatisticalModel->Write(Superclass::m_DataSet,
                                         Superclass::m_PopulationRER, Superclass::m_IndividualRER);
+  AsyncOutputWriter::instance()->Wait();
   std::cout << " done." << std::endl;
 
   /* SERIALIZATION */
@@ -298,7 +311,7 @@ FastGradientAscent<ScalarType, Dimension>
                       << Superclass::m_PopulationRER << auxPopRER
                       << Superclass::m_IndividualRER << auxIndRER
                       << popGrad << indGrad;
-    deformation_state.save_and_reset(def::utils::settings.output_state_filename);
+    deformation_state.save_and_reset(def::utils::settings.output_state_filename, false);
   }
 }
 
@@ -327,14 +340,14 @@ FastGradientAscent<ScalarType, Dimension>
 
   for (auto it = popGrad.begin(); it != popGrad.end(); ++it, ++k) {
     if (newFixedEffects.count(it->first)) {
-      newFixedEffects[it->first] = auxFixedEffects.at(it->first) + it->second * step(k);
+      newFixedEffects[it->first].axpy(step(k), it->second);
     } else {
-      newPopRER[it->first] = auxPopRER.at(it->first) + it->second * step(k);
+      newPopRER[it->first].axpy(step(k), it->second);
     }
   }
 
   for (auto it = indGrad.begin(); it != indGrad.end(); ++it, ++k) {
-    newIndRER[it->first] = auxIndRER.at(it->first) + it->second * step(k);
+    newIndRER[it->first].axpy(step(k), it->second);
   }
 }
 
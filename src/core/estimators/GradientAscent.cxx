@@ -9,6 +9,8 @@
  ****************************************************************************************/
 
 #include "GradientAscent.h"
+#include "Profiler.h"
+#include "AsyncOutputWriter.h"
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 // Constructor(s) / Destructor :
@@ -120,6 +122,8 @@ GradientAscent<ScalarType, Dimension>
 
     bool foundMin = false;
     for (unsigned int li = 0; li < m_MaxLineSearchIterations; li++) {
+      DEF_PROFILE_SCOPE("GradientAscent::LineSearchStep");
+      DEF_PROFILE_COUNT("GradientAscent::LineSearchSteps", 1);
       if (!(iter % Superclass::m_PrintEveryNIters)) {
         k = 0;
         std::cout << "Step size  = ";
@@ -194,8 +198,12 @@ GradientAscent<ScalarType, Dimension>
     lsqRef = newLogLikelihoodTerms.sum();
 
     /// Displays information about the current state of the algorithm.
-    if (!(iter % Superclass::m_PrintEveryNIters)) { Print(); }
+    if (!(iter % Superclass::m_PrintEveryNIters)) {
+      Print();
+      DEF_PROFILE_SUMMARY(iter);
+    }
     if (!(iter % Superclass::m_SaveEveryNIters)) {
+      DEF_PROFILE_SCOPE("GradientAscent::Write");
       Superclass::m_StatisticalModel->Write(Superclass::m_DataSet,
                                             Superclass::m_PopulationRER, Superclass::m_IndividualRER);
     }
@@ -209,11 +217,15 @@ GradientAscent<ScalarType, Dimension>
     }
 
     Superclass::m_StatisticalModel->SetFixedEffects(fixedEffects);
-    Superclass::m_StatisticalModel->ComputeCompleteLogLikelihoodGradient(
-        Superclass::m_DataSet, Superclass::m_PopulationRER, Superclass::m_IndividualRER, popGrad, indGrad);
+    {
+      DEF_PROFILE_SCOPE("GradientAscent::ComputeGradient");
+      Superclass::m_StatisticalModel->ComputeCompleteLogLikelihoodGradient(
+          Superclass::m_DataSet, Superclass::m_PopulationRER, Superclass::m_IndividualRER, popGrad, indGrad);
+    }
 
     /* SERIALIZATION */
     if (def::utils::settings.save_state && !(iter % Superclass::m_SaveEveryNIters)) {
+      DEF_PROFILE_SCOPE("GradientAscent::SaveState");
       deformation_state << computation_end_state << iter << step << m_LogLikelihoodTermsHistory
                         << fixedEffects << Superclass::m_PopulationRER << Superclass::m_IndividualRER
                         << popGrad << indGrad;
@@ -224,6 +236,7 @@ GradientAscent<ScalarType, Dimension>
   std::cout << "Write output files ...";
   Superclass::m_StatisticalModel->Write(
       Superclass::m_DataSet, Superclass::m_PopulationRER, Superclass::m_IndividualRER);
+  AsyncOutputWriter::instance()->Wait();
   std::cout << " done." << std::endl;
 
   /* SERIALIZATION */
@@ -232,7 +245,7 @@ GradientAscent<ScalarType, Dimension>
     deformation_state << computation_end_state << iter << step << m_LogLikelihoodTermsHistory
                       << fixedEffects << Superclass::m_PopulationRER << Superclass::m_IndividualRER
                       << popGrad << indGrad;
-    deformation_state.save_and_reset(def::utils::settings.output_state_filename);
+    deformation_state.save_and_reset(def::utils::settings.output_state_filename, false);
   }
 }
 
@@ -251,7 +264,7 @@ GradientAscent<ScalarType, Dimension>
                      LinearVariableMapType &newFixedEffects,
                      LinearVariableMapType &newPopRER,
                      LinearVariablesMapType &newIndRER) {
-  newFixedEffects.clear();
+  /// The assignments reuse the storage of the previous proposal, and the steps are added in situ.
   newFixedEffects = fixedEffects;
   newPopRER = Superclass::m_PopulationRER;
   newIndRER = Superclass::m_IndividualRER;
@@ -260,14 +273,14 @@ GradientAscent<ScalarType, Dimension>
 
   for (auto it = popGrad.begin(); it != popGrad.end(); ++it, ++k) {
     if (newFixedEffects.count(it->first)) {
-      newFixedEffects[it->first] = fixedEffects.at(it->first) + it->second * step(k);
+      newFixedEffects[it->first].axpy(step(k), it->second);
     } else {
-      newPopRER[it->first] = Superclass::m_PopulationRER[it->first] + it->second * step(k);
+      newPopRER[it->first].axpy(step(k), it->second);
     }
   }
 
   for (auto it = indGrad.begin(); it != indGrad.end(); ++it, ++k) {
-    newIndRER[it->first] = Superclass::m_IndividualRER[it->first] + it->second * step(k);
+    newIndRER[it->first].axpy(step(k), it->second);
   }
 }
 
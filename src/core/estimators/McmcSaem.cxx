@@ -9,7 +9,37 @@
  ****************************************************************************************/
 
 #include "McmcSaem.h"
+#include "ParallelTempering.h"
 #include "MatrixDLM.h"
+#include "RandomNumberGenerator.h"
+#include "Profiler.h"
+#include "AsyncOutputWriter.h"
+
+#include <lib/ThreadPool/ThreadPool.h>
+#include <numeric>
+
+namespace {
+
+/// Runs \e task concurrently for each of the \e chains, and rethrows the first error raised.
+template<class TaskType>
+void RunChainsConcurrently(std::vector<unsigned int> const &chains, TaskType const &task) {
+  std::vector<std::future<void>> futures;
+  {
+    ThreadPool pool(std::max<std::size_t>(1, std::min<std::size_t>(chains.size(),
+                                                                    def::utils::settings.number_of_threads)));
+    for (unsigned int k : chains) futures.push_back(pool.enqueue([&task, k]() { task(k); }));
+  }
+  for (auto &f : futures) f.get();
+}
+
+/// Returns the indices of the chains from \e first to \e last excluded.
+std::vector<unsigned int> ChainIndices(unsigned int first, unsigned int last) {
+  std::vector<unsigned int> out(last > first ? last - first : 0);
+  std::iota(out.begin(), out.end(), first);
+  return out;
+}
+
+}
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 // Constructor(s) / Destructor :
@@ -18,7 +48,8 @@
 template<class ScalarType, unsigned int Dimension>
 McmcSaem<ScalarType, Dimension>
 ::McmcSaem() : Superclass(), m_NbBurnInIterations(100), m_MemoryWindowSize(100),
-               m_UseTempering(false), m_InitialTemperature(100.0), m_TemperingDurationRatio(0.5) {
+               m_UseTempering(false), m_InitialTemperature(100.0), m_TemperingDurationRatio(0.5),
+               m_NumberOfChains(1), m_MaximumChainTemperature(10.0), m_ChainsSwapEveryNIters(1) {
   this->SetMcmcSaemType();
 }
 
@@ -32,6 +63,9 @@ McmcSaem<ScalarType, Dimension>
   m_Sampler = other.m_Sampler;
   m_SufficientStatistics = other.m_SufficientStatistics;
   m_NbBurnInIterations = other.m_NbBurnInIterations;
+  m_NumberOfChains = other.m_NumberOfChains;
+  m_MaximumChainTemperature = other.m_MaximumChainTemperature;
+  m_ChainsSwapEveryNIters = other.m_ChainsSwapEveryNIters;
 }
 
 
@@ -65,7 +99,8 @@ McmcSaem<ScalarType, Dimension>
 
   bool computation_end_state = false;
   def::utils::DeformationState state;
-  if (def::utils::settings.load_state && check_file(def::utils::settings.input_state_filename)) {
+  const bool load_state = def::utils::settings.load_state && check_file(def::utils::settings.input_state_filename);
+  if (load_state) {
 
     /* SERIALIZE : LOAD */
     state.load(def::utils::settings.input_state_filename);
@@ -88,6 +123,7 @@ McmcSaem<ScalarType, Dimension>
 
     Superclass::m_StatisticalModel->SetFixedEffects(fixedEffects);
     m_Sampler->RecoverState(state);
+    RandomNumberGenerator::instance()->RecoverState(state);
 
     /// Print console information.
     Superclass::m_CurrentIteration = iter;
@@ -130,15 +166,22 @@ McmcSaem<ScalarType, Dimension>
     averagedPopRER.fill(0.0);
   }
 
-  m_Sampler->Initialize(Superclass::m_PopulationRER, Superclass::m_IndividualRER);
+  InitializeChains();
+  if (load_state) { RecoverChainsState(state); }
+  for (unsigned int k = 0; k < m_NumberOfChains; ++k) {
+    m_ChainSamplers[k]->Initialize(ChainPopulationRER(k), ChainIndividualRER(k));
+  }
 
   /// Main loop.
   for (; iter < Superclass::m_MaxIterations + 1; ++iter) {
     Superclass::m_CurrentIteration = iter;
 
     /// Simulation.
-    m_Sampler->Sample(Superclass::m_PopulationRER, Superclass::m_IndividualRER,
-                      m_CurrentAcceptanceRates, m_CurrentTemperature);
+    {
+      DEF_PROFILE_SCOPE("McmcSaem::Simulation");
+      SampleChains();
+      if (m_NumberOfChains > 1 && !(iter % m_ChainsSwapEveryNIters)) { SwapChains(); }
+    }
 
     /// Stochastic approximation.
     Superclass::m_StatisticalModel->ComputeSufficientStatistics(Superclass::m_DataSet,
@@ -152,6 +195,7 @@ McmcSaem<ScalarType, Dimension>
     /// Maximization and update.
     Superclass::m_StatisticalModel->UpdateFixedEffects(
         Superclass::m_DataSet, m_SufficientStatistics, m_CurrentTemperature);
+    UpdateChainsFixedEffects();
 
     /// Averages the random effect realizations in the concentration phase.
     if (step < 1.0) {
@@ -164,8 +208,12 @@ McmcSaem<ScalarType, Dimension>
     /// Displays information about the current state of the algorithm.
     UpdateAcceptanceRatesInformation();
     if (!(iter % m_SaveModelParametersEveryNIters)) { UpdateModelParametersTrajectory(); }
-    if (!(iter % Superclass::m_PrintEveryNIters)) { Print(); } // Prints information.
+    if (!(iter % Superclass::m_PrintEveryNIters)) {            // Prints information.
+      Print();
+      DEF_PROFILE_SUMMARY(iter);
+    }
     if (!(iter % Superclass::m_SaveEveryNIters)) {             // Saves information.
+      DEF_PROFILE_SCOPE("McmcSaem::Write");
       /* SERIALIZATION */
       if (def::utils::settings.save_state) {
         Superclass::m_StatisticalModel->GetFixedEffects(fixedEffects);
@@ -179,6 +227,8 @@ McmcSaem<ScalarType, Dimension>
               << m_CurrentTemperature << m_NbTemperingIterations << m_TemperatureUpdateParameter
               << fixedEffects;
         m_Sampler->SaveState(state);
+        RandomNumberGenerator::instance()->SaveState(state);
+        SaveChainsState(state);
         state.save_and_reset(def::utils::settings.output_state_filename);
       }
 
@@ -189,6 +239,7 @@ McmcSaem<ScalarType, Dimension>
     if (m_AdaptiveMode && !(iter % m_AdaptMemoryWindowSize)) { // Optionally adapts the sampler.
       m_Sampler->AdaptProposalDistributions(
           m_AdaptWindowMeanAcceptanceRates, iter, !(iter % Superclass::m_PrintEveryNIters));
+      AdaptChainsProposalDistributions();
     }
     if (m_UseTempering) { UpdateTemperature(); }
   }
@@ -210,11 +261,14 @@ McmcSaem<ScalarType, Dimension>
           << m_CurrentTemperature << m_NbTemperingIterations << m_TemperatureUpdateParameter
           << fixedEffects;
     m_Sampler->SaveState(state);
-    state.save_and_reset(def::utils::settings.output_state_filename);
+    RandomNumberGenerator::instance()->SaveState(state);
+    SaveChainsState(state);
+    state.save_and_reset(def::utils::settings.output_state_filename, false);
   }
 
   Superclass::m_StatisticalModel->Write(Superclass::m_DataSet, averagedPopRER, averagedIndRER);
   Write();
+  AsyncOutputWriter::instance()->Wait();
 
   std::cout << "... done." << std::endl;
 }
@@ -271,6 +325,17 @@ McmcSaem<ScalarType, Dimension>
   }
   std::cout << std::endl;
 
+  /// Prints the mean acceptance rates of the exchanges between the chains, in case of parallel tempering.
+  if (m_NumberOfChains > 1) {
+    std::cout << ">> Mean acceptance rates of the chains exchanges (all past iterations) = ";
+    for (unsigned int k = 0; k + 1 < m_NumberOfChains; ++k) {
+      std::cout << std::endl;
+      std::cout << "\t\t" << m_ChainsSwapAcceptanceRates(k) << " % \t[T = " << m_ChainTemperatures[k]
+                << " <-> T = " << m_ChainTemperatures[k + 1] << "]";
+    }
+    std::cout << std::endl;
+  }
+
   /// Prints information about the current statistical model.
   Superclass::m_StatisticalModel->Print();
 }
@@ -398,10 +463,7 @@ McmcSaem<ScalarType, Dimension>
   LinearVariableMapType modelParameters;
   Superclass::m_StatisticalModel->GetFixedEffects(modelParameters);
 
-  VectorType vectorizedModelParameters(0);
-  for (auto it = modelParameters.begin(); it != modelParameters.end(); ++it) {
-    vectorizedModelParameters.push_back(it->second.vectorize());
-  }
+  const VectorType vectorizedModelParameters = modelParameters.vectorize();
 
   m_ModelParametersTrajectory.set_size(totalNumberOfTrajectoryPoints + 1, vectorizedModelParameters.size());
   m_ModelParametersTrajectory.set_row(0, vectorizedModelParameters);
@@ -414,10 +476,7 @@ McmcSaem<ScalarType, Dimension>
   LinearVariableMapType modelParameters;
   Superclass::m_StatisticalModel->GetFixedEffects(modelParameters);
 
-  VectorType vectorizedModelParameters(0);
-  for (auto it = modelParameters.begin(); it != modelParameters.end(); ++it) {
-    vectorizedModelParameters.push_back(it->second.vectorize());
-  }
+  const VectorType vectorizedModelParameters = modelParameters.vectorize();
 
   m_ModelParametersTrajectory.set_row(Superclass::m_CurrentIteration / m_SaveModelParametersEveryNIters,
                                       vectorizedModelParameters);
@@ -449,6 +508,173 @@ McmcSaem<ScalarType, Dimension>
   } else { m_CurrentTemperature = 1.0; }
 }
 
+template<class ScalarType, unsigned int Dimension>
+void
+McmcSaem<ScalarType, Dimension>
+::InitializeChains() {
+  if (m_NumberOfChains > 1 && m_MaximumChainTemperature < 1.0)
+    throw std::runtime_error("The maximum chain temperature should be greater than one");
+
+  m_ChainTemperatures.assign(1, 1.0);
+  m_ChainModels.assign(1, Superclass::m_StatisticalModel);
+  m_ChainSamplers.assign(1, m_Sampler);
+  for (unsigned int k = 1; k < m_NumberOfChains; ++k) {
+    m_ChainTemperatures.push_back(pow(m_MaximumChainTemperature, ScalarType(k) / (m_NumberOfChains - 1)));
+    m_ChainModels.push_back(Superclass::m_StatisticalModel->Clone());
+    m_ChainSamplers.push_back(std::shared_ptr<AbstractSamplerType>(m_Sampler->Clone()));
+    m_ChainSamplers[k]->SetStatisticalModel(m_ChainModels[k]);
+  }
+
+  /// The hotter chains start from the state of the first one.
+  m_ChainPopulationRER.assign(m_NumberOfChains, Superclass::m_PopulationRER);
+  m_ChainIndividualRER.assign(m_NumberOfChains, Superclass::m_IndividualRER);
+  m_ChainCurrentAcceptanceRates.assign(m_NumberOfChains, m_CurrentAcceptanceRates);
+  m_ChainAdaptAcceptanceRates.assign(m_NumberOfChains, VectorType(m_CurrentAcceptanceRates.size(), 0.0));
+
+  m_NumberOfChainsSwaps.set_size(m_NumberOfChains - 1);
+  m_NumberOfChainsSwaps.fill(0.0);
+  m_ChainsSwapAcceptanceRates.set_size(m_NumberOfChains - 1);
+  m_ChainsSwapAcceptanceRates.fill(0.0);
+
+  if (m_NumberOfChains > 1) {
+    std::cout << ">> Parallel tempering option activated :" << std::endl;
+    std::cout << "\t\t" << m_NumberOfChains << " chains of relative temperatures";
+    for (unsigned int k = 0; k < m_NumberOfChains; ++k) std::cout << " " << m_ChainTemperatures[k];
+    std::cout << std::endl;
+    std::cout << "\t\tExchanges of states between the chains every " << m_ChainsSwapEveryNIters
+              << " iteration(s)" << std::endl;
+  }
+}
+
+template<class ScalarType, unsigned int Dimension>
+void
+McmcSaem<ScalarType, Dimension>
+::SampleChains() {
+  if (m_NumberOfChains == 1) {
+    m_Sampler->Sample(Superclass::m_PopulationRER, Superclass::m_IndividualRER,
+                      m_CurrentAcceptanceRates, m_CurrentTemperature);
+    return;
+  }
+
+  /// Each chain draws from its own stream, so that the draws do not depend on the thread scheduling.
+  std::vector<RandomStream> streams(m_NumberOfChains);
+  const std::uint64_t firstStreamId = RandomNumberGenerator::instance()->Bits();
+  for (unsigned int k = 0; k < m_NumberOfChains; ++k)
+    streams[k] = RandomNumberGenerator::instance()->Stream(firstStreamId + k);
+
+  RunChainsConcurrently(ChainIndices(0, m_NumberOfChains), [&](unsigned int k) {
+    ScopedRandomStream scope(streams[k]);
+    m_ChainSamplers[k]->Sample(ChainPopulationRER(k), ChainIndividualRER(k),
+                               k ? m_ChainCurrentAcceptanceRates[k] : m_CurrentAcceptanceRates,
+                               m_CurrentTemperature * m_ChainTemperatures[k]);
+  });
+
+  for (unsigned int k = 1; k < m_NumberOfChains; ++k)
+    m_ChainAdaptAcceptanceRates[k] += m_ChainCurrentAcceptanceRates[k];
+}
+
+template<class ScalarType, unsigned int Dimension>
+void
+McmcSaem<ScalarType, Dimension>
+::SwapChains() {
+  /// Energies of the current states, i.e. their complete log-likelihoods at temperature 1 : the samplers temper both
+  /// the model terms and the priors of the random effects, so that the priors do not cancel out of the exchanges.
+  std::vector<ScalarType> energies(m_NumberOfChains);
+  auto evaluate = [&](unsigned int k) {
+    std::vector<ScalarType> contributions;
+    energies[k] = m_ChainModels[k]->ComputeModelLogLikelihood(
+        Superclass::m_DataSet, ChainPopulationRER(k), ChainIndividualRER(k), 1.0, "All", contributions);
+
+    ProbabilityDistributionMapType popRED, indRED;
+    m_ChainModels[k]->GetPopulationRandomEffects(popRED);
+    m_ChainModels[k]->GetIndividualRandomEffects(indRED);
+    for (auto it = ChainPopulationRER(k).begin(); it != ChainPopulationRER(k).end(); ++it)
+      energies[k] += popRED[it->first]->ComputeLogLikelihood(it->second, 1.0);
+    for (auto it = ChainIndividualRER(k).begin(); it != ChainIndividualRER(k).end(); ++it)
+      for (const auto &rer : it->second)
+        energies[k] += indRED[it->first]->ComputeLogLikelihood(rer, 1.0);
+  };
+  RunChainsConcurrently(ChainIndices(0, m_NumberOfChains), evaluate);
+
+  /// The pairs (0, 1), (2, 3), ... and (1, 2), (3, 4), ... are proposed in turns.
+  std::vector<unsigned int> swapped;
+  const unsigned int first = (Superclass::m_CurrentIteration / m_ChainsSwapEveryNIters) % 2;
+  for (unsigned int k = first; k + 1 < m_NumberOfChains; k += 2) {
+    const ScalarType logRatio = ChainsSwapLogRatio<ScalarType>(
+        m_CurrentTemperature * m_ChainTemperatures[k], m_CurrentTemperature * m_ChainTemperatures[k + 1],
+        energies[k], energies[k + 1]);
+    const bool accepted = log(RandomNumberGenerator::instance()->Uniform()) < logRatio;
+
+    m_NumberOfChainsSwaps(k) += 1.0;
+    m_ChainsSwapAcceptanceRates(k) += ((accepted ? 100.0 : 0.0) - m_ChainsSwapAcceptanceRates(k))
+        / m_NumberOfChainsSwaps(k);
+
+    if (accepted) {
+      std::swap(ChainPopulationRER(k), ChainPopulationRER(k + 1));
+      std::swap(ChainIndividualRER(k), ChainIndividualRER(k + 1));
+      swapped.push_back(k);
+      swapped.push_back(k + 1);
+    }
+  }
+
+  /// The models and the samplers memorize information about the current state : they are brought up to date.
+  RunChainsConcurrently(swapped, [&](unsigned int k) {
+    evaluate(k);
+    m_ChainSamplers[k]->Initialize(ChainPopulationRER(k), ChainIndividualRER(k));
+  });
+}
+
+template<class ScalarType, unsigned int Dimension>
+void
+McmcSaem<ScalarType, Dimension>
+::UpdateChainsFixedEffects() {
+  /// The maximization step is deterministic : all the models keep the same fixed effects.
+  RunChainsConcurrently(ChainIndices(1, m_NumberOfChains), [&](unsigned int k) {
+    m_ChainModels[k]->UpdateFixedEffects(Superclass::m_DataSet, m_SufficientStatistics, m_CurrentTemperature);
+  });
+}
+
+template<class ScalarType, unsigned int Dimension>
+void
+McmcSaem<ScalarType, Dimension>
+::AdaptChainsProposalDistributions() {
+  for (unsigned int k = 1; k < m_NumberOfChains; ++k) {
+    m_ChainSamplers[k]->AdaptProposalDistributions(
+        m_ChainAdaptAcceptanceRates[k] / m_AdaptMemoryWindowSize, Superclass::m_CurrentIteration);
+    m_ChainAdaptAcceptanceRates[k].fill(0.0);
+  }
+}
+
+template<class ScalarType, unsigned int Dimension>
+void
+McmcSaem<ScalarType, Dimension>
+::SaveChainsState(def::utils::DeformationState &state) const {
+  /// Nothing is appended for a single chain, so that the saved states remain the same as before.
+  if (m_NumberOfChains == 1) { return; }
+
+  state << m_NumberOfChainsSwaps << m_ChainsSwapAcceptanceRates;
+  for (unsigned int k = 1; k < m_NumberOfChains; ++k) {
+    state << m_ChainPopulationRER[k] << m_ChainIndividualRER[k] << m_ChainAdaptAcceptanceRates[k];
+    m_ChainSamplers[k]->SaveState(state);
+  }
+}
+
+template<class ScalarType, unsigned int Dimension>
+void
+McmcSaem<ScalarType, Dimension>
+::RecoverChainsState(def::utils::DeformationState &state) {
+  if (m_NumberOfChains == 1) { return; }
+
+  state >> m_NumberOfChainsSwaps >> m_ChainsSwapAcceptanceRates;
+  if (m_NumberOfChainsSwaps.size() != m_NumberOfChains - 1)
+    throw std::runtime_error("The saved state was computed with a different number of chains");
+
+  for (unsigned int k = 1; k < m_NumberOfChains; ++k) {
+    state >> m_ChainPopulationRER[k] >> m_ChainIndividualRER[k] >> m_ChainAdaptAcceptanceRates[k];
+    m_ChainSamplers[k]->RecoverState(state);
+  }
+}
+
 template
 class McmcSaem<double, 2>;
 template
@@ -99,6 +99,13 @@ class McmcSaem : public AbstractEstimator<ScalarType, Dimension> {
   /// Sets the tempering duration ratio.
   void SetTemperingDurationRatio(const ScalarType &tdr) { m_TemperingDurationRatio = tdr; }
 
+  /// Sets the number of chains. Several chains enable the parallel tempering.
+  void SetNumberOfChains(unsigned int const &n) { m_NumberOfChains = std::max(n, 1u); }
+  /// Sets the temperature of the hottest chain, relatively to the one of the first chain.
+  void SetMaximumChainTemperature(const ScalarType &temperature) { m_MaximumChainTemperature = temperature; }
+  /// Sets the number of iterations between two exchanges of states between the chains.
+  void SetChainsSwapEveryNIters(unsigned int const &n) { m_ChainsSwapEveryNIters = std::max(n, 1u); }
+
 
   ////////////////////////////////////////////////////////////////////////////////////////////////////
   // Other public method(s) :
@@ -143,6 +150,31 @@ class McmcSaem : public AbstractEstimator<ScalarType, Dimension> {
   /// Updates the temperature.
   void UpdateTemperature();
 
+  /// Initializes the hotter chains as copies of the first one.
+  void InitializeChains();
+  /// Runs one simulation step of all the chains.
+  void SampleChains();
+  /// Proposes exchanges of states between the chains of neighbouring temperatures.
+  void SwapChains();
+  /// Runs the maximization step on the hotter chains models, with the sufficient statistics of the first chain.
+  void UpdateChainsFixedEffects();
+  /// Adapts the proposal distributions of the hotter chains samplers.
+  void AdaptChainsProposalDistributions();
+
+  /// Saves the state of the hotter chains.
+  void SaveChainsState(def::utils::DeformationState &state) const;
+  /// Recovers a previously saved state of the hotter chains.
+  void RecoverChainsState(def::utils::DeformationState &state);
+
+  /// Returns the population random effects realizations of the chain \e k.
+  LinearVariableMapType &ChainPopulationRER(unsigned int k) {
+    return k ? m_ChainPopulationRER[k] : Superclass::m_PopulationRER;
+  }
+  /// Returns the individual random effects realizations of the chain \e k.
+  LinearVariablesMapType &ChainIndividualRER(unsigned int k) {
+    return k ? m_ChainIndividualRER[k] : Superclass::m_IndividualRER;
+  }
+
 
   ////////////////////////////////////////////////////////////////////////////////////////////////////
   // Protected attribute(s)
@@ -201,6 +233,27 @@ class McmcSaem : public AbstractEstimator<ScalarType, Dimension> {
   /// Temperature update parameter.
   ScalarType m_TemperatureUpdateParameter;
 
+  /// Number of chains. The first one is the estimated one, the others are hotter and only help it to mix.
+  unsigned int m_NumberOfChains;
+  /// Temperature of the hottest chain, relatively to the first one. The ladder in between is geometric.
+  ScalarType m_MaximumChainTemperature;
+  /// Number of iterations between two exchanges of states between the chains.
+  unsigned int m_ChainsSwapEveryNIters;
+  /// Temperatures of the chains, relatively to the first one.
+  std::vector<ScalarType> m_ChainTemperatures;
+  /// Statistical models and samplers of the chains. The first ones are the estimated model and m_Sampler.
+  std::vector<std::shared_ptr<StatisticalModelType>> m_ChainModels;
+  std::vector<std::shared_ptr<AbstractSamplerType>> m_ChainSamplers;
+  /// Random effects realizations of the hotter chains. Those of the first chain are the estimator ones.
+  std::vector<LinearVariableMapType> m_ChainPopulationRER;
+  std::vector<LinearVariablesMapType> m_ChainIndividualRER;
+  /// Acceptance rates of the current iteration of the hotter chains, and their sum over the adaptation window.
+  std::vector<VectorType> m_ChainCurrentAcceptanceRates;
+  std::vector<VectorType> m_ChainAdaptAcceptanceRates;
+  /// Numbers of attempted exchanges between each chain and the next one, and their mean acceptance rates.
+  VectorType m_NumberOfChainsSwaps;
+  VectorType m_ChainsSwapAcceptanceRates;
+
 }; /* class McmcSaem */
 
 
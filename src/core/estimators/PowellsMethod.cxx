@@ -9,6 +9,7 @@
  ****************************************************************************************/
 
 #include "PowellsMethod.h"
+#include "AsyncOutputWriter.h"
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 // Constructor(s) / Destructor :
@@ -102,6 +103,7 @@ PowellsMethod<ScalarType, Dimension>
   std::cout << "Write output files ...";
   Superclass::m_StatisticalModel->Write(
       Superclass::m_DataSet, Superclass::m_PopulationRER, Superclass::m_IndividualRER);
+  AsyncOutputWriter::instance()->Wait();
   std::cout << " done." << std::endl;
 }
 
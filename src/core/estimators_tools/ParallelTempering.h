@@ -0,0 +1,21 @@
+/***************************************************************************************
+*                                                                                      *
+*                                     Deformetrica                                     *
+*                                                                                      *
+*    Copyright Inria and the University of Utah.  All rights reserved. This file is    *
+*    distributed under the terms of the Inria Non-Commercial License Agreement.        *
+*                                                                                      *
+*                                                                                      *
+****************************************************************************************/
+
+#pragma once
+
+/// Log-ratio of the exchange of the states of two tempered chains, which sample from exp(energy / temperature).
+/// The energy of a state is its complete log-likelihood at temperature 1 : the model terms plus the priors of all the
+/// random effects, since the samplers temper both of them. The exchange is accepted with probability
+/// min(1, exp(ratio)), which keeps the target of each chain invariant.
+template<class ScalarType>
+inline ScalarType ChainsSwapLogRatio(ScalarType temperature, ScalarType nextTemperature,
+                                     ScalarType energy, ScalarType nextEnergy) {
+  return (1.0 / temperature - 1.0 / nextTemperature) * (nextEnergy - energy);
+}
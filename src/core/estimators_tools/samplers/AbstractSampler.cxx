@@ -26,7 +26,13 @@ AbstractSampler<ScalarType, Dimension>
 
 template<class ScalarType, unsigned int Dimension>
 AbstractSampler<ScalarType, Dimension>
-::AbstractSampler(const AbstractSampler &other) {}
+::AbstractSampler(const AbstractSampler &other) {
+  m_Type = other.m_Type;
+  m_StatisticalModel = other.m_StatisticalModel;
+  m_DataSet = other.m_DataSet;
+  m_NumberOfSubjects = other.m_NumberOfSubjects;
+  m_AcceptanceRatesTarget = other.m_AcceptanceRatesTarget;
+}
 
 template
 class AbstractSampler<double, 2>;
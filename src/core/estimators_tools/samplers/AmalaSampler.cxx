@@ -36,7 +36,16 @@ AmalaSampler<ScalarType, Dimension>
 
 template<class ScalarType, unsigned int Dimension>
 AmalaSampler<ScalarType, Dimension>
-::AmalaSampler(const AmalaSampler &other) {}
+::AmalaSampler(const AmalaSampler &other) : Superclass(other) {
+  m_Threshold = other.m_Threshold;
+  m_MeanScales = other.m_MeanScales;
+  m_CovarianceScales = other.m_CovarianceScales;
+  m_Regularizations = other.m_Regularizations;
+  m_CurrentTotalRER = other.m_CurrentTotalRER;
+  m_CurrentProposalRED = other.m_CurrentProposalRED;
+  m_SizeParametersRER = other.m_SizeParametersRER;
+  m_TotalSizeRER = other.m_TotalSizeRER;
+}
 
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
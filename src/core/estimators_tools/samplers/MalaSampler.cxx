@@ -27,7 +27,14 @@ MalaSampler<ScalarType, Dimension>
 
 template<class ScalarType, unsigned int Dimension>
 MalaSampler<ScalarType, Dimension>
-::MalaSampler(const MalaSampler &other) {}
+::MalaSampler(const MalaSampler &other) : Superclass(other) {
+  m_Threshold = other.m_Threshold;
+  m_Scales = other.m_Scales;
+  m_CurrentTotalRER = other.m_CurrentTotalRER;
+  m_CurrentProposalRED = other.m_CurrentProposalRED;
+  m_SizeParametersRER = other.m_SizeParametersRER;
+  m_TotalSizeRER = other.m_TotalSizeRER;
+}
 
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -10,6 +10,10 @@
 
 
 #include "SrwMhwgSampler.h"
+#include "GeneralSettings.h"
+#include <lib/ThreadPool/ThreadPool.h>
+
+#include <algorithm>
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 // Constructor(s) / Destructor :
@@ -27,7 +31,17 @@ SrwMhwgSampler<ScalarType, Dimension>
 
 template<class ScalarType, unsigned int Dimension>
 SrwMhwgSampler<ScalarType, Dimension>
-::SrwMhwgSampler(const SrwMhwgSampler &other) {}
+::SrwMhwgSampler(const SrwMhwgSampler &other) : Superclass(other) {
+  /// The proposals are adapted along the estimation : each copy gets its own.
+  for (auto it = other.m_PopulationProposalDistribution.begin();
+       it != other.m_PopulationProposalDistribution.end(); ++it)
+    m_PopulationProposalDistribution[it->first]
+        = std::shared_ptr<AbstractNormalDistributionType>(it->second->Clone());
+  for (auto it = other.m_IndividualProposalDistribution.begin();
+       it != other.m_IndividualProposalDistribution.end(); ++it)
+    m_IndividualProposalDistribution[it->first]
+        = std::shared_ptr<AbstractNormalDistributionType>(it->second->Clone());
+}
 
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -145,100 +159,90 @@ SrwMhwgSampler<ScalarType, Dimension>
     acceptanceRates(popRECount) *= 100.0 / blockCount;
   }
 
-  /// [std::map loop] Loop on the individual variables (typically momentas). Parallelization ?? TODO.
+  /// [std::map loop] Loop on the individual variables (typically momentas).
+  /// The subjects being conditionally independent given the population variables, their proposals are drawn in
+  /// parallel, each one from its own random stream so that the draws do not depend on the thread scheduling.
+  const unsigned long numberOfSubjects = Superclass::m_NumberOfSubjects;
   unsigned int indRECount = 0;
   for (auto it = indRER.begin(); it != indRER.end(); ++it, ++indRECount) {
-//    /// For bug-tracking.
-//    std::cout << "\n[" << it->first << "]" << std::endl;
-
     acceptanceRates(popRECount + indRECount) = 0.0;
 
     // RED (Random Effect Distribution).
     std::shared_ptr<ProbabilityDistributionType> priorRED = indRE[it->first];
     std::shared_ptr<AbstractNormalDistributionType> propoRED = m_IndividualProposalDistribution.at(it->first);
 
-    /// [std::vector loop] Loop on the individuals i.
+    // RER (Random Effect Realization) size.
+    std::vector<unsigned int> sizeParams;
+    const unsigned int sizeRER = vectorize(it->second[0], sizeParams).size();
+
+    /// [VectorType loop] Exhaustive loop on the blocks of scalar values of the current and candidate RERs.
     unsigned int blockCount = 0;
-    for (unsigned int l = 0; l < indRER[it->first][0].n_elem(); ++blockCount) {
-      unsigned int blockSize = propoRED->GetMean().size();
-      std::vector<ScalarType> currPriorTerms(Superclass::m_NumberOfSubjects);
-      std::vector<ScalarType> candPriorTerms(Superclass::m_NumberOfSubjects);
-      std::vector<ScalarType> candModelTerms(Superclass::m_NumberOfSubjects);
-      std::vector<VectorType> currRERs(Superclass::m_NumberOfSubjects);
-      std::vector<VectorType> currRERs_block_memory(Superclass::m_NumberOfSubjects);
-      std::vector<VectorType> candRERs_block(Superclass::m_NumberOfSubjects);
-      std::vector<unsigned int> sizeParams;
-
-      for (unsigned long i = 0; i < Superclass::m_NumberOfSubjects; ++i) {
-        currPriorTerms[i] = priorRED->ComputeLogLikelihood(it->second[i], temperature);
-
-        // RER (Random Effect Realization) ; Curr (Current).
-        currRERs[i] = vectorize(indRER[it->first][i], sizeParams);
-
-        /// [VectorType loop] Exhaustive loop on every scalar value of the current and candidate RER.
-        /// Draw the candidate (Cand).
-        currRERs_block_memory[i].set_size(blockSize);
-        currRERs_block_memory[i].fill(0.0);
-        for (unsigned int m = 0; m < blockSize;) {
-          currRERs_block_memory[i](m) = currRERs[i](l + m);
-          ++m;
-          if (l + m == currRERs[i].size()) {
-            currRERs_block_memory[i].set_size(m);
-            blockSize = m;
-            break;
-          }
+    for (unsigned int l = 0; l < sizeRER; ++blockCount) {
+      const unsigned int blockSize = std::min<unsigned int>(propoRED->GetMean().size(), sizeRER - l);
+      std::vector<ScalarType> currPriorTerms(numberOfSubjects);
+      std::vector<ScalarType> candPriorTerms(numberOfSubjects);
+      std::vector<ScalarType> candModelTerms(numberOfSubjects);
+      std::vector<VectorType> currRERs(numberOfSubjects);
+      std::vector<VectorType> currRERs_block_memory(numberOfSubjects);
+
+      std::vector<RandomStream> streams(numberOfSubjects);
+      const std::uint64_t firstStreamId = RandomNumberGenerator::instance()->Bits();
+      for (unsigned long i = 0; i < numberOfSubjects; ++i)
+        streams[i] = RandomNumberGenerator::instance()->Stream(firstStreamId + i);
+
+      /// Draw the candidates (Cand), and evaluate their prior terms.
+      {
+        ThreadPool pool(def::utils::settings.number_of_threads);
+        for (unsigned long i = 0; i < numberOfSubjects; ++i) {
+          pool.enqueue([&, i]() {
+            ScopedRandomStream scope(streams[i]);
+            currPriorTerms[i] = priorRED->ComputeLogLikelihood(it->second[i], temperature);
+
+            std::vector<unsigned int> sizeParams_i;
+            currRERs[i] = vectorize(it->second[i], sizeParams_i);
+            currRERs_block_memory[i] = currRERs[i].subvec(l, l + blockSize - 1);
+
+            const std::unique_ptr<AbstractNormalDistributionType> propoRED_i(propoRED->Clone());
+            propoRED_i->SetMean(currRERs_block_memory[i]);
+            VectorType candRER_i_block = propoRED_i->Sample();
+            candRER_i_block.set_size(blockSize);
+
+            for (unsigned int m = 0; m < blockSize; ++m)
+              currRERs[i](l + m) = candRER_i_block(m); // Accept
+
+            it->second[i] = unvectorize(currRERs[i], sizeParams_i);
+            candPriorTerms[i] = priorRED->ComputeLogLikelihood(currRERs[i], temperature);
+          });
         }
-        propoRED->SetMean(currRERs_block_memory[i]);
-        VectorType candRER_i_block = propoRED->Sample();
-        candRER_i_block.set_size(blockSize);
-
-        /// Evaluate the candidate part (Cand).
-        for (unsigned int m = 0; m < blockSize; ++m)
-          currRERs[i](l + m) = candRER_i_block(m); // Accept
-
-//        /// For bug-tracking.
-//        ScalarType before = Superclass::m_StatisticalModel->ComputeCompleteLogLikelihood(
-//            Superclass::m_DataSet, popRER, indRER);
-
-        it->second[i] = unvectorize(currRERs[i], sizeParams);
-        candPriorTerms[i] = priorRED->ComputeLogLikelihood(currRERs[i], temperature);
       }
 
-      ScalarType candModelTerm = Superclass::m_StatisticalModel->ComputeModelLogLikelihood(
+      /// Evaluate the candidates part (Cand). Only the subjects whose realization changed are actually recomputed.
+      Superclass::m_StatisticalModel->ComputeModelLogLikelihood(
           Superclass::m_DataSet, popRER, indRER, temperature, it->first, candModelTerms);
 
-      for (unsigned long i = 0; i < Superclass::m_NumberOfSubjects; ++i) {
-        /// Accept-reject.
+      /// Accept-reject.
+      std::vector<bool> rejected(numberOfSubjects, false);
+      for (unsigned long i = 0; i < numberOfSubjects; ++i) {
+        ScopedRandomStream scope(streams[i]);
         ScalarType tau = candPriorTerms[i] + candModelTerms[i] - currPriorTerms[i] - currModelTerms[i];
         if (std::log(u.Sample()(0)) > tau)       // Reject.
         {
           for (unsigned int m = 0; m < blockSize; ++m) { currRERs[i](l + m) = currRERs_block_memory[i](m); }
           it->second[i] = unvectorize(currRERs[i], sizeParams);
-          Superclass::m_StatisticalModel->RecoverMemorizedState();
+          rejected[i] = true;
         } else {
-//          /// For bug-tracking.
-//          deltaCLL += candPriorTerms[i] + candModelTerms[i] - currPriorTerms[i] - currModelTerms[i];
-//
-//          ScalarType after = Superclass::m_StatisticalModel->ComputeCompleteLogLikelihood(
-//              Superclass::m_DataSet, popRER, indRER);
-//          std::cout << "We should have delta model term = " << candModelTerms[i] - currModelTerms[i] << std::endl;
-//          std::cout << "We should have delta prior term = " << candPriorTerms[i] - currPriorTerms[i] << std::endl;
-//          std::cout << "We should have " << candPriorTerms[i] + candModelTerms[i] - currPriorTerms[i] - currModelTerms[i]
-//                    << " = " << after - before;
-//          if (std::fabs(after - before - (candPriorTerms[i] + candModelTerms[i] - currPriorTerms[i] - currModelTerms[i])) < 1e-5) {
-//            std::cout << " >> OK \n" << std::endl;
-//          } else { std::cout << " >> NOT OK \n" << std::endl; }
-//          assert(std::fabs(after - before - (candPriorTerms[i] + candModelTerms[i] - currPriorTerms[i] - currModelTerms[i])) < 1e-5);
-
           currModelTerms[i] = candModelTerms[i];
           currPriorTerms[i] = candPriorTerms[i];
           acceptanceRates(popRECount + indRECount) += 1.0;
         }
       }
+      if (std::find(rejected.begin(), rejected.end(), true) != rejected.end())
+        Superclass::m_StatisticalModel->RecoverMemorizedState(rejected);
+
       /// Move on to the next block.
       l += blockSize;
     }
-    acceptanceRates(popRECount + indRECount) *= 100.0 / (blockCount * Superclass::m_NumberOfSubjects);
+    acceptanceRates(popRECount + indRECount) *= 100.0 / (blockCount * numberOfSubjects);
   }
 
   /// For bug-tracking.
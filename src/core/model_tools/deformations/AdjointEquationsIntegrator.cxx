@@ -6,6 +6,7 @@
 #include <itkDerivativeImageFilter.h>
 
 #include "MatrixDLM.h"
+#include <lib/ThreadPool/ThreadPool.h>
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 // Constructor(s) / Destructor :
@@ -14,7 +15,7 @@
 template <class ScalarType, unsigned int Dimension>
 AdjointEquationsIntegrator<ScalarType, Dimension>
 ::AdjointEquationsIntegrator() :
-	m_IsLandmarkPoints(false), m_IsImagePoints(false), m_HasJumps(false), m_KernelObj1(NULL),
+	m_NumberOfPointBlocks(1), m_IsLandmarkPoints(false), m_IsImagePoints(false), m_HasJumps(false), m_KernelObj1(NULL),
 	m_KernelObj2(NULL), m_KernelObj3(NULL), m_KernelObj4(NULL), m_UseFastConvolutions(false)
 {}
 
@@ -61,10 +62,60 @@ void
 AdjointEquationsIntegrator<ScalarType, Dimension>
 ::IntegrateAdjointOfLandmarkPointsEquations()
 {
-
 	// Propagate theta backward. Initialization.
 	m_ThetaT.resize(m_NumberOfTimePoints); // <--- Initialize each matrix at 0 ?
 
+	// The adjoint variables of the points do not depend on each other : blocks of points may be integrated concurrently.
+	const unsigned int numberOfPoints = m_LandmarkPointsT[0].rows();
+	const unsigned int numberOfBlocks = std::max(1u, std::min(m_NumberOfPointBlocks, numberOfPoints));
+	if (numberOfBlocks == 1)
+	{
+		this->IntegrateAdjointOfLandmarkPoints(m_LandmarkPointsT, m_ListInitialConditionsLandmarkPoints, m_ThetaT);
+		return;
+	}
+
+	std::vector<unsigned int> bounds(numberOfBlocks + 1);
+	for (unsigned int b = 0; b <= numberOfBlocks; ++b)
+		bounds[b] = b * numberOfPoints / numberOfBlocks;
+
+	std::vector<MatrixListType> blockPointsT(numberOfBlocks), blockInitialConditions(numberOfBlocks);
+	std::vector<MatrixListType> blockThetaT(numberOfBlocks);
+	std::vector<std::future<void>> futures;
+	{
+		ThreadPool pool(numberOfBlocks);
+		for (unsigned int b = 0; b < numberOfBlocks; ++b)
+		{
+			const unsigned int n = bounds[b + 1] - bounds[b];
+			blockPointsT[b].resize(m_NumberOfTimePoints);
+			for (unsigned int t = 0; t < m_NumberOfTimePoints; ++t)
+				blockPointsT[b][t] = m_LandmarkPointsT[t].get_n_rows(bounds[b], n);
+			blockInitialConditions[b].resize(m_ListInitialConditionsLandmarkPoints.size());
+			for (unsigned int i = 0; i < m_ListInitialConditionsLandmarkPoints.size(); ++i)
+				blockInitialConditions[b][i] = m_ListInitialConditionsLandmarkPoints[i].get_n_rows(bounds[b], n);
+			blockThetaT[b].resize(m_NumberOfTimePoints);
+
+			futures.push_back(pool.enqueue([&, b]() {
+				this->IntegrateAdjointOfLandmarkPoints(blockPointsT[b], blockInitialConditions[b], blockThetaT[b]);
+			}));
+		}
+	}
+	for (auto &f : futures) f.get();
+
+	for (unsigned int t = 0; t < m_NumberOfTimePoints; ++t)
+	{
+		m_ThetaT[t].set_size(numberOfPoints, Dimension);
+		for (unsigned int b = 0; b < numberOfBlocks; ++b)
+			m_ThetaT[t].update(blockThetaT[b][t], bounds[b]);
+	}
+}
+
+
+template <class ScalarType, unsigned int Dimension>
+void
+AdjointEquationsIntegrator<ScalarType, Dimension>
+::IntegrateAdjointOfLandmarkPoints(const MatrixListType& pointsT, const MatrixListType& initialConditions,
+		MatrixListType& thetaT) const
+{
     ScalarType dt = (m_TN - m_T0) / (m_NumberOfTimePoints - 1);
     int subjIndex = m_JumpTimes.size() - 1;
 
@@ -72,22 +123,20 @@ AdjointEquationsIntegrator<ScalarType, Dimension>
 	{
         if (m_JumpTimes[subjIndex] == m_NumberOfTimePoints - 1)
         {
-            m_ThetaT[m_NumberOfTimePoints - 1] = m_ListInitialConditionsLandmarkPoints[subjIndex];
+            thetaT[m_NumberOfTimePoints - 1] = initialConditions[subjIndex];
             --subjIndex; if (subjIndex < 0) subjIndex = 0;
         }
         else
         {
-            m_ThetaT[m_NumberOfTimePoints - 1] = m_ListInitialConditionsLandmarkPoints[0];
-            m_ThetaT[m_NumberOfTimePoints - 1].fill(0.0);
+            thetaT[m_NumberOfTimePoints - 1] = initialConditions[0];
+            thetaT[m_NumberOfTimePoints - 1].fill(0.0);
         }
 	}
     else
 	{
-		m_ThetaT[m_NumberOfTimePoints - 1] = m_ListInitialConditionsLandmarkPoints[0];
+		thetaT[m_NumberOfTimePoints - 1] = initialConditions[0];
 	}
 
-	typedef KernelFactory<ScalarType, Dimension> KernelFactoryType;
-	typedef typename KernelFactoryType::KernelBaseType KernelType;
 	KernelFactoryType* kFactory = KernelFactoryType::Instantiate();
 
 	std::shared_ptr<KernelType> kernelObj = kFactory->CreateKernelObject(m_KernelType);
@@ -99,17 +148,17 @@ AdjointEquationsIntegrator<ScalarType, Dimension>
 		kernelObj->SetSources(m_PosT[t]);
 		kernelObj->SetWeights(m_MomT[t]);
 
-		MatrixType dTheta = kernelObj->ConvolveGradient(m_LandmarkPointsT[t], m_ThetaT[t]);
+		MatrixType dTheta = kernelObj->ConvolveGradient(pointsT[t], thetaT[t]);
 
 		if (m_HasJumps)
 		{
 			if (t == m_JumpTimes[subjIndex])
 			{
-				dTheta += m_ListInitialConditionsLandmarkPoints[subjIndex]; // WARNING : problem here if simple euler ?
+				dTheta += initialConditions[subjIndex]; // WARNING : problem here if simple euler ?
 			}
 		}
 
-		m_ThetaT[t-1] = m_ThetaT[t] + dTheta * dt; // the plus is correct! dTheta should be negative.
+		thetaT[t-1] = thetaT[t] + dTheta * dt; // the plus is correct! dTheta should be negative.
 
 		// Heun's method
 		if (m_UseImprovedEuler)
@@ -118,18 +167,18 @@ AdjointEquationsIntegrator<ScalarType, Dimension>
 			kernelObj->SetSources(m_PosT[t-1]);
 			kernelObj->SetWeights(m_MomT[t-1]);
 
-			MatrixType dTheta2 = kernelObj->ConvolveGradient(m_LandmarkPointsT[t-1], m_ThetaT[t-1]);
+			MatrixType dTheta2 = kernelObj->ConvolveGradient(pointsT[t-1], thetaT[t-1]);
 
 			if (m_HasJumps)
 			{
 				if (t == m_JumpTimes[subjIndex])
 				{
-					dTheta2 += m_ListInitialConditionsLandmarkPoints[subjIndex];
+					dTheta2 += initialConditions[subjIndex];
 					--subjIndex; if (subjIndex < 0) subjIndex = 0;
 				}
 			}
 
-			m_ThetaT[t-1] = m_ThetaT[t] + (dTheta + dTheta2) * (dt * 0.5f);
+			thetaT[t-1] = thetaT[t] + (dTheta + dTheta2) * (dt * 0.5f);
 		}
 	}
 
@@ -438,6 +487,8 @@ AdjointEquationsIntegrator<ScalarType, Dimension>
 
 	ScalarType dt = (m_TN - m_T0) / (m_NumberOfTimePoints-1);
 
+	this->ComputePointsTermsOfUpdates();
+
 	for (long t = m_NumberOfTimePoints-1; t >= 1; t--)
 	{
 		MatrixType dPos;
@@ -476,41 +527,107 @@ AdjointEquationsIntegrator<ScalarType, Dimension>
 template <class ScalarType, unsigned int Dimension>
 void
 AdjointEquationsIntegrator<ScalarType, Dimension>
-::ComputeUpdateAt(unsigned int s, MatrixType& dPos, MatrixType &dMom)
+::ComputePointsTermsOfUpdates()
 {
-
 	long numCP = m_PosT[0].rows();
 
-	std::shared_ptr<KernelType> momXiPosKernelObj = m_KernelObj1;
-	std::shared_ptr<KernelType> etaKernelObj = m_KernelObj2;
-	std::shared_ptr<KernelType> tmpKernelObj = m_KernelObj3;
-
 	// Concatenate landmark and image points, as well as their adjoint variables. Save time in convolution.
 	int nbOfLandmarkPoints = m_IsLandmarkPoints?m_LandmarkPointsT[0].rows():0;
 	int nbOfImagePoints = m_IsImagePoints?m_ImagePointsT[0].rows():0;
 	int nbTotalPoints = nbOfLandmarkPoints + nbOfImagePoints;
 
-	MatrixType ConcatenatedPoints(nbTotalPoints, Dimension);
-	MatrixType ConcatenatedVectors(nbTotalPoints, Dimension);
+	// These terms do not depend on the adjoint variables of control points and momentas : the convolutions are sums over
+	// the points, computed by blocks of points concurrently, at every time at once.
+	const int numberOfBlocks = std::max(1, std::min<int>(m_NumberOfPointBlocks, nbTotalPoints));
+	std::vector<int> bounds(numberOfBlocks + 1);
+	for (int b = 0; b <= numberOfBlocks; ++b)
+		bounds[b] = b * nbTotalPoints / numberOfBlocks;
+
+	std::vector<MatrixListType> blockXiPosT(numberOfBlocks), blockXiMomT(numberOfBlocks);
+	auto computeBlock = [&](int b, std::shared_ptr<KernelType> etaKernelObj)
+	{
+		blockXiPosT[b].resize(m_NumberOfTimePoints);
+		blockXiMomT[b].resize(m_NumberOfTimePoints);
+
+		MatrixType ConcatenatedPoints(bounds[b + 1] - bounds[b], Dimension);
+		MatrixType ConcatenatedVectors(bounds[b + 1] - bounds[b], Dimension);
+		for (unsigned int s = 0; s < m_NumberOfTimePoints; s++)
+		{
+			for (int r = bounds[b]; r < bounds[b + 1]; r++)
+			{
+				if (r < nbOfLandmarkPoints)
+				{
+					ConcatenatedPoints.set_row(r - bounds[b], m_LandmarkPointsT[s].get_row(r));
+					ConcatenatedVectors.set_row(r - bounds[b], m_ThetaT[s].get_row(r));
+				}
+				else
+				{
+					// Be careful: if ComputeTrueInverseFlow, vectors m_EtaT[s] are always attached to the fixed points
+					// m_ImagePointsT[0]!
+					const int i = r - nbOfLandmarkPoints;
+					ConcatenatedPoints.set_row(r - bounds[b], m_ComputeTrueInverseFlow ? m_ImagePointsT[0].get_row(i)
+					                                                                   : m_ImagePointsT[s].get_row(i));
+					ConcatenatedVectors.set_row(r - bounds[b], m_EtaT[s].get_row(i));
+				}
+			}
+
+			etaKernelObj->SetSources(ConcatenatedPoints);
+			etaKernelObj->SetWeights(ConcatenatedVectors);
 
-	for (int r = 0; r < nbOfLandmarkPoints; r++)
+			blockXiPosT[b][s] = etaKernelObj->ConvolveGradient(m_PosT[s], m_MomT[s]);
+			blockXiMomT[b][s] = etaKernelObj->Convolve(m_PosT[s]);
+		}
+	};
+
+	if (numberOfBlocks == 1)
+		computeBlock(0, m_KernelObj2);
+	else
 	{
-		ConcatenatedPoints.set_row(r, m_LandmarkPointsT[s].get_row(r));
-		ConcatenatedVectors.set_row(r, m_ThetaT[s].get_row(r));
+		KernelFactoryType* kFactory = KernelFactoryType::Instantiate();
+
+		std::vector<std::future<void>> futures;
+		{
+			ThreadPool pool(numberOfBlocks);
+			for (int b = 0; b < numberOfBlocks; ++b)
+			{
+				std::shared_ptr<KernelType> etaKernelObj = kFactory->CreateKernelObject(m_KernelType);
+				etaKernelObj->SetKernelWidth(m_KernelWidth);
+				futures.push_back(pool.enqueue([&, b, etaKernelObj]() { computeBlock(b, etaKernelObj); }));
+			}
+		}
+		for (auto &f : futures) f.get();
 	}
-	for (int r = 0; r < nbOfImagePoints; r++)
+
+	m_PointsTermOfXiPosT.resize(m_NumberOfTimePoints);
+	m_PointsTermOfXiMomT.resize(m_NumberOfTimePoints);
+	for (unsigned int s = 0; s < m_NumberOfTimePoints; s++)
 	{
-		// Be careful: if ComputeTrueInverseFlow, vectors m_EtaT[s] are always attached to the fixed points m_ImagePointsT[0]!
-		ConcatenatedPoints.set_row(nbOfLandmarkPoints + r, m_ComputeTrueInverseFlow?m_ImagePointsT[0].get_row(r):m_ImagePointsT[s].get_row(r));
-		ConcatenatedVectors.set_row(nbOfLandmarkPoints + r, m_EtaT[s].get_row(r));
+		m_PointsTermOfXiPosT[s] = MatrixType(numCP, Dimension, 0);
+		m_PointsTermOfXiMomT[s] = MatrixType(numCP, Dimension, 0);
+		for (int b = 0; b < numberOfBlocks; ++b)
+		{
+			m_PointsTermOfXiPosT[s] += blockXiPosT[b][s];
+			m_PointsTermOfXiMomT[s] += blockXiMomT[b][s];
+		}
 	}
+}
 
-	etaKernelObj->SetSources(ConcatenatedPoints);
-	etaKernelObj->SetWeights(ConcatenatedVectors);
 
-	MatrixType dXi1 = etaKernelObj->ConvolveGradient(m_PosT[s], m_MomT[s]);
+template <class ScalarType, unsigned int Dimension>
+void
+AdjointEquationsIntegrator<ScalarType, Dimension>
+::ComputeUpdateAt(unsigned int s, MatrixType& dPos, MatrixType &dMom)
+{
+
+	long numCP = m_PosT[0].rows();
+
+	std::shared_ptr<KernelType> momXiPosKernelObj = m_KernelObj1;
+	std::shared_ptr<KernelType> tmpKernelObj = m_KernelObj3;
+
+	// Convolutions of the adjoint variables of landmark and image points (see ComputePointsTermsOfUpdates()).
+	const MatrixType& dXi1 = m_PointsTermOfXiPosT[s];
 
-	MatrixType dXi2 = etaKernelObj->Convolve(m_PosT[s]);
+	const MatrixType& dXi2 = m_PointsTermOfXiMomT[s];
 
 	MatrixType AXiPos(numCP, Dimension*2, 0);
 	AXiPos.set_columns(0, m_MomT[s]);
@@ -17,6 +17,7 @@
 #include "GridFunctions.h"
 
 /// Libraries files.
+#include <algorithm>
 #include <vector>
 #include "itkImage.h"
 #include "itkVector.h"
@@ -147,6 +148,10 @@ public:
 	void UnsetComputeTrueInverseFlow() { m_ComputeTrueInverseFlow = false; }
 
 
+	/// Sets the number of blocks of landmark and image points processed concurrently (see m_NumberOfPointBlocks).
+	void SetNumberOfPointBlocks(unsigned int n) { m_NumberOfPointBlocks = std::max(1u, n); }
+
+
 	/// Returns the value of the adjoint variable of control points at time t = \e q.
 	MatrixType GetAdjointPosAt(long q) const { return m_XiPosT[q]; }
 
@@ -184,12 +189,19 @@ protected:
 	
 	/// TODO .
 	void IntegrateAdjointOfLandmarkPointsEquations();
+	/// Integrates backward the adjoint variable \e thetaT of the landmark points of trajectories \e pointsT, from the
+	/// initial conditions \e initialConditions (the rows of the three lists correspond to the same points).
+	void IntegrateAdjointOfLandmarkPoints(const MatrixListType& pointsT, const MatrixListType& initialConditions,
+			MatrixListType& thetaT) const;
 	/// TODO .
 	void IntegrateAdjointOfImagePointsBackward();
 	/// TODO .
 	void IntegrateAdjointOfImagePointsForward();
 	/// TODO .
 	void IntegrateAdjointOfDiffeoParametersEquations();
+	/// Computes, at every time, the convolutions of the adjoint variables of the landmark and image points which enter
+	/// the time derivatives of the adjoint variables of control points and momentas (see ComputeUpdateAt()).
+	void ComputePointsTermsOfUpdates();
 
 
 	////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -226,6 +238,11 @@ protected:
   	///Boolean which indicates if we use fast convolutions for the image backward.
 	bool m_UseFastConvolutions;
 
+	/// Number of blocks of landmark and image points processed concurrently (1 : sequential integration). The
+	/// adjoint variables of the points do not depend on each other, and contribute additively to the ones of the
+	/// control points and momentas.
+	unsigned int m_NumberOfPointBlocks;
+
 	/// true if Landmark points are set
 	bool m_IsLandmarkPoints;
 	/// true if Image points are set
@@ -265,6 +282,13 @@ protected:
 	/// Adjoint variable of image points.
 	MatrixListType m_EtaT;
 
+	/// Contributions of the adjoint variables of the points to the time derivative of the adjoint variable of control
+	/// points, at every time.
+	MatrixListType m_PointsTermOfXiPosT;
+	/// Contributions of the adjoint variables of the points to the time derivative of the adjoint variable of
+	/// momentum vectors, at every time.
+	MatrixListType m_PointsTermOfXiMomT;
+
 	/// \cond HIDE_FOR_DOXYGEN
 
 	std::shared_ptr<KernelType> m_KernelObj1;
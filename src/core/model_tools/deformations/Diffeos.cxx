@@ -11,6 +11,14 @@
 #include <itkDerivativeImageFilter.h>
 #include "Diffeos.h"
 
+#include "GeneralSettings.h"
+#include "KernelMatrixCache.h"
+#include "Profiler.h"
+#include <lib/ThreadPool/ThreadPool.h>
+
+#include <algorithm>
+#include <future>
+
 /// For bug-tracking.
 #include "MatrixDLM.h"
 
@@ -25,7 +33,9 @@ template<class ScalarType, unsigned int Dimension>
 Diffeos<ScalarType, Dimension>
 ::Diffeos() : Superclass(), m_T0(0.0), m_TN(1.0), m_NumberOfTimePoints(10), m_KernelType(null),
               m_KernelWidth(1.0), m_UseImprovedEuler(true), m_PaddingFactor(0.0), m_OutOfBox(true),
-              m_ComputeTrueInverseFlow(false), m_UseImplicitEuler(false), m_RegressionFlag(false), m_UseFastConvolutions(false) {
+              m_ComputeTrueInverseFlow(false), m_UseImplicitEuler(false), m_RegressionFlag(false),
+              m_UseFastConvolutions(false), m_FrozenStartPositions(false), m_NumberOfTimeSlices(1),
+              m_NumberOfPointBlocks(1), m_PararealTolerance(1e-6) {
   this->SetDiffeosType();
 }
 
@@ -42,6 +52,8 @@ Diffeos<ScalarType, Dimension>
 
   m_PositionsT = other.m_PositionsT;
   m_MomentasT = other.m_MomentasT;
+  m_KernelCholeskyCache = other.m_KernelCholeskyCache;
+  m_DeformedObjectCache = other.m_DeformedObjectCache;
 
   m_KernelType = other.m_KernelType;
   m_KernelWidth = other.m_KernelWidth;
@@ -66,6 +78,10 @@ Diffeos<ScalarType, Dimension>
   m_AdjointLandmarkPointsAt0 = other.m_AdjointLandmarkPointsAt0;
 
   m_UseFastConvolutions = other.m_UseFastConvolutions;
+  m_FrozenStartPositions = other.m_FrozenStartPositions;
+  m_NumberOfTimeSlices = other.m_NumberOfTimeSlices;
+  m_NumberOfPointBlocks = other.m_NumberOfPointBlocks;
+  m_PararealTolerance = other.m_PararealTolerance;
 }
 
 template<class ScalarType, unsigned int Dimension>
@@ -137,6 +153,7 @@ Diffeos<ScalarType, Dimension>
     if (Superclass::m_DeformableObjectModified) {
       if (Superclass::m_IsLandmarkPoints) { FlowLandmarkPointsTrajectory(); }
       if (Superclass::m_IsImagePoints) { FlowImagePointsTrajectory(); }
+      m_DeformedObjectCache = std::make_shared<DeformedObjectCache>(m_NumberOfTimePoints);
       Superclass::m_DeformableObjectModified = false;
     }
 
@@ -148,6 +165,7 @@ Diffeos<ScalarType, Dimension>
       m_PositionsT[0] = m_StartPositions;
       m_MomentasT.resize(1);
       m_MomentasT[0] = m_StartMomentas;
+      m_KernelCholeskyCache = std::make_shared<KernelCholeskyCache>(1);
       Superclass::UnsetModified();
       Superclass::m_DeformableObjectModified = true;
     }
@@ -163,6 +181,7 @@ Diffeos<ScalarType, Dimension>
         m_MapsT[0] = Superclass::m_ImagePoints;
         m_InverseMapsT[0] = Superclass::m_ImagePoints;
       }
+      m_DeformedObjectCache = std::make_shared<DeformedObjectCache>(1);
       Superclass::m_DeformableObjectModified = false;
     }
   }
@@ -222,6 +241,20 @@ Diffeos<ScalarType, Dimension>
   return deformedObjects;
 }
 
+template<class ScalarType, unsigned int Dimension>
+std::shared_ptr<typename Diffeos<ScalarType, Dimension>::DeformableMultiObjectType>
+Diffeos<ScalarType, Dimension>
+::GetSharedDeformedObjectAt(unsigned int t) const {
+  const std::shared_ptr<DeformedObjectCache> cache = m_DeformedObjectCache;
+  if (!cache || t >= cache->objects.size() || this->IsModified() || Superclass::m_DeformableObjectModified)
+    throw std::runtime_error(
+        "In Diffeos::GetSharedDeformedObjectAt() - The Diffeos was not updated or the objects not deformed");
+
+  /// Concurrent requests of the same time wait for a single deformation of the objects.
+  std::call_once(cache->once[t], [&]() { cache->objects[t] = GetDeformedObjectAt(t); });
+  return cache->objects[t];
+}
+
 template<class ScalarType, unsigned int Dimension>
 MatrixType
 Diffeos<ScalarType, Dimension>
@@ -298,10 +331,28 @@ Diffeos<ScalarType, Dimension>
                     ScalarType const &initialTime,
                     std::vector<ScalarType> const &targetTimes,
                     MatrixListType &velocities) {
+  std::vector<MatrixListType> batchVelocities;
+  const std::vector<MatrixListType> out = ParallelTransport(
+      std::vector<MatrixType>(1, initialMomenta), initialControlPoints, initialTime, targetTimes, batchVelocities);
+  if (batchVelocities[0].size()) { velocities = batchVelocities[0]; }
+  return out[0];
+}
+
+template<class ScalarType, unsigned int Dimension>
+std::vector<MatrixListType>
+Diffeos<ScalarType, Dimension>
+::ParallelTransport(std::vector<MatrixType> const &initialMomentas,
+                    MatrixType const &initialControlPoints,
+                    ScalarType const &initialTime,
+                    std::vector<ScalarType> const &targetTimes,
+                    std::vector<MatrixListType> &velocities) {
+  DEF_PROFILE_SCOPE_SIZE("Diffeos::ParallelTransport", initialMomentas.size());
   /*
-   * t0 is the starting point index, initialVelocity is the velocity of the vector to be transported from this time point
-   * t1 is the final point, and we fill velocities with the values of the transported velocities at the different time points.
-   * We also return the values of the parallel-transported momentas, attached to the control points of the diffeo.
+   * initialTime is the starting time, initialMomentas are the momenta (attached to initialControlPoints) of the vectors
+   * to be transported from this time point. We return the parallel-transported momentas, attached to the control
+   * points of the diffeo, at the target times, and fill velocities with the transported velocities at these times.
+   * All the vectors are transported at once : the velocities of the S vectors are stored side by side in
+   * N x (S * Dimension) matrices, so that each kernel operation along the geodesic is shared by all the vectors.
    */
 
   /// Verbose option.
@@ -312,17 +363,25 @@ Diffeos<ScalarType, Dimension>
   ///    2) Nearly zero initial tangent vector.
   ///    3) No target time.
   ///    4) Weird number of time points.
+  const unsigned int nbVectors = initialMomentas.size();
   const unsigned int nbTargetTimes = targetTimes.size();
+
+  std::vector<MatrixListType> out(nbVectors, MatrixListType(nbTargetTimes));
+  for (unsigned int s = 0; s < nbVectors; ++s) {
+    for (unsigned int t = 0; t < nbTargetTimes; ++t) { out[s][t] = initialMomentas[s]; }
+  }
+  velocities.assign(nbVectors, MatrixListType());
+
+  std::vector<unsigned int> moving;
+  for (unsigned int s = 0; s < nbVectors; ++s) {
+    if (initialMomentas[s].sum_of_squares() >= 1e-20) { moving.push_back(s); }
+  }
+
   if (m_StartMomentas.sum_of_squares() < 1e-20 ||
-      initialMomenta.sum_of_squares() < 1e-20 ||
+      moving.empty() ||
       nbTargetTimes == 0 ||
       m_NumberOfTimePoints <= 1) {
     if (verbose) { std::cout << "No motion detected when computing the parallel transport." << std::endl; }
-
-    MatrixListType out(nbTargetTimes);
-    for (unsigned int t = 0; t < nbTargetTimes; ++t) {
-      out[t] = initialMomenta;
-    }
     return out;
   }
 
@@ -356,240 +415,336 @@ Diffeos<ScalarType, Dimension>
   ///    5) Nearly zero transport length.
   if (finalIndex == initialIndex) {
     if (verbose) { std::cout << "No motion detected when computing the parallel transport." << std::endl; }
-
-    MatrixListType out(nbTargetTimes);
-    for (unsigned int t = 0; t < nbTargetTimes; ++t) {
-      out[t] = initialMomenta;
-    }
     return out;
   }
 
   /// Some optional printing.
+  const unsigned int nbMoving = moving.size();
   if (verbose) {
+    std::cout << "Number of transported vectors : " << nbMoving << "." << std::endl;
     std::cout << "Number of control points in the matching : " << initialControlPoints.rows() << "." << std::endl;
     std::cout << "Number of control points in the regression : " << m_StartPositions.rows() << "." << std::endl;
     std::cout << "epsilon : " << epsilon << std::endl;
   }
 
   /// Miscellaneous initializations.
+  const unsigned int numCP = this->m_StartPositions.rows();
   KernelFactoryType *kFactory = KernelFactoryType::Instantiate();
   std::shared_ptr<KernelType> kernelObj = kFactory->CreateKernelObject(GetKernelType());
   kernelObj->SetKernelWidth(GetKernelWidth());
-  MatrixType initialVelocity;
+
+  /// The Runge-Kutta midpoints differ from one vector to the other : one kernel object per vector.
+  std::vector<std::shared_ptr<KernelType>> midpointKernels(nbMoving);
+  for (unsigned int s = 0; s < nbMoving; ++s) {
+    midpointKernels[s] = kFactory->CreateKernelObject(GetKernelType());
+    midpointKernels[s]->SetKernelWidth(GetKernelWidth());
+  }
+
+  std::vector<MatrixType> movingMomentas(nbMoving);
+  for (unsigned int s = 0; s < nbMoving; ++s) { movingMomentas[s] = initialMomentas[moving[s]]; }
   kernelObj->SetSources(initialControlPoints);
-  kernelObj->SetWeights(initialMomenta);
-  initialVelocity = kernelObj->Convolve(m_PositionsT[0]);
-  unsigned int numCP = this->m_StartPositions.rows();
+  kernelObj->SetWeights(ConcatenateVectors(movingMomentas));
 
   this->InitBoundingBox();
-  MatrixType convolvKInv;
-  MatrixType dPos;
-  MatrixListType kGradMom;
-  MatrixType CP_epsi1(numCP, Dimension, 0.); // first part of RK2
-  MatrixType CP_epsi2(numCP, Dimension, 0.); // second part of RK2
-  MatrixType MOM_epsi1; // first part of RK2 for the momenta, needed to compute CP_epsi1
-  VectorType mom_eps_pos_temp;
-  VectorType mom_eps_neg_temp;
-  MatrixType mom_eps_pos(numCP, Dimension, 0.);
-  MatrixType mom_eps_neg(numCP, Dimension, 0.);
-  MatrixType dmom_eps_pos(numCP, Dimension, 0.);
-  MatrixType dmom_eps_neg(numCP, Dimension, 0.);
-  MatrixType dPos2;
-
   MatrixListType velocities_allSteps(numberOfSteps);
-  for (unsigned int t = 0; t < numberOfSteps; ++t) { velocities_allSteps[t] = initialVelocity; }
+  velocities_allSteps[0] = kernelObj->Convolve(m_PositionsT[0]);
   MatrixListType parallelTransport(numberOfSteps);
 
-  /// These quantities should be conserved during the transport.
-  ScalarType initialScalarProductWV(0.);
-  ScalarType initialSquaredNormW(0.);
-  ScalarType scalarProductWV(0.);
-  ScalarType squaredNormW(0.);
+  /// These quantities should be conserved during the transport, for each vector.
+  std::vector<ScalarType> initialScalarProductWV(nbMoving, 0.), initialSquaredNormW(nbMoving, 0.);
+  std::vector<ScalarType> scalarProductWV(nbMoving, 0.), squaredNormW(nbMoving, 0.);
+  std::vector<ScalarType> alpha(nbMoving, 1.), beta(nbMoving, 0.);
   ScalarType squaredNormV(0.);
-  MatrixType toComputeConservedQuantities;
-  ScalarType alpha(1.), beta(0.);
-
-  /// Here we compute the initial values of the conserved quantities for comparisons.
-  kernelObj->SetSources(m_PositionsT[initialIndex]);
-  kernelObj->SetWeights(m_MomentasT[initialIndex]);
-  toComputeConservedQuantities = kernelObj->Convolve(initialControlPoints);
-  for (unsigned int i = 0; i < initialMomenta.rows(); ++i)
-    scalarProductWV += dot_product(initialMomenta.get_row(i), toComputeConservedQuantities.get_row(i));
-  if (verbose) { std::cout << "Initial scalar product with velocities :" << scalarProductWV << std::endl; }
 
-  kernelObj->SetSources(initialControlPoints);
-  kernelObj->SetWeights(initialMomenta);
-  toComputeConservedQuantities = kernelObj->Convolve(initialControlPoints);
-  for (unsigned int i = 0; i < initialMomenta.rows(); ++i)
-    squaredNormW += dot_product(initialMomenta.get_row(i), toComputeConservedQuantities.get_row(i));
-  if (verbose) { std::cout << "Initial squared norm of w :" << squaredNormW << std::endl; }
+  ThreadPool pool(nbMoving > 1 ? def::utils::settings.number_of_threads : 1);
 
   /// Main loop
   unsigned int index = 0;
   for (unsigned int t = initialIndex; t < finalIndex; ++t, ++index) {
     if (verbose) { std::cout << "Time step : " << t << std::endl; }
-    kernelObj->SetSources(m_PositionsT[t]);
-    kernelObj->SetWeights(m_MomentasT[t]);
-    MatrixListType CP_epsiList;
-    CP_epsiList.resize(2);
-    dPos = kernelObj->Convolve(m_PositionsT[t]);
+    const MatrixType &positions = m_PositionsT[t];
+    const MatrixType &momentas = m_MomentasT[t];
 
-    /// This will be used to get the momenta best describing the velocities field on the control points of the diffeo.
-    convolvKInv = kernelObj->ConvolveInverse(velocities_allSteps[index]);
-
-    /// If it's the first iteration, we compute the initial scalar products and norm, to later ensure conservations.
-    if (t == initialIndex) {
-      kernelObj->SetSources(m_PositionsT[t]);
-      kernelObj->SetWeights(m_MomentasT[t]);
-      toComputeConservedQuantities = kernelObj->Convolve(m_PositionsT[t]);
-      for (unsigned int i = 0; i < numCP; ++i) {
-        initialScalarProductWV += dot_product(convolvKInv.get_row(i), toComputeConservedQuantities.get_row(i));
-      }
+    kernelObj->SetSources(positions);
+    kernelObj->SetWeights(momentas);
+    const MatrixType dPos = kernelObj->Convolve(positions);
 
-      if (verbose) {
-        std::cout << "Initial scalar product of proposal with velocities after projection : "
-                  << initialScalarProductWV << std::endl;
-      }
-
-      kernelObj->SetWeights(convolvKInv);
-      toComputeConservedQuantities = kernelObj->Convolve(m_PositionsT[t]);
-      for (unsigned int i = 0; i < numCP; ++i) {
-        initialSquaredNormW += dot_product(convolvKInv.get_row(i), toComputeConservedQuantities.get_row(i));
+    /// This will be used to get the momenta best describing the velocities field on the control points of the diffeo.
+    const MatrixType convolvKInv = ConvolveInverseAt(t, velocities_allSteps[index]);
+    kernelObj->SetWeights(convolvKInv);
+    const MatrixType kConvolvKInv = kernelObj->Convolve(positions);
+
+    for (unsigned int s = 0; s < nbMoving; ++s) {
+      const MatrixType w = ExtractVector(convolvKInv, s);
+      const MatrixType kw = ExtractVector(kConvolvKInv, s);
+
+      /// If it's the first iteration, we compute the initial scalar products and norm, to later ensure conservations.
+      if (t == initialIndex) {
+        initialScalarProductWV[s] = dot_product(w, dPos);
+        initialSquaredNormW[s] = dot_product(w, kw);
+        if (verbose) {
+          std::cout << "Initial scalar product of proposal with velocities after projection : "
+                    << initialScalarProductWV[s] << std::endl;
+          std::cout << "Inital squared norm of w after projection : " << initialSquaredNormW[s] << std::endl;
+        }
       }
 
-      if (verbose) { std::cout << "Inital squared norm of w after projection : " << initialSquaredNormW << std::endl; }
-    }
+      /// We check the two conservations before updating !
+      if (t > initialIndex) {
+        const ScalarType proposalNormSquared = dot_product(w, kw);
+        const ScalarType proposalScalarProductVelocity = dot_product(momentas, kw);
+        if (verbose) {
+          std::cout << "Squared norm of proposal w : " << proposalNormSquared << std::endl;
+          std::cout << "Scalar product of proposal with velocities : " << proposalScalarProductVelocity << std::endl;
+        }
 
-    /// We check the two conservations before updating !
-    if (t > initialIndex) {
-      ScalarType proposalNormSquared(0.), proposalScalarProductVelocity(0.);
-      kernelObj->SetSources(m_PositionsT[t]);
-      kernelObj->SetWeights(convolvKInv);
-      toComputeConservedQuantities = kernelObj->Convolve(m_PositionsT[t]);
-      for (unsigned int i = 0; i < numCP; ++i) {
-        proposalNormSquared += dot_product(convolvKInv.get_row(i), toComputeConservedQuantities.get_row(i));
+        alpha[s] = std::sqrt((initialSquaredNormW[s] * squaredNormV - initialScalarProductWV[s] * scalarProductWV[s])
+                                 / (proposalNormSquared * squaredNormV
+                                     - proposalScalarProductVelocity * proposalScalarProductVelocity));
+        beta[s] = (initialScalarProductWV[s] - alpha[s] * proposalScalarProductVelocity) / squaredNormV;
       }
-      if (verbose) { std::cout << "Squared norm of proposal w : " << proposalNormSquared << std::endl; }
-      for (unsigned int i = 0; i < numCP; ++i) {
-        proposalScalarProductVelocity +=
-            dot_product(m_MomentasT.at(t).get_row(i), toComputeConservedQuantities.get_row(i));
+      if (std::abs(alpha[s] - 1.) > 0.1) {
+        std::cout << ">> Warning : large alpha required to enforce the conservations. "
+            "Consider decreasing the size of the steps in the scheme. (alpha = " << alpha[s] << ")" << std::endl;
       }
-
       if (verbose) {
-        std::cout << "Scalar product of proposal with velocities : " << proposalScalarProductVelocity << std::endl;
+        std::cout << "Enforcing conservation with alpha :" << alpha[s] << " and beta :" << beta[s] << std::endl;
       }
-
-      alpha = std::sqrt((initialSquaredNormW * squaredNormV - initialScalarProductWV * scalarProductWV)
-                            / (proposalNormSquared * squaredNormV
-                                - proposalScalarProductVelocity * proposalScalarProductVelocity));
-      beta = (initialScalarProductWV - alpha * proposalScalarProductVelocity) / squaredNormV;
-    }
-    if (std::abs(alpha - 1.) > 0.1) {
-      std::cout << ">> Warning : large alpha required to enforce the conservations. "
-          "Consider decreasing the size of the steps in the scheme. (alpha = " << alpha << ")" << std::endl;
     }
 
-    if (verbose) { std::cout << "Enforcing conservation with alpha :" << alpha << " and beta :" << beta << std::endl; }
-    parallelTransport[index] = alpha * convolvKInv + beta * m_MomentasT.at(t);
+    parallelTransport[index] = MatrixType(numCP, nbMoving * Dimension, 0.);
+    for (unsigned int s = 0; s < nbMoving; ++s) {
+      InsertVector(parallelTransport[index], s, alpha[s] * ExtractVector(convolvKInv, s) + beta[s] * momentas);
+    }
 
     /// Here we can update our values for the conserved quantities :
     kernelObj->SetWeights(parallelTransport[index]);
-    toComputeConservedQuantities = kernelObj->Convolve(m_PositionsT[t]);
-    scalarProductWV = 0;
-    squaredNormW = 0;
-    squaredNormV = 0;
-    for (unsigned int i = 0; i < numCP; ++i) {
-      scalarProductWV += dot_product(m_MomentasT.at(t).get_row(i), toComputeConservedQuantities.get_row(i));
-    }
-    if (verbose) { std::cout << "Scalar product with velocities : " << scalarProductWV << std::endl; }
-    for (unsigned int i = 0; i < numCP; ++i) {
-      squaredNormW += dot_product(convolvKInv.get_row(i), toComputeConservedQuantities.get_row(i));
-    }
-    if (verbose) { std::cout << "Squared norm of w : " << squaredNormW << std::endl; }
-
-    kernelObj->SetWeights(m_MomentasT[t]);
-    kernelObj->SetSources(m_PositionsT[t]);
-    toComputeConservedQuantities = kernelObj->Convolve(m_PositionsT[t]);
-    for (unsigned int i = 0; i < numCP; ++i) {
-      squaredNormV += dot_product(m_MomentasT.at(t).get_row(i), toComputeConservedQuantities.get_row(i));
+    const MatrixType kParallelTransport = kernelObj->Convolve(positions);
+    for (unsigned int s = 0; s < nbMoving; ++s) {
+      const MatrixType kp = ExtractVector(kParallelTransport, s);
+      scalarProductWV[s] = dot_product(momentas, kp);
+      squaredNormW[s] = dot_product(ExtractVector(convolvKInv, s), kp);
+      if (verbose) {
+        std::cout << "Scalar product with velocities : " << scalarProductWV[s] << std::endl;
+        std::cout << "Squared norm of w : " << squaredNormW[s] << std::endl;
+      }
     }
-//        std::cout << "Squared norm of v : " << squaredNormV << std::endl;
-
-    /// Computation of the pertubated momentum vector:
-    for (unsigned int i = 0; i < numCP; i++) {
-      mom_eps_pos_temp = m_MomentasT[t].get_row(i) + epsilon * convolvKInv.get_row(i);
-      mom_eps_pos.set_row(i, mom_eps_pos_temp);
-
-      mom_eps_neg_temp = m_MomentasT[t].get_row(i) - epsilon * convolvKInv.get_row(i);
-      mom_eps_neg.set_row(i, (mom_eps_neg_temp));
+    squaredNormV = dot_product(momentas, dPos);
+
+    /// Computation of the pertubated momentum vectors.
+    MatrixType mom_eps_pos(numCP, nbMoving * Dimension, 0.);
+    MatrixType mom_eps_neg(numCP, nbMoving * Dimension, 0.);
+    for (unsigned int s = 0; s < nbMoving; ++s) {
+      InsertVector(mom_eps_pos, s, momentas + epsilon * ExtractVector(convolvKInv, s));
+      InsertVector(mom_eps_neg, s, momentas - epsilon * ExtractVector(convolvKInv, s));
     }
 
     /// We compute the hamiltonian equations with these perturbed momenta.
-    kernelObj->SetWeights(mom_eps_pos);
-    kGradMom = kernelObj->ConvolveGradient(m_PositionsT[t]);
-    for (unsigned int i = 0; i < numCP; i++) {
-      dmom_eps_pos.set_row(i, kGradMom[i].transpose() * mom_eps_pos.get_row(i));
-    }
-
-    kernelObj->SetWeights(mom_eps_neg);
-    kGradMom = kernelObj->ConvolveGradient(m_PositionsT[t]);
-    for (unsigned int i = 0; i < numCP; i++) {
-      dmom_eps_neg.set_row(i, kGradMom[i].transpose() * mom_eps_neg.get_row(i));
+    const MatrixType dmom_eps_pos = ComputeMomentaDerivatives(kernelObj, positions, mom_eps_pos);
+    const MatrixType dmom_eps_neg = ComputeMomentaDerivatives(kernelObj, positions, mom_eps_neg);
+
+    /// Runge Kutta 2, whose midpoints differ from one vector to the other.
+    MatrixType nextVelocities(numCP, nbMoving * Dimension, 0.);
+    const MatrixType &currentVelocities = velocities_allSteps[index];
+    const double div = 1 / (2 * epsilon);
+    std::vector<std::future<void>> tasks;
+    for (unsigned int s = 0; s < nbMoving; ++s) {
+      tasks.push_back(pool.enqueue([&, s]() {
+        const std::shared_ptr<KernelType> &kernel = midpointKernels[s];
+        const MatrixType v = ExtractVector(currentVelocities, s);
+
+        /// Computation of the middle point, computed for + epsilon.
+        MatrixType CP_epsi1 = positions + h / 2 * (dPos + epsilon * v);
+        kernel->SetSources(CP_epsi1);
+        kernel->SetWeights(ExtractVector(mom_eps_pos, s) - h / 2 * ExtractVector(dmom_eps_pos, s)); //TODO : check this !
+        const MatrixType CP_epsi_pos = (positions + h * kernel->Convolve(CP_epsi1)) * div;
+
+        /// Computation of the middle point, computed for - epsilon.
+        CP_epsi1 = positions + h / 2 * (dPos - epsilon * v);
+        kernel->SetSources(CP_epsi1);
+        kernel->SetWeights(ExtractVector(mom_eps_neg, s) - h / 2 * ExtractVector(dmom_eps_neg, s));
+        const MatrixType CP_epsi_neg = (positions + h * kernel->Convolve(CP_epsi1)) * div;
+
+        /// Update the transport accordingly, in the tangent space (each task writes its own columns).
+        InsertVector(nextVelocities, s, (CP_epsi_pos - CP_epsi_neg) / epsilon);
+      }));
     }
-
-    /// Runge Kutta 2: computation of the middle point, computed for + epsilon.
-    CP_epsi1 = m_PositionsT[t] + h / 2 * (dPos + epsilon * velocities_allSteps[index]);
-    MOM_epsi1 = mom_eps_pos - h / 2 * (dmom_eps_pos); //TODO : check this !
-    kernelObj->SetSources(CP_epsi1);
-    kernelObj->SetWeights(MOM_epsi1);
-    dPos2 = kernelObj->Convolve(CP_epsi1);
-    CP_epsi2 = m_PositionsT[t] + h * dPos2;
-    double div = 1 / (2 * epsilon);
-    CP_epsiList[0] = CP_epsi2 * div;
-
-    /// Runge Kutta 2: computation of the middle point, computed for - epsilon.
-    CP_epsi1 = m_PositionsT[t] + h / 2 * (dPos - epsilon * velocities_allSteps[index]);
-    MOM_epsi1 = mom_eps_neg - h / 2 * (dmom_eps_neg);
-    kernelObj->SetSources(CP_epsi1);
-    kernelObj->SetWeights(MOM_epsi1);
-    dPos2 = kernelObj->Convolve(CP_epsi1);
-    CP_epsi2 = m_PositionsT[t] + h * dPos2;
-    CP_epsiList[1] = CP_epsi2 * div;
-
-    /// Update the transport accordingly, in the tangent space.
-    velocities_allSteps[index + 1] = (CP_epsiList[0] - CP_epsiList[1]) / epsilon;
+    for (auto &task : tasks) task.wait();
+    for (auto &task : tasks) task.get();
+    velocities_allSteps[index + 1] = nextVelocities;
   }
 
   /// Last iteration (without conservation : TODO ?).
-  kernelObj->SetSources(m_PositionsT[finalIndex - 1]);
-  kernelObj->SetWeights(m_MomentasT[finalIndex - 1]);
   assert(index == numberOfSteps - 1);
-  convolvKInv = kernelObj->ConvolveInverse(velocities_allSteps[index]);
-  parallelTransport[index] = convolvKInv;
+  parallelTransport[index] = ConvolveInverseAt(finalIndex - 1, velocities_allSteps[index]);
 
   /// Final outputs, only at required times.
-  velocities.resize(nbTargetTimes);
-  MatrixListType out(nbTargetTimes);
+  for (unsigned int s = 0; s < nbMoving; ++s) { velocities[moving[s]] = MatrixListType(nbTargetTimes); }
   unsigned int outIndex = 0;
   for (unsigned int t = initialIndex; t < finalIndex + 1; ++t) {
-    if (t == targetIndices[outIndex]) {
-      velocities[outIndex] = velocities_allSteps[t];
-      out[outIndex] = parallelTransport[t];
-      ++outIndex;
+    for (; outIndex < nbTargetTimes && targetIndices[outIndex] == t; ++outIndex) {
+      for (unsigned int s = 0; s < nbMoving; ++s) {
+        velocities[moving[s]][outIndex] = ExtractVector(velocities_allSteps[t - initialIndex], s);
+        out[moving[s]][outIndex] = ExtractVector(parallelTransport[t - initialIndex], s);
+      }
     }
   }
   return out;
 }
 
+template<class ScalarType, unsigned int Dimension>
+std::vector<MatrixListType>
+Diffeos<ScalarType, Dimension>
+::ParallelTransport(std::shared_ptr<Diffeos> backwardGeodesic,
+                    std::shared_ptr<Diffeos> forwardGeodesic,
+                    std::vector<MatrixType> const &initialMomentas,
+                    std::vector<std::vector<ScalarType>> const &timeIncrements) {
+  const unsigned int nbVectors = initialMomentas.size();
+  assert(timeIncrements.size() == nbVectors);
+
+  /// Union of the target times on each side, the backward ones being counted positively.
+  std::vector<ScalarType> backwardTimes, forwardTimes;
+  for (unsigned int s = 0; s < nbVectors; ++s) {
+    for (ScalarType const &dt : timeIncrements[s]) {
+      if (dt < 0.0) { backwardTimes.push_back(-dt); }
+      else { forwardTimes.push_back(dt); }
+    }
+  }
+  for (std::vector<ScalarType> *times : {&backwardTimes, &forwardTimes}) {
+    std::sort(times->begin(), times->end());
+    times->erase(std::unique(times->begin(), times->end()), times->end());
+  }
+
+  /// Transport of all the vectors along each side, in one sweep.
+  std::vector<MatrixListType> backwardTransport, forwardTransport;
+  if (backwardTimes.size()) { backwardTransport = backwardGeodesic->ParallelTransport(initialMomentas, backwardTimes); }
+  if (forwardTimes.size()) { forwardTransport = forwardGeodesic->ParallelTransport(initialMomentas, forwardTimes); }
+
+  /// Dispatch of the results, in the order of the time increments.
+  std::vector<MatrixListType> out(nbVectors);
+  for (unsigned int s = 0; s < nbVectors; ++s) {
+    out[s] = MatrixListType(timeIncrements[s].size());
+    for (unsigned int k = 0; k < timeIncrements[s].size(); ++k) {
+      const ScalarType dt = timeIncrements[s][k];
+      const std::vector<ScalarType> &times = (dt < 0.0) ? backwardTimes : forwardTimes;
+      const std::size_t position = std::lower_bound(times.begin(), times.end(), std::abs(dt)) - times.begin();
+      out[s][k] = (dt < 0.0) ? backwardTransport[s][position] : forwardTransport[s][position];
+    }
+  }
+  return out;
+}
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 // Method(s) :
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
+template<class ScalarType, unsigned int Dimension>
+MatrixType
+Diffeos<ScalarType, Dimension>
+::ConcatenateVectors(std::vector<MatrixType> const &vectors) {
+  const unsigned int nbVectors = vectors.size();
+  MatrixType out(nbVectors ? vectors[0].rows() : 0, nbVectors * Dimension, 0.);
+  for (unsigned int s = 0; s < nbVectors; ++s) { InsertVector(out, s, vectors[s]); }
+  return out;
+}
+
+template<class ScalarType, unsigned int Dimension>
+MatrixType
+Diffeos<ScalarType, Dimension>
+::ExtractVector(MatrixType const &concatenated, unsigned int s) {
+  MatrixType out(concatenated.rows(), Dimension);
+  for (unsigned int d = 0; d < Dimension; ++d) { out.set_column(d, concatenated.get_column(s * Dimension + d)); }
+  return out;
+}
+
+template<class ScalarType, unsigned int Dimension>
+void
+Diffeos<ScalarType, Dimension>
+::InsertVector(MatrixType &concatenated, unsigned int s, MatrixType const &vector) {
+  for (unsigned int d = 0; d < Dimension; ++d) { concatenated.set_column(s * Dimension + d, vector.get_column(d)); }
+}
+
+template<class ScalarType, unsigned int Dimension>
+MatrixType
+Diffeos<ScalarType, Dimension>
+::ComputeMomentaDerivatives(std::shared_ptr<KernelType> kernel,
+                            MatrixType const &positions,
+                            MatrixType const &momentas) {
+  kernel->SetSources(positions);
+  kernel->SetWeights(momentas);
+  const std::vector<MatrixType> kGradMom = kernel->ConvolveGradient(positions);
+
+  /// For each vector, the rows are the products of the transposed kernel gradients with its momenta.
+  const unsigned int nbVectors = momentas.cols() / Dimension;
+  MatrixType out(momentas.rows(), momentas.cols(), 0.);
+  for (unsigned int i = 0; i < momentas.rows(); ++i) {
+    for (unsigned int s = 0; s < nbVectors; ++s) {
+      for (unsigned int l = 0; l < Dimension; ++l) {
+        ScalarType value = 0.;
+        for (unsigned int k = 0; k < Dimension; ++k) {
+          value += kGradMom[i](s * Dimension + k, l) * momentas(i, s * Dimension + k);
+        }
+        out(i, s * Dimension + l) = value;
+      }
+    }
+  }
+  return out;
+}
+
+template<class ScalarType, unsigned int Dimension>
+MatrixType
+Diffeos<ScalarType, Dimension>
+::ConvolveInverseAt(unsigned int t, MatrixType const &X) {
+  return solve_cholesky(*GetKernelCholeskyAt(t), X);
+}
+
+template<class ScalarType, unsigned int Dimension>
+std::shared_ptr<const MatrixType>
+Diffeos<ScalarType, Dimension>
+::GetKernelCholeskyAt(unsigned int t) {
+  const std::shared_ptr<KernelCholeskyCache> cache = m_KernelCholeskyCache;
+  if (!cache || t >= cache->factors.size())
+    throw std::runtime_error("The trajectory must be computed before its kernel matrices in Diffeos");
+  {
+    std::lock_guard<std::mutex> lock(cache->mutex);
+    if (cache->factors[t]) return cache->factors[t];
+  }
+
+  /// The factor of the frozen control points is kept with their kernel matrix, from one shooting to the next.
+  const std::shared_ptr<const KernelMatrixType> startKernelMatrix = (t == 0) ? GetStartKernelMatrix() : nullptr;
+  if (startKernelMatrix) {
+    const std::shared_ptr<const MatrixType> factor = startKernelMatrix->GetCholeskyFactor();
+    std::lock_guard<std::mutex> lock(cache->mutex);
+    if (!cache->factors[t]) cache->factors[t] = factor;
+    return cache->factors[t];
+  }
+
+  /// The factorization runs unlocked, so that different time indices may be factorized concurrently. Nearly
+  /// coincident control points make the kernel matrix singular: it is then regularized with a diagonal jitter.
+  KernelFactoryType *kFactory = KernelFactoryType::Instantiate();
+  std::shared_ptr<KernelType> kernelObj = kFactory->CreateKernelObject(GetKernelType());
+  kernelObj->SetKernelWidth(GetKernelWidth());
+  const std::shared_ptr<const MatrixType> factor
+      = std::make_shared<const MatrixType>(chol_regularized(kernelObj->ComputeKernelMatrix(m_PositionsT[t])));
+
+  std::lock_guard<std::mutex> lock(cache->mutex);
+  if (!cache->factors[t]) cache->factors[t] = factor;
+  return cache->factors[t];
+}
+
+template<class ScalarType, unsigned int Dimension>
+std::shared_ptr<const typename Diffeos<ScalarType, Dimension>::KernelMatrixType>
+Diffeos<ScalarType, Dimension>
+::GetStartKernelMatrix() const {
+  if (!m_FrozenStartPositions) return nullptr;
+  return KernelMatrixCache<ScalarType, Dimension>::instance()->Get(m_KernelType, m_KernelWidth, m_StartPositions);
+}
+
 template<class ScalarType, unsigned int Dimension>
 void
 Diffeos<ScalarType, Dimension>
 ::Shoot() {
+  DEF_PROFILE_SCOPE_SIZE("Diffeos::Shoot", m_StartPositions.rows());
   unsigned int numCP =
       m_StartPositions.rows(); // WHY not creating a variable numberCP, they do not change and we could set it as const
 
@@ -605,6 +760,7 @@ Diffeos<ScalarType, Dimension>
   }
   outPos[0] = m_StartPositions;
   outMoms[0] = m_StartMomentas;
+  m_KernelCholeskyCache = std::make_shared<KernelCholeskyCache>(m_NumberOfTimePoints);
 
   // Special case: nearly zero momentas yield no motion
   if (outMoms[0].frobenius_norm() < 1e-20)
@@ -613,23 +769,21 @@ Diffeos<ScalarType, Dimension>
   //ScalarType timeStep = 1.0 / (m_NumberOfTimePoints-1); // Why not T0 and Tm
   ScalarType dt = (m_TN - m_T0) / (m_NumberOfTimePoints - 1);
 
+  if (m_NumberOfTimeSlices > 1 && m_NumberOfTimePoints > 2) {
+    ShootParareal(dt);
+    return;
+  }
+
   KernelFactoryType *kFactory = KernelFactoryType::Instantiate();
   std::shared_ptr<KernelType> kernelObj = kFactory->CreateKernelObject(this->GetKernelType());
   kernelObj->SetKernelWidth(this->GetKernelWidth());
 
-  for (unsigned int t = 0; t < (m_NumberOfTimePoints - 1); t++) {
-    kernelObj->SetSources(outPos[t]);
-    kernelObj->SetWeights(outMoms[t]);
-
-    std::vector<MatrixType> kGradMom = kernelObj->ConvolveGradient(outPos[t]);
+  /// With frozen control points, the first step is a product of their kernel matrix with the momenta.
+  const std::shared_ptr<const KernelMatrixType> startKernelMatrix = GetStartKernelMatrix();
 
-    MatrixType dPos = kernelObj->Convolve(outPos[t]);
-    MatrixType dMom(numCP, Dimension, 0);
-    for (unsigned int i = 0; i < numCP; i++)
-      dMom.set_row(i, (kGradMom[i].transpose() * outMoms[t].get_row(i)));
-
-    outPos[t + 1] = outPos[t] + dPos * dt;
-    outMoms[t + 1] = outMoms[t] - dMom * dt;
+  for (unsigned int t = 0; t < (m_NumberOfTimePoints - 1); t++) {
+    ComputeGeodesicEulerStep(kernelObj, outPos[t], outMoms[t], dt, outPos[t + 1], outMoms[t + 1],
+                             t == 0 ? startKernelMatrix : nullptr);
 
     //		// Heun's method
     //		if (m_UseImprovedEuler)
@@ -658,10 +812,116 @@ Diffeos<ScalarType, Dimension>
   }
 }
 
+template<class ScalarType, unsigned int Dimension>
+void
+Diffeos<ScalarType, Dimension>
+::ShootParareal(ScalarType dt) {
+  DEF_PROFILE_SCOPE_SIZE("Diffeos::ShootParareal", m_StartPositions.rows());
+  MatrixListType &outPos = m_PositionsT;
+  MatrixListType &outMoms = m_MomentasT;
+
+  /// The slice n covers the time steps from bounds[n] to bounds[n + 1].
+  const unsigned int numberOfSteps = m_NumberOfTimePoints - 1;
+  const unsigned int numberOfSlices = std::min(m_NumberOfTimeSlices, numberOfSteps);
+  std::vector<unsigned int> bounds(numberOfSlices + 1);
+  for (unsigned int n = 0; n <= numberOfSlices; ++n) { bounds[n] = n * numberOfSteps / numberOfSlices; }
+
+  KernelFactoryType *kFactory = KernelFactoryType::Instantiate();
+  std::vector<std::shared_ptr<KernelType>> kernels(numberOfSlices);
+  for (unsigned int n = 0; n < numberOfSlices; ++n) {
+    kernels[n] = kFactory->CreateKernelObject(this->GetKernelType());
+    kernels[n]->SetKernelWidth(this->GetKernelWidth());
+  }
+
+  /// Boundary states of the slices, their coarse predictions, and the ends of the fine trajectories of the slices.
+  MatrixListType pos(numberOfSlices + 1), mom(numberOfSlices + 1);
+  MatrixListType coarsePos(numberOfSlices + 1), coarseMom(numberOfSlices + 1);
+  MatrixListType finePos(numberOfSlices + 1), fineMom(numberOfSlices + 1);
+
+  const std::shared_ptr<const KernelMatrixType> startKernelMatrix = GetStartKernelMatrix();
+
+  pos[0] = outPos[0];
+  mom[0] = outMoms[0];
+  for (unsigned int n = 0; n < numberOfSlices; ++n) {
+    ComputeGeodesicEulerStep(kernels[0], pos[n], mom[n], (bounds[n + 1] - bounds[n]) * dt,
+                             coarsePos[n + 1], coarseMom[n + 1], n == 0 ? startKernelMatrix : nullptr);
+    pos[n + 1] = coarsePos[n + 1];
+    mom[n + 1] = coarseMom[n + 1];
+  }
+
+  ThreadPool pool(def::utils::settings.number_of_threads);
+  bool converged = false;
+  for (unsigned int iteration = 0;; ++iteration) {
+    /// Fine integration of the slices, concurrently. After k iterations, the first k boundary states are exact : the
+    /// corresponding slices were already integrated from them.
+    std::vector<std::future<void>> futures;
+    for (unsigned int n = iteration; n < numberOfSlices; ++n) {
+      futures.push_back(pool.enqueue([&, n]() {
+        outPos[bounds[n]] = pos[n];
+        outMoms[bounds[n]] = mom[n];
+        for (unsigned int t = bounds[n]; t < bounds[n + 1]; ++t) {
+          const bool last = (t + 1 == bounds[n + 1]);
+          ComputeGeodesicEulerStep(kernels[n], outPos[t], outMoms[t], dt,
+                                   last ? finePos[n + 1] : outPos[t + 1], last ? fineMom[n + 1] : outMoms[t + 1],
+                                   t == 0 ? startKernelMatrix : nullptr);
+        }
+      }));
+    }
+    for (auto &f : futures) f.get();
+
+    if (converged || iteration + 1 == numberOfSlices)
+      break;
+
+    /// Sequential correction of the boundary states : U_{n+1} = G(U_n) + F(U_n^old) - G(U_n^old).
+    ScalarType maxJump = 0.0;
+    for (unsigned int n = iteration; n < numberOfSlices; ++n) {
+      MatrixType nextCoarsePos, nextCoarseMom;
+      ComputeGeodesicEulerStep(kernels[0], pos[n], mom[n], (bounds[n + 1] - bounds[n]) * dt,
+                               nextCoarsePos, nextCoarseMom, n == 0 ? startKernelMatrix : nullptr);
+      const MatrixType nextPos = nextCoarsePos + finePos[n + 1] - coarsePos[n + 1];
+      const MatrixType nextMom = nextCoarseMom + fineMom[n + 1] - coarseMom[n + 1];
+
+      const ScalarType scale = std::max(pos[n + 1].frobenius_norm() + mom[n + 1].frobenius_norm(), ScalarType(1e-20));
+      const ScalarType jump = (nextPos - pos[n + 1]).frobenius_norm() + (nextMom - mom[n + 1]).frobenius_norm();
+      maxJump = std::max(maxJump, jump / scale);
+
+      pos[n + 1] = nextPos;
+      mom[n + 1] = nextMom;
+      coarsePos[n + 1] = nextCoarsePos;
+      coarseMom[n + 1] = nextCoarseMom;
+    }
+    converged = (maxJump < m_PararealTolerance);
+  }
+
+  outPos[numberOfSteps] = finePos[numberOfSlices];
+  outMoms[numberOfSteps] = fineMom[numberOfSlices];
+}
+
+template<class ScalarType, unsigned int Dimension>
+void
+Diffeos<ScalarType, Dimension>
+::ComputeGeodesicEulerStep(std::shared_ptr<KernelType> kernel,
+                           MatrixType const &pos, MatrixType const &mom, ScalarType dt,
+                           MatrixType &nextPos, MatrixType &nextMom,
+                           std::shared_ptr<const KernelMatrixType> posKernelMatrix) {
+  kernel->SetSources(pos);
+  kernel->SetSourcesKernelMatrix(posKernelMatrix);
+  kernel->SetWeights(mom);
+
+  /// The contraction of the kernel gradients with the momenta is done within the kernel, without building the
+  /// per-point gradient matrices.
+  MatrixType dPos = kernel->ConvolveAtSources();
+  MatrixType dMom = kernel->ConvolveGradient(pos, mom);
+
+  nextPos = pos + dPos * dt;
+  nextMom = mom - dMom * dt;
+}
+
 template<class ScalarType, unsigned int Dimension>
 void
 Diffeos<ScalarType, Dimension>
 ::FlowLandmarkPointsTrajectory() {
+  DEF_PROFILE_SCOPE_SIZE("Diffeos::FlowLandmarkPointsTrajectory", Superclass::m_LandmarkPoints.rows());
 
   //ScalarType dt = 1.0 / (m_NumberOfTimePoints - 1);
   ScalarType dt = (m_TN - m_T0) / (m_NumberOfTimePoints - 1);
@@ -670,12 +930,6 @@ Diffeos<ScalarType, Dimension>
   typedef typename KernelFactoryType::KernelBaseType KernelType;
   KernelFactoryType *kFactory = KernelFactoryType::Instantiate();
 
-  std::shared_ptr<KernelType> kernelObj = kFactory->CreateKernelObject(this->GetKernelType());
-  kernelObj->SetKernelWidth(this->GetKernelWidth());
-
-  MatrixListType posT = this->GetTrajectoryPositions();
-  MatrixListType momT = this->GetTrajectoryMomentas();
-
   m_LandmarkPointsT.resize(m_NumberOfTimePoints);
   m_LandmarkPointsVelocity.resize(m_NumberOfTimePoints);
   for (unsigned int t = 0; t < m_NumberOfTimePoints; t++) {
@@ -683,23 +937,68 @@ Diffeos<ScalarType, Dimension>
     m_LandmarkPointsVelocity[t].fill(0.0);
   }
 
-  if (momT[0].frobenius_norm() < 1e-20)
+  if (m_MomentasT[0].frobenius_norm() < 1e-20)
     return;
 
+  /// The trajectories of the points do not depend on each other : blocks of points may be flowed concurrently.
+  const unsigned int numberOfPoints = Superclass::m_LandmarkPoints.rows();
+  const unsigned int numberOfBlocks = std::max(1u, std::min(m_NumberOfPointBlocks, numberOfPoints));
+  if (numberOfBlocks == 1) {
+    std::shared_ptr<KernelType> kernelObj = kFactory->CreateKernelObject(this->GetKernelType());
+    kernelObj->SetKernelWidth(this->GetKernelWidth());
+    FlowPoints(kernelObj, dt, m_LandmarkPointsT, m_LandmarkPointsVelocity);
+    return;
+  }
+
+  std::vector<unsigned int> bounds(numberOfBlocks + 1);
+  for (unsigned int b = 0; b <= numberOfBlocks; ++b) { bounds[b] = b * numberOfPoints / numberOfBlocks; }
+
+  std::vector<MatrixListType> blockPointsT(numberOfBlocks), blockVelocityT(numberOfBlocks);
+  std::vector<std::future<void>> futures;
+  {
+    ThreadPool pool(numberOfBlocks);
+    for (unsigned int b = 0; b < numberOfBlocks; ++b) {
+      blockPointsT[b].resize(m_NumberOfTimePoints);
+      blockVelocityT[b].resize(m_NumberOfTimePoints);
+      blockPointsT[b][0] = Superclass::m_LandmarkPoints.get_n_rows(bounds[b], bounds[b + 1] - bounds[b]);
+      std::shared_ptr<KernelType> kernelObj = kFactory->CreateKernelObject(this->GetKernelType());
+      kernelObj->SetKernelWidth(this->GetKernelWidth());
+      futures.push_back(pool.enqueue([&, b, kernelObj]() {
+        FlowPoints(kernelObj, dt, blockPointsT[b], blockVelocityT[b]);
+      }));
+    }
+  }
+  for (auto &f : futures) f.get();
+
+  for (unsigned int t = 0; t < m_NumberOfTimePoints; t++) {
+    if (blockVelocityT[0][t].rows())
+      m_LandmarkPointsVelocity[t].set_size(numberOfPoints, Dimension);
+    for (unsigned int b = 0; b < numberOfBlocks; ++b) {
+      m_LandmarkPointsT[t].update(blockPointsT[b][t], bounds[b]);
+      if (blockVelocityT[b][t].rows())
+        m_LandmarkPointsVelocity[t].update(blockVelocityT[b][t], bounds[b]);
+    }
+  }
+}
+
+template<class ScalarType, unsigned int Dimension>
+void
+Diffeos<ScalarType, Dimension>
+::FlowPoints(std::shared_ptr<KernelType> kernel, ScalarType dt,
+             MatrixListType &pointsT, MatrixListType &velocityT) const {
   for (unsigned int t = 0; t < m_NumberOfTimePoints - 1; t++) {
-    kernelObj->SetSources(posT[t]);
-    kernelObj->SetWeights(momT[t]);
+    kernel->SetSources(m_PositionsT[t]);
+    kernel->SetWeights(m_MomentasT[t]);
 
-    m_LandmarkPointsVelocity[t] = kernelObj->Convolve(m_LandmarkPointsT[t]);
-    m_LandmarkPointsT[t + 1] = m_LandmarkPointsT[t] + (m_LandmarkPointsVelocity[t] * dt);
+    velocityT[t] = kernel->Convolve(pointsT[t]);
+    pointsT[t + 1] = pointsT[t] + (velocityT[t] * dt);
 
     if (this->ImprovedEuler()) {
-      kernelObj->SetSources(posT[t + 1]);
-      kernelObj->SetWeights(momT[t + 1]);
+      kernel->SetSources(m_PositionsT[t + 1]);
+      kernel->SetWeights(m_MomentasT[t + 1]);
 
-      m_LandmarkPointsVelocity[t + 1] = kernelObj->Convolve(m_LandmarkPointsT[t + 1]);
-      m_LandmarkPointsT[t + 1] =
-          m_LandmarkPointsT[t] + (m_LandmarkPointsVelocity[t] + m_LandmarkPointsVelocity[t + 1]) * (dt * 0.5f);
+      velocityT[t + 1] = kernel->Convolve(pointsT[t + 1]);
+      pointsT[t + 1] = pointsT[t] + (velocityT[t] + velocityT[t + 1]) * (dt * 0.5f);
     }
 
 //    if (this->CheckBoundingBox(m_LandmarkPointsT, t + 1)) {
@@ -713,6 +1012,7 @@ template<class ScalarType, unsigned int Dimension>
 void
 Diffeos<ScalarType, Dimension>
 ::FlowImagePointsTrajectory() {
+  DEF_PROFILE_SCOPE_SIZE("Diffeos::FlowImagePointsTrajectory", Superclass::m_ImagePoints.rows());
 
   if (m_ComputeTrueInverseFlow) { IntegrateImagePointsWithTrueInverseFlow(); }
   else { IntegrateImagePointsBackward(); }
@@ -1393,6 +1693,7 @@ Diffeos<ScalarType, Dimension>
 ::IntegrateAdjointEquations(MatrixListType &InitialConditionsLandmarkPoints,
                             MatrixListType &InitialConditionsImagePoints,
                             std::vector<unsigned int> jumpTimes) {
+  DEF_PROFILE_SCOPE("Diffeos::IntegrateAdjointEquations");
   // Upsample image maps, since initial condition of image objects are at full resolution
   // ImagePointerType image = Superclass::m_Template->GetTemplateObjects()->GetImage();
   // The path of the image points over time
@@ -1426,6 +1727,7 @@ Diffeos<ScalarType, Dimension>
   integrator->SetT0(m_T0);
   integrator->SetTN(m_TN);
   integrator->SetJumpTimes(jumpTimes);
+  integrator->SetNumberOfPointBlocks(m_NumberOfPointBlocks);
 
   (m_ComputeTrueInverseFlow || m_RegressionFlag) ? integrator->SetComputeTrueInverseFlow()
                                                  : integrator->UnsetComputeTrueInverseFlow();
@@ -20,6 +20,9 @@
 /// Non-core files.
 #include "itkImage.h"
 
+#include <algorithm>
+#include <mutex>
+
 /**
  *  \brief      Standard diffeomorphisms.
  *
@@ -55,6 +58,8 @@ class Diffeos : public AbstractDeformations<ScalarType, Dimension> {
   typedef KernelFactory<ScalarType, Dimension> KernelFactoryType;
   /// Kernel type.
   typedef typename KernelFactoryType::KernelBaseType KernelType;
+  /// Kernel matrix type.
+  typedef KernelMatrix<ScalarType> KernelMatrixType;
 
 
   ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -113,6 +118,14 @@ class Diffeos : public AbstractDeformations<ScalarType, Dimension> {
     m_UseFastConvolutions = false;
   }
 
+  /// Returns true if the start positions are frozen control points, false otherwise.
+  bool FrozenStartPositions() const { return m_FrozenStartPositions; }
+  /// Declares the start positions as frozen control points : their kernel matrix is then kept between the shootings
+  /// (see KernelMatrixCache), for the first step of Shoot() and the kernel inversions at time 0.
+  void SetFrozenStartPositions() { m_FrozenStartPositions = true; }
+  /// Declares the start positions as varying from one shooting to the next.
+  void UnsetFrozenStartPositions() { m_FrozenStartPositions = false; }
+
   ///	Return the type of the kernel.
   KernelEnumType GetKernelType() const { return m_KernelType; }
   /// Set the type of the kernel to \e kernelType.
@@ -137,6 +150,8 @@ class Diffeos : public AbstractDeformations<ScalarType, Dimension> {
     this->SetModified();
   }
 
+  /// Gets the initial momenta.
+  MatrixType GetStartMomentas() const { return m_StartMomentas; }
   /// Set the initial momenta to \e A.
   void SetStartMomentas(const MatrixType &A) {
     m_StartMomentas = A;
@@ -195,6 +210,27 @@ class Diffeos : public AbstractDeformations<ScalarType, Dimension> {
   /// Sets the m_UseImplicitEuler flag to false.
   inline void UnsetUseImplicitEuler() { m_UseImplicitEuler = false; }
 
+  /// Return the number of time slices of the parallel-in-time integration (see Diffeos::m_NumberOfTimeSlices).
+  unsigned int GetNumberOfTimeSlices() const { return m_NumberOfTimeSlices; }
+  /// Set the number of time slices of the parallel-in-time integration (1 for the sequential integration).
+  void SetNumberOfTimeSlices(unsigned int n) {
+    m_NumberOfTimeSlices = std::max(1u, n);
+    this->SetModified();
+  }
+
+  /// Return the number of blocks of landmark points flowed concurrently (see Diffeos::m_NumberOfPointBlocks).
+  unsigned int GetNumberOfPointBlocks() const { return m_NumberOfPointBlocks; }
+  /// Set the number of blocks of landmark points flowed concurrently (1 for the sequential flow).
+  void SetNumberOfPointBlocks(unsigned int n) { m_NumberOfPointBlocks = std::max(1u, n); }
+
+  /// Return the relative tolerance on the boundary states of the time slices of the Parareal iterations.
+  ScalarType GetPararealTolerance() const { return m_PararealTolerance; }
+  /// Set the relative tolerance on the boundary states of the time slices of the Parareal iterations.
+  void SetPararealTolerance(ScalarType tolerance) {
+    m_PararealTolerance = tolerance;
+    this->SetModified();
+  }
+
 
 
   ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -239,6 +275,9 @@ class Diffeos : public AbstractDeformations<ScalarType, Dimension> {
 
   /// Returns the deformed objects at time \e t.
   std::shared_ptr<DeformableMultiObjectType> GetDeformedObjectAt(unsigned int t) const;
+  /// Returns the deformed objects at time \e t, built once per trajectory and shared by all the callers :
+  /// the returned objects must not be modified (e.g. when they are the reference shapes of further deformations).
+  std::shared_ptr<DeformableMultiObjectType> GetSharedDeformedObjectAt(unsigned int t) const;
   /// Returns the deformed control points at time \e t.
   MatrixType GetDeformedControlPointsAt(unsigned int t) const;
 
@@ -275,6 +314,29 @@ class Diffeos : public AbstractDeformations<ScalarType, Dimension> {
     }
   }
 
+  /// Batched parallel transport : transports all the \e initialMomentas (attached to \e initialControlPoints) in one
+  /// sweep along the geodesic, sharing the kernel operations on its control points. Returns, and fills \e velocities
+  /// with, one list per vector of the transported momentas (resp. velocities) at the times \e targetTimes.
+  std::vector<MatrixListType> ParallelTransport(std::vector<MatrixType> const &initialMomentas,
+                                                MatrixType const &initialControlPoints,
+                                                ScalarType const &initialTime,
+                                                std::vector<ScalarType> const &targetTimes,
+                                                std::vector<MatrixListType> &velocities);
+  /// Batched parallel transport, with some default values.
+  std::vector<MatrixListType> ParallelTransport(std::vector<MatrixType> const &initialMomentas,
+                                                std::vector<ScalarType> const &targetTimes) {
+    std::vector<MatrixListType> aux;
+    return ParallelTransport(initialMomentas, m_StartPositions, m_T0, targetTimes, aux);
+  }
+
+  /// Batched parallel transport along a geodesic made of two sides, both starting at the reference time : each of the
+  /// \e initialMomentas is transported to its signed \e timeIncrements, the negative ones along \e backwardGeodesic and
+  /// the positive ones along \e forwardGeodesic. Each side is swept once, up to the union of the target times.
+  static std::vector<MatrixListType> ParallelTransport(std::shared_ptr<Diffeos> backwardGeodesic,
+                                                       std::shared_ptr<Diffeos> forwardGeodesic,
+                                                       std::vector<MatrixType> const &initialMomentas,
+                                                       std::vector<std::vector<ScalarType>> const &timeIncrements);
+
  protected:
 
   ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -299,6 +361,37 @@ class Diffeos : public AbstractDeformations<ScalarType, Dimension> {
 
   /// Solves the Hamiltonian system associated to the initial positions and momenta.
   void Shoot();
+  /// Parareal version of Shoot() : the time slices are integrated concurrently from boundary states predicted by
+  /// a coarse propagator (one Euler step per slice), which are corrected until they match the fine trajectories.
+  void ShootParareal(ScalarType dt);
+  /// Explicit Euler step of size \e dt of the Hamiltonian system, from \e pos and \e mom. The kernel matrix of \e pos
+  /// may be given by \e posKernelMatrix.
+  static void ComputeGeodesicEulerStep(std::shared_ptr<KernelType> kernel,
+                                       MatrixType const &pos, MatrixType const &mom, ScalarType dt,
+                                       MatrixType &nextPos, MatrixType &nextMom,
+                                       std::shared_ptr<const KernelMatrixType> posKernelMatrix = nullptr);
+  /// Flows the points \e pointsT[0] along the trajectory of the control points, filling \e pointsT and \e velocityT.
+  void FlowPoints(std::shared_ptr<KernelType> kernel, ScalarType dt,
+                  MatrixListType &pointsT, MatrixListType &velocityT) const;
+
+  /// Stores the S matrices of size N x Dimension \e vectors side by side, in a N x (S * Dimension) matrix.
+  static MatrixType ConcatenateVectors(std::vector<MatrixType> const &vectors);
+  /// Returns the \e s-th N x Dimension block of columns of \e concatenated.
+  static MatrixType ExtractVector(MatrixType const &concatenated, unsigned int s);
+  /// Sets the \e s-th N x Dimension block of columns of \e concatenated to \e vector.
+  static void InsertVector(MatrixType &concatenated, unsigned int s, MatrixType const &vector);
+  /// Returns the derivatives of the side by side \e momentas given by the Hamiltonian equations at \e positions.
+  static MatrixType ComputeMomentaDerivatives(std::shared_ptr<KernelType> kernel,
+                                              MatrixType const &positions,
+                                              MatrixType const &momentas);
+
+  /// Returns the solution W of K(t) * W = \e X, K(t) being the kernel matrix of the control points at time index \e t.
+  MatrixType ConvolveInverseAt(unsigned int t, MatrixType const &X);
+  /// Returns the upper Cholesky factor of the kernel matrix of the control points at time index \e t.
+  std::shared_ptr<const MatrixType> GetKernelCholeskyAt(unsigned int t);
+  /// Returns the kernel matrix of the start positions if they are frozen (see SetFrozenStartPositions()), nullptr
+  /// otherwise.
+  std::shared_ptr<const KernelMatrixType> GetStartKernelMatrix() const;
 
  private:
 
@@ -346,6 +439,26 @@ class Diffeos : public AbstractDeformations<ScalarType, Dimension> {
   /// List containing the position of the momenta at different time points.
   MatrixListType m_MomentasT;
 
+  /// Upper Cholesky factors of the kernel matrices of the control points along the trajectory.
+  struct KernelCholeskyCache {
+    explicit KernelCholeskyCache(std::size_t n) : factors(n) {}
+    std::mutex mutex;
+    std::vector<std::shared_ptr<const MatrixType>> factors;
+  };
+  /// Factors are built on first use, and shared by all the parallel transports along the trajectory (and by the copies
+  /// of this object) ; a new, empty cache is created whenever the trajectory is computed again.
+  std::shared_ptr<KernelCholeskyCache> m_KernelCholeskyCache;
+
+  /// Deformed objects along the trajectory, returned by GetSharedDeformedObjectAt().
+  struct DeformedObjectCache {
+    explicit DeformedObjectCache(std::size_t n) : once(n), objects(n) {}
+    std::vector<std::once_flag> once;
+    std::vector<std::shared_ptr<DeformableMultiObjectType>> objects;
+  };
+  /// Objects are built on first use, and shared by the copies of this object ; a new, empty cache is created whenever
+  /// the objects are flowed again.
+  std::shared_ptr<DeformedObjectCache> m_DeformedObjectCache;
+
   /// Type of the kernel.
   KernelEnumType m_KernelType;
   /// Size of the kernel associated to the deformation.
@@ -400,5 +513,20 @@ class Diffeos : public AbstractDeformations<ScalarType, Dimension> {
   /// Wether to use fast convolutions (experimental feature)
   bool m_UseFastConvolutions;
 
+  /// The start positions are frozen control points (see SetFrozenStartPositions()).
+  bool m_FrozenStartPositions;
+
+  /// Number of time slices integrated concurrently by the Parareal scheme, in Shoot() (1 : sequential integration).
+  /// Only worth it for long geodesics, whose integration is the critical path of the computations (e.g. longitudinal
+  /// reference geodesics).
+  unsigned int m_NumberOfTimeSlices;
+  /// Number of blocks of landmark points flowed concurrently in FlowLandmarkPointsTrajectory(), and of points whose
+  /// adjoint equations are integrated concurrently in IntegrateAdjointEquations() (1 : sequential computations).
+  /// Opt-in, for the top-level callers which deform a single object at a time (e.g. the geodesic regression) : the
+  /// models which deform their subjects from the tasks of a thread pool keep 1, to avoid nested pools.
+  unsigned int m_NumberOfPointBlocks;
+  /// Relative tolerance on the jumps of the boundary states between two Parareal iterations.
+  ScalarType m_PararealTolerance;
+
 }; /* class Diffeos */
 
@@ -45,6 +45,18 @@ AbstractStatisticalModel<ScalarType, Dimension>
   m_Name = name.str();
 
   m_Type = other.m_Type;
+  m_FixedEffects = other.m_FixedEffects;
+
+  /// The distributions are updated with the fixed effects : each copy gets its own.
+  auto clone = [](ProbabilityDistributionMapType const &map) {
+    ProbabilityDistributionMapType out;
+    for (auto it = map.begin(); it != map.end(); ++it)
+      out[it->first] = std::shared_ptr<ProbabilityDistributionType>(it->second->Clone());
+    return out;
+  };
+  m_Priors = clone(other.m_Priors);
+  m_PopulationRandomEffects = clone(other.m_PopulationRandomEffects);
+  m_IndividualRandomEffects = clone(other.m_IndividualRandomEffects);
 }
 
 template
@@ -319,6 +319,8 @@ class AbstractStatisticalModel {
 
   /// Recovers the memorized random effect realizations-based state.
   virtual void RecoverMemorizedState() {}
+  /// Variation after an individual proposal, where only the subjects flagged in \e rejectedSubjects recover their state.
+  virtual void RecoverMemorizedState(std::vector<bool> const &rejectedSubjects) { RecoverMemorizedState(); }
 
  protected:
 
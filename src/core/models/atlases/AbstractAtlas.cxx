@@ -10,6 +10,7 @@
 
 
 #include "AbstractAtlas.h"
+#include "GridFunctions.h"
 #include "LinearAlgebra.h"
 
 using namespace def::algebra;
@@ -36,6 +37,15 @@ AbstractAtlas<ScalarType, Dimension>
 template<class ScalarType, unsigned int Dimension>
 AbstractAtlas<ScalarType, Dimension>
 ::AbstractAtlas(const AbstractAtlas &other) : Superclass(other) {
+  m_Template = other.m_Template->Clone();
+  m_TemplateObjectsName = other.m_TemplateObjectsName;
+  m_TemplateObjectsNameExtension = other.m_TemplateObjectsNameExtension;
+  m_BoundingBox = other.m_BoundingBox;
+  m_NumberOfObjects = other.m_NumberOfObjects;
+  m_CPSpacing = other.m_CPSpacing;
+  m_FreezeTemplateFlag = other.m_FreezeTemplateFlag;
+  m_FreezeControlPointsFlag = other.m_FreezeControlPointsFlag;
+
   m_Def = std::static_pointer_cast<DiffeosType>(other.m_Def->Clone());
   m_SmoothingKernelWidth = other.m_SmoothingKernelWidth;
   m_NumberOfThreads = other.m_NumberOfThreads;
@@ -242,12 +252,11 @@ AbstractAtlas<ScalarType, Dimension>
   VectorType Xmin = temp->GetBoundingBox().get_column(0);
   VectorType Xmax = temp->GetBoundingBox().get_column(1);
 
-  /// For the optimize==true case.
-  ImageTypePointer img;
-  ImageSpacingType spacing;
+  /// For the optimize==true case : largest intensity variation in the neighborhood of each voxel of the template.
+  ImageTypePointer deviation;
   if (optimize && temp->IsOfImageKind()[0]) {
-    img = temp->GetImage();
-    spacing = img->GetSpacing();
+    deviation = GridFunctions<ScalarType, Dimension>::LocalIntensityDeviation(temp->GetImage(),
+                                                                              2 * m_Def->GetKernelWidth());
     std::cout << "We optimize the position of the control points." << std::endl;
   } else { optimize = false; }
 
@@ -260,34 +269,16 @@ AbstractAtlas<ScalarType, Dimension>
 
       for (ScalarType x = Xmin[0] + offsetX; x <= Xmax[0]; x += m_CPSpacing) {
         for (ScalarType y = Xmin[1] + offsetY; y <= Xmax[1]; y += m_CPSpacing) {
-          bool getOut = false;
           v[0] = x;
           v[1] = y;
           if (optimize) {
             ImageIndexType ind;
             ImagePointType p;
-            ScalarType value;
-            ScalarType toSpan = 2 * m_Def->GetKernelWidth();
             p[0] = x;
             p[1] = y;
-            img->TransformPhysicalPointToIndex(p, ind);
-            value = img->GetPixel(ind);
             // Here we look : if all the intensities are equal in the neighborhood of the cp, we discard it.
-            for (ScalarType xTest = x - toSpan; xTest < x + toSpan; xTest += spacing[0]) {
-              if (getOut) {
-                break;
-              }
-              p[0] = xTest;
-              for (ScalarType yTest = y - toSpan; yTest < y + toSpan; yTest += spacing[1]) {
-                p[1] = yTest;
-                if (img->TransformPhysicalPointToIndex(p, ind)
-                    && std::fabs(img->GetPixel(ind) - value) > 0.01) {
-                  pointList.push_back(v);
-                  getOut = true;
-                  break;
-                }
-              }
-            }
+            if (deviation->TransformPhysicalPointToIndex(p, ind) && deviation->GetPixel(ind) > 0.01)
+              pointList.push_back(v);
           } else // Else we don't have a criterion to discard the cp : we keep it.
             pointList.push_back(v);
         }
@@ -302,39 +293,17 @@ AbstractAtlas<ScalarType, Dimension>
       for (ScalarType x = Xmin[0] + offsetX; x <= Xmax[0]; x += m_CPSpacing)
         for (ScalarType y = Xmin[1] + offsetY; y <= Xmax[1]; y += m_CPSpacing)
           for (ScalarType z = Xmin[2] + offsetZ; z <= Xmax[2]; z += m_CPSpacing) {
-            bool getOut = false;
             v[0] = x;
             v[1] = y;
             v[2] = z;
             if (optimize) {
               ImageIndexType ind;
               ImagePointType p;
-              ScalarType value;
-              ScalarType toSpan = 2 * m_Def->GetKernelWidth();
-
               p[0] = x;
               p[1] = y;
               p[2] = z;
-              img->TransformPhysicalPointToIndex(p, ind);
-              value = img->GetPixel(ind);
-              // Here we look : if all the intensities are equal in the neighborhood of the cp, we discard it.
-              for (ScalarType xTest = x - toSpan; xTest < x + toSpan; xTest += spacing[0]) {
-                if (getOut) { break; }
-                p[0] = xTest;
-                for (ScalarType yTest = y - toSpan; yTest < y + toSpan; yTest += spacing[1]) {
-                  if (getOut) { break; }
-                  p[1] = yTest;
-                  for (ScalarType zTest = z - toSpan; zTest < z + toSpan; zTest += spacing[2]) {
-                    p[2] = zTest;
-                    if (img->TransformPhysicalPointToIndex(p, ind)
-                        && std::fabs(img->GetPixel(ind) - value) > 0.01) {
-                      pointList.push_back(v);
-                      getOut = true;
-                      break;
-                    }
-                  }
-                }
-              }
+              if (deviation->TransformPhysicalPointToIndex(p, ind) && deviation->GetPixel(ind) > 0.01)
+                pointList.push_back(v);
             } else
               pointList.push_back(v);
           }
@@ -432,7 +401,7 @@ AbstractAtlas<ScalarType, Dimension>
     defFieldIO.WriteDeformationField(outputDir + Superclass::m_Name, true);
   }
 
-  writeMatrixDLM<ScalarType>(outputDir+"Residuals.txt", residuals);
+  writeMatrixDLM<ScalarType>(outputDir + "Residuals" + matrixFileExtension(), residuals);
 
 }
 
@@ -445,17 +414,17 @@ AbstractAtlas<ScalarType, Dimension>
 
   /// Write control points.
   std::ostringstream oss1;
-  oss1 << outputDir << Superclass::m_Name << "_ControlPoints.txt" << std::ends;
+  oss1 << outputDir << Superclass::m_Name << "_ControlPoints" << matrixFileExtension() << std::ends;
   writeMatrixDLM<ScalarType>(oss1.str().c_str(), GetControlPoints());
 
   /// Write initial momentas.
   std::ostringstream oss2;
-  oss2 << outputDir << Superclass::m_Name << "_Momentas.txt" << std::ends;
+  oss2 << outputDir << Superclass::m_Name << "_Momentas" << matrixFileExtension() << std::ends;
   writeMultipleMatrixDLM<ScalarType>(oss2.str().c_str(), momentas);
 
   /// Write inverse of optimal covariance momenta matrix.
   std::ostringstream ossCMI;
-  ossCMI << outputDir << this->m_Name << "_CovarianceMomentaInverse.txt" << std::ends;
+  ossCMI << outputDir << this->m_Name << "_CovarianceMomentaInverse" << matrixFileExtension() << std::ends;
   writeMatrixDLM<ScalarType>(ossCMI.str().c_str(), covarianceMomentaInverse);
 
   /// Write data sigma.
@@ -464,7 +433,7 @@ AbstractAtlas<ScalarType, Dimension>
     dataSigma(0, i) = sqrt(dataSigmaSquared(i));
 
   std::ostringstream ossDSS;
-  ossDSS << outputDir << this->m_Name << "_DataSigma.txt" << std::ends;
+  ossDSS << outputDir << this->m_Name << "_DataSigma" << matrixFileExtension() << std::ends;
   writeMatrixDLM<ScalarType>(ossDSS.str().c_str(), dataSigma);
 }
 
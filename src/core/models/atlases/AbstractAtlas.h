@@ -216,6 +216,8 @@ class AbstractAtlas : public AbstractStatisticalModel<ScalarType, Dimension> {
                                const MatrixType &momenta,
                                const std::shared_ptr<DeformableMultiObjectType> target,
                                std::vector<ScalarType> &residuals) const;
+  /// Updates the data domain of the deformation and the kernel. Needed before any ComputeResidualsSubject() call.
+  void UpdateDeformationAndKernelDataDomain(const std::vector<std::shared_ptr<DeformableMultiObjectType>> target);
 
   /// Computes the complete log-likelihood, given an input random effects realization ("RER").
   virtual ScalarType ComputeCompleteLogLikelihood(const LongitudinalDataSetType *const dataSet,
@@ -319,9 +321,6 @@ class AbstractAtlas : public AbstractStatisticalModel<ScalarType, Dimension> {
   /// Computes the Sobolev gradient of template objects of landmark type (or children types) from the \f$L^2\f$ gradient
   MatrixListType ConvolveGradTemplate(MatrixListType &GradTemplate_L2);
 
-  /// Updates the data domain of the deformation and the kernel.
-  void UpdateDeformationAndKernelDataDomain(const std::vector<std::shared_ptr<DeformableMultiObjectType>> target);
-
   /// Converts a matrix of size N x Dimension to a vector \e V of length Dimension x N.
   VectorType Vectorize(const MatrixType &M) const { return M.vectorise_row_wise(); }
   /// Converts a vector \e V of length Dimension x N to a matrix of size N x Dimension. Inverse operation of Vectorize.
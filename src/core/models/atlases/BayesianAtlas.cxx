@@ -51,6 +51,9 @@ template<class ScalarType, unsigned int Dimension>
 BayesianAtlas<ScalarType, Dimension>
 ::BayesianAtlas(const BayesianAtlas &other) : Superclass(other) {
   m_NoiseDimension = other.m_NoiseDimension;
+  m_UseParametricTemplate = other.m_UseParametricTemplate;
+  m_UsePriorOnControlPoints = other.m_UsePriorOnControlPoints;
+  m_UseRandomControlPoints = other.m_UseRandomControlPoints;
 }
 
 
@@ -326,7 +329,7 @@ BayesianAtlas<ScalarType, Dimension>
     if (m_UseParametricTemplate) {
       const VectorType photoWeights = (this->GetTemplateData()[this->m_Template->GetImageIndex()]).get_column(0);
       gradTempL_L2[this->m_Template->GetImageIndex()].get_column(0)
-          -= GetParametricTemplatePriorCovarianceInverse() * (photoWeights - GetParametricTemplatePriorMean());
+          -= MultiplyByParametricTemplatePriorCovarianceInverse(photoWeights - GetParametricTemplatePriorMean());
       gradTempL_Sob = this->ConvolveGradTemplate(gradTempL_L2);
     }
   } else { this->ComputeDataTermGradient(cp, momentas, dataSigmaSquared, target, gradPos, gradMom); }
@@ -338,12 +341,11 @@ BayesianAtlas<ScalarType, Dimension>
 
   if (m_UseRandomControlPoints) {
     const VectorType cp = this->Vectorize(recast<MatrixType>(popRER.at("ControlPoints")));
-    gradPos -= this->VectorToMatrix(GetControlPointsRandomEffectCovarianceInverse()
-                                        * (cp - GetControlPointsRandomEffectMean()));
+    gradPos -= this->VectorToMatrix(
+        MultiplyByControlPointsRandomEffectCovarianceInverse(cp - GetControlPointsRandomEffectMean()));
   } else if (m_UsePriorOnControlPoints) {
     const VectorType cp = this->Vectorize(this->GetControlPoints());
-    gradPos -= this->VectorToMatrix(GetControlPointsPriorCovarianceInverse()
-                                        * (cp - GetControlPointsPriorMean()));
+    gradPos -= this->VectorToMatrix(MultiplyByControlPointsPriorCovarianceInverse(cp - GetControlPointsPriorMean()));
   }
 
   if (!this->m_FreezeControlPointsFlag) { popGrad["ControlPoints"] = gradPos; }
@@ -390,7 +392,7 @@ BayesianAtlas<ScalarType, Dimension>
     if (m_UseParametricTemplate) {
       const VectorType photoWeights = (this->GetTemplateData()[this->m_Template->GetImageIndex()]).get_column(0);
       gradTempL_L2[this->m_Template->GetImageIndex()].get_column(0)
-          -= GetParametricTemplatePriorCovarianceInverse() * (photoWeights - GetParametricTemplatePriorMean());
+          -= MultiplyByParametricTemplatePriorCovarianceInverse(photoWeights - GetParametricTemplatePriorMean());
     }
     gradTempL_Sob = this->ConvolveGradTemplate(gradTempL_L2);
   } else { this->ComputeDataTermGradient(cp, momentas, dataSigmaSquared, target, gradPos, gradMom); }
@@ -402,12 +404,11 @@ BayesianAtlas<ScalarType, Dimension>
 
   if (m_UseRandomControlPoints) {
     const VectorType cp = this->Vectorize(recast<MatrixType>(popRER.at("ControlPoints")));
-    gradPos -= this->VectorToMatrix(GetControlPointsRandomEffectCovarianceInverse()
-                                        * (cp - GetControlPointsRandomEffectMean()));
+    gradPos -= this->VectorToMatrix(
+        MultiplyByControlPointsRandomEffectCovarianceInverse(cp - GetControlPointsRandomEffectMean()));
   } else if (m_UsePriorOnControlPoints) {
     const VectorType cp = this->Vectorize(this->GetControlPoints());
-    gradPos -= this->VectorToMatrix(GetControlPointsPriorCovarianceInverse()
-                                        * (cp - GetControlPointsPriorMean()));
+    gradPos -= this->VectorToMatrix(MultiplyByControlPointsPriorCovarianceInverse(cp - GetControlPointsPriorMean()));
   }
 
   if (!this->m_FreezeControlPointsFlag) { popGrad["ControlPoints"] = gradPos; }
@@ -462,8 +463,8 @@ BayesianAtlas<ScalarType, Dimension>
 
   if (m_UseRandomControlPoints) {
     const VectorType cp = this->Vectorize(recast<MatrixType>(popRER.at("ControlPoints")));
-    gradPos -= this->VectorToMatrix(GetControlPointsRandomEffectCovarianceInverse()
-                                        * (cp - GetControlPointsRandomEffectMean()));
+    gradPos -= this->VectorToMatrix(
+        MultiplyByControlPointsRandomEffectCovarianceInverse(cp - GetControlPointsRandomEffectMean()));
     popGrad["ControlPoints"] = gradPos;
   }
 }
@@ -725,27 +726,12 @@ BayesianAtlas<ScalarType, Dimension>
   VectorType mean(nbPhotoCPs, 0.0);
   SetParametricTemplatePriorMean(mean);
 
-  /// Inverse of the covariance of the prior normal distribution.
-  MatrixType photometricCPs = parametricTemplate->GetPhotometricControlPoints();
-
-  KernelFactoryType *kfac = KernelFactoryType::Instantiate();
-  std::shared_ptr<KernelType> ker = kfac->CreateKernelObject(this->m_Def->GetKernelType());
-  ker->SetKernelWidth(parametricTemplate->GetPhotometricKernelWidth());
-
-  MatrixType covInv(nbPhotoCPs, nbPhotoCPs);
-  for (unsigned int i = 0; i < nbPhotoCPs; i++) {
-    for (unsigned int j = 0; j < i; j++) {
-      VectorType CPi = photometricCPs.get_row(i);
-      VectorType CPj = photometricCPs.get_row(j);
-      ScalarType k = ker->EvaluateKernel(CPi, CPj);
-
-      covInv(i, j) = k;
-      covInv(j, i) = k;
-    }
-    covInv(i, i) = 1;
-  }
-
-  SetParametricTemplatePriorCovarianceInverse(covInv);
+  /// Covariance of the prior normal distribution : its inverse is the kernel matrix of the photometric control points,
+  /// which is never inverted nor stored.
+  std::static_pointer_cast<NormalDistributionType>(this->m_Priors.at("ParametricTemplate"))->SetCovarianceOperator(
+      std::make_shared<KernelCovarianceOperator<ScalarType, Dimension>>(
+          this->m_Def->GetKernelType(), parametricTemplate->GetPhotometricKernelWidth(),
+          parametricTemplate->GetPhotometricControlPoints(), 1));
 }
 
 template<class ScalarType, unsigned int Dimension>
@@ -755,7 +741,7 @@ BayesianAtlas<ScalarType, Dimension>
   /// Mean of the prior normal distribution.
   SetControlPointsPriorMean(this->GetControlPoints().vectorize());
 
-  /// Sqrt of the covariance of the prior normal distribution.
+  /// Diagonal covariance of the prior normal distribution.
   const std::shared_ptr<const DeformableMultiObjectType> temp = this->GetTemplate();
   const VectorType Xmin = temp->GetBoundingBox().get_column(0);
   const VectorType Xmax = temp->GetBoundingBox().get_column(1);
@@ -765,13 +751,13 @@ BayesianAtlas<ScalarType, Dimension>
   for (unsigned int dim = 0; dim < Dimension; ++dim)
     aux(dim) = 0.5 * (Xmax(dim) - Xmin(dim));
 
-  MatrixType covSqrt(nbCPs * Dimension, nbCPs * Dimension, 0.0);
+  VectorType variances(nbCPs * Dimension);
   for (unsigned int k = 0; k < nbCPs; ++k) {
     for (unsigned int dim = 0; dim < Dimension; ++dim) {
-      covSqrt(Dimension * k + dim, Dimension * k + dim) = aux(dim);
+      variances(Dimension * k + dim) = aux(dim) * aux(dim);
     }
   }
-  SetControlPointsPriorCovarianceSqrt(covSqrt);
+  SetControlPointsPriorVariances(variances);
 }
 
 template<class ScalarType, unsigned int Dimension>
@@ -807,14 +793,14 @@ BayesianAtlas<ScalarType, Dimension>
     for (unsigned int dim = 0; dim < Dimension; ++dim)
       aux(dim) = 0.01 * (Xmax(dim) - Xmin(dim)); // Here 1/100th.
 
-    MatrixType covSqrt(nbCPs * Dimension, nbCPs * Dimension, 0.0);
+    VectorType variances(nbCPs * Dimension);
     for (unsigned int k = 0; k < nbCPs; ++k) {
       for (unsigned int dim = 0; dim < Dimension; ++dim) {
-        covSqrt(Dimension * k + dim, Dimension * k + dim) = aux(dim);
+        variances(Dimension * k + dim) = aux(dim) * aux(dim);
       }
     }
 
-    SetControlPointsRandomEffectCovarianceSqrt(covSqrt);
+    SetControlPointsRandomEffectVariances(variances);
   }
 }
 
@@ -196,6 +196,16 @@ class BayesianAtlas : public AbstractAtlas<ScalarType, Dimension> {
     std::static_pointer_cast<NormalDistributionType>(
         this->m_PopulationRandomEffects.at("ControlPoints"))->SetCovarianceSqrt(m);
   }
+  /// Sets the diagonal covariance of the control points population random effect, from the variances.
+  void SetControlPointsRandomEffectVariances(VectorType const &v) {
+    std::static_pointer_cast<NormalDistributionType>(this->m_PopulationRandomEffects.at("ControlPoints"))
+        ->SetCovarianceOperator(std::make_shared<DiagonalCovarianceOperator<ScalarType>>(v));
+  }
+  /// Returns the product of the inverse of the covariance of the control points population random effect with \e v.
+  VectorType MultiplyByControlPointsRandomEffectCovarianceInverse(VectorType const &v) const {
+    return std::static_pointer_cast<NormalDistributionType>(
+        this->m_PopulationRandomEffects.at("ControlPoints"))->MultiplyByCovarianceInverse(v);
+  }
 
   /// Gets the momenta covariance matrix hyperparameter.
   ScalarType GetCovarianceMomenta_HyperParameter() const {
@@ -269,6 +279,11 @@ class BayesianAtlas : public AbstractAtlas<ScalarType, Dimension> {
     std::static_pointer_cast<NormalDistributionType>(
         this->m_Priors.at("ParametricTemplate"))->SetCovarianceInverse(m);
   }
+  /// Returns the product of the inverse of the covariance of the prior on the parametric template with \e v.
+  VectorType MultiplyByParametricTemplatePriorCovarianceInverse(VectorType const &v) const {
+    return std::static_pointer_cast<NormalDistributionType>(
+        this->m_Priors.at("ParametricTemplate"))->MultiplyByCovarianceInverse(v);
+  }
 
   /// Gets the mean of the prior distribution on the random control points.
   VectorType GetControlPointsPriorMean() const {
@@ -296,6 +311,16 @@ class BayesianAtlas : public AbstractAtlas<ScalarType, Dimension> {
     std::static_pointer_cast<NormalDistributionType>(
         this->m_Priors.at("ControlPoints"))->SetCovarianceSqrt(m);
   }
+  /// Sets the diagonal covariance of the prior distribution on the random control points, from the variances.
+  void SetControlPointsPriorVariances(VectorType const &v) {
+    std::static_pointer_cast<NormalDistributionType>(this->m_Priors.at("ControlPoints"))
+        ->SetCovarianceOperator(std::make_shared<DiagonalCovarianceOperator<ScalarType>>(v));
+  }
+  /// Returns the product of the inverse of the covariance of the prior on the random control points with \e v.
+  VectorType MultiplyByControlPointsPriorCovarianceInverse(VectorType const &v) const {
+    return std::static_pointer_cast<NormalDistributionType>(
+        this->m_Priors.at("ControlPoints"))->MultiplyByCovarianceInverse(v);
+  }
 
   /// Sets the dimension of the noise.
   void SetNoiseDimension(std::vector<unsigned long> V) { m_NoiseDimension = V; }
@@ -334,6 +359,9 @@ class BayesianAtlas : public AbstractAtlas<ScalarType, Dimension> {
                                                                  VectorType &logLikelihoodTerms);
 
   /// Computes the model log-likelihood, returning as well the detailed contribution of each subject.
+  /// The only population random effect of this model is the control points : a proposed block of them shoots every
+  /// subject again. Every control point enters the geodesic equations of every subject, so that no exact incremental
+  /// update exists, and neglecting the far-away subjects or points would bias the acceptance ratio of the sampler.
   virtual ScalarType ComputeModelLogLikelihood(const LongitudinalDataSetType *const dataSet,
                                                const LinearVariableMapType &popRER,
                                                const LinearVariablesMapType &indRER,
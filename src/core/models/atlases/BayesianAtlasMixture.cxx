@@ -10,6 +10,10 @@
 
 #include "BayesianAtlasMixture.h"
 
+#include <lib/ThreadPool/ThreadPool.h>
+#include <algorithm>
+#include <limits>
+
 
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -19,7 +23,8 @@
 
 template<class ScalarType, unsigned int Dimension>
 BayesianAtlasMixture<ScalarType, Dimension>
-::BayesianAtlasMixture() : Superclass(), m_NumberOfAtlases(1) {
+::BayesianAtlasMixture() : Superclass(), m_NumberOfAtlases(1), m_ResponsibilityThreshold(0.0),
+                           m_PrunedPairsRefreshPeriod(10), m_NumberOfResidualsEvaluations(0) {
   this->SetBayesianAtlasMixtureType();
 
   /// atlas coefficients random effect.
@@ -43,6 +48,9 @@ BayesianAtlasMixture<ScalarType, Dimension>
   for (unsigned int k = 0; k < m_NumberOfAtlases; ++k) {
     m_Atlases[k] = other.m_Atlases[k]->Clone();
   }
+  m_ResponsibilityThreshold = other.m_ResponsibilityThreshold;
+  m_PrunedPairsRefreshPeriod = other.m_PrunedPairsRefreshPeriod;
+  m_NumberOfResidualsEvaluations = 0;
 }
 
 
@@ -80,6 +88,9 @@ BayesianAtlasMixture<ScalarType, Dimension>
 
   /// Mixture-specific fixed effects.
   SetMixtureCoefficientsRandomEffectConcentrationParameters(map.at("ConcentrationParameters"));
+
+  /// The templates may have changed.
+  m_PairResiduals.clear();
 }
 
 
@@ -125,6 +136,7 @@ BayesianAtlasMixture<ScalarType, Dimension>
   /// Mixture-specific initialization.
   InitializeMixtureCoefficientsRandomEffect();
   InitializeMixtureCoefficientsPrior();
+  m_PairResiduals.clear();
 }
 
 template<class ScalarType, unsigned int Dimension>
@@ -155,7 +167,7 @@ BayesianAtlasMixture<ScalarType, Dimension>
   }
 
   std::ostringstream oss;
-  oss << outputDir << this->m_Name << "_MixtureCoefficients.txt" << std::ends;
+  oss << outputDir << this->m_Name << "_MixtureCoefficients" << matrixFileExtension() << std::ends;
   writeMatrixDLM<ScalarType>(oss.str().c_str(), cc);
 }
 
@@ -186,16 +198,10 @@ BayesianAtlasMixture<ScalarType, Dimension>
                    std::vector<std::vector<ScalarType>> &residuals) {
   const std::vector<VectorType> mixtureCoefficients = recast<VectorType>(indRER.at("MixtureCoefficients"));
 
-  std::vector<LinearVariableMapType> atlasPopRERs;
-  std::vector<LinearVariablesMapType> atlasIndRERs;
-  ExtractAtlasInformation(popRER, atlasPopRERs);
-  ExtractAtlasInformation(indRER, atlasIndRERs);
-
   /// Computes the residuals for each atlas.
-  std::vector<std::vector<std::vector<ScalarType>>> atlasResiduals(m_NumberOfAtlases);
-  for (unsigned int k = 0; k < m_NumberOfAtlases; ++k)
-    if (m_Atlases[k]->ComputeResiduals(dataSet, atlasPopRERs[k], atlasIndRERs[k], atlasResiduals[k]))
-      return true;
+  std::vector<std::vector<std::vector<ScalarType>>> atlasResiduals;
+  if (ComputeAtlasResiduals(dataSet, popRER, indRER, atlasResiduals))
+    return true;
 
   /// Initializes the output container.
   const unsigned int nbSubjects = atlasResiduals[0].size();
@@ -316,17 +322,21 @@ BayesianAtlasMixture<ScalarType, Dimension>
   const std::vector<VectorType> mixtureCoefficients = recast<VectorType>(indRER.at("MixtureCoefficients"));
   const unsigned int nbSubjects = indRER.at(indRER.begin()->first).size();
 
-  std::vector<LinearVariableMapType> atlasPopRERs;
-  std::vector<LinearVariablesMapType> atlasIndRERs;
-  ExtractAtlasInformation(popRER, atlasPopRERs);
-  ExtractAtlasInformation(indRER, atlasIndRERs);
+  /// Computes the model log-likelihood for each atlas, as BayesianAtlas::ComputeModelLogLikelihood does.
+  std::vector<std::vector<std::vector<ScalarType>>> atlasResiduals;
+  if (ComputeAtlasResiduals(dataSet, popRER, indRER, atlasResiduals)) {
+    /// Deformations out of the box have a null likelihood.
+    contributions.assign(nbSubjects, -std::numeric_limits<ScalarType>::infinity());
+    return -std::numeric_limits<ScalarType>::infinity();
+  }
 
-  /// Computes the model log-likelihood for each atlas.
   std::vector<std::vector<ScalarType>> atlasModelLogLikelihoodForSubject(m_NumberOfAtlases);
   for (unsigned int k = 0; k < m_NumberOfAtlases; ++k) {
-    atlasModelLogLikelihoodForSubject[k].resize(nbSubjects);
-    m_Atlases[k]->ComputeModelLogLikelihood(dataSet, atlasPopRERs[k], atlasIndRERs[k],
-                                            atlasModelLogLikelihoodForSubject[k]);
+    const VectorType noiseVariances = m_Atlases[k]->GetDataSigmaSquared();
+    atlasModelLogLikelihoodForSubject[k].assign(nbSubjects, 0.0);
+    for (unsigned int i = 0; i < nbSubjects; ++i)
+      for (unsigned int j = 0; j < atlasResiduals[k][i].size(); ++j)
+        atlasModelLogLikelihoodForSubject[k][i] -= 0.5 * atlasResiduals[k][i][j] / noiseVariances(j);
   }
 
   /// Averages over all the atlas models.
@@ -490,6 +500,9 @@ BayesianAtlasMixture<ScalarType, Dimension>
 
   VectorType aux = a_bar + sigmaSquared_a * S0;
   SetMixtureCoefficientsRandomEffectConcentrationParameters(aux);
+
+  /// The templates may have changed.
+  m_PairResiduals.clear();
 }
 
 
@@ -563,6 +576,85 @@ BayesianAtlasMixture<ScalarType, Dimension>
   SetMixtureCoefficientsPriorCovarianceSqrt(diagonal_matrix<ScalarType>(m_NumberOfAtlases, 0.5));
 }
 
+template<class ScalarType, unsigned int Dimension>
+bool
+BayesianAtlasMixture<ScalarType, Dimension>
+::ComputeAtlasResiduals(const LongitudinalDataSetType *const dataSet,
+                        LinearVariableMapType const &popRER,
+                        LinearVariablesMapType const &indRER,
+                        std::vector<std::vector<std::vector<ScalarType>>> &atlasResiduals) {
+  const CrossSectionalDataSetType *const crossSectionalDataSet
+      = static_cast<const CrossSectionalDataSetType *const>(dataSet);
+  std::vector<std::shared_ptr<DeformableMultiObjectType>> targets = crossSectionalDataSet->GetDeformableMultiObjects();
+  const unsigned int nbSubjects = targets.size();
+
+  const std::vector<VectorType> mixtureCoefficients = recast<VectorType>(indRER.at("MixtureCoefficients"));
+
+  std::vector<LinearVariableMapType> atlasPopRERs;
+  std::vector<LinearVariablesMapType> atlasIndRERs;
+  ExtractAtlasInformation(popRER, atlasPopRERs);
+  ExtractAtlasInformation(indRER, atlasIndRERs);
+
+  if (m_PairResiduals.size() != m_NumberOfAtlases)
+    m_PairResiduals.assign(m_NumberOfAtlases, std::vector<PairResiduals>(nbSubjects));
+  const bool refreshPrunedPairs = !(++m_NumberOfResidualsEvaluations % m_PrunedPairsRefreshPeriod);
+
+  /// Lists the subject-atlas pairs whose residuals have to be computed.
+  std::vector<MatrixType> controlPoints(m_NumberOfAtlases);
+  std::vector<std::vector<MatrixType>> momentas(m_NumberOfAtlases);
+  std::vector<std::pair<unsigned int, unsigned int>> pairs;
+  for (unsigned int k = 0; k < m_NumberOfAtlases; ++k) {
+    if (m_Atlases[k]->UseRandomControlPoints())
+      controlPoints[k] = recast<MatrixType>(atlasPopRERs[k].at("ControlPoints"));
+    else
+      controlPoints[k] = m_Atlases[k]->GetControlPoints();
+    momentas[k] = recast<MatrixType>(atlasIndRERs[k].at("Momenta"));
+
+    const std::size_t firstPair = pairs.size();
+    for (unsigned int i = 0; i < nbSubjects; ++i) {
+      PairResiduals const &last = m_PairResiduals[k][i];
+      if (!last.residuals.empty()) {
+        if (last.controlPoints == controlPoints[k] && last.momenta == momentas[k][i]) continue;
+        if (!refreshPrunedPairs && mixtureCoefficients[i][k] < m_ResponsibilityThreshold) continue;
+      }
+      pairs.push_back(std::make_pair(k, i));
+    }
+    if (pairs.size() > firstPair) m_Atlases[k]->UpdateDeformationAndKernelDataDomain(targets);
+  }
+
+  /// Computes them concurrently.
+  std::vector<std::vector<ScalarType>> residuals(pairs.size());
+  std::vector<char> outOfBox(pairs.size(), 0);
+  std::vector<std::future<void>> futures;
+  {
+    ThreadPool pool(def::utils::settings.number_of_threads);
+    for (std::size_t p = 0; p < pairs.size(); ++p) {
+      futures.push_back(pool.enqueue([&, p]() {
+        const unsigned int k = pairs[p].first, i = pairs[p].second;
+        outOfBox[p] = m_Atlases[k]->ComputeResidualsSubject(controlPoints[k], momentas[k][i], targets[i], residuals[p]);
+      }));
+    }
+  }
+  for (auto &f : futures) f.get();
+
+  if (std::find(outOfBox.begin(), outOfBox.end(), 1) != outOfBox.end())
+    return true;
+
+  for (std::size_t p = 0; p < pairs.size(); ++p) {
+    PairResiduals &last = m_PairResiduals[pairs[p].first][pairs[p].second];
+    last.controlPoints = controlPoints[pairs[p].first];
+    last.momenta = momentas[pairs[p].first][pairs[p].second];
+    last.residuals = residuals[p];
+  }
+
+  atlasResiduals.assign(m_NumberOfAtlases, std::vector<std::vector<ScalarType>>(nbSubjects));
+  for (unsigned int k = 0; k < m_NumberOfAtlases; ++k)
+    for (unsigned int i = 0; i < nbSubjects; ++i)
+      atlasResiduals[k][i] = m_PairResiduals[k][i].residuals;
+
+  return false;
+}
+
 template<class ScalarType, unsigned int Dimension>
 void
 BayesianAtlasMixture<ScalarType, Dimension>
@@ -94,8 +94,15 @@ class BayesianAtlasMixture : public AbstractStatisticalModel<ScalarType, Dimensi
   void SetAtlases(const std::vector<std::shared_ptr<BayesianAtlasType>> atlases) {
     m_Atlases = atlases;
     m_NumberOfAtlases = atlases.size();
+    m_PairResiduals.clear();
   }
 
+  /// Sets the mixture coefficient under which the residuals of a subject for an atlas are not recomputed, their last
+  /// value being used instead. The default zero value disables this pruning.
+  void SetResponsibilityThreshold(ScalarType const &threshold) { m_ResponsibilityThreshold = threshold; }
+  /// Sets the number of residuals evaluations between two refreshes of the pruned subject-atlas pairs.
+  void SetPrunedPairsRefreshPeriod(unsigned int const &n) { m_PrunedPairsRefreshPeriod = std::max(n, 1u); }
+
   /// Gets the atlas coefficients concentration paramters fixed effect.
   VectorType GetConcentrationParameters() const {
     return this->m_FixedEffects.at("ConcentrationParameters").vectorize();
@@ -245,6 +252,14 @@ class BayesianAtlasMixture : public AbstractStatisticalModel<ScalarType, Dimensi
   /// Initializes the prior on the atlas coefficients.
   void InitializeMixtureCoefficientsPrior();
 
+  /// Computes the residuals of each atlas (first index) for each subject (second index). The residuals of a pair are
+  /// only recomputed if its control points or momenta changed, and those of the pairs of negligible responsibility
+  /// only every m_PrunedPairsRefreshPeriod calls. The pairs of all the atlases are evaluated concurrently.
+  bool ComputeAtlasResiduals(const LongitudinalDataSetType *const dataSet,
+                             LinearVariableMapType const &popRER,
+                             LinearVariablesMapType const &indRER,
+                             std::vector<std::vector<std::vector<ScalarType>>> &atlasResiduals);
+
   /// Extracts the map components relevant to the atlases of the mixture.
   void ExtractAtlasInformation(LinearVariableMapType const &map,
                                std::vector<LinearVariableMapType> &out) const;
@@ -272,6 +287,22 @@ class BayesianAtlasMixture : public AbstractStatisticalModel<ScalarType, Dimensi
   /// Number of atlases.
   unsigned int m_NumberOfAtlases;
 
+  /// Residuals of a subject for an atlas, with the control points and the momenta they were computed with.
+  struct PairResiduals {
+    MatrixType controlPoints;
+    MatrixType momenta;
+    std::vector<ScalarType> residuals;
+  };
+  /// Last residuals of each atlas (first index) for each subject (second index). Cleared with the fixed effects.
+  std::vector<std::vector<PairResiduals>> m_PairResiduals;
+
+  /// Mixture coefficient under which the residuals of a subject for an atlas are not recomputed.
+  ScalarType m_ResponsibilityThreshold;
+  /// Number of residuals evaluations between two refreshes of the pruned pairs.
+  unsigned int m_PrunedPairsRefreshPeriod;
+  /// Number of residuals evaluations so far.
+  unsigned int m_NumberOfResidualsEvaluations;
+
 }; /* class BayesianAtlasMixture */
 
 
@@ -10,6 +10,8 @@
 
 #include "DeterministicAtlas.h"
 
+#include "KernelMatrixCache.h"
+
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 // Constructor(s) / Destructor :
@@ -132,10 +134,14 @@ DeterministicAtlas<ScalarType, Dimension>
     std::shared_ptr<KernelType> momKernelObj = kfac->CreateKernelObject(this->m_Def->GetKernelType());
     momKernelObj->SetKernelWidth(this->m_Def->GetKernelWidth());
     momKernelObj->SetSources(controlPoints);
+    /// Frozen control points : the convolutions are products with their kernel matrix, computed once.
+    if (this->m_FreezeControlPointsFlag)
+      momKernelObj->SetSourcesKernelMatrix(KernelMatrixCache<ScalarType, Dimension>::instance()->Get(
+          this->m_Def->GetKernelType(), this->m_Def->GetKernelWidth(), controlPoints));
 
     for (unsigned int s = 0; s < nbSubjects; s++) {
       momKernelObj->SetWeights(momentas[s]);
-      MatrixType kMom = momKernelObj->Convolve(controlPoints);
+      MatrixType kMom = momKernelObj->ConvolveAtSources();
 
       for (unsigned int i = 0; i < controlPoints.rows(); i++)
         logLikelihoodTerms[1] -= dot_product(kMom.get_row(i), momentas[s].get_row(i));
@@ -262,10 +268,13 @@ DeterministicAtlas<ScalarType, Dimension>
     std::shared_ptr<KernelType> momKernelObj = kfac->CreateKernelObject(this->m_Def->GetKernelType());
     momKernelObj->SetKernelWidth(this->m_Def->GetKernelWidth());
     momKernelObj->SetSources(controlPoints);
+    if (this->m_FreezeControlPointsFlag)
+      momKernelObj->SetSourcesKernelMatrix(KernelMatrixCache<ScalarType, Dimension>::instance()->Get(
+          this->m_Def->GetKernelType(), this->m_Def->GetKernelWidth(), controlPoints));
 
     for (unsigned int s = 0; s < numSubjects; s++) {
       momKernelObj->SetWeights(momentas[s]);
-      GradMom[s] -= momKernelObj->Convolve(controlPoints);
+      GradMom[s] -= momKernelObj->ConvolveAtSources();
 
       GradPos -= momKernelObj->ConvolveGradient(controlPoints, momentas[s]);
     }
@@ -887,16 +887,16 @@ LdaAtlas<ScalarType, Dimension>
   if (m_NumberOfClasses > 1) {
     const MatrixType F = GetF();
     const MatrixListType alpha = recast<MatrixListType>(this->m_FixedEffects["alpha"]);
-    writeMatrixDLM<ScalarType>(outputDir+"F.txt", F);
-    writeMultipleMatrixDLM<ScalarType>(outputDir+"alpha.txt", alpha);
+    writeMatrixDLM<ScalarType>(outputDir + "F" + matrixFileExtension(), F);
+    writeMultipleMatrixDLM<ScalarType>(outputDir + "alpha" + matrixFileExtension(), alpha);
   }
 
-  writeMatrixDLM<ScalarType>(outputDir+"G.txt", G);
-  writeMultipleMatrixDLM<ScalarType>(outputDir+"betas.txt", beta);
+  writeMatrixDLM<ScalarType>(outputDir + "G" + matrixFileExtension(), G);
+  writeMultipleMatrixDLM<ScalarType>(outputDir + "betas" + matrixFileExtension(), beta);
 
   ///Writing the gammas
   MatrixType gamma = MatrixType(GetGamma());
-  writeMatrixDLM<ScalarType>(outputDir+"gamma.txt", gamma);
+  writeMatrixDLM<ScalarType>(outputDir + "gamma" + matrixFileExtension(), gamma);
 
 
   ///Need to write : les objets reconstitués (toute la séquence ?)
@@ -910,12 +910,12 @@ LdaAtlas<ScalarType, Dimension>
 
     /// Write control points.
   std::ostringstream oss1;
-  oss1 << outputDir << "Atlas_ControlPoints.txt" << std::ends;
+  oss1 << outputDir << "Atlas_ControlPoints" << matrixFileExtension() << std::ends;
   writeMatrixDLM<ScalarType>(oss1.str().c_str(), this->GetControlPoints());
 
   /// Write initial momentas.
   std::ostringstream oss2;
-  oss2 << outputDir << "Atlas_Momentas.txt" << std::ends;
+  oss2 << outputDir << "Atlas_Momentas" << matrixFileExtension() << std::ends;
   writeMultipleMatrixDLM<ScalarType>(oss2.str().c_str(), momentas);
 
 }
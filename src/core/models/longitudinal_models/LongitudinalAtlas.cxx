@@ -9,6 +9,7 @@
  ****************************************************************************************/
 
 #include "LongitudinalAtlas.h"
+#include "GridFunctions.h"
 
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -20,8 +21,11 @@ LongitudinalAtlas<ScalarType, Dimension>
 ::LongitudinalAtlas() : Superclass(),
                         m_Template(NULL),
                         m_Def(NULL),
+                        m_OptimizeInitialControlPoints(false),
                         m_ForwardReferenceGeodesic(NULL),
-                        m_BackwardReferenceGeodesic(NULL) {
+                        m_BackwardReferenceGeodesic(NULL),
+                        m_AbsoluteTimeIncrementsModified(false),
+                        m_PopulationStateModified(true) {
   Superclass::SetLongitudinalAtlasType();
 
   /// Fixed effects.
@@ -100,6 +104,7 @@ LongitudinalAtlas<ScalarType, Dimension>
   m_NumberOfSources = other.m_NumberOfSources;
 
   m_CPSpacing = other.m_CPSpacing;
+  m_OptimizeInitialControlPoints = other.m_OptimizeInitialControlPoints;
   m_FreezeControlPointsFlag = other.m_FreezeControlPointsFlag;
   m_FrozenControlPoints = other.m_FrozenControlPoints;
 
@@ -117,6 +122,9 @@ LongitudinalAtlas<ScalarType, Dimension>
 
   m_ProjectedModulationMatrix = other.m_ProjectedModulationMatrix;
   m_ProjectedModulationMatrix_Memory = other.m_ProjectedModulationMatrix_Memory;
+
+  m_AbsoluteTimeIncrementsModified = other.m_AbsoluteTimeIncrementsModified;
+  m_PopulationStateModified = other.m_PopulationStateModified;
 }
 
 
@@ -330,32 +338,19 @@ LongitudinalAtlas<ScalarType, Dimension>
     }
   }
 
-  /// For each subject, transport along the reference geodesic and then shoot at the target time-points.
+  /// Transport of all the subjects space shifts at once, along the reference geodesic.
+  std::vector<MatrixType> spaceShifts(numberOfSubjects);
+  for (unsigned int i = 0; i < numberOfSubjects; ++i) {
+    spaceShifts[i] = (projectedModulationMatrixRER * sourcesRERs[i]).unvectorize(m_NumberOfControlPoints, Dimension);
+  }
+  const std::vector<MatrixListType> allTransportedSpaceShifts
+      = DiffeosType::ParallelTransport(backwardDef, forwardDef, spaceShifts, absoluteTimeIncrements);
+
+  /// For each subject, shoot at the target time-points.
   std::vector<std::vector<std::shared_ptr<DeformableMultiObjectType >>> samples(numberOfSubjects);
   for (unsigned int i = 0; i < numberOfSubjects; ++i) {
     const unsigned int nbObservations_i = absoluteTimeIncrements[i].size();
-
-    /// Transport.
-    MatrixType spaceShift = (projectedModulationMatrixRER * sourcesRERs[i])
-        .unvectorize(m_NumberOfControlPoints, Dimension);
-
-    // Divide the target absolute times into backward and forward targets.
-    std::vector<ScalarType> forwardabsoluteTimeIncrements, backwardabsoluteTimeIncrements;
-    for (unsigned int t = 0; t < nbObservations_i; ++t) {
-      if (absoluteTimeIncrements[i][t] < 0.0) {
-        backwardabsoluteTimeIncrements.push_back(-absoluteTimeIncrements[i][t]);
-      } else { forwardabsoluteTimeIncrements.push_back(absoluteTimeIncrements[i][t]); }
-    }
-    std::reverse(backwardabsoluteTimeIncrements.begin(), backwardabsoluteTimeIncrements.end());
-
-    // Perform the transport.
-    MatrixListType backwardTransportedSpaceShifts = backwardDef->ParallelTransport(
-        spaceShift, backwardabsoluteTimeIncrements).reverse();
-    MatrixListType forwardTransportedSpaceShifts = forwardDef->ParallelTransport(
-        spaceShift, forwardabsoluteTimeIncrements);
-
-    // Concatenate the results.
-    MatrixListType transportedSpaceShifts = concatenate(backwardTransportedSpaceShifts, forwardTransportedSpaceShifts);
+    const MatrixListType &transportedSpaceShifts = allTransportedSpaceShifts[i];
     assert(transportedSpaceShifts.size() == nbObservations_i);
 
     /// Exponentiation.
@@ -372,13 +367,13 @@ LongitudinalAtlas<ScalarType, Dimension>
         ScalarType continuousIndex = absoluteTimeIncrements[i][t] / forwardStepSize;
         unsigned int index = continuousIndex;
         if ((continuousIndex - index) >= 0.5) { ++index; }
-        referenceShape = forwardDef->GetDeformedObjectAt(index);
+        referenceShape = forwardDef->GetSharedDeformedObjectAt(index);
         referenceControlPoints = forwardDef->GetDeformedControlPointsAt(index);
       } else {
         ScalarType continuousIndex = -absoluteTimeIncrements[i][t] / backwardStepSize;
         unsigned int index = continuousIndex;
         if ((continuousIndex - index) >= 0.5) { ++index; }
-        referenceShape = backwardDef->GetDeformedObjectAt(index);
+        referenceShape = backwardDef->GetSharedDeformedObjectAt(index);
         referenceControlPoints = backwardDef->GetDeformedControlPointsAt(index);
       }
 
@@ -424,54 +419,38 @@ LongitudinalAtlas<ScalarType, Dimension>
       targets = dataSet->GetDeformableMultiObjects();
   const std::vector<VectorType> sourcesRERs = recast<VectorType>(indRER.at("Sources"));
 
-  /// For each subject, transport along the reference geodesic and then shoot at the target time-points.
+  /// Transport of all the subjects space shifts at once, along the reference geodesic.
+  std::vector<MatrixType> spaceShifts(numberOfSubjects);
+  for (unsigned int i = 0; i < numberOfSubjects; ++i) {
+    spaceShifts[i] = (m_ProjectedModulationMatrix * sourcesRERs[i]).unvectorize(m_NumberOfControlPoints, Dimension);
+  }
+  const std::vector<MatrixListType> allTransportedSpaceShifts = DiffeosType::ParallelTransport(
+      m_BackwardReferenceGeodesic, m_ForwardReferenceGeodesic, spaceShifts, m_AbsoluteTimeIncrements);
+
+  /// Memorize the current state.
+  m_Exponentiations_Memory = m_Exponentiations;
+  m_Exponentiations.resize(numberOfSubjects);
+
+  /// For each subject, shoot at the target time-points.
   residuals.resize(numberOfSubjects);
   {
     ThreadPool pool(def::utils::settings.number_of_threads);
     for (unsigned int i = 0; i < numberOfSubjects; ++i) {
       pool.enqueue([&, i]() {
         const unsigned int nbObservations_i = m_AbsoluteTimeIncrements[i].size();
-
-        /// Transport.
-        MatrixType spaceShift = (m_ProjectedModulationMatrix * sourcesRERs[i])
-            .unvectorize(m_NumberOfControlPoints, Dimension);
-
-        // Divide the target absolute times into backward and forward targets.
-        std::vector<ScalarType> forwardabsoluteTimeIncrements, backwardabsoluteTimeIncrements;
-        for (unsigned int t = 0; t < nbObservations_i; ++t) {
-          if (m_AbsoluteTimeIncrements[i][t] < 0.0) {
-            backwardabsoluteTimeIncrements.push_back(-m_AbsoluteTimeIncrements[i][t]);
-          } else { forwardabsoluteTimeIncrements.push_back(m_AbsoluteTimeIncrements[i][t]); }
-        }
-        std::reverse(backwardabsoluteTimeIncrements.begin(), backwardabsoluteTimeIncrements.end());
-
-        // Perform the transport.
-        MatrixListType backwardTransportedSpaceShifts = m_BackwardReferenceGeodesic->ParallelTransport(
-            spaceShift, backwardabsoluteTimeIncrements).reverse();
-        MatrixListType forwardTransportedSpaceShifts = m_ForwardReferenceGeodesic->ParallelTransport(
-            spaceShift, forwardabsoluteTimeIncrements);
-
-        // Concatenate the results.
-        MatrixListType
-            transportedSpaceShifts = concatenate(backwardTransportedSpaceShifts, forwardTransportedSpaceShifts);
-        assert(transportedSpaceShifts.size() == nbObservations_i);
+        const MatrixListType &transportedSpaceShifts = allTransportedSpaceShifts[i];
 
         /// Exponentiation.
         residuals[i].resize(nbObservations_i);
+        m_Exponentiations[i].resize(nbObservations_i);
         for (unsigned int t = 0; t < nbObservations_i; ++t) {
           std::shared_ptr<DeformableMultiObjectType> referenceShape;
           MatrixType referenceControlPoints;
           GetDeformedObjectAndControlPointsAt(m_AbsoluteTimeIncrements[i][t], referenceShape, referenceControlPoints);
 
-          std::shared_ptr<DiffeosType> expDef = m_Def->Clone();
-          expDef->SetNumberOfTimePoints(m_NumberOfTimePointsForExponentiation);
-          expDef->SetDeformableMultiObject(referenceShape);
-          expDef->SetStartPositions(referenceControlPoints);
-          expDef->SetStartMomentas(transportedSpaceShifts[t]);
-          expDef->Update();
-
-          std::shared_ptr<DeformableMultiObjectType> predictedShape = expDef->GetDeformedObject();
-          residuals[i][t] = predictedShape->ComputeMatch(targets[i][t]);
+          residuals[i][t] = ComputeExponentiationResidual(referenceShape, referenceControlPoints,
+                                                          transportedSpaceShifts[t], targets[i][t],
+                                                          m_Exponentiations[i][t]);
         }
       });
     }
@@ -575,8 +554,10 @@ LongitudinalAtlas<ScalarType, Dimension>
                             const std::string &modifiedVar,
                             std::vector<ScalarType> &contributions) {
   /// Update the relevant memorized intermediate variables based on the random effects realizations.
-  if (modifiedVar == "TemplateData") { // NOTE : ONLY FLOW() IS ACTUALLY NECESSARY. TODO.
-    UpdateReferenceGeodesic(popRER);
+  m_AbsoluteTimeIncrementsModified = false;
+  m_PopulationStateModified = true;
+  if (modifiedVar == "TemplateData") {
+    UpdateReferenceGeodesicTemplate(popRER);
   } else if (!m_FreezeControlPointsFlag and modifiedVar == "ControlPoints") {
     UpdateReferenceGeodesic(popRER);
     UpdateProjectedModulationMatrix(popRER);
@@ -586,8 +567,11 @@ LongitudinalAtlas<ScalarType, Dimension>
   } else if (modifiedVar == "ModulationMatrix") {
     UpdateProjectedModulationMatrix(popRER);
   } else if (modifiedVar == "Sources") {
+    m_PopulationStateModified = false;
   } else if (modifiedVar == "TimeShift" || modifiedVar == "LogAcceleration") {
     UpdateAbsoluteTimeIncrements(dataSet, popRER, indRER);
+    m_AbsoluteTimeIncrementsModified = true;
+    m_PopulationStateModified = false;
 
     // Memorize the current state. Necessary if the geodesic has been updated at the previous call.
     *m_ForwardReferenceGeodesic_Memory = *m_ForwardReferenceGeodesic;
@@ -598,11 +582,13 @@ LongitudinalAtlas<ScalarType, Dimension>
         (m_MaximumAbsoluteTimeIncrement > 0.0 &&
             m_MaximumAbsoluteTimeIncrement > m_ForwardReferenceGeodesic->GetTN())) {
       UpdateReferenceGeodesic(popRER); // SHOULD ONLY BE EXTENDED. TODO.
+      m_PopulationStateModified = true;
     }
   } else {
     UpdateAbsoluteTimeIncrements(dataSet, popRER, indRER);
     UpdateReferenceGeodesic(popRER);
     UpdateProjectedModulationMatrix(popRER);
+    m_AbsoluteTimeIncrementsModified = true;
   }
 
   /// Data (residuals) term.
@@ -826,6 +812,34 @@ LongitudinalAtlas<ScalarType, Dimension>
   *m_BackwardReferenceGeodesic = *m_BackwardReferenceGeodesic_Memory;
 
   m_ProjectedModulationMatrix = m_ProjectedModulationMatrix_Memory;
+
+  m_Exponentiations = m_Exponentiations_Memory;
+}
+
+template<class ScalarType, unsigned int Dimension>
+void
+LongitudinalAtlas<ScalarType, Dimension>
+::RecoverMemorizedState(std::vector<bool> const &rejectedSubjects) {
+  /// The population-wide state is shared by all the subjects : the accepted ones cannot keep it alone.
+  if (m_PopulationStateModified || m_Exponentiations_Memory.size() != rejectedSubjects.size()) {
+    RecoverMemorizedState();
+    return;
+  }
+
+  for (unsigned int i = 0; i < rejectedSubjects.size(); ++i) {
+    if (!rejectedSubjects[i]) continue;
+    m_Exponentiations[i] = m_Exponentiations_Memory[i];
+    if (m_AbsoluteTimeIncrementsModified) { m_AbsoluteTimeIncrements[i] = m_AbsoluteTimeIncrements_Memory[i]; }
+  }
+
+  if (m_AbsoluteTimeIncrementsModified) {
+    m_MinimumAbsoluteTimeIncrement = 0.0;
+    m_MaximumAbsoluteTimeIncrement = 0.0;
+    for (unsigned int i = 0; i < m_AbsoluteTimeIncrements.size(); ++i) {
+      m_MinimumAbsoluteTimeIncrement = std::min(m_MinimumAbsoluteTimeIncrement, m_AbsoluteTimeIncrements[i].front());
+      m_MaximumAbsoluteTimeIncrement = std::max(m_MaximumAbsoluteTimeIncrement, m_AbsoluteTimeIncrements[i].back());
+    }
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -960,8 +974,8 @@ LongitudinalAtlas<ScalarType, Dimension>
           oss1 << "-";
           oss2 << "-";
         }
-        oss1 << floor << "." << decimals << ".txt" << std::ends;
-        oss2 << floor << "." << decimals << ".txt" << std::ends;
+        oss1 << floor << "." << decimals << matrixFileExtension() << std::ends;
+        oss2 << floor << "." << decimals << matrixFileExtension() << std::ends;
         writeMatrixDLM<ScalarType>(oss1.str().c_str(), forwardPositions[t]);
         writeMatrixDLM<ScalarType>(oss2.str().c_str(), forwardMomentas[t]);
       }
@@ -1001,8 +1015,8 @@ LongitudinalAtlas<ScalarType, Dimension>
         oss1 << "-";
         oss2 << "-";
       }
-      oss1 << floor << "." << decimals << ".txt" << std::ends;
-      oss2 << floor << "." << decimals << ".txt" << std::ends;
+      oss1 << floor << "." << decimals << matrixFileExtension() << std::ends;
+      oss2 << floor << "." << decimals << matrixFileExtension() << std::ends;
       writeMatrixDLM<ScalarType>(oss1.str().c_str(), backwardPositions[t]);
       writeMatrixDLM<ScalarType>(oss2.str().c_str(), backwardMomenta[t]);
     }
@@ -1037,35 +1051,22 @@ LongitudinalAtlas<ScalarType, Dimension>
 
   /// Write the projected modulation matrix.
   std::ostringstream oss;
-  oss << outputDir << Superclass::m_Name << "__Parameters__ProjectedModulationMatrix.txt" << std::ends;
+  oss << outputDir << Superclass::m_Name << "__Parameters__ProjectedModulationMatrix" << matrixFileExtension()
+      << std::ends;
   writeMatrixDLM<ScalarType>(oss.str().c_str(), projectedModulationMatrix);
 
   /// Compute and write the model-based reconstruction of the observations.
   const std::vector<std::string> subjectIds = dataSet->GetSubjectIds();
+  std::vector<MatrixType> spaceShifts(numberOfSubjects);
   for (unsigned int i = 0; i < numberOfSubjects; ++i) {
-    const unsigned int nbObservations_i = absoluteTimeIncrements[i].size();
-
-    // Transport.
-    MatrixType spaceShift = (projectedModulationMatrix * sourcesRERs[i])
-        .unvectorize(m_NumberOfControlPoints, Dimension);
-
-    // Divide the target absolute times into backward and forward targets.
-    std::vector<ScalarType> forwardabsoluteTimeIncrements, backwardabsoluteTimeIncrements;
-    for (unsigned int t = 0; t < nbObservations_i; ++t) {
-      if (absoluteTimeIncrements[i][t] < 0.0) {
-        backwardabsoluteTimeIncrements.push_back(-absoluteTimeIncrements[i][t]);
-      } else { forwardabsoluteTimeIncrements.push_back(absoluteTimeIncrements[i][t]); }
-    }
-    std::reverse(backwardabsoluteTimeIncrements.begin(), backwardabsoluteTimeIncrements.end());
-
-    // Perform the transport.
-    MatrixListType backwardTransportedSpaceShifts = backwardDef->ParallelTransport(
-        spaceShift, backwardabsoluteTimeIncrements).reverse();
-    MatrixListType forwardTransportedSpaceShifts = forwardDef->ParallelTransport(
-        spaceShift, forwardabsoluteTimeIncrements);
+    spaceShifts[i] = (projectedModulationMatrix * sourcesRERs[i]).unvectorize(m_NumberOfControlPoints, Dimension);
+  }
+  const std::vector<MatrixListType> allTransportedSpaceShifts
+      = DiffeosType::ParallelTransport(backwardDef, forwardDef, spaceShifts, absoluteTimeIncrements);
 
-    // Concatenate the results.
-    MatrixListType transportedSpaceShifts = concatenate(backwardTransportedSpaceShifts, forwardTransportedSpaceShifts);
+  for (unsigned int i = 0; i < numberOfSubjects; ++i) {
+    const unsigned int nbObservations_i = absoluteTimeIncrements[i].size();
+    const MatrixListType &transportedSpaceShifts = allTransportedSpaceShifts[i];
     assert(transportedSpaceShifts.size() == nbObservations_i);
 
     // Exponentiation.
@@ -1078,13 +1079,13 @@ LongitudinalAtlas<ScalarType, Dimension>
         ScalarType continuousIndex = absoluteTimeIncrements[i][t] / forwardStepSize;
         unsigned int index = continuousIndex;
         if ((continuousIndex - index) >= 0.5) { ++index; }
-        referenceShape = forwardDef->GetDeformedObjectAt(index);
+        referenceShape = forwardDef->GetSharedDeformedObjectAt(index);
         referenceControlPoints = forwardDef->GetDeformedControlPointsAt(index);
       } else {
         ScalarType continuousIndex = -absoluteTimeIncrements[i][t] / backwardStepSize;
         unsigned int index = continuousIndex;
         if ((continuousIndex - index) >= 0.5) { ++index; }
-        referenceShape = backwardDef->GetDeformedObjectAt(index);
+        referenceShape = backwardDef->GetSharedDeformedObjectAt(index);
         referenceControlPoints = backwardDef->GetDeformedControlPointsAt(index);
       }
 
@@ -1146,11 +1147,11 @@ LongitudinalAtlas<ScalarType, Dimension>
       ScalarType time;
 
       if (t < clampedBackwardNumberOfTimePoints - 1) {
-        referenceShape = backwardDef->GetDeformedObjectAt(clampedBackwardNumberOfTimePoints - t - 1);
+        referenceShape = backwardDef->GetSharedDeformedObjectAt(clampedBackwardNumberOfTimePoints - t - 1);
         referenceControlPoints = backwardDef->GetDeformedControlPointsAt(clampedBackwardNumberOfTimePoints - t - 1);
         time = referenceTime - backwardDef->GetTN() + t * backwardStepSize;
       } else {
-        referenceShape = forwardDef->GetDeformedObjectAt(t - clampedBackwardNumberOfTimePoints + 1);
+        referenceShape = forwardDef->GetSharedDeformedObjectAt(t - clampedBackwardNumberOfTimePoints + 1);
         referenceControlPoints = forwardDef->GetDeformedControlPointsAt(t - clampedBackwardNumberOfTimePoints + 1);
         time = referenceTime + (t - clampedBackwardNumberOfTimePoints + 1) * forwardStepSize;
       }
@@ -1190,7 +1191,7 @@ LongitudinalAtlas<ScalarType, Dimension>
         oss << "__IndependentComponent_" << i;
         oss << "__TransportedMomenta__tp_" << t << "__age_";
         if (time < 0) { oss << "-"; }
-        oss << floor << "." << decimals << ".txt" << std::ends;
+        oss << floor << "." << decimals << matrixFileExtension() << std::ends;
         writeMatrixDLM<ScalarType>(oss.str().c_str(), transportedSpaceShifts[t]);
       }
     }
@@ -1216,60 +1217,60 @@ LongitudinalAtlas<ScalarType, Dimension>
 
   // Write template data.
   std::ostringstream oss1;
-  oss1 << outputDir << Superclass::m_Name << "__Parameters__TemplateData.txt" << std::ends;
+  oss1 << outputDir << Superclass::m_Name << "__Parameters__TemplateData" << matrixFileExtension() << std::ends;
   writeMultipleMatrixDLM<ScalarType>(oss1.str().c_str(), GetTemplateData());
 
   // Write control points.
   std::ostringstream oss2;
-  oss2 << outputDir << Superclass::m_Name << "__Parameters__ControlPoints.txt" << std::ends;
+  oss2 << outputDir << Superclass::m_Name << "__Parameters__ControlPoints" << matrixFileExtension() << std::ends;
   writeMatrixDLM<ScalarType>(oss2.str().c_str(), GetControlPoints());
 
   // Write momenta.
   std::ostringstream oss3;
-  oss3 << outputDir << Superclass::m_Name << "__Parameters__Momenta.txt" << std::ends;
+  oss3 << outputDir << Superclass::m_Name << "__Parameters__Momenta" << matrixFileExtension() << std::ends;
   writeMatrixDLM<ScalarType>(oss3.str().c_str(), GetMomenta());
 
   // Write modulation matrix.
   std::ostringstream oss4;
-  oss4 << outputDir << Superclass::m_Name << "__Parameters__ModulationMatrix.txt" << std::ends;
+  oss4 << outputDir << Superclass::m_Name << "__Parameters__ModulationMatrix" << matrixFileExtension() << std::ends;
   writeMatrixDLM<ScalarType>(oss4.str().c_str(), GetModulationMatrix());
 
   // Write reference time.
   std::ostringstream oss5;
-  oss5 << outputDir << Superclass::m_Name << "__Parameters__ReferenceTime.txt" << std::ends;
+  oss5 << outputDir << Superclass::m_Name << "__Parameters__ReferenceTime" << matrixFileExtension() << std::ends;
   writeMatrixDLM<ScalarType>(oss5.str().c_str(), MatrixType(1, 1, GetReferenceTime()));
 
   // Write time-shift standard deviation.
   std::ostringstream oss6;
-  oss6 << outputDir << Superclass::m_Name << "__Parameters__TimeShiftStd.txt" << std::ends;
+  oss6 << outputDir << Superclass::m_Name << "__Parameters__TimeShiftStd" << matrixFileExtension() << std::ends;
   writeMatrixDLM<ScalarType>(oss6.str().c_str(), MatrixType(1, 1, std::sqrt(GetTimeShiftVariance())));
 
   // Write log-acceleration standard deviation.
   std::ostringstream oss7;
-  oss7 << outputDir << Superclass::m_Name << "__Parameters__LogAccelerationStd.txt" << std::ends;
+  oss7 << outputDir << Superclass::m_Name << "__Parameters__LogAccelerationStd" << matrixFileExtension() << std::ends;
   writeMatrixDLM<ScalarType>(oss7.str().c_str(), MatrixType(1, 1, std::sqrt(GetLogAccelerationVariance())));
 
   // Write noise standard deviation.
   std::ostringstream oss8;
-  oss8 << outputDir << Superclass::m_Name << "__Parameters__NoiseStd.txt" << std::ends;
+  oss8 << outputDir << Superclass::m_Name << "__Parameters__NoiseStd" << matrixFileExtension() << std::ends;
   writeMatrixDLM<ScalarType>(oss8.str().c_str(), MatrixType(GetNoiseVariance().sqrt()));
 
   // Write sources.
   MatrixType sourcesRERs = recast<VectorType>(indRER.at("Sources"));
   std::ostringstream oss9;
-  oss9 << outputDir << Superclass::m_Name << "__Parameters__Sources.txt" << std::ends;
+  oss9 << outputDir << Superclass::m_Name << "__Parameters__Sources" << matrixFileExtension() << std::ends;
   writeMatrixDLM<ScalarType>(oss9.str().c_str(), sourcesRERs);
 
   // Write log-acceleration factors.
   MatrixType logAccelerationRERs = recast<ScalarType>(indRER.at("LogAcceleration"));
   std::ostringstream oss10;
-  oss10 << outputDir << Superclass::m_Name << "__Parameters__LogAccelerations.txt" << std::ends;
+  oss10 << outputDir << Superclass::m_Name << "__Parameters__LogAccelerations" << matrixFileExtension() << std::ends;
   writeMatrixDLM<ScalarType>(oss10.str().c_str(), logAccelerationRERs);
 
   // Write log-acceleration factors.
   MatrixType timeShiftRERs = recast<ScalarType>(indRER.at("TimeShift"));
   std::ostringstream oss11;
-  oss11 << outputDir << Superclass::m_Name << "__Parameters__TimeShifts.txt" << std::ends;
+  oss11 << outputDir << Superclass::m_Name << "__Parameters__TimeShifts" << matrixFileExtension() << std::ends;
   writeMatrixDLM<ScalarType>(oss11.str().c_str(), timeShiftRERs);
 }
 
@@ -1290,24 +1291,9 @@ LongitudinalAtlas<ScalarType, Dimension>
   /// For the chosen subject, transport along the reference geodesic and then shoot at the target time-points.
   /// Transport.
   MatrixType spaceShift = (m_ProjectedModulationMatrix * sourcesRER).unvectorize(m_NumberOfControlPoints, Dimension);
-
-  // Divide the target absolute times into backward and forward targets.
-  std::vector<ScalarType> forwardabsoluteTimeIncrements, backwardabsoluteTimeIncrements;
-  for (unsigned int t = 0; t < nbObservations_i; ++t) {
-    if (m_AbsoluteTimeIncrements[i][t] < 0.0) {
-      backwardabsoluteTimeIncrements.push_back(-m_AbsoluteTimeIncrements[i][t]);
-    } else { forwardabsoluteTimeIncrements.push_back(m_AbsoluteTimeIncrements[i][t]); }
-  }
-  std::reverse(backwardabsoluteTimeIncrements.begin(), backwardabsoluteTimeIncrements.end());
-
-  // Perform the transport.
-  MatrixListType backwardTransportedSpaceShifts = m_BackwardReferenceGeodesic->ParallelTransport(
-      spaceShift, backwardabsoluteTimeIncrements).reverse();
-  MatrixListType forwardTransportedSpaceShifts = m_ForwardReferenceGeodesic->ParallelTransport(
-      spaceShift, forwardabsoluteTimeIncrements);
-
-  // Concatenate the results.
-  MatrixListType transportedSpaceShifts = concatenate(backwardTransportedSpaceShifts, forwardTransportedSpaceShifts);
+  const MatrixListType transportedSpaceShifts = DiffeosType::ParallelTransport(
+      m_BackwardReferenceGeodesic, m_ForwardReferenceGeodesic,
+      std::vector<MatrixType>(1, spaceShift), std::vector<std::vector<ScalarType>>(1, m_AbsoluteTimeIncrements[i]))[0];
   assert(transportedSpaceShifts.size() == nbObservations_i);
 
   /// Exponentiation.
@@ -1471,6 +1457,55 @@ LongitudinalAtlas<ScalarType, Dimension>
   }
 }
 
+template<class ScalarType, unsigned int Dimension>
+void
+LongitudinalAtlas<ScalarType, Dimension>
+::UpdateReferenceGeodesicTemplate(const LinearVariableMapType &popRER) {
+  /// Memorize the current state.
+  *m_ForwardReferenceGeodesic_Memory = *m_ForwardReferenceGeodesic;
+  *m_BackwardReferenceGeodesic_Memory = *m_BackwardReferenceGeodesic;
+
+  /// Extract the needed population random effects realizations (RER).
+  const MatrixListType templateDataRER = recast<MatrixListType>(popRER.at("TemplateData"));
+  const std::shared_ptr<DeformableMultiObjectType> templateRER = m_Template->Clone();
+  templateRER->UpdateImageIntensityAndLandmarkPointCoordinates(templateDataRER);
+  templateRER->Update();
+
+  /// The control points and momenta are unchanged : the geodesic is kept, only the template objects are flowed again.
+  m_ForwardReferenceGeodesic->SetDeformableMultiObject(templateRER);
+  if (m_ForwardReferenceGeodesic->GetNumberOfTimePoints() > 1) { m_ForwardReferenceGeodesic->Update(); }
+  m_BackwardReferenceGeodesic->SetDeformableMultiObject(templateRER);
+  if (m_BackwardReferenceGeodesic->GetNumberOfTimePoints() > 1) { m_BackwardReferenceGeodesic->Update(); }
+}
+
+template<class ScalarType, unsigned int Dimension>
+std::vector<ScalarType>
+LongitudinalAtlas<ScalarType, Dimension>
+::ComputeExponentiationResidual(std::shared_ptr<DeformableMultiObjectType> const &referenceShape,
+                                MatrixType const &referenceControlPoints,
+                                MatrixType const &spaceShift,
+                                std::shared_ptr<DeformableMultiObjectType> const &target,
+                                Exponentiation &exponentiation) const {
+  /// Nothing changed for this observation.
+  if (exponentiation.referenceShape == referenceShape && exponentiation.target == target
+      && exponentiation.referenceControlPoints == referenceControlPoints && exponentiation.spaceShift == spaceShift)
+    return exponentiation.residual;
+
+  std::shared_ptr<DiffeosType> expDef = m_Def->Clone();
+  expDef->SetNumberOfTimePoints(m_NumberOfTimePointsForExponentiation);
+  expDef->SetDeformableMultiObject(referenceShape);
+  expDef->SetStartPositions(referenceControlPoints);
+  expDef->SetStartMomentas(spaceShift);
+  expDef->Update();
+
+  exponentiation.referenceShape = referenceShape;
+  exponentiation.referenceControlPoints = referenceControlPoints;
+  exponentiation.spaceShift = spaceShift;
+  exponentiation.target = target;
+  exponentiation.residual = expDef->GetDeformedObject()->ComputeMatch(target);
+  return exponentiation.residual;
+}
+
 template<class ScalarType, unsigned int Dimension>
 void
 LongitudinalAtlas<ScalarType, Dimension>
@@ -1490,7 +1525,7 @@ LongitudinalAtlas<ScalarType, Dimension>
       unsigned int index = continuousIndex;
       if ((continuousIndex - index) >= 0.5) { ++index; }
 
-      shape = m_ForwardReferenceGeodesic->GetDeformedObjectAt(index);
+      shape = m_ForwardReferenceGeodesic->GetSharedDeformedObjectAt(index);
       cp = m_ForwardReferenceGeodesic->GetDeformedControlPointsAt(index);
     } else {
       shape = m_ForwardReferenceGeodesic->GetDeformableMultiObject();
@@ -1504,7 +1539,7 @@ LongitudinalAtlas<ScalarType, Dimension>
       unsigned int index = continuousIndex;
       if ((continuousIndex - index) >= 0.5) { ++index; }
 
-      shape = m_BackwardReferenceGeodesic->GetDeformedObjectAt(index);
+      shape = m_BackwardReferenceGeodesic->GetSharedDeformedObjectAt(index);
       cp = m_BackwardReferenceGeodesic->GetDeformedControlPointsAt(index);
     } else {
       shape = m_BackwardReferenceGeodesic->GetDeformableMultiObject();
@@ -1599,6 +1634,16 @@ LongitudinalAtlas<ScalarType, Dimension>
     VectorType Xmin = temp->GetBoundingBox().get_column(0);
     VectorType Xmax = temp->GetBoundingBox().get_column(1);
 
+    /// If needed, discards the control points around which the template image is uniform.
+    ImageTypePointer deviation;
+    if (m_OptimizeInitialControlPoints && temp->IsOfImageKind()[0]) {
+      deviation = GridFunctions<ScalarType, Dimension>::LocalIntensityDeviation(temp->GetImage(),
+                                                                                2 * m_Def->GetKernelWidth());
+      std::cout << "We optimize the position of the control points." << std::endl;
+    }
+    ImageIndexType ind;
+    ImagePointType p;
+
     std::vector<VectorType> pointList;
     VectorType v(Dimension);
     switch (Dimension) {
@@ -1610,7 +1655,11 @@ LongitudinalAtlas<ScalarType, Dimension>
           for (ScalarType y = Xmin[1] + offsetY; y <= Xmax[1]; y += m_CPSpacing) {
             v[0] = x;
             v[1] = y;
-            pointList.push_back(v);
+            p[0] = x;
+            p[1] = y;
+            if (!deviation
+                || (deviation->TransformPhysicalPointToIndex(p, ind) && deviation->GetPixel(ind) > 0.01))
+              pointList.push_back(v);
           }
         break;
       }
@@ -1625,7 +1674,12 @@ LongitudinalAtlas<ScalarType, Dimension>
               v[0] = x;
               v[1] = y;
               v[2] = z;
-              pointList.push_back(v);
+              p[0] = x;
+              p[1] = y;
+              p[2] = z;
+              if (!deviation
+                  || (deviation->TransformPhysicalPointToIndex(p, ind) && deviation->GetPixel(ind) > 0.01))
+                pointList.push_back(v);
             }
         break;
       }
@@ -68,6 +68,10 @@ class LongitudinalAtlas : public AbstractStatisticalModel<ScalarType, Dimension>
   typedef itk::Image<ScalarType, Dimension> ImageType;
   /// ITK image pointer type.
   typedef typename ImageType::Pointer ImageTypePointer;
+  /// ITK image index type.
+  typedef typename ImageType::IndexType ImageIndexType;
+  /// ITK image point type.
+  typedef typename ImageType::PointType ImagePointType;
 
   /// Diffeos type.
   typedef Diffeos<ScalarType, Dimension> DiffeosType;
@@ -139,6 +143,8 @@ class LongitudinalAtlas : public AbstractStatisticalModel<ScalarType, Dimension>
     m_BackwardReferenceGeodesic = def->Clone();
     m_ForwardReferenceGeodesic_Memory = def->Clone();
     m_BackwardReferenceGeodesic_Memory = def->Clone();
+    m_Exponentiations.clear();
+    m_Exponentiations_Memory.clear();
   }
 
   /// Sets the concentration of time points for the reference geodesic.
@@ -146,7 +152,11 @@ class LongitudinalAtlas : public AbstractStatisticalModel<ScalarType, Dimension>
     m_ConcentrationOfTimePointsForReferenceGeodesic = c;
   }
   /// Sets the number of time points for the exponentiation operation.
-  void SetNumberOfTimePointsForExponentiation(const unsigned int n) { m_NumberOfTimePointsForExponentiation = n; }
+  void SetNumberOfTimePointsForExponentiation(const unsigned int n) {
+    m_NumberOfTimePointsForExponentiation = n;
+    m_Exponentiations.clear();
+    m_Exponentiations_Memory.clear();
+  }
   /// Sets the margin on the geodesic length.
   void SetMarginOnGeodesicLength(const ScalarType m) { m_MarginOnGeodesicLength = m; }
 
@@ -168,6 +178,9 @@ class LongitudinalAtlas : public AbstractStatisticalModel<ScalarType, Dimension>
   /// Sets control point spacing. Used in case no control points have been set to define a regular lattice of control points.
   void SetCPSpacing(const ScalarType s) { m_CPSpacing = s; }
 
+  /// Sets the flag which discards the lattice control points around which the template image is uniform.
+  void SetOptimizeInitialControlPoints(bool optimize) { m_OptimizeInitialControlPoints = optimize; }
+
   /// Sets the freeze control points flag.
   void SetFreezeControlPointsFlag(bool const &flag) { m_FreezeControlPointsFlag = flag; }
 
@@ -684,6 +697,8 @@ class LongitudinalAtlas : public AbstractStatisticalModel<ScalarType, Dimension>
 
   /// Recovers the memorized random effect realizations-based state.
   virtual void RecoverMemorizedState();
+  /// Recovers the memorized state of the rejected subjects only, when the population-wide state was not modified.
+  virtual void RecoverMemorizedState(std::vector<bool> const &rejectedSubjects);
 
  protected:
 
@@ -710,6 +725,8 @@ class LongitudinalAtlas : public AbstractStatisticalModel<ScalarType, Dimension>
                                     const LinearVariablesMapType &indRER);
   /// Updates the memorized reference geodesic.
   void UpdateReferenceGeodesic(const LinearVariableMapType &popRER);
+  /// Updates the template objects flowed along the memorized reference geodesic, which is not shot again.
+  void UpdateReferenceGeodesicTemplate(const LinearVariableMapType &popRER);
   /// Updates the memorized projected modulation matrix.
   void UpdateProjectedModulationMatrix(const LinearVariableMapType &popRER);
 
@@ -718,6 +735,22 @@ class LongitudinalAtlas : public AbstractStatisticalModel<ScalarType, Dimension>
                                            std::shared_ptr<DeformableMultiObjectType> &shape,
                                            MatrixType &cp) const;
 
+  /// Start state of the Riemannian exponential of an observation, and residual of the exponentiated shape with it.
+  struct Exponentiation {
+    std::shared_ptr<DeformableMultiObjectType> referenceShape;
+    MatrixType referenceControlPoints;
+    MatrixType spaceShift;
+    std::shared_ptr<DeformableMultiObjectType> target;
+    std::vector<ScalarType> residual;
+  };
+  /// Returns the residual of \e target with the exponential of \e referenceShape, \e referenceControlPoints and
+  /// \e spaceShift, reusing the residual of the previous exponentiation \e exponentiation of the same observation
+  /// when its start state is unchanged.
+  std::vector<ScalarType> ComputeExponentiationResidual(
+      std::shared_ptr<DeformableMultiObjectType> const &referenceShape, MatrixType const &referenceControlPoints,
+      MatrixType const &spaceShift, std::shared_ptr<DeformableMultiObjectType> const &target,
+      Exponentiation &exponentiation) const;
+
   /// Initializes the bounding box, based on the template data and the control points.
   void InitializeBoundingBox();
 
@@ -778,6 +811,8 @@ class LongitudinalAtlas : public AbstractStatisticalModel<ScalarType, Dimension>
 
   /// CP spacing used if no set of control points is given.
   ScalarType m_CPSpacing;
+  /// Flag which discards the lattice control points lying in uniform regions of the template image.
+  bool m_OptimizeInitialControlPoints;
   /// Flag which freezes the control points when true.
   bool m_FreezeControlPointsFlag;
   /// If the previous flag is active, stores the frozen control points.
@@ -809,6 +844,17 @@ class LongitudinalAtlas : public AbstractStatisticalModel<ScalarType, Dimension>
   MatrixType m_ProjectedModulationMatrix;
   MatrixType m_ProjectedModulationMatrix_Memory;
 
+  /// Flags set by the last ComputeModelLogLikelihood() call : whether it modified the absolute times, and whether it
+  /// modified the population-wide state (reference geodesic or projected modulation matrix).
+  bool m_AbsoluteTimeIncrementsModified;
+  bool m_PopulationStateModified;
+
+  /// Memorized exponentiations of the observations, for each subject. An observation whose reference shape, control
+  /// points and transported space shift did not change since the last computation of the residuals keeps its residual.
+  /// Only the start states are kept, whose reference shapes are shared with the reference geodesic.
+  std::vector<std::vector<Exponentiation>> m_Exponentiations;
+  std::vector<std::vector<Exponentiation>> m_Exponentiations_Memory;
+
 }; /* class LongitudinalAtlas */
 
 
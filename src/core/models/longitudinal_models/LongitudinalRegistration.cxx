@@ -229,23 +229,10 @@ LongitudinalRegistration<ScalarType, Dimension>
   /// Transport long the reference geodesic.
   MatrixType spaceShift = (m_ProjectedModulationMatrix * sources).unvectorize(m_NumberOfControlPoints, Dimension);
 
-  // Divide the target absolute times into backward and forward targets.
-  std::vector<ScalarType> forwardAbsoluteTimeIncrements, backwardAbsoluteTimeIncrements;
-  for (unsigned int t = 0; t < nbObservations; ++t) {
-    if (m_AbsoluteTimeIncrements[t] < 0.0) {
-      backwardAbsoluteTimeIncrements.push_back(-m_AbsoluteTimeIncrements[t]);
-    } else { forwardAbsoluteTimeIncrements.push_back(m_AbsoluteTimeIncrements[t]); }
-  }
-  std::reverse(backwardAbsoluteTimeIncrements.begin(), backwardAbsoluteTimeIncrements.end());
-
-  // Perform the transport.
-  MatrixListType backwardTransportedSpaceShifts = m_BackwardReferenceGeodesic->ParallelTransport(
-      spaceShift, backwardAbsoluteTimeIncrements).reverse();
-  MatrixListType forwardTransportedSpaceShifts = m_ForwardReferenceGeodesic->ParallelTransport(
-      spaceShift, forwardAbsoluteTimeIncrements);
-
-  // Concatenate the results.
-  MatrixListType transportedSpaceShifts = concatenate(backwardTransportedSpaceShifts, forwardTransportedSpaceShifts);
+  // Perform the transport, along both sides of the reference geodesic.
+  MatrixListType transportedSpaceShifts = DiffeosType::ParallelTransport(
+      m_BackwardReferenceGeodesic, m_ForwardReferenceGeodesic,
+      std::vector<MatrixType>(1, spaceShift), std::vector<std::vector<ScalarType>>(1, m_AbsoluteTimeIncrements))[0];
   assert(transportedSpaceShifts.size() == nbObservations);
 
   /// Exponentiation : shoot at each target time-point. Then compute the residual.
@@ -419,8 +406,8 @@ LongitudinalRegistration<ScalarType, Dimension>
           oss1 << "-";
           oss2 << "-";
         }
-        oss1 << floor << "." << decimals << ".txt" << std::ends;
-        oss2 << floor << "." << decimals << ".txt" << std::ends;
+        oss1 << floor << "." << decimals << matrixFileExtension() << std::ends;
+        oss2 << floor << "." << decimals << matrixFileExtension() << std::ends;
         writeMatrixDLM<ScalarType>(oss1.str().c_str(), forwardPositions[t]);
         writeMatrixDLM<ScalarType>(oss2.str().c_str(), forwardMomentas[t]);
       }
@@ -460,8 +447,8 @@ LongitudinalRegistration<ScalarType, Dimension>
         oss1 << "-";
         oss2 << "-";
       }
-      oss1 << floor << "." << decimals << ".txt" << std::ends;
-      oss2 << floor << "." << decimals << ".txt" << std::ends;
+      oss1 << floor << "." << decimals << matrixFileExtension() << std::ends;
+      oss2 << floor << "." << decimals << matrixFileExtension() << std::ends;
       writeMatrixDLM<ScalarType>(oss1.str().c_str(), backwardPositions[t]);
       writeMatrixDLM<ScalarType>(oss2.str().c_str(), backwardMomenta[t]);
     }
@@ -473,23 +460,10 @@ LongitudinalRegistration<ScalarType, Dimension>
   // Transport.
   MatrixType spaceShift = (m_ProjectedModulationMatrix * sources).unvectorize(m_NumberOfControlPoints, Dimension);
 
-  // Divide the target absolute times into backward and forward targets.
-  std::vector<ScalarType> forwardAbsoluteTimeIncrements, backwardAbsoluteTimeIncrements;
-  for (unsigned int t = 0; t < nbObservations; ++t) {
-    if (absoluteTimeIncrements[t] < 0.0) {
-      backwardAbsoluteTimeIncrements.push_back(-absoluteTimeIncrements[t]);
-    } else { forwardAbsoluteTimeIncrements.push_back(absoluteTimeIncrements[t]); }
-  }
-  std::reverse(backwardAbsoluteTimeIncrements.begin(), backwardAbsoluteTimeIncrements.end());
-
-  // Perform the transport.
-  MatrixListType backwardTransportedSpaceShifts = backwardDef->ParallelTransport(
-      spaceShift, backwardAbsoluteTimeIncrements).reverse();
-  MatrixListType forwardTransportedSpaceShifts = forwardDef->ParallelTransport(
-      spaceShift, forwardAbsoluteTimeIncrements);
-
-  // Concatenate the results.
-  MatrixListType transportedSpaceShifts = concatenate(backwardTransportedSpaceShifts, forwardTransportedSpaceShifts);
+  // Perform the transport, along both sides of the reference geodesic.
+  MatrixListType transportedSpaceShifts = DiffeosType::ParallelTransport(
+      backwardDef, forwardDef,
+      std::vector<MatrixType>(1, spaceShift), std::vector<std::vector<ScalarType>>(1, absoluteTimeIncrements))[0];
   assert(transportedSpaceShifts.size() == nbObservations);
 
   // Exponentiation.
@@ -502,13 +476,13 @@ LongitudinalRegistration<ScalarType, Dimension>
       ScalarType continuousIndex = absoluteTimeIncrements[t] / forwardStepSize;
       unsigned int index = continuousIndex;
       if ((continuousIndex - index) >= 0.5) { ++index; }
-      referenceShape = forwardDef->GetDeformedObjectAt(index);
+      referenceShape = forwardDef->GetSharedDeformedObjectAt(index);
       referenceControlPoints = forwardDef->GetDeformedControlPointsAt(index);
     } else {
       ScalarType continuousIndex = -absoluteTimeIncrements[t] / backwardStepSize;
       unsigned int index = continuousIndex;
       if ((continuousIndex - index) >= 0.5) { ++index; }
-      referenceShape = backwardDef->GetDeformedObjectAt(index);
+      referenceShape = backwardDef->GetSharedDeformedObjectAt(index);
       referenceControlPoints = backwardDef->GetDeformedControlPointsAt(index);
     }
 
@@ -551,19 +525,19 @@ LongitudinalRegistration<ScalarType, Dimension>
   // Write time-shift.
   const ScalarType timeShift = recast<ScalarType>(Superclass::m_FixedEffects.at("TimeShift"));
   std::ostringstream oss1;
-  oss1 << outputDir << Superclass::m_Name << "__Parameters__TimeShift.txt" << std::ends;
+  oss1 << outputDir << Superclass::m_Name << "__Parameters__TimeShift" << matrixFileExtension() << std::ends;
   writeMatrixDLM<ScalarType>(oss1.str().c_str(), MatrixType(1, 1, timeShift));
 
   // Write log-acceleration.
   const ScalarType logAcceleration = recast<ScalarType>(Superclass::m_FixedEffects.at("LogAcceleration"));
   std::ostringstream oss2;
-  oss2 << outputDir << Superclass::m_Name << "__Parameters__LogAcceleration.txt" << std::ends;
+  oss2 << outputDir << Superclass::m_Name << "__Parameters__LogAcceleration" << matrixFileExtension() << std::ends;
   writeMatrixDLM<ScalarType>(oss2.str().c_str(), MatrixType(1, 1, timeShift));
 
   // Write sources.
   const VectorType sources = recast<VectorType>(Superclass::m_FixedEffects.at("Sources"));
   std::ostringstream oss3;
-  oss3 << outputDir << Superclass::m_Name << "__Parameters__Sources.txt" << std::ends;
+  oss3 << outputDir << Superclass::m_Name << "__Parameters__Sources" << matrixFileExtension() << std::ends;
   writeMatrixDLM<ScalarType>(oss3.str().c_str(), MatrixType(sources));
 }
 
@@ -654,7 +628,7 @@ LongitudinalRegistration<ScalarType, Dimension>
       unsigned int index = continuousIndex;
       if ((continuousIndex - index) >= 0.5) { ++index; }
 
-      shape = m_ForwardReferenceGeodesic->GetDeformedObjectAt(index);
+      shape = m_ForwardReferenceGeodesic->GetSharedDeformedObjectAt(index);
       cp = m_ForwardReferenceGeodesic->GetDeformedControlPointsAt(index);
     } else {
       shape = m_ForwardReferenceGeodesic->GetDeformableMultiObject();
@@ -668,7 +642,7 @@ LongitudinalRegistration<ScalarType, Dimension>
       unsigned int index = continuousIndex;
       if ((continuousIndex - index) >= 0.5) { ++index; }
 
-      shape = m_BackwardReferenceGeodesic->GetDeformedObjectAt(index);
+      shape = m_BackwardReferenceGeodesic->GetSharedDeformedObjectAt(index);
       cp = m_BackwardReferenceGeodesic->GetDeformedControlPointsAt(index);
     } else {
       shape = m_BackwardReferenceGeodesic->GetDeformableMultiObject();
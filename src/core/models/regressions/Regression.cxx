@@ -9,6 +9,8 @@
  ****************************************************************************************/
 
 #include "Regression.h"
+#include "GridFunctions.h"
+#include "KernelMatrixCache.h"
 
 using namespace def::algebra;
 
@@ -187,9 +189,17 @@ Regression<ScalarType, Dimension>
   unsigned int numberOfObservations = targets.size();
   residuals.resize(numberOfObservations);
 
-  // Loop over the number of observations to compute the value of the data matching term
-  for (unsigned int t = 0; t < numberOfObservations; ++t)
-    residuals[t] = subjectDef->GetDeformedObjectAt(timeIndices[t])->ComputeMatch(targets[t]);
+  // The data matching terms of the observations are independent once the flow is integrated
+  std::vector<std::future<void>> futures;
+  {
+    ThreadPool pool(def::utils::settings.number_of_threads);
+    for (unsigned int t = 0; t < numberOfObservations; ++t) {
+      futures.push_back(pool.enqueue([&, t]() {
+        residuals[t] = subjectDef->GetDeformedObjectAt(timeIndices[t])->ComputeMatch(targets[t]);
+      }));
+    }
+  }
+  for (auto &f : futures) f.get();
 
   return false;
 }
@@ -223,8 +233,12 @@ Regression<ScalarType, Dimension>
   momKernelObj->SetKernelWidth(m_Def->GetKernelWidth());
   momKernelObj->SetSources(controlPoints);
   momKernelObj->SetWeights(initialMomenta);
+  /// Frozen control points : the convolution is a product with their kernel matrix, computed once.
+  if (m_FreezeControlPointsFlag)
+    momKernelObj->SetSourcesKernelMatrix(KernelMatrixCache<ScalarType, Dimension>::instance()->Get(
+        m_Def->GetKernelType(), m_Def->GetKernelWidth(), controlPoints));
 
-  MatrixType kMom = momKernelObj->Convolve(controlPoints);
+  MatrixType kMom = momKernelObj->ConvolveAtSources();
   for (unsigned int i = 0; i < nbControlPoints; ++i)
     logLikelihoodTerms[1] -= dot_product(kMom.get_row(i), initialMomenta.get_row(i));
   logLikelihoodTerms[1] *= 0.5f;
@@ -391,12 +405,11 @@ Regression<ScalarType, Dimension>
   VectorType Xmin = temp->GetBoundingBox().get_column(0);
   VectorType Xmax = temp->GetBoundingBox().get_column(1);
 
-  /// For the optimize==true case.
-  ImageTypePointer img;
-  ImageSpacingType spacing;
+  /// For the optimize==true case : largest intensity variation in the neighborhood of each voxel of the template.
+  ImageTypePointer deviation;
   if (optimize && temp->IsOfImageKind()[0]) {
-    img = temp->GetImage();
-    spacing = img->GetSpacing();
+    deviation = GridFunctions<ScalarType, Dimension>::LocalIntensityDeviation(temp->GetImage(),
+                                                                              2 * m_Def->GetKernelWidth());
     std::cout << "We optimize the position of the control points." << std::endl;
   } else { optimize = false; }
 
@@ -409,34 +422,16 @@ Regression<ScalarType, Dimension>
 
       for (ScalarType x = Xmin[0] + offsetX; x <= Xmax[0]; x += m_CPSpacing) {
         for (ScalarType y = Xmin[1] + offsetY; y <= Xmax[1]; y += m_CPSpacing) {
-          bool getOut = false;
           v[0] = x;
           v[1] = y;
           if (optimize) {
             ImageIndexType ind;
             ImagePointType p;
-            ScalarType value;
-            ScalarType toSpan = 2 * m_Def->GetKernelWidth();
             p[0] = x;
             p[1] = y;
-            img->TransformPhysicalPointToIndex(p, ind);
-            value = img->GetPixel(ind);
             // Here we look : if all the intensities are equal in the neighborhood of the cp, we discard it.
-            for (ScalarType xTest = x - toSpan; xTest < x + toSpan; xTest += spacing[0]) {
-              if (getOut) {
-                break;
-              }
-              p[0] = xTest;
-              for (ScalarType yTest = y - toSpan; yTest < y + toSpan; yTest += spacing[1]) {
-                p[1] = yTest;
-                if (img->TransformPhysicalPointToIndex(p, ind)
-                    && std::fabs(img->GetPixel(ind) - value) > 0.01) {
-                  pointList.push_back(v);
-                  getOut = true;
-                  break;
-                }
-              }
-            }
+            if (deviation->TransformPhysicalPointToIndex(p, ind) && deviation->GetPixel(ind) > 0.01)
+              pointList.push_back(v);
           } else // Else we don't have a criterion to discard the cp : we keep it.
             pointList.push_back(v);
         }
@@ -451,39 +446,17 @@ Regression<ScalarType, Dimension>
       for (ScalarType x = Xmin[0] + offsetX; x <= Xmax[0]; x += m_CPSpacing)
         for (ScalarType y = Xmin[1] + offsetY; y <= Xmax[1]; y += m_CPSpacing)
           for (ScalarType z = Xmin[2] + offsetZ; z <= Xmax[2]; z += m_CPSpacing) {
-            bool getOut = false;
             v[0] = x;
             v[1] = y;
             v[2] = z;
             if (optimize) {
               ImageIndexType ind;
               ImagePointType p;
-              ScalarType value;
-              ScalarType toSpan = 2 * m_Def->GetKernelWidth();
-
               p[0] = x;
               p[1] = y;
               p[2] = z;
-              img->TransformPhysicalPointToIndex(p, ind);
-              value = img->GetPixel(ind);
-              // Here we look : if all the intensities are equal in the neighborhood of the cp, we discard it.
-              for (ScalarType xTest = x - toSpan; xTest < x + toSpan; xTest += spacing[0]) {
-                if (getOut) { break; }
-                p[0] = xTest;
-                for (ScalarType yTest = y - toSpan; yTest < y + toSpan; yTest += spacing[1]) {
-                  if (getOut) { break; }
-                  p[1] = yTest;
-                  for (ScalarType zTest = z - toSpan; zTest < z + toSpan; zTest += spacing[2]) {
-                    p[2] = zTest;
-                    if (img->TransformPhysicalPointToIndex(p, ind)
-                        && std::fabs(img->GetPixel(ind) - value) > 0.01) {
-                      pointList.push_back(v);
-                      getOut = true;
-                      break;
-                    }
-                  }
-                }
-              }
+              if (deviation->TransformPhysicalPointToIndex(p, ind) && deviation->GetPixel(ind) > 0.01)
+                pointList.push_back(v);
             } else
               pointList.push_back(v);
           }
@@ -551,11 +524,11 @@ Regression<ScalarType, Dimension>
     MatrixListType TrajectoryMomentas = m_Def->GetTrajectoryMomentas();
     for (unsigned int t = 0; t < m_Def->GetNumberOfTimePoints(); ++t) {
       std::ostringstream oss;
-      oss << outputDir << Superclass::m_Name << "__CP_t_" << t << ".txt" << std::ends;
+      oss << outputDir << Superclass::m_Name << "__CP_t_" << t << matrixFileExtension() << std::ends;
       writeMatrixDLM<ScalarType>(oss.str().c_str(), TrajectoryPositions[t]);
 
       std::ostringstream oss2;
-      oss2 << outputDir << Superclass::m_Name << "__MOM_t_" << t << ".txt" << std::ends;
+      oss2 << outputDir << Superclass::m_Name << "__MOM_t_" << t << matrixFileExtension() << std::ends;
       writeMatrixDLM<ScalarType>(oss2.str().c_str(), TrajectoryMomentas[t]);
     }
   }
@@ -569,12 +542,12 @@ Regression<ScalarType, Dimension>
 
   // Write control points.
   std::ostringstream oss1;
-  oss1 << outputDir << Superclass::m_Name << "_ControlPoints.txt" << std::ends;
+  oss1 << outputDir << Superclass::m_Name << "_ControlPoints" << matrixFileExtension() << std::ends;
   writeMatrixDLM<ScalarType>(oss1.str().c_str(), GetControlPoints());
 
   // Write initialMomenta.
   std::ostringstream oss2;
-  oss2 << outputDir << Superclass::m_Name << "_InitialMomenta.txt" << std::ends;
+  oss2 << outputDir << Superclass::m_Name << "_InitialMomenta" << matrixFileExtension() << std::ends;
   writeMatrixDLM<ScalarType>(oss2.str().c_str(), GetInitialMomenta());
 }
 
@@ -627,19 +600,26 @@ Regression<ScalarType, Dimension>
   unsigned int numberOfObservations = targets.size();
   MatrixListType GradientDataTermOfLandmarkTypes(numberOfObservations);
   MatrixListType GradientDataTermOfImageTypes(numberOfObservations);
-  for (unsigned int s = 0; s < numberOfObservations; s++) {
-    std::shared_ptr<DeformableMultiObjectType> deformedTemplateObjects
-        = subjectDef->GetDeformedObjectAt(timeIndices[s]);
-
-    // Get the gradient of the similarity metric between deformed template and target
-    MatrixListType currGradDataTi = deformedTemplateObjects->ComputeMatchGradient(targets[s]);
-
-    for (unsigned int i = 0; i < numberOfObjects; i++)
-      currGradDataTi[i] /= 2.0 * m_DataSigmaSquared[i];
-
-    GetTemplate()->ListToMatrices(
-        currGradDataTi, GradientDataTermOfLandmarkTypes[s], GradientDataTermOfImageTypes[s]);
+  std::vector<std::future<void>> futures;
+  {
+    ThreadPool pool(def::utils::settings.number_of_threads);
+    for (unsigned int s = 0; s < numberOfObservations; s++) {
+      futures.push_back(pool.enqueue([&, s]() {
+        std::shared_ptr<DeformableMultiObjectType> deformedTemplateObjects
+            = subjectDef->GetDeformedObjectAt(timeIndices[s]);
+
+        // Get the gradient of the similarity metric between deformed template and target
+        MatrixListType currGradDataTi = deformedTemplateObjects->ComputeMatchGradient(targets[s]);
+
+        for (unsigned int i = 0; i < numberOfObjects; i++)
+          currGradDataTi[i] /= 2.0 * m_DataSigmaSquared[i];
+
+        GetTemplate()->ListToMatrices(
+            currGradDataTi, GradientDataTermOfLandmarkTypes[s], GradientDataTermOfImageTypes[s]);
+      }));
+    }
   }
+  for (auto &f : futures) f.get();
 
   subjectDef->IntegrateAdjointEquations(GradientDataTermOfLandmarkTypes, GradientDataTermOfImageTypes, timeIndices);
 
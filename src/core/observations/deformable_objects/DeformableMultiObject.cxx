@@ -23,6 +23,7 @@
 #include "KernelFactory.h"
 
 #include "LinearAlgebra.h"
+#include "Profiler.h"
 
 using namespace def::algebra;
 
@@ -435,6 +436,7 @@ typename std::vector<ScalarType>
 DeformableMultiObject<ScalarType, Dimension>
 ::ComputeMatch(const std::shared_ptr<DeformableMultiObject> target)
 {
+	DEF_PROFILE_SCOPE_SIZE("DeformableMultiObject::ComputeMatch", m_NumberOfObjects);
 	if (m_NumberOfObjects != target->GetNumberOfObjects())
 		throw std::runtime_error("number of objects mismatched");
 
@@ -454,6 +456,7 @@ MatrixListType
 DeformableMultiObject<ScalarType, Dimension>
 ::ComputeMatchGradient(const std::shared_ptr<DeformableMultiObject> target)
 {
+	DEF_PROFILE_SCOPE_SIZE("DeformableMultiObject::ComputeMatchGradient", m_NumberOfObjects);
 	if (m_NumberOfObjects != target->GetNumberOfObjects())
 		throw std::runtime_error("number of objects mismatched");
 
@@ -531,6 +534,7 @@ void
 DeformableMultiObject<ScalarType, Dimension>
 ::WriteMultiObject(std::vector<std::string>& outfn) const
 {
+	DEF_PROFILE_SCOPE("DeformableMultiObject::WriteMultiObject");
 	for (int i = 0; i < m_NumberOfObjects; i++)
 		m_ObjectList[i]->WriteObject(outfn[i]);
 }
@@ -541,6 +545,7 @@ void
 DeformableMultiObject<ScalarType, Dimension>
 ::WriteMultiObject(std::vector<std::string>& outfn, const MatrixListType& velocity) const
 {
+	DEF_PROFILE_SCOPE("DeformableMultiObject::WriteMultiObject");
 	for (int i = 0; i < m_NumberOfObjects; i++)
 		m_ObjectList[i]->WriteObject(outfn[i], velocity);
 }
@@ -30,6 +30,8 @@
 
 #include "itkOrientImageFilter.h"
 
+#include "AsyncOutputWriter.h"
+
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 // Constructor(s) / Destructor :
@@ -295,6 +297,22 @@ LinearInterpImage<ScalarType, Dimension>
 
 
 
+/// Writes \e image to \e fileName through the AsyncOutputWriter. The image is first disconnected from the pipeline
+/// which produced it, so that the writing task owns it.
+template <class OutImageType>
+void QueueImageWriting(typename OutImageType::Pointer image, const std::string& fileName)
+{
+	image->DisconnectPipeline();
+	AsyncOutputWriter::instance()->Submit([image, fileName]()
+	{
+		typedef itk::ImageFileWriter<OutImageType> WriterType;
+		typename WriterType::Pointer writer = WriterType::New();
+		writer->SetInput(image);
+		writer->SetFileName(fileName.c_str());
+		writer->Update();
+	});
+}
+
 template <class ScalarType, unsigned int Dimension>
 void LinearInterpImage<ScalarType, Dimension>
 ::WriteObject(std::string str) const
@@ -326,22 +344,12 @@ void LinearInterpImage<ScalarType, Dimension>
 			orienter->Update();
 
 			// std::cout << "Orientation filter" << std::endl;
-			typedef itk::ImageFileWriter<OutImageType_dim_3> WriterType;
-			typename WriterType::Pointer writer = WriterType::New();
-			writer->SetInput(orienter->GetOutput()); //
-			writer->SetFileName(str.c_str());
-			writer->Update();
-			// std::cout << "Writing filter for oriented image" << std::endl;
+			QueueImageWriting<OutImageType_dim_3>(orienter->GetOutput(), str);
 		}
 		else
 		{
 			// write output image
-			typedef itk::ImageFileWriter<OutImageType> WriterType;
-			typename WriterType::Pointer writer = WriterType::New();
-			writer->SetInput(castf->GetOutput());
-			writer->SetFileName(str.c_str());
-			writer->Update();
-			// std::cout << "Writing filter" << std::endl;
+			QueueImageWriting<OutImageType>(castf->GetOutput(), str);
 		}
 	}
 	else
@@ -368,20 +376,12 @@ void LinearInterpImage<ScalarType, Dimension>
 			orienter->SetInput(dynamic_cast<OutImageType_dim_3*>( castf->GetOutput() ));
 			orienter->Update();
 
-			typedef itk::ImageFileWriter<OutImageType_dim_3> WriterType;
-			typename WriterType::Pointer writer = WriterType::New();
-			writer->SetInput(orienter->GetOutput()); //
-			writer->SetFileName(str.c_str());
-			writer->Update();
+			QueueImageWriting<OutImageType_dim_3>(orienter->GetOutput(), str);
 		}
 		else
 		{
-	    // write output image
-		typedef itk::ImageFileWriter<OutImageType> WriterType;
-		typename WriterType::Pointer writer = WriterType::New();
-		writer->SetInput(castf->GetOutput()); //
-		writer->SetFileName(str.c_str());
-		writer->Update();
+			// write output image
+			QueueImageWriting<OutImageType>(castf->GetOutput(), str);
 		}
 	}
 }
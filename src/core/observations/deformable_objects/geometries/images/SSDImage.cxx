@@ -88,9 +88,6 @@ ScalarType
 SSDImage<ScalarType, Dimension>
 ::ComputeMatch(const std::shared_ptr<AbstractGeometryType> target)
 {
-//	/// For profiling.
-//	std::chrono::high_resolution_clock::time_point t1 = std::chrono::high_resolution_clock::now();
-
   if (this->GetType() != target->GetType())
     throw std::runtime_error("Abstract Geometries types mismatched");
 
@@ -110,11 +107,6 @@ SSDImage<ScalarType, Dimension>
   VectorType D = I0 - I1;
   ScalarType match = D.squared_magnitude();
 
-//	/// For profiling.
-//	std::chrono::high_resolution_clock::time_point t2 = std::chrono::high_resolution_clock::now();
-//	auto d = std::chrono::duration_cast<std::chrono::milliseconds>(t2-t1).count();
-//	std::cout << ">>>> SSDImage::ComputeMatch() method took " << d << " ms." << std::endl;
-
   return match;
 }
 
@@ -126,9 +118,6 @@ MatrixType
 SSDImage<ScalarType, Dimension>
 ::ComputeMatchGradient(const std::shared_ptr<AbstractGeometryType> target)
 {
-//	/// For profiling.
-//	std::chrono::high_resolution_clock::time_point t1 = std::chrono::high_resolution_clock::now();
-
   if (this->GetType() != target->GetType())
     std::cerr << "Abstract Geometries types mismatched: " << this->GetType() << " and " << target->GetType() << "\n";
 
@@ -11,6 +11,8 @@
 #include "Landmark.h"
 
 #include "KernelFactory.h"
+#include "AsyncOutputWriter.h"
+#include "GeneralSettings.h"
 
 #include "vtkPolyData.h"
 #include "vtkSmartPointer.h"
@@ -130,16 +132,25 @@ Landmark<ScalarType, Dimension>
 
   m_PointCoordinates.set_size(m_NumberOfPoints, Dimension);
 
-  for (unsigned int i = 0; i < m_NumberOfPoints; i++) {
-    // Here we used 3 since 2D points still have a z-coordinate that is equal to 0 in vtkPolyData.
-    // This coordinate is removed in m_WorkingPointCoordinates
+  // Here we used 3 since 2D points still have a z-coordinate that is equal to 0 in vtkPolyData.
+  // This coordinate is removed in m_WorkingPointCoordinates
+  m_VTKMutex.Lock();
+  vtkDoubleArray *coordinates = vtkDoubleArray::SafeDownCast(m_PointSet->GetPoints()->GetData());
+  if (coordinates != NULL) {
+    /// The coordinates are stored interleaved by VTK : they are read in place, without a call per point.
+    RowMajorMatrixView<double> points(coordinates->GetPointer(0), m_NumberOfPoints, 3);
+    for (unsigned int i = 0; i < m_NumberOfPoints; i++)
+      for (int dim = 0; dim < Dimension; dim++)
+        m_PointCoordinates(i, dim) = points(i, dim);
+  } else {
     double p[3];
-    m_VTKMutex.Lock();
-    m_PointSet->GetPoint(i, p);
-    m_VTKMutex.Unlock();
-    for (int dim = 0; dim < Dimension; dim++)
-      m_PointCoordinates(i, dim) = p[dim];
+    for (unsigned int i = 0; i < m_NumberOfPoints; i++) {
+      m_PointSet->GetPoint(i, p);
+      for (int dim = 0; dim < Dimension; dim++)
+        m_PointCoordinates(i, dim) = p[dim];
+    }
   }
+  m_VTKMutex.Unlock();
 
   this->SetModified();
 }
@@ -231,16 +242,25 @@ Landmark<ScalarType, Dimension>
   if (Y.columns() != Dimension)
     throw std::runtime_error("Dimension mismatched");
 
-  for (unsigned int i = 0; i < m_NumberOfPoints; i++) {
+  m_VTKMutex.Lock();
+  vtkDoubleArray *coordinates = vtkDoubleArray::SafeDownCast(m_PointSet->GetPoints()->GetData());
+  if (coordinates != NULL) {
+    /// The interleaved coordinates are written in place, as in the vtkPoints::SetPoint() calls below.
+    double *points = coordinates->GetPointer(0);
+    for (unsigned int i = 0; i < m_NumberOfPoints; i++)
+      for (int dim = 0; dim < 3; dim++)
+        points[3 * i + dim] = (dim < Dimension) ? Y(i, dim) : 0.0;
+    m_PointSet->GetPoints()->Modified();
+  } else {
     double p[3];
     p[2] = 0.0;
-    for (int dim = 0; dim < Dimension; dim++)
-      p[dim] = Y(i, dim);
-
-    m_VTKMutex.Lock();
-    m_PointSet->GetPoints()->SetPoint(i, p);
-    m_VTKMutex.Unlock();
+    for (unsigned int i = 0; i < m_NumberOfPoints; i++) {
+      for (int dim = 0; dim < Dimension; dim++)
+        p[dim] = Y(i, dim);
+      m_PointSet->GetPoints()->SetPoint(i, p);
+    }
   }
+  m_VTKMutex.Unlock();
 
   m_PointCoordinates = Y;
 
@@ -335,28 +355,40 @@ Landmark<ScalarType, Dimension>
     outData = ReorientPolyData(m_PointSet, true);
   }
 
+  /// A background writing task works on a deep copy, since the point coordinates are updated in place.
+  vtkSmartPointer<vtkPointSet> snapshot = outData;
+  if (def::utils::settings.async_output_writing) {
+    snapshot.TakeReference(outData->NewInstance());
+    snapshot->DeepCopy(outData);
+  }
+  const bool binary = def::utils::settings.binary_vtk_output;
+
   if (this->IsOfUnstructuredKind()) {
     std::cout << "Writing object as a vtkUnstructuredGrid " << std::endl;
-    vtkSmartPointer<vtkUnstructuredGrid> downcastedPointer = vtkUnstructuredGrid::SafeDownCast(outData);
-    vtkSmartPointer<vtkUnstructuredGridWriter> writer = vtkSmartPointer<vtkUnstructuredGridWriter>::New();
-    writer->SetFileName(str.c_str());
+    AsyncOutputWriter::instance()->Submit([snapshot, str, binary]() {
+      vtkSmartPointer<vtkUnstructuredGridWriter> writer = vtkSmartPointer<vtkUnstructuredGridWriter>::New();
+      writer->SetFileName(str.c_str());
+      if (binary) writer->SetFileTypeToBinary();
 #if (VTK_MAJOR_VERSION == 5)
-    writer->SetInput(downcastedPointer);
+      writer->SetInput(vtkUnstructuredGrid::SafeDownCast(snapshot));
 #else
-    writer->SetInputData(downcastedPointer); //
+      writer->SetInputData(vtkUnstructuredGrid::SafeDownCast(snapshot));
 #endif
-    writer->Update();
+      writer->Update();
+    });
 
   } else {
-    vtkSmartPointer<vtkPolyData> downcastedPointer = vtkPolyData::SafeDownCast(outData);
-    vtkSmartPointer<vtkPolyDataWriter> writer = vtkSmartPointer<vtkPolyDataWriter>::New();
-    writer->SetFileName(str.c_str());
+    AsyncOutputWriter::instance()->Submit([snapshot, str, binary]() {
+      vtkSmartPointer<vtkPolyDataWriter> writer = vtkSmartPointer<vtkPolyDataWriter>::New();
+      writer->SetFileName(str.c_str());
+      if (binary) writer->SetFileTypeToBinary();
 #if (VTK_MAJOR_VERSION == 5)
-    writer->SetInput(downcastedPointer);
+      writer->SetInput(vtkPolyData::SafeDownCast(snapshot));
 #else
-    writer->SetInputData(downcastedPointer); //
+      writer->SetInputData(vtkPolyData::SafeDownCast(snapshot));
 #endif
-    writer->Update();
+      writer->Update();
+    });
   }
 }
 
@@ -164,7 +164,7 @@ OrientedPolyLine<ScalarType, Dimension>
 
   MatrixType SdotT = kernelObject->Convolve(targCenters);
   for (int i = 0; i < targetOrientedPolyLine->GetNumberOfCells(); i++)
-    match -= 2.0f * dot_product( SdotT.get_row(i),  targTangents.get_row(i) );
+    match -= 2.0f * dot_product(SdotT.get_fixed_row<Dimension>(i), targTangents.get_fixed_row<Dimension>(i));
 
   return match;
 }
@@ -224,13 +224,12 @@ OrientedPolyLine<ScalarType, Dimension>
     int indM = ptIds->GetId(0);
     int indP = ptIds->GetId(1);
 
-    VectorType Ktau = KtauS.get_row(f) - KtauT.get_row(f);
+    /// Fixed-size rows : no heap allocation per cell.
+    FixedVectorType Ktau = KtauS.get_fixed_row<Dimension>(f) - KtauT.get_fixed_row<Dimension>(f);
     Ktau *= 2.0f;
-    gradmatch.set_row(indM, gradmatch.get_row(indM) - Ktau);
-    gradmatch.set_row(indP, gradmatch.get_row(indP) + Ktau);
-
-    gradmatch.set_row(indM, gradmatch.get_row(indM) + gradKtau.get_row(f));
-    gradmatch.set_row(indP, gradmatch.get_row(indP) + gradKtau.get_row(f));
+    const FixedVectorType gradKtauf = gradKtau.get_fixed_row<Dimension>(f);
+    gradmatch.increment_row(indM, gradKtauf - Ktau);
+    gradmatch.increment_row(indP, gradKtauf + Ktau);
 
   }
 
@@ -48,6 +48,9 @@ class OrientedPolyLine : public Landmark<ScalarType, Dimension>
   /// Deformable object type.
   typedef typename Superclass::Superclass AbstractGeometryType;
 
+  /// Fixed-size vector type, for the points of the cells.
+  typedef FixedVector<ScalarType, Dimension> FixedVectorType;
+
 
   ////////////////////////////////////////////////////////////////////////////////////////////////////
   // Constructor(s) / Destructor :
@@ -27,6 +27,25 @@
 #include <sstream>
 
 #include <cassert>
+#include <stdexcept>
+
+namespace {
+
+/// Cross product of the cell loops. Triangle meshes are surfaces of the 3D space : the 2D instantiation of the class
+/// compiles, but cannot compute their normals (as with the dynamic vectors, whose cross product throws).
+template<class ScalarType>
+inline FixedVector<ScalarType, 3> CellCrossProduct(FixedVector<ScalarType, 3> const &v1,
+                                                   FixedVector<ScalarType, 3> const &v2) {
+  return cross_3d(v1, v2);
+}
+
+template<class ScalarType, unsigned int Dim>
+inline FixedVector<ScalarType, Dim> CellCrossProduct(FixedVector<ScalarType, Dim> const &,
+                                                     FixedVector<ScalarType, Dim> const &) {
+  throw std::runtime_error("The normals of a surface mesh are only defined in 3D");
+}
+
+}
 
 
 
@@ -157,7 +176,7 @@ ScalarType OrientedSurfaceMesh<ScalarType, Dimension>
 
   MatrixType SdotT = kernelObject->Convolve(targCenters);
   for (int i = 0; i < targetOrientedSurfaceMesh->GetNumberOfCells(); i++)
-    match -= 2.0f * dot_product(SdotT.get_row(i), targNormals.get_row(i));
+    match -= 2.0f * dot_product(SdotT.get_fixed_row<Dimension>(i), targNormals.get_fixed_row<Dimension>(i));
 
   return match;
 }
@@ -218,18 +237,16 @@ MatrixType OrientedSurfaceMesh<ScalarType, Dimension>
     int ind1 = ptIds->GetId(1);
     int ind2 = ptIds->GetId(2);
 
-    VectorType e0 = Pts.get_row(ind2) - Pts.get_row(ind1);
-    VectorType e1 = Pts.get_row(ind0) - Pts.get_row(ind2);
-    VectorType e2 = Pts.get_row(ind1) - Pts.get_row(ind0);
-
-    VectorType Ktau = KtauS.get_row(f) - KtauT.get_row(f);
-    gradmatch.set_row(ind0, gradmatch.get_row(ind0) + cross_3d(e0, Ktau));
-    gradmatch.set_row(ind1, gradmatch.get_row(ind1) + cross_3d(e1, Ktau));
-    gradmatch.set_row(ind2, gradmatch.get_row(ind2) + cross_3d(e2, Ktau));
+    /// Fixed-size rows : no heap allocation per cell.
+    const FixedVectorType p0 = Pts.get_fixed_row<Dimension>(ind0);
+    const FixedVectorType p1 = Pts.get_fixed_row<Dimension>(ind1);
+    const FixedVectorType p2 = Pts.get_fixed_row<Dimension>(ind2);
 
-    gradmatch.set_row(ind0, gradmatch.get_row(ind0) + gradKtau.get_row(f));
-    gradmatch.set_row(ind1, gradmatch.get_row(ind1) + gradKtau.get_row(f));
-    gradmatch.set_row(ind2, gradmatch.get_row(ind2) + gradKtau.get_row(f));
+    const FixedVectorType Ktau = KtauS.get_fixed_row<Dimension>(f) - KtauT.get_fixed_row<Dimension>(f);
+    const FixedVectorType gradKtauf = gradKtau.get_fixed_row<Dimension>(f);
+    gradmatch.increment_row(ind0, CellCrossProduct(p2 - p1, Ktau) + gradKtauf);
+    gradmatch.increment_row(ind1, CellCrossProduct(p0 - p2, Ktau) + gradKtauf);
+    gradmatch.increment_row(ind2, CellCrossProduct(p1 - p0, Ktau) + gradKtauf);
 
   }
 
@@ -49,6 +49,9 @@ class OrientedSurfaceMesh : public Landmark<ScalarType, Dimension>
   /// Deformable object type.
   typedef typename Superclass::Superclass AbstractGeometryType;
 
+  /// Fixed-size vector type, for the points of the cells.
+  typedef FixedVector<ScalarType, Dimension> FixedVectorType;
+
 
   ////////////////////////////////////////////////////////////////////////////////////////////////////
   // Constructor(s) / Destructor :
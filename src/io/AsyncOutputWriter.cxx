@@ -0,0 +1,88 @@
+/***************************************************************************************
+*                                                                                      *
+*                                     Deformetrica                                     *
+*                                                                                      *
+*    Copyright Inria and the University of Utah.  All rights reserved. This file is    *
+*    distributed under the terms of the Inria Non-Commercial License Agreement.        *
+*                                                                                      *
+*                                                                                      *
+****************************************************************************************/
+
+#include "AsyncOutputWriter.h"
+
+#include "GeneralSettings.h"
+
+AsyncOutputWriter *AsyncOutputWriter::instance() {
+  static AsyncOutputWriter *instance = nullptr;
+  static std::once_flag flag;
+  std::call_once(flag, []() { instance = new AsyncOutputWriter(); });
+  return instance;
+}
+
+AsyncOutputWriter::~AsyncOutputWriter() {
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Stop = true;
+  }
+  m_TaskAdded.notify_all();
+  if (m_Thread.joinable()) m_Thread.join();
+}
+
+void AsyncOutputWriter::Submit(TaskType task) {
+  Submit(std::move(task), def::utils::settings.async_output_writing);
+}
+
+void AsyncOutputWriter::Submit(TaskType task, bool asynchronous) {
+  if (!asynchronous) {
+    /// Keeps the order of the files written to disk when the option is switched off during the run.
+    Wait();
+    task();
+    return;
+  }
+
+  std::unique_lock<std::mutex> lock(m_Mutex);
+  if (m_Error) {
+    std::exception_ptr error = m_Error;
+    m_Error = nullptr;
+    std::rethrow_exception(error);
+  }
+  if (!m_Thread.joinable()) m_Thread = std::thread(&AsyncOutputWriter::Run, this);
+  m_TaskDone.wait(lock, [this]() { return m_Tasks.size() < kMaxPendingTasks; });
+  m_Tasks.push_back(std::move(task));
+  lock.unlock();
+  m_TaskAdded.notify_one();
+}
+
+void AsyncOutputWriter::Wait() {
+  std::unique_lock<std::mutex> lock(m_Mutex);
+  m_TaskDone.wait(lock, [this]() { return m_Tasks.empty() && !m_Busy; });
+
+  if (m_Error) {
+    std::exception_ptr error = m_Error;
+    m_Error = nullptr;
+    std::rethrow_exception(error);
+  }
+}
+
+void AsyncOutputWriter::Run() {
+  std::unique_lock<std::mutex> lock(m_Mutex);
+  while (true) {
+    m_TaskAdded.wait(lock, [this]() { return m_Stop || !m_Tasks.empty(); });
+    if (m_Tasks.empty()) return;
+
+    TaskType task = std::move(m_Tasks.front());
+    m_Tasks.pop_front();
+    m_Busy = true;
+    lock.unlock();
+
+    /// The writing goes on after a failure : the first error is reported to the next Wait().
+    std::exception_ptr error;
+    try { task(); }
+    catch (...) { error = std::current_exception(); }
+
+    lock.lock();
+    if (error && !m_Error) m_Error = error;
+    m_Busy = false;
+    m_TaskDone.notify_all();
+  }
+}
@@ -0,0 +1,81 @@
+/***************************************************************************************
+*                                                                                      *
+*                                     Deformetrica                                     *
+*                                                                                      *
+*    Copyright Inria and the University of Utah.  All rights reserved. This file is    *
+*    distributed under the terms of the Inria Non-Commercial License Agreement.        *
+*                                                                                      *
+*                                                                                      *
+****************************************************************************************/
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+
+/**
+ *  \brief      Background writer of the output files.
+ *
+ *  \copyright  Inria and the University of Utah
+ *  \version    Deformetrica 2.0
+ *
+ *  \details    The AsyncOutputWriter class runs the writing tasks submitted by the matrix, mesh and image writers on
+ *              one background thread, in submission order, when def::utils::settings.async_output_writing is set :
+ *              the estimators then never wait for the disk when saving the model. The deformation state snapshots go
+ *              through the same thread, so that a single writer has to be drained at exit. A task must own all the
+ *              data it writes (copies of the matrices, deep copies of the meshes, images disconnected from their
+ *              pipeline), since the caller keeps on modifying the model. Otherwise, the tasks are run at once by the
+ *              caller.
+ */
+class AsyncOutputWriter {
+ public:
+
+  typedef std::function<void()> TaskType;
+
+  AsyncOutputWriter(const AsyncOutputWriter &) = delete;
+  AsyncOutputWriter(AsyncOutputWriter &&) = delete;
+
+  AsyncOutputWriter &operator=(const AsyncOutputWriter &) = delete;
+  AsyncOutputWriter &operator=(AsyncOutputWriter &&) = delete;
+
+  static AsyncOutputWriter *instance();
+
+  /// Runs \e task in the background, or at once if the asynchronous writing is disabled. Blocks while too many
+  /// tasks are pending, which bounds the memory held by the snapshots when the disk cannot keep up. Rethrows the
+  /// exception a previous task may have raised.
+  void Submit(TaskType task);
+  /// Same as above, but runs \e task in the background whenever \e asynchronous is set, whatever the
+  /// def::utils::settings.async_output_writing option (e.g. for the deformation state, see async_state_saving).
+  void Submit(TaskType task, bool asynchronous);
+
+  /// Blocks until all the submitted tasks are done, and rethrows the first exception one of them may have raised.
+  void Wait();
+
+ protected:
+
+  AsyncOutputWriter() : m_Busy(false), m_Stop(false) {}
+  ~AsyncOutputWriter();
+
+ private:
+
+  /// Loop of the background thread.
+  void Run();
+
+  /// Maximum number of pending tasks.
+  static const std::size_t kMaxPendingTasks = 256;
+
+  std::mutex m_Mutex;
+  std::condition_variable m_TaskAdded;
+  std::condition_variable m_TaskDone;
+  std::deque<TaskType> m_Tasks;
+  std::thread m_Thread;
+  bool m_Busy;
+  bool m_Stop;
+  std::exception_ptr m_Error;
+
+};
@@ -0,0 +1,182 @@
+/***************************************************************************************
+*                                                                                      *
+*                                     Deformetrica                                     *
+*                                                                                      *
+*    Copyright Inria and the University of Utah.  All rights reserved. This file is    *
+*    distributed under the terms of the Inria Non-Commercial License Agreement.        *
+*                                                                                      *
+*                                                                                      *
+****************************************************************************************/
+
+#include "DeformableObjectLoader.h"
+
+#include "GeneralSettings.h"
+#include "Profiler.h"
+#include <lib/ThreadPool/ThreadPool.h>
+
+#include "itksys/SystemTools.hxx"
+
+#include <cstdint>
+#include <fstream>
+#include <future>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+/// 64-bit FNV-1a hash of the content of \e fileName.
+std::uint64_t HashFileContent(const std::string &fileName) {
+  std::ifstream in(fileName, std::ios::binary);
+  if (!in)
+    throw std::runtime_error("Cannot open the deformable object file " + fileName);
+
+  std::uint64_t hash = 14695981039346656037ULL;
+  std::vector<char> buffer(1 << 16);
+  while (in) {
+    in.read(buffer.data(), buffer.size());
+    const std::streamsize n = in.gcount();
+    for (std::streamsize k = 0; k < n; ++k) {
+      hash ^= static_cast<unsigned char>(buffer[k]);
+      hash *= 1099511628211ULL;
+    }
+  }
+  return hash;
+}
+
+/// Waits for all the tasks, rethrowing the first exception raised by one of them.
+void WaitAll(std::vector<std::future<void>> &tasks) {
+  for (auto &task : tasks) task.wait();
+  for (auto &task : tasks) task.get();
+}
+
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Constructor(s) / Destructor :
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+template<class ScalarType, unsigned int Dimension>
+DeformableObjectLoader<ScalarType, Dimension>
+::DeformableObjectLoader() : m_NumberOfParsedObjects(0) {}
+
+template<class ScalarType, unsigned int Dimension>
+DeformableObjectLoader<ScalarType, Dimension>
+::~DeformableObjectLoader() {}
+
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Encapsulation method(s) :
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+template<class ScalarType, unsigned int Dimension>
+std::size_t
+DeformableObjectLoader<ScalarType, Dimension>
+::AddObject(DeformableObjectParameters::Pointer param, const std::string &fileName, bool isTemplate) {
+  m_Requests.push_back({param, fileName, isTemplate});
+  return m_Requests.size() - 1;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Other method(s) :
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+template<class ScalarType, unsigned int Dimension>
+void
+DeformableObjectLoader<ScalarType, Dimension>
+::Update() {
+  DEF_PROFILE_SCOPE_SIZE("DeformableObjectLoader::Update", m_Requests.size());
+  const std::size_t numberOfRequests = m_Requests.size();
+  std::vector<std::string> keys(numberOfRequests);
+  m_Outputs.assign(numberOfRequests, nullptr);
+  m_NumberOfParsedObjects = 0;
+
+  ThreadPool pool(def::utils::settings.number_of_threads);
+
+  /// Identifies the content of every file.
+  {
+    std::vector<std::future<void>> tasks;
+    for (std::size_t i = 0; i < numberOfRequests; ++i)
+      tasks.push_back(pool.enqueue([&, i]() { keys[i] = ComputeKey(i); }));
+    WaitAll(tasks);
+  }
+
+  /// Parses each distinct content once, the first request holding it being the one actually read.
+  std::map<std::string, std::size_t> firstRequest;
+  for (std::size_t i = 0; i < numberOfRequests; ++i)
+    if (!m_Cache.count(keys[i]) && !firstRequest.count(keys[i]))
+      firstRequest[keys[i]] = i;
+
+  std::vector<std::shared_ptr<AbstractGeometryType>> parsed(numberOfRequests);
+  {
+    std::vector<std::future<void>> tasks;
+    for (const auto &it : firstRequest) {
+      const std::size_t i = it.second;
+      tasks.push_back(pool.enqueue([&, i]() {
+        DeformableObjectReader<ScalarType, Dimension> reader;
+        reader.SetObjectParameters(m_Requests[i].param);
+        reader.SetFileName(m_Requests[i].fileName);
+        if (m_Requests[i].isTemplate) reader.SetTemplateType();
+        {
+          DEF_PROFILE_SCOPE("DeformableObjectReader::Update");
+          reader.Update();
+        }
+        parsed[i] = reader.GetOutput();
+      }));
+    }
+    WaitAll(tasks);
+  }
+
+  for (const auto &it : firstRequest)
+    m_Cache[it.first] = parsed[it.second];
+  m_NumberOfParsedObjects = firstRequest.size();
+
+  for (std::size_t i = 0; i < numberOfRequests; ++i)
+    m_Outputs[i] = m_Cache[keys[i]];
+
+  m_Requests.clear();
+}
+
+template<class ScalarType, unsigned int Dimension>
+void
+DeformableObjectLoader<ScalarType, Dimension>
+::UpdateMultiObjects(const std::vector<std::shared_ptr<DeformableMultiObjectType>> &objects) {
+  ThreadPool pool(def::utils::settings.number_of_threads);
+  std::vector<std::future<void>> tasks;
+  for (const auto &object : objects)
+    tasks.push_back(pool.enqueue([object]() { object->Update(); }));
+  WaitAll(tasks);
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Method(s) :
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+template<class ScalarType, unsigned int Dimension>
+std::string
+DeformableObjectLoader<ScalarType, Dimension>
+::ComputeKey(std::size_t i) const {
+  const Request &request = m_Requests[i];
+  std::ostringstream key;
+  key << request.param.GetPointer() << (request.isTemplate ? ":template:" : ":object:");
+
+  /// Multi-file image formats keep the voxels out of the header file : these are identified by their path instead.
+  const std::string extension = itksys::SystemTools::LowerCase(
+      itksys::SystemTools::GetFilenameLastExtension(request.fileName));
+  if (extension == ".hdr" || extension == ".mhd")
+    key << "path:" << itksys::SystemTools::CollapseFullPath(request.fileName);
+  else
+    key << "content:" << std::hex << HashFileContent(request.fileName)
+        << ":" << std::dec << itksys::SystemTools::FileLength(request.fileName);
+
+  return key.str();
+}
+
+
+template class DeformableObjectLoader<double, 2>;
+template class DeformableObjectLoader<double, 3>;
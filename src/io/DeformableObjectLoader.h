@@ -0,0 +1,125 @@
+/***************************************************************************************
+*                                                                                      *
+*                                     Deformetrica                                     *
+*                                                                                      *
+*    Copyright Inria and the University of Utah.  All rights reserved. This file is    *
+*    distributed under the terms of the Inria Non-Commercial License Agreement.        *
+*                                                                                      *
+*                                                                                      *
+****************************************************************************************/
+
+#pragma once
+
+/// Core files.
+#include "AbstractGeometry.h"
+#include "DeformableMultiObject.h"
+
+/// Input-output files.
+#include "DeformableObjectParameters.h"
+#include "DeformableObjectReader.h"
+
+/// Non-core files.
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+
+/**
+ *  \brief      Reads a whole data set of deformable objects concurrently.
+ *
+ *  \details    The DeformableObjectLoader class queues (parameters, file name) pairs, then reads them all at once
+ *              on a thread pool of def::utils::settings.number_of_threads threads, each task using its own
+ *              DeformableObjectReader. Files are identified by a hash of their content : identical files read with
+ *              the same object parameters (e.g. a template which is also one of the observations, or a repeated
+ *              visit) are parsed only once and share the same geometry. This is safe since
+ *              DeformableMultiObject::SetObjectList() deep-copies the objects it is given.
+ */
+template<class ScalarType, unsigned int Dimension>
+class DeformableObjectLoader {
+ public:
+
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+  // typedef :
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+
+  /// Deformable object type.
+  typedef AbstractGeometry<ScalarType, Dimension> AbstractGeometryType;
+  /// Multi-object type.
+  typedef DeformableMultiObject<ScalarType, Dimension> DeformableMultiObjectType;
+
+
+
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Constructor(s) / Destructor :
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+
+  DeformableObjectLoader();
+
+  ~DeformableObjectLoader();
+
+
+
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Encapsulation method(s) :
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+
+  /// Queues the object stored in \e fileName, read with the parameters \e param. Returns its index for GetOutput().
+  std::size_t AddObject(DeformableObjectParameters::Pointer param, const std::string &fileName,
+                        bool isTemplate = false);
+
+  /// Returns the \e i-th queued object, once Update() has been called.
+  std::shared_ptr<AbstractGeometryType> GetOutput(std::size_t i) const { return m_Outputs.at(i); }
+
+  /// Returns the number of distinct objects actually parsed by the last call to Update().
+  std::size_t GetNumberOfParsedObjects() const { return m_NumberOfParsedObjects; }
+
+
+
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Other method(s) :
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+
+  /// Reads all the queued objects concurrently.
+  void Update();
+
+  /// Updates the multi-objects \e objects concurrently (bounding boxes, centers, normals, image gradients...).
+  static void UpdateMultiObjects(const std::vector<std::shared_ptr<DeformableMultiObjectType>> &objects);
+
+
+
+ protected:
+
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Method(s) :
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+
+  /// Returns the key identifying the content of the \e i-th queued object.
+  std::string ComputeKey(std::size_t i) const;
+
+
+
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Attribute(s)
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+
+  /// A queued read.
+  struct Request {
+    DeformableObjectParameters::Pointer param;
+    std::string fileName;
+    bool isTemplate;
+  };
+
+  /// Queued reads.
+  std::vector<Request> m_Requests;
+
+  /// Objects read, in the order of the requests.
+  std::vector<std::shared_ptr<AbstractGeometryType>> m_Outputs;
+
+  /// Objects already parsed, indexed by content key. Kept from one call to Update() to the next.
+  std::map<std::string, std::shared_ptr<AbstractGeometryType>> m_Cache;
+
+  /// Number of distinct objects parsed by the last call to Update().
+  std::size_t m_NumberOfParsedObjects;
+
+};
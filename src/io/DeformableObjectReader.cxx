@@ -477,6 +477,9 @@ DeformableObjectReader<ScalarType, Dimension>
 #ifdef USE_CUDA
   else if (itksys::SystemTools::Strucmp(kernelType, "cudaexact") == 0) { result = CUDAExact; }
 #endif
+  else if (itksys::SystemTools::Strucmp(kernelType, "cauchy") == 0) { result = Cauchy; }
+  else if (itksys::SystemTools::Strucmp(kernelType, "wendland") == 0) { result = Wendland; }
+  else if (itksys::SystemTools::Strucmp(kernelType, "nystrom") == 0) { result = Nystrom; }
   else {
     if (itksys::SystemTools::Strucmp(kernelType, "exact") != 0)
       std::cerr << "Unknown kernel type for the deformable object : defaulting to exact" << std::endl;
@@ -0,0 +1,255 @@
+/***************************************************************************************
+*                                                                                      *
+*                                     Deformetrica                                     *
+*                                                                                      *
+*    Copyright Inria and the University of Utah.  All rights reserved. This file is    *
+*    distributed under the terms of the Inria Non-Commercial License Agreement.        *
+*                                                                                      *
+*                                                                                      *
+****************************************************************************************/
+
+#include "MatrixBinary.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+const char BINARY_MATRIX_MAGIC[8] = {'D', 'E', 'F', 'M', 'A', 'T', 'B', '\0'};
+const uint32_t BINARY_MATRIX_VERSION = 1;
+/// The header is padded to one page so that the payload is page aligned.
+const uint64_t BINARY_MATRIX_HEADER_SIZE = 4096;
+
+struct BinaryMatrixHeader {
+  uint32_t version;
+  uint32_t scalar_size;
+  uint64_t count;
+  uint64_t rows;
+  uint64_t cols;
+};
+
+bool isLittleEndianHost() {
+  const uint16_t one = 1;
+  return *reinterpret_cast<const uint8_t *>(&one) == 1;
+}
+
+/// Reads an unsigned integer of \e size bytes stored in little-endian order.
+uint64_t getLittleEndian(const char *src, unsigned int size) {
+  uint64_t value = 0;
+  for (unsigned int k = 0; k < size; ++k)
+    value |= static_cast<uint64_t>(static_cast<uint8_t>(src[k])) << (8 * k);
+  return value;
+}
+
+/// Writes the unsigned integer \e value on \e size bytes in little-endian order.
+void putLittleEndian(char *dst, uint64_t value, unsigned int size) {
+  for (unsigned int k = 0; k < size; ++k)
+    dst[k] = static_cast<char>((value >> (8 * k)) & 0xff);
+}
+
+/// Read-only memory mapping of a whole file, released on destruction.
+class MappedFile {
+ public:
+  MappedFile(const char *fn) : m_Data(nullptr), m_Size(0) {
+    const int fd = open(fn, O_RDONLY);
+    if (fd < 0) {
+      std::cout << "error opening file: " << std::string(fn) << std::endl; // to re-route error stream to std::cout
+      throw std::runtime_error("error opening file");
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t) BINARY_MATRIX_HEADER_SIZE) {
+      close(fd);
+      throw std::runtime_error("Binary matrix file " + std::string(fn) + " is too small to hold a header");
+    }
+
+    m_Size = st.st_size;
+    void *data = mmap(nullptr, m_Size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+      throw std::runtime_error("Could not map the binary matrix file " + std::string(fn));
+    m_Data = static_cast<const char *>(data);
+  }
+
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  ~MappedFile() { munmap(const_cast<char *>(m_Data), m_Size); }
+
+  const char *data() const { return m_Data; }
+  size_t size() const { return m_Size; }
+
+  /// Pointer to the payload, following the page-sized header.
+  const char *payload() const { return m_Data + BINARY_MATRIX_HEADER_SIZE; }
+
+ private:
+  const char *m_Data;
+  size_t m_Size;
+};
+
+/// Maps \e fn, and checks and decodes its header.
+std::unique_ptr<MappedFile> mapMatrixFile(const char *fn, BinaryMatrixHeader &header) {
+  std::unique_ptr<MappedFile> file(new MappedFile(fn));
+  const char *h = file->data();
+
+  if (std::memcmp(h, BINARY_MATRIX_MAGIC, sizeof(BINARY_MATRIX_MAGIC)) != 0)
+    throw std::runtime_error("File " + std::string(fn) + " is not a binary matrix file");
+
+  header.version = getLittleEndian(h + 8, 4);
+  header.scalar_size = getLittleEndian(h + 12, 4);
+  header.count = getLittleEndian(h + 16, 8);
+  header.rows = getLittleEndian(h + 24, 8);
+  header.cols = getLittleEndian(h + 32, 8);
+
+  if (header.version > BINARY_MATRIX_VERSION)
+    throw std::runtime_error("Binary matrix file " + std::string(fn) + " has an unsupported version");
+  if (header.scalar_size != sizeof(float) && header.scalar_size != sizeof(double))
+    throw std::runtime_error("Binary matrix file " + std::string(fn) + " has an unsupported scalar type");
+  if (file->size() < BINARY_MATRIX_HEADER_SIZE + header.count * header.rows * header.cols * header.scalar_size)
+    throw std::runtime_error("Binary matrix file " + std::string(fn) + " is truncated");
+
+  return file;
+}
+
+/// Copies the \e k-th matrix of a payload. When the scalar type and the byte order are the host's, this is a single
+/// block copy out of the mapped pages; otherwise each scalar is decoded.
+template<class ScalarType>
+MatrixType copyMatrix(const char *payload, const BinaryMatrixHeader &header, uint64_t k) {
+  const uint64_t n = header.rows * header.cols;
+  const char *src = payload + k * n * header.scalar_size;
+
+  MatrixType M(header.rows, header.cols, 0);
+  ScalarType *dst = M.begin();
+  if (isLittleEndianHost() && header.scalar_size == sizeof(ScalarType)) {
+    std::memcpy(dst, src, n * sizeof(ScalarType));
+    return M;
+  }
+
+  for (uint64_t i = 0; i < n; ++i, src += header.scalar_size) {
+    const uint64_t bits = getLittleEndian(src, header.scalar_size);
+    if (header.scalar_size == sizeof(float)) {
+      uint32_t b = bits;
+      float f;
+      std::memcpy(&f, &b, sizeof(float));
+      dst[i] = f;
+    } else {
+      double d;
+      std::memcpy(&d, &bits, sizeof(double));
+      dst[i] = d;
+    }
+  }
+  return M;
+}
+
+template<class ScalarType>
+void writeMatrices(const std::string &fn, const std::vector<const MatrixType *> &M) {
+  const uint64_t rows = M.size() ? M[0]->rows() : 0;
+  const uint64_t cols = M.size() ? M[0]->cols() : 0;
+  for (auto m : M)
+    if (m->rows() != rows || m->cols() != cols)
+      throw std::runtime_error("Matrices written to a binary matrix file must have the same size");
+
+  char header[BINARY_MATRIX_HEADER_SIZE];
+  std::memset(header, 0, BINARY_MATRIX_HEADER_SIZE);
+  std::memcpy(header, BINARY_MATRIX_MAGIC, sizeof(BINARY_MATRIX_MAGIC));
+  putLittleEndian(header + 8, BINARY_MATRIX_VERSION, 4);
+  putLittleEndian(header + 12, sizeof(ScalarType), 4);
+  putLittleEndian(header + 16, M.size(), 8);
+  putLittleEndian(header + 24, rows, 8);
+  putLittleEndian(header + 32, cols, 8);
+
+  /// Written next to the destination and renamed into place, so that a file mapped by a reader is never truncated
+  /// or rewritten in place, and an interrupted write does not leave a partial file behind.
+  const std::string tmp = fn + ".tmp";
+  std::ofstream outfile(tmp, std::ios::binary);
+  if (!outfile)
+    throw std::runtime_error("Could not open " + tmp + " for writing");
+  outfile.write(header, BINARY_MATRIX_HEADER_SIZE);
+
+  const bool native = isLittleEndianHost();
+  std::vector<char> buffer;
+  for (auto m : M) {
+    const ScalarType *mem = m->memptr();
+    if (native) {
+      outfile.write(reinterpret_cast<const char *>(mem), m->size() * sizeof(ScalarType));
+    } else {
+      buffer.resize(m->size() * sizeof(ScalarType));
+      for (unsigned int i = 0; i < m->size(); ++i) {
+        uint64_t bits = 0;
+        std::memcpy(&bits, mem + i, sizeof(ScalarType));
+        putLittleEndian(buffer.data() + i * sizeof(ScalarType), bits, sizeof(ScalarType));
+      }
+      outfile.write(buffer.data(), buffer.size());
+    }
+  }
+
+  outfile.close();
+  if (!outfile) {
+    std::remove(tmp.c_str());
+    throw std::runtime_error("Could not write the binary matrix file " + fn);
+  }
+  if (std::rename(tmp.c_str(), fn.c_str()) != 0) {
+    std::remove(tmp.c_str());
+    throw std::runtime_error("Could not move " + tmp + " to " + fn);
+  }
+}
+
+}
+
+bool isMatrixBinaryFile(const std::string &fn) {
+  return fn.size() >= BINARY_MATRIX_EXTENSION.size()
+      && fn.compare(fn.size() - BINARY_MATRIX_EXTENSION.size(), BINARY_MATRIX_EXTENSION.size(),
+                    BINARY_MATRIX_EXTENSION) == 0;
+}
+
+template<class ScalarType>
+MatrixType readMatrixBinary(const char *fn) {
+  BinaryMatrixHeader header;
+  const std::unique_ptr<MappedFile> file = mapMatrixFile(fn, header);
+
+  if (header.count != 1)
+    throw std::runtime_error("Binary matrix file " + std::string(fn) + " holds a list of matrices, not a matrix");
+
+  return copyMatrix<ScalarType>(file->payload(), header, 0);
+}
+
+template<class ScalarType>
+std::vector<MatrixType> readMultipleMatrixBinary(const char *fn) {
+  BinaryMatrixHeader header;
+  const std::unique_ptr<MappedFile> file = mapMatrixFile(fn, header);
+
+  std::vector<MatrixType> M;
+  M.reserve(header.count);
+  for (uint64_t k = 0; k < header.count; ++k)
+    M.push_back(copyMatrix<ScalarType>(file->payload(), header, k));
+
+  return M;
+}
+
+template<class ScalarType>
+void writeMatrixBinary(std::string fn, const MatrixType &M) {
+  writeMatrices<ScalarType>(fn, std::vector<const MatrixType *>(1, &M));
+}
+
+template<class ScalarType>
+void writeMultipleMatrixBinary(std::string fn, MatrixListType const &M) {
+  std::vector<const MatrixType *> matrices(M.size());
+  for (unsigned int n = 0; n < M.size(); ++n)
+    matrices[n] = &M[n];
+  writeMatrices<ScalarType>(fn, matrices);
+}
+
+template MatrixType readMatrixBinary<double>(const char *fn);
+template std::vector<MatrixType> readMultipleMatrixBinary<double>(const char *fn);
+template void writeMatrixBinary<double>(std::string fn, const MatrixType &M);
+template void writeMultipleMatrixBinary<double>(std::string fn, MatrixListType const &M);
@@ -0,0 +1,49 @@
+/***************************************************************************************
+*                                                                                      *
+*                                     Deformetrica                                     *
+*                                                                                      *
+*    Copyright Inria and the University of Utah.  All rights reserved. This file is    *
+*    distributed under the terms of the Inria Non-Commercial License Agreement.        *
+*                                                                                      *
+*                                                                                      *
+****************************************************************************************/
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "LinearAlgebra.h"
+
+using namespace def::algebra;
+
+/**
+ *  Binary matrix files (extension ".bmat").
+ *
+ *  A file holds a list of \e count matrices of identical size (a single matrix being a list of one element). It
+ *  starts with a little-endian header padded to one page, followed by the matrices stored contiguously in
+ *  column-major order, so that the payload is page aligned and can be copied out of a memory mapping in one block:
+ *
+ *    magic "DEFMATB" + '\0' | uint32 version | uint32 scalar size | uint64 count | uint64 rows | uint64 cols
+ *
+ *  The returned matrices own their memory: the file is unmapped before the read returns. Files are written to a
+ *  temporary file which is then renamed into place.
+ */
+
+/// Extension of the binary matrix files.
+const std::string BINARY_MATRIX_EXTENSION = ".bmat";
+
+/// Returns true if \e fn has the extension of a binary matrix file.
+bool isMatrixBinaryFile(const std::string &fn);
+
+template <class ScalarType>
+MatrixType readMatrixBinary(const char* fn);
+
+template <class ScalarType>
+std::vector<MatrixType> readMultipleMatrixBinary(const char* fn);
+
+template <class ScalarType>
+void writeMatrixBinary(std::string fn, const MatrixType & M);
+
+template <class ScalarType>
+void writeMultipleMatrixBinary(std::string fn, MatrixListType const& M);
@@ -15,8 +15,20 @@
 #include <sstream>
 #include <string>
 
+#include "AsyncOutputWriter.h"
+#include "GeneralSettings.h"
+
+std::string matrixFileExtension() {
+  return def::utils::settings.binary_matrix_output ? BINARY_MATRIX_EXTENSION : ".txt";
+}
+
 template<class ScalarType>
 MatrixType readMatrixDLM(const char *fn) {
+  /// The file may be pending in the background writer.
+  AsyncOutputWriter::instance()->Wait();
+
+  if (isMatrixBinaryFile(fn))
+    return readMatrixBinary<ScalarType>(fn);
 
 //	std::cout << "Reading " << fn << std::endl;
 
@@ -78,6 +90,10 @@ MatrixType readMatrixDLM(const char *fn) {
 
 template<class ScalarType>
 std::vector<MatrixType> readMultipleMatrixDLM(const char *fn) {
+  AsyncOutputWriter::instance()->Wait();
+
+  if (isMatrixBinaryFile(fn))
+    return readMultipleMatrixBinary<ScalarType>(fn);
 
 //	std::cout << "Reading " << fn << std::endl;
 
@@ -128,8 +144,15 @@ std::vector<MatrixType> readMultipleMatrixDLM(const char *fn) {
   return M;
 }
 
+namespace {
+
 template<class ScalarType>
-void writeMatrixDLM(std::string fn, const MatrixType &M) {
+void writeMatrixDLMNow(std::string fn, const MatrixType &M) {
+  if (isMatrixBinaryFile(fn)) {
+    writeMatrixBinary<ScalarType>(fn, M);
+    return;
+  }
+
   unsigned int numRows = M.rows();
   unsigned int numCols = M.columns();
   if (numRows == 0 || numCols == 0)
@@ -147,7 +170,12 @@ void writeMatrixDLM(std::string fn, const MatrixType &M) {
 }
 
 template<class ScalarType>
-void writeMultipleMatrixDLM(std::string fn, MatrixListType const &M) {
+void writeMultipleMatrixDLMNow(std::string fn, MatrixListType const &M) {
+  if (isMatrixBinaryFile(fn)) {
+    writeMultipleMatrixBinary<ScalarType>(fn, M);
+    return;
+  }
+
   std::ofstream outfile(fn);
 
   unsigned int N = M.size();
@@ -172,6 +200,19 @@ void writeMultipleMatrixDLM(std::string fn, MatrixListType const &M) {
   outfile.close();
 }
 
+}
+
+/// The matrices are copied into the writing task, so that the caller may modify them right away.
+template<class ScalarType>
+void writeMatrixDLM(std::string fn, const MatrixType &M) {
+  AsyncOutputWriter::instance()->Submit([fn, M]() { writeMatrixDLMNow<ScalarType>(fn, M); });
+}
+
+template<class ScalarType>
+void writeMultipleMatrixDLM(std::string fn, MatrixListType const &M) {
+  AsyncOutputWriter::instance()->Submit([fn, M]() { writeMultipleMatrixDLMNow<ScalarType>(fn, M); });
+}
+
 template <class ScalarType>
 void printMatrix(std::string const name, MatrixType const &M){
 
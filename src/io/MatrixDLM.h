@@ -15,9 +15,15 @@
 #include <string>
 
 #include "LinearAlgebra.h"
+#include "MatrixBinary.h"
 
 using namespace def::algebra;
 
+/// The readers and writers below handle the binary format when the file name has the BINARY_MATRIX_EXTENSION
+/// extension (see MatrixBinary.h), and the text format otherwise.
+/// The writers go through the AsyncOutputWriter : the file may still be pending when they return, and the readers
+/// wait for the pending files first.
+
 template <class ScalarType>
 MatrixType readMatrixDLM(const char* fn);
 
@@ -30,6 +36,10 @@ void writeMatrixDLM(std::string fn, const MatrixType & M);
 template <class ScalarType>
 void writeMultipleMatrixDLM(std::string fn, MatrixListType const& M);
 
+/// Returns the extension of the matrix files written by the models: ".txt", or BINARY_MATRIX_EXTENSION when
+/// def::utils::settings.binary_matrix_output is set.
+std::string matrixFileExtension();
+
 template<class ScalarType>
 void printMatrix(std::string const name, MatrixType const& M);
 
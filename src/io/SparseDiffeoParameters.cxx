@@ -52,6 +52,8 @@ SparseDiffeoParameters
   m_CovarianceMomentaInverse_fn = "";
   m_ModelType = "Undefined";
   m_MaximumNumberOfClasses = 1;
+  m_MixtureResponsibilityThreshold = 0.0;
+  m_MixtureRefreshPeriod = 10;
 
   m_ModelName = "";
 
@@ -59,6 +61,10 @@ SparseDiffeoParameters
   m_InitialTemperature = 100.0;
   m_TemperingDurationRatio = 0.5;
 
+  m_NumberOfChains = 1;
+  m_MaximumChainTemperature = 10.0;
+  m_ChainsSwapEveryNIters = 1;
+
   m_FreezeCP = false;
   m_FreezeTemplate = false;
 
@@ -95,6 +101,9 @@ SparseDiffeoParameters
   m_NumberOfTimePointsForExponentiation = 10;
   m_MarginOnGeodesicLength = 1.25;
 
+  m_NumberOfTimeSlices = 1;
+  m_PararealTolerance = 1e-6;
+
   m_NumberOfSources = 4;
 
   m_LogAccelerationRandomEffectStd = -1;
@@ -119,6 +119,12 @@ class SparseDiffeoParameters : public itk::Object {
   itkGetMacro(MaximumNumberOfClasses, int);
   itkSetMacro(MaximumNumberOfClasses, int);
 
+  itkGetMacro(MixtureResponsibilityThreshold, double);
+  itkSetMacro(MixtureResponsibilityThreshold, double);
+
+  itkGetMacro(MixtureRefreshPeriod, unsigned int);
+  itkSetMacro(MixtureRefreshPeriod, unsigned int);
+
   itkGetMacro(CovarianceMomentaInverse_fn, std::string);
   itkSetMacro(CovarianceMomentaInverse_fn, std::string);
 
@@ -175,6 +181,15 @@ class SparseDiffeoParameters : public itk::Object {
   itkGetMacro(TemperingDurationRatio, double);
   itkSetMacro(TemperingDurationRatio, double);
 
+  itkGetMacro(NumberOfChains, unsigned int);
+  itkSetMacro(NumberOfChains, unsigned int);
+
+  itkGetMacro(MaximumChainTemperature, double);
+  itkSetMacro(MaximumChainTemperature, double);
+
+  itkGetMacro(ChainsSwapEveryNIters, unsigned int);
+  itkSetMacro(ChainsSwapEveryNIters, unsigned int);
+
   void SetFreezeCP() {m_FreezeCP = true;}
   void UnsetFreezeCP() {m_FreezeCP = false;}
   bool FreezeCP() {return m_FreezeCP;}
@@ -224,6 +239,11 @@ class SparseDiffeoParameters : public itk::Object {
   itkGetMacro(MarginOnGeodesicLength, double);
   itkSetMacro(MarginOnGeodesicLength, double);
 
+  itkGetMacro(NumberOfTimeSlices, unsigned int);
+  itkSetMacro(NumberOfTimeSlices, unsigned int);
+  itkGetMacro(PararealTolerance, double);
+  itkSetMacro(PararealTolerance, double);
+
   itkGetMacro(NumberOfSources, unsigned int);
   itkSetMacro(NumberOfSources, unsigned int);
 
@@ -431,6 +451,8 @@ class SparseDiffeoParameters : public itk::Object {
 //	bool m_BayesianFramework;
   std::string m_ModelType;
   int m_MaximumNumberOfClasses;
+  double m_MixtureResponsibilityThreshold;
+  unsigned int m_MixtureRefreshPeriod;
   std::string m_CovarianceMomenta_Prior_Inverse_fn; // Inverse of the Prior of the Cov Momenta in a Bayesian Framework
   std::string m_CovarianceMomentaInverse_fn; // Matrix to use in place of the kernel in a Deterministic Framework
 
@@ -440,6 +462,10 @@ class SparseDiffeoParameters : public itk::Object {
   double m_InitialTemperature;
   double m_TemperingDurationRatio;
 
+  unsigned int m_NumberOfChains;
+  double m_MaximumChainTemperature;
+  unsigned int m_ChainsSwapEveryNIters;
+
   bool m_FreezeCP;
   bool m_FreezeTemplate;
   std::string m_InitialCPPosition_fn;
@@ -475,6 +501,9 @@ class SparseDiffeoParameters : public itk::Object {
   unsigned int m_NumberOfTimePointsForExponentiation;
   double m_MarginOnGeodesicLength;
 
+  unsigned int m_NumberOfTimeSlices;
+  double m_PararealTolerance;
+
   unsigned int m_NumberOfSources;
 
   double m_LogAccelerationRandomEffectStd;
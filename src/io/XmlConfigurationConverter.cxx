@@ -111,7 +111,7 @@ void XmlConfigurationConverter::programming_xml_model(XmlDictionary& xml, Sparse
   xml["deformation-parameters"]["kernel-width"].assign_to<double>(sp, &SparseDiffeoParameters::SetKernelWidth);
 
   xml["deformation-parameters"]["kernel-type"]
-      .one_of<std::string>("EXACT","CUDAEXACT","P3M","COMPACT")
+      .one_of<std::string>("EXACT","CUDAEXACT","P3M","COMPACT","CAUCHY","WENDLAND","NYSTROM")
       .assign_to<std::string>(sp, &SparseDiffeoParameters::SetKernelType);
 
   xml["deformation-parameters"]["t0"]
@@ -141,6 +141,10 @@ void XmlConfigurationConverter::programming_xml_model(XmlDictionary& xml, Sparse
       .assign_to<unsigned int>(sp, &SparseDiffeoParameters::SetNumberOfTimePointsForExponentiation);
   xml["deformation-parameters"]["margin-on-geodesic"]
       .assign_to<double>(sp, &SparseDiffeoParameters::SetMarginOnGeodesicLength);
+  xml["deformation-parameters"]["number-of-time-slices"]
+      .assign_to<unsigned int>(sp, &SparseDiffeoParameters::SetNumberOfTimeSlices);
+  xml["deformation-parameters"]["parareal-tolerance"]
+      .assign_to<double>(sp, &SparseDiffeoParameters::SetPararealTolerance);
 
   ///For LDA model:
   xml["intra-class-pca-dimension"]
@@ -225,6 +229,8 @@ void XmlConfigurationConverter::programming_xml_optimization_parameters(XmlDicti
   xml["covariance-momenta-prior-inverse-fn"].assign_to<std::string>(sp, &SparseDiffeoParameters::SetCovarianceMomenta_Prior_Inverse_fn);
   xml["covariance-momenta-inverse-fn"].assign_to<std::string>(sp, &SparseDiffeoParameters::SetCovarianceMomentaInverse_fn);
   xml["maximum-number-of-class"].assign_to<int>(sp, &SparseDiffeoParameters::SetMaximumNumberOfClasses);
+  xml["mixture-responsibility-threshold"].assign_to<double>(sp, &SparseDiffeoParameters::SetMixtureResponsibilityThreshold);
+  xml["mixture-refresh-period"].assign_to<unsigned int>(sp, &SparseDiffeoParameters::SetMixtureRefreshPeriod);
   xml["smoothing-kernel-with-ratio"].assign_to<double>(sp, &SparseDiffeoParameters::SetSmoothingKernelWidthRatio);
 
   xml["use-tempering"]
@@ -235,6 +241,10 @@ void XmlConfigurationConverter::programming_xml_optimization_parameters(XmlDicti
   xml["initial-temperature"].assign_to<double>(sp, &SparseDiffeoParameters::SetInitialTemperature);
   xml["tempering-duration-ratio"].assign_to<double>(sp, &SparseDiffeoParameters::SetTemperingDurationRatio);
 
+  xml["number-of-chains"].assign_to<unsigned int>(sp, &SparseDiffeoParameters::SetNumberOfChains);
+  xml["maximum-chain-temperature"].assign_to<double>(sp, &SparseDiffeoParameters::SetMaximumChainTemperature);
+  xml["chains-swap-every-n-iters"].assign_to<unsigned int>(sp, &SparseDiffeoParameters::SetChainsSwapEveryNIters);
+
   xml["freeze-cp"]
       .filter_with(def::io::filters::lower_case())
       .add_reader([sp](const std::string &v) {
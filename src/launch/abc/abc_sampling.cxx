@@ -116,7 +116,6 @@ void abc_sampling(std::shared_ptr<const def::io::XmlModel> xml_model)
   std::vector<std::string> subjectClasses(numSubjects);
   std::vector<std::string> classesFound;
   std::vector<bool> belongsToTestSet(numSubjects);
-  srand(time(NULL));
 
   std::cout << "Parsing the xml and building objects..." << std::endl;
 
@@ -208,6 +207,15 @@ void abc_sampling(std::shared_ptr<const def::io::XmlModel> xml_model)
         def->SetKernelType(CUDAExact);
       }
 #endif
+  else if (itksys::SystemTools::Strucmp(paramDiffeos->GetKernelType().c_str(), "cauchy") == 0) {
+    def->SetKernelType(Cauchy);
+  }
+  else if (itksys::SystemTools::Strucmp(paramDiffeos->GetKernelType().c_str(), "wendland") == 0) {
+    def->SetKernelType(Wendland);
+  }
+  else if (itksys::SystemTools::Strucmp(paramDiffeos->GetKernelType().c_str(), "nystrom") == 0) {
+    def->SetKernelType(Nystrom);
+  }
   else {
     if (itksys::SystemTools::Strucmp(paramDiffeos->GetKernelType().c_str(), "exact") != 0)
       std::cerr << "Unknown kernel type for the deformation : defaulting to exact" << std::endl;
@@ -297,7 +305,7 @@ void abc_sampling(std::shared_ptr<const def::io::XmlModel> xml_model)
         ///Sampling parameters
         for (unsigned j = 0; j < numberOfControlPoints; ++j) {
           unsigned int nbPoints = randomTemplate->GetNumberOfPoints()[0];
-          randomIntControlPoint = rand() % nbPoints;
+          randomIntControlPoint = RandomNumberGenerator::instance()->Bits() % nbPoints;
           if (randomTemplate->IsOfLandmarkKind()[0])
             aux = randomTemplate->GetLandmarkPoints().get_row(randomIntControlPoint);
           else
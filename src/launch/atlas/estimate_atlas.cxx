@@ -160,33 +160,32 @@ void estimateAtlas(std::shared_ptr<const def::io::XmlModel> xml_model) {
     AbstractGeometryListType Aux(numObjects);
     targetObjectList[s] = std::move(Aux);
   }
-  /// Scans the list of objects.
-  typedef DeformableObjectReader<ScalarType, Dimension> ObjectReaderType;
+  /// Reads the template and target objects concurrently.
+  DeformableObjectLoader<ScalarType, Dimension> loader;
+  std::vector<std::vector<std::size_t>> targetRequests(numSubjects, std::vector<std::size_t>(numObjects));
+  std::vector<std::size_t> templateRequests(numObjects);
   std::size_t i_object = 0;
   for (auto it : xml_model->param_objects) {
     std::size_t i_subject = 0;
-    for (auto subject_filename : xml_model->subjects_filename_by_object_id(it.first)) {
-      ObjectReaderType reader;
-      reader.SetObjectParameters(it.second);
-      reader.SetFileName(subject_filename);
-      reader.Update();
-      targetObjectList[i_subject++][i_object] = reader.GetOutput();
-    }
-    ObjectReaderType reader;
-    reader.SetObjectParameters(it.second);
-    reader.SetTemplateType();
-    auto fn = it.second->GetFilename();
-    reader.SetFileName(fn);
-    reader.Update();
-    templateObjectList[i_object++] = reader.GetOutput();
+    for (auto subject_filename : xml_model->subjects_filename_by_object_id(it.first))
+      targetRequests[i_subject++][i_object] = loader.AddObject(it.second, subject_filename);
+    templateRequests[i_object++] = loader.AddObject(it.second, it.second->GetFilename(), true);
   } // End scanning objects.
-  /// Creates multi-objects for template aÒ/nd targets.
+  loader.Update();
+
+  for (unsigned int s = 0; s < numSubjects; s++)
+    for (unsigned int i = 0; i < numObjects; i++)
+      targetObjectList[s][i] = loader.GetOutput(targetRequests[s][i]);
+  for (unsigned int i = 0; i < numObjects; i++)
+    templateObjectList[i] = loader.GetOutput(templateRequests[i]);
+
+  /// Creates multi-objects for template and targets.
   typename std::vector<std::shared_ptr<DeformableMultiObjectType>> target(numSubjects);
   for (unsigned int s = 0; s < numSubjects; s++) {
     target[s] = std::make_shared<DeformableMultiObjectType>();
     target[s]->SetObjectList(targetObjectList[s]);
-    target[s]->Update();
   }
+  DeformableObjectLoader<ScalarType, Dimension>::UpdateMultiObjects(target);
   std::shared_ptr<DeformableMultiObjectType> templateObjects = std::make_shared<DeformableMultiObjectType>();
   templateObjects->SetObjectList(templateObjectList);
   templateObjects->Update();
@@ -246,6 +245,9 @@ void estimateAtlas(std::shared_ptr<const def::io::XmlModel> xml_model) {
   else {def -> UnsetUseFastConvolutions();}
   if (not(paramDiffeos->UseImprovedEuler()))
     def->UseStandardEuler();
+  /// The kernel matrix of frozen control points is computed once for the whole estimation.
+  if (paramDiffeos->FreezeCP())
+    def->SetFrozenStartPositions();
   if (paramDiffeos->ComputeTrueInverseFlow() == SparseDiffeoParameters::On) {
     std::cout
         << "Warning : an active compute-true-inverse-flow flag is usually not advised when used for the atlas model."
@@ -264,6 +266,15 @@ void estimateAtlas(std::shared_ptr<const def::io::XmlModel> xml_model) {
       def->SetKernelType(CUDAExact);
     }
 #endif
+  else if (itksys::SystemTools::Strucmp(paramDiffeos->GetKernelType().c_str(), "cauchy") == 0) {
+    def->SetKernelType(Cauchy);
+  }
+  else if (itksys::SystemTools::Strucmp(paramDiffeos->GetKernelType().c_str(), "wendland") == 0) {
+    def->SetKernelType(Wendland);
+  }
+  else if (itksys::SystemTools::Strucmp(paramDiffeos->GetKernelType().c_str(), "nystrom") == 0) {
+    def->SetKernelType(Nystrom);
+  }
   else {
     if (itksys::SystemTools::Strucmp(paramDiffeos->GetKernelType().c_str(), "exact") != 0)
       std::cerr << "Unknown kernel type for the deformation : defaulting to exact." << std::endl;
@@ -396,6 +407,8 @@ void estimateAtlas(std::shared_ptr<const def::io::XmlModel> xml_model) {
       atlases[k]->SetDataSigmaSquared_Prior(DataSigmaSquared_Prior);
     }
     bayesianAtlasMixtureModel->SetAtlases(atlases);
+    bayesianAtlasMixtureModel->SetResponsibilityThreshold(paramDiffeos->GetMixtureResponsibilityThreshold());
+    bayesianAtlasMixtureModel->SetPrunedPairsRefreshPeriod(paramDiffeos->GetMixtureRefreshPeriod());
     if (useSrwMhwgSaem) {
       McmcSaemType *mcmcSaemEstimator = new McmcSaemType();
       std::shared_ptr<SrwMhwgSamplerType> sampler = std::make_shared<SrwMhwgSamplerType>();
@@ -611,6 +624,9 @@ void estimateAtlas(std::shared_ptr<const def::io::XmlModel> xml_model) {
     auto sampler = saem->GetSampler();
     saem->SetMemoryWindowSize(paramDiffeos->GetPrintAcceptanceRatesWindow());
     saem->SetAdaptMemoryWindowSize(paramDiffeos->GetAdaptiveAcceptanceRatesWindow());
+    saem->SetNumberOfChains(paramDiffeos->GetNumberOfChains());
+    saem->SetMaximumChainTemperature(paramDiffeos->GetMaximumChainTemperature());
+    saem->SetChainsSwapEveryNIters(paramDiffeos->GetChainsSwapEveryNIters());
     const unsigned int arw = paramDiffeos->GetAdaptiveAcceptanceRatesWindow();
     if (arw < 1) { saem->UnsetAdaptiveMode(); }
     else {
@@ -29,6 +29,7 @@
 #include "ProbabilityDistributions.h"
 #include "LinearAlgebra.h"
 #include "DeformableObjectReader.h"
+#include "DeformableObjectLoader.h"
 #include "SimpleTimer.h"
 
 /// Input-output files.
@@ -109,6 +109,15 @@ int main(int argc, char** argv) {
         def->SetKernelType(CUDAExact);
     }
 #endif
+    else if (itksys::SystemTools::Strucmp(paramDiffeos->GetKernelType().c_str(), "cauchy") == 0) {
+        def->SetKernelType(Cauchy);
+    }
+    else if (itksys::SystemTools::Strucmp(paramDiffeos->GetKernelType().c_str(), "wendland") == 0) {
+        def->SetKernelType(Wendland);
+    }
+    else if (itksys::SystemTools::Strucmp(paramDiffeos->GetKernelType().c_str(), "nystrom") == 0) {
+        def->SetKernelType(Nystrom);
+    }
     else {
         if (itksys::SystemTools::Strucmp(paramDiffeos->GetKernelType().c_str(), "exact") != 0)
             std::cerr << "Unknown kernel type for the deformation : defaulting to exact" << std::endl;
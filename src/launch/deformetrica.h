@@ -10,6 +10,7 @@
 #pragma once
 
 #include <src/io/XmlConfigurationConverter.h>
+#include <src/io/AsyncOutputWriter.h>
 #include <src/launch/abc/abc_sampling.cxx>
 #include <src/launch/atlas/estimate_atlas.h>
 #include <src/launch/longitudinal_atlas/estimate_longitudinal_atlas.h>
@@ -19,6 +20,9 @@
 #include <src/launch/parallel_transport/parallel_transport.h>
 #include <src/support/utilities/Utils.hpp>
 #include <src/support/utilities/GeneralSettings.h>
+#include <src/support/utilities/Profiler.h>
+#include <src/support/fast_math/MathFunctions.h>
+#include <src/support/probability_distributions/RandomNumberGenerator.h>
 #include <boost/exception/all.hpp>
 
 enum type {
@@ -51,7 +55,16 @@ enum cmdline_position {
 enum cmdline_options {
   _INPUT_STATE_FILE_,
   _OUTPUT_STATE_FILE_,
-  _OUTPUT_DIR_
+  _OUTPUT_DIR_,
+  _STATE_FORMAT_,
+  _MATRIX_FORMAT_,
+  _SEED_,
+  _PROFILE_,
+  _TRACE_FILE_,
+  _MESH_FORMAT_,
+  _SYNCHRONOUS_OUTPUT_,
+  _EXP_DEGREE_,
+  _NYSTROM_TOLERANCE_
 };
 
 void deformetrica(int argc, char **argv) {
@@ -68,7 +81,10 @@ void deformetrica(int argc, char **argv) {
               << " {registration, atlas, regression, longitudinal, longitudinal-registration, parallel-transport} "
               "{2D, 3D} <model.xml> <data_set.xml> <optimization_parameters.xml> "
               "[--input-state-file=<filename.bin>] [--output-state-file=<filename.bin>] [--save-period=<integer>] "
-              "[--output-dir=<path>]"
+              "[--output-dir=<path>] [--state-format={text, binary, compressed}] "
+              "[--matrix-format={text, binary}] [--mesh-format={text, binary}] [--synchronous-output] "
+              "[--seed=<integer>] [--profile] [--trace-file=<filename.json>] [--exp-degree=<3..13>] "
+              "[--nystrom-tolerance=<value>]"
               << std::endl;
 
     exit(-1);
@@ -82,12 +98,23 @@ void deformetrica(int argc, char **argv) {
   index["--input-state-file="] = _INPUT_STATE_FILE_;
   index["--output-state-file="] = _OUTPUT_STATE_FILE_;
   index["--output-dir="] = _OUTPUT_DIR_;
+  index["--state-format="] = _STATE_FORMAT_;
+  index["--matrix-format="] = _MATRIX_FORMAT_;
+  index["--seed="] = _SEED_;
+  index["--profile"] = _PROFILE_;
+  index["--trace-file="] = _TRACE_FILE_;
+  index["--mesh-format="] = _MESH_FORMAT_;
+  index["--synchronous-output"] = _SYNCHRONOUS_OUTPUT_;
+  index["--exp-degree="] = _EXP_DEGREE_;
+  index["--nystrom-tolerance="] = _NYSTROM_TOLERANCE_;
 
   std::for_each(argv, argv + argc, [&](char *v) {
     std::string s(v);
     int i = s_argv.size();
     int j = s_opt.size();
-    for (std::string op : {"--input-state-file=", "--output-state-file=", "--output-dir="}) {
+    for (std::string op : {"--input-state-file=", "--output-state-file=", "--output-dir=", "--state-format=",
+                           "--matrix-format=", "--seed=", "--profile", "--trace-file=", "--mesh-format=",
+                           "--synchronous-output", "--exp-degree=", "--nystrom-tolerance="}) {
       if (std::string::npos != s.find(op)) {
         s_opt[index[op]] = s.erase(0, op.size());
         return;
@@ -103,6 +130,14 @@ void deformetrica(int argc, char **argv) {
   def::utils::settings.load_state = false;
   def::utils::settings.output_state_filename = "deformetrica-state.bin";
   def::utils::settings.output_dir = "./";
+  def::utils::settings.state_format = def::utils::BinaryArchive;
+  def::utils::settings.async_state_saving = true;
+  def::utils::settings.binary_matrix_output = false;
+  def::utils::settings.binary_vtk_output = false;
+  def::utils::settings.async_output_writing = true;
+  def::utils::settings.profiling = false;
+  def::utils::settings.exp_polynomial_degree = fast_math::kExpMaxDegree;
+  def::utils::settings.nystrom_tolerance = 1e-4;
 
   if (s_opt.size()) {
     if (s_opt.find(_INPUT_STATE_FILE_) != s_opt.end()) {
@@ -121,8 +156,83 @@ void deformetrica(int argc, char **argv) {
             def::utils::settings.output_dir + def::utils::settings.output_state_filename;
       }
     }
+
+    if (s_opt.find(_STATE_FORMAT_) != s_opt.end()) {
+      std::map<std::string, def::utils::StateFormatType> state_formats;
+      state_formats["text"] = def::utils::TextArchive;
+      state_formats["binary"] = def::utils::BinaryArchive;
+      state_formats["compressed"] = def::utils::CompressedArchive;
+
+      cmdline_assert(state_formats.count(s_opt[_STATE_FORMAT_]) > 0,
+                     "Error: available state formats are 'text', 'binary' or 'compressed'");
+      def::utils::settings.state_format = state_formats[s_opt[_STATE_FORMAT_]];
+    }
+
+    if (s_opt.find(_MATRIX_FORMAT_) != s_opt.end()) {
+      cmdline_assert(s_opt[_MATRIX_FORMAT_] == "text" || s_opt[_MATRIX_FORMAT_] == "binary",
+                     "Error: available matrix formats are 'text' or 'binary'");
+      def::utils::settings.binary_matrix_output = (s_opt[_MATRIX_FORMAT_] == "binary");
+    }
+
+    if (s_opt.find(_MESH_FORMAT_) != s_opt.end()) {
+      cmdline_assert(s_opt[_MESH_FORMAT_] == "text" || s_opt[_MESH_FORMAT_] == "binary",
+                     "Error: available mesh formats are 'text' or 'binary'");
+      def::utils::settings.binary_vtk_output = (s_opt[_MESH_FORMAT_] == "binary");
+    }
+
+    if (s_opt.find(_SYNCHRONOUS_OUTPUT_) != s_opt.end()) {
+      cmdline_assert(s_opt[_SYNCHRONOUS_OUTPUT_].empty(), "Error: --synchronous-output does not take any value");
+      def::utils::settings.async_output_writing = false;
+    }
+
+    if (s_opt.find(_EXP_DEGREE_) != s_opt.end()) {
+      const std::string &degree = s_opt[_EXP_DEGREE_];
+      cmdline_assert(degree.size() && degree.size() < 3 && degree.find_first_not_of("0123456789") == std::string::npos
+                         && std::stoul(degree) >= fast_math::kExpMinDegree
+                         && std::stoul(degree) <= fast_math::kExpMaxDegree,
+                     "Error: the degree of the exponential must be an integer between 3 and 13");
+      def::utils::settings.exp_polynomial_degree = std::stoul(degree);
+    }
+
+    if (s_opt.find(_NYSTROM_TOLERANCE_) != s_opt.end()) {
+      const std::string &tolerance = s_opt[_NYSTROM_TOLERANCE_];
+      std::size_t end = 0;
+      double value = -1.0;
+      try { value = std::stod(tolerance, &end); } catch (const std::exception &) {}
+      cmdline_assert(end == tolerance.size() && value >= 0.0 && value < 1.0,
+                     "Error: the tolerance of the Nystrom kernel must be a number between 0 and 1");
+      def::utils::settings.nystrom_tolerance = value;
+    }
+
+    if (s_opt.find(_SEED_) != s_opt.end()) {
+      const std::string &seed = s_opt[_SEED_];
+      cmdline_assert(seed.size() && seed.find_first_not_of("0123456789") == std::string::npos,
+                     "Error: the seed must be a non-negative integer");
+      RandomNumberGenerator::instance()->SetSeed(std::stoull(seed));
+    }
+
+    if (s_opt.find(_PROFILE_) != s_opt.end()) {
+      cmdline_assert(s_opt[_PROFILE_].empty(), "Error: --profile does not take any value");
+      def::utils::settings.profiling = true;
+    }
+
+    /// A trace file implies the profiling.
+    if (s_opt.find(_TRACE_FILE_) != s_opt.end()) {
+      cmdline_assert(s_opt[_TRACE_FILE_].size(), "Error: the trace file name is empty");
+      def::utils::settings.trace_filename = s_opt[_TRACE_FILE_];
+      def::utils::settings.profiling = true;
+    }
   }
 
+#ifndef USE_PROFILING
+  if (def::utils::settings.profiling)
+    std::cerr << "Warning: Deformetrica was compiled without the USE_PROFILING option : "
+              "--profile and --trace-file are ignored" << std::endl;
+#endif
+
+  /// The seed is also saved in the deformation state : printing it allows to replay a run from scratch.
+  std::cout << "Random seed: " << RandomNumberGenerator::instance()->GetSeed() << std::endl;
+
   auto &cmp = def::support::utilities::strucmp;
   std::map<decltype(_NO_TYPE_), std::string> type_algo;
   type_algo[_REGISTRATION_] = "registration";
@@ -225,4 +335,11 @@ void deformetrica(int argc, char **argv) {
   };
 
   run[algo]();
+
+  /// The last output files may still be pending in the background writer.
+  AsyncOutputWriter::instance()->Wait();
+
+#ifdef USE_PROFILING
+  def::utils::Profiler::instance()->WriteTrace();
+#endif
 }
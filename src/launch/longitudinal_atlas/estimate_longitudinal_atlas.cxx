@@ -22,6 +22,7 @@
 
 /// Support files.
 #include "DeformableObjectReader.h"
+#include "DeformableObjectLoader.h"
 
 #if ITK_VERSION_MAJOR >= 4
 #include <itkFFTWGlobalConfiguration.h>
@@ -127,30 +128,31 @@ void estimateLongitudinalAtlas(std::shared_ptr<const def::io::XmlModel> xml_mode
     }
   }
 
-  /// Scans the list of objects.
+  /// Reads the template and target objects concurrently.
+  DeformableObjectLoader<ScalarType, Dimension> loader;
+  std::vector<std::vector<std::vector<std::size_t>>> targetRequests(numSubjects);
+  std::vector<std::size_t> templateRequests(numObjects);
+  for (unsigned int i = 0; i < numSubjects; ++i)
+    targetRequests[i].resize(xml_model->subjects[i].visits.size(), std::vector<std::size_t>(numObjects));
+
   std::size_t i_object = 0;
   for (auto it : xml_model->param_objects) {
     std::vector<std::vector<std::string>>
         filenames = xml_model->subjects_filename_by_object_id_several_visits(it.first);
-    for (unsigned int i = 0; i < numSubjects; ++i) {
-      for (unsigned int t = 0; t < xml_model->subjects[i].visits.size(); ++t) {
-        ObjectReaderType reader;
-        reader.SetObjectParameters(it.second);
-        reader.SetFileName(filenames[i][t]);
-        reader.Update();
-        targetsList[i][t][i_object] = reader.GetOutput();
-      }
-    }
+    for (unsigned int i = 0; i < numSubjects; ++i)
+      for (unsigned int t = 0; t < xml_model->subjects[i].visits.size(); ++t)
+        targetRequests[i][t][i_object] = loader.AddObject(it.second, filenames[i][t]);
 
-    ObjectReaderType reader;
-    reader.SetObjectParameters(it.second);
-    reader.SetTemplateType();
-    auto fn = it.second->GetFilename();
-    reader.SetFileName(fn);
-    reader.Update();
-
-    tempList[i_object++] = reader.GetOutput();
+    templateRequests[i_object++] = loader.AddObject(it.second, it.second->GetFilename(), true);
   }
+  loader.Update();
+
+  for (unsigned int i = 0; i < numSubjects; ++i)
+    for (unsigned int t = 0; t < xml_model->subjects[i].visits.size(); ++t)
+      for (unsigned int k = 0; k < numObjects; ++k)
+        targetsList[i][t][k] = loader.GetOutput(targetRequests[i][t][k]);
+  for (unsigned int k = 0; k < numObjects; ++k)
+    tempList[k] = loader.GetOutput(templateRequests[k]);
 
   /// Scans the list of times.
   xml_model->check_age_consistency();
@@ -175,14 +177,16 @@ void estimateLongitudinalAtlas(std::shared_ptr<const def::io::XmlModel> xml_mode
 
   /// Creates multi-objects for template and targets.
   std::vector<std::vector<std::shared_ptr<DeformableMultiObjectType>>> targets(numSubjects);
+  std::vector<std::shared_ptr<DeformableMultiObjectType>> allTargets;
   for (unsigned int i = 0; i < numSubjects; ++i) {
     targets[i].resize(xml_model->subjects[i].visits.size());
     for (unsigned int t = 0; t < xml_model->subjects[i].visits.size(); ++t) {
       targets[i][t] = std::make_shared<DeformableMultiObjectType>();
       targets[i][t]->SetObjectList(targetsList[i][t]);
-      targets[i][t]->Update();
+      allTargets.push_back(targets[i][t]);
     }
   }
+  DeformableObjectLoader<ScalarType, Dimension>::UpdateMultiObjects(allTargets);
 
   std::shared_ptr<DeformableMultiObjectType> temp = std::make_shared<DeformableMultiObjectType>();
   temp->SetObjectList(tempList);
@@ -210,6 +214,8 @@ void estimateLongitudinalAtlas(std::shared_ptr<const def::io::XmlModel> xml_mode
   def->SetPaddingFactor(paramDiffeos->GetP3MPaddingFactor()); // to define the bounding box
   if (not(paramDiffeos->UseImprovedEuler()))
     def->UseStandardEuler();
+  def->SetNumberOfTimeSlices(paramDiffeos->GetNumberOfTimeSlices());
+  def->SetPararealTolerance(paramDiffeos->GetPararealTolerance());
   if (itksys::SystemTools::Strucmp(paramDiffeos->GetKernelType().c_str(), "p3m") == 0) {
     def->SetKernelType(P3M);
   }
@@ -218,6 +224,15 @@ void estimateLongitudinalAtlas(std::shared_ptr<const def::io::XmlModel> xml_mode
       def->SetKernelType(CUDAExact);
     }
 #endif
+  else if (itksys::SystemTools::Strucmp(paramDiffeos->GetKernelType().c_str(), "cauchy") == 0) {
+    def->SetKernelType(Cauchy);
+  }
+  else if (itksys::SystemTools::Strucmp(paramDiffeos->GetKernelType().c_str(), "wendland") == 0) {
+    def->SetKernelType(Wendland);
+  }
+  else if (itksys::SystemTools::Strucmp(paramDiffeos->GetKernelType().c_str(), "nystrom") == 0) {
+    def->SetKernelType(Nystrom);
+  }
   else {
     if (itksys::SystemTools::Strucmp(paramDiffeos->GetKernelType().c_str(), "exact") != 0)
       std::cerr << "Unknown kernel type for the deformation : defaulting to exact." << std::endl;
@@ -285,6 +300,7 @@ void estimateLongitudinalAtlas(std::shared_ptr<const def::io::XmlModel> xml_mode
   const std::string mom_fn = paramDiffeos->GetInitialMomenta_fn();
   model->SetMomenta(mom_fn);
   model->SetCPSpacing(paramDiffeos->GetInitialCPSpacing());
+  model->SetOptimizeInitialControlPoints(paramDiffeos->OptimizeInitialControlPoints());
   model->SetDiffeos(def);
   model->Update();
 
@@ -373,6 +389,11 @@ void estimateLongitudinalAtlas(std::shared_ptr<const def::io::XmlModel> xml_mode
     estimator->SetTemperingDurationRatio(paramDiffeos->GetTemperingDurationRatio());
   } else { estimator->UnsetUseTempering(); }
 
+  /// Initialization of the optional parallel tempering.
+  estimator->SetNumberOfChains(paramDiffeos->GetNumberOfChains());
+  estimator->SetMaximumChainTemperature(paramDiffeos->GetMaximumChainTemperature());
+  estimator->SetChainsSwapEveryNIters(paramDiffeos->GetChainsSwapEveryNIters());
+
   /// Initialization of the sampler's proposal distributions.
   AbstractNormalDistributionMapType popPD, indPD; // PD : Proposal Distribution.
   const unsigned int proposalBlocksize = paramDiffeos->GetSrwProposalBlocksize();
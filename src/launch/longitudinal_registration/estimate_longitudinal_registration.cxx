@@ -19,6 +19,7 @@
 
 /// IO files.
 #include "DeformableObjectReader.h"
+#include "DeformableObjectLoader.h"
 
 /// Miscellaneous files.
 #include <src/support/utilities/SimpleTimer.h>
@@ -133,30 +134,29 @@ void estimateLongitudinalRegistration(std::shared_ptr<const def::io::XmlModel> x
     targetsList[0][t] = std::move(Aux);
   }
 
-  /// Scans the list of objects.
+  /// Reads the template and target objects concurrently.
+  DeformableObjectLoader<ScalarType, Dimension> loader;
+  std::vector<std::vector<std::size_t>>
+      targetRequests(xml_model->subjects[0].visits.size(), std::vector<std::size_t>(numObjects));
+  std::vector<std::size_t> templateRequests(numObjects);
   VectorType noiseVariance(numObjects);
   std::size_t i_object = 0;
   for (auto it : xml_model->param_objects) {
     std::vector<std::vector<std::string>>
         filenames = xml_model->subjects_filename_by_object_id_several_visits(it.first);
-    for (unsigned int t = 0; t < xml_model->subjects[0].visits.size(); ++t) {
-      ObjectReaderType reader;
-      reader.SetObjectParameters(it.second);
-      reader.SetFileName(filenames[0][t]);
-      reader.Update();
-      targetsList[0][t][i_object] = reader.GetOutput();
-    }
-
-    ObjectReaderType reader;
-    reader.SetObjectParameters(it.second);
-    reader.SetTemplateType();
-    auto fn = it.second->GetFilename();
-    reader.SetFileName(fn);
-    reader.Update();
+    for (unsigned int t = 0; t < xml_model->subjects[0].visits.size(); ++t)
+      targetRequests[t][i_object] = loader.AddObject(it.second, filenames[0][t]);
 
-    tempList[i_object] = reader.GetOutput();
+    templateRequests[i_object] = loader.AddObject(it.second, it.second->GetFilename(), true);
     noiseVariance(i_object++) = it.second->GetDataSigma();
   }
+  loader.Update();
+
+  for (unsigned int t = 0; t < xml_model->subjects[0].visits.size(); ++t)
+    for (unsigned int k = 0; k < numObjects; ++k)
+      targetsList[0][t][k] = loader.GetOutput(targetRequests[t][k]);
+  for (unsigned int k = 0; k < numObjects; ++k)
+    tempList[k] = loader.GetOutput(templateRequests[k]);
 
   /// Scans the list of times.
   xml_model->check_age_consistency();
@@ -173,8 +173,8 @@ void estimateLongitudinalRegistration(std::shared_ptr<const def::io::XmlModel> x
   for (unsigned int t = 0; t < xml_model->subjects[0].visits.size(); ++t) {
     targets[0][t] = std::make_shared<DeformableMultiObjectType>();
     targets[0][t]->SetObjectList(targetsList[0][t]);
-    targets[0][t]->Update();
   }
+  DeformableObjectLoader<ScalarType, Dimension>::UpdateMultiObjects(targets[0]);
 
   std::shared_ptr<DeformableMultiObjectType> temp = std::make_shared<DeformableMultiObjectType>();
   temp->SetObjectList(tempList);
@@ -202,6 +202,8 @@ void estimateLongitudinalRegistration(std::shared_ptr<const def::io::XmlModel> x
   def->SetPaddingFactor(paramDiffeos->GetP3MPaddingFactor()); // to define the bounding box
   if (not(paramDiffeos->UseImprovedEuler()))
     def->UseStandardEuler();
+  def->SetNumberOfTimeSlices(paramDiffeos->GetNumberOfTimeSlices());
+  def->SetPararealTolerance(paramDiffeos->GetPararealTolerance());
   if (itksys::SystemTools::Strucmp(paramDiffeos->GetKernelType().c_str(), "p3m") == 0) {
     def->SetKernelType(P3M);
   }
@@ -210,6 +212,15 @@ void estimateLongitudinalRegistration(std::shared_ptr<const def::io::XmlModel> x
       def->SetKernelType(CUDAExact);
     }
 #endif
+  else if (itksys::SystemTools::Strucmp(paramDiffeos->GetKernelType().c_str(), "cauchy") == 0) {
+    def->SetKernelType(Cauchy);
+  }
+  else if (itksys::SystemTools::Strucmp(paramDiffeos->GetKernelType().c_str(), "wendland") == 0) {
+    def->SetKernelType(Wendland);
+  }
+  else if (itksys::SystemTools::Strucmp(paramDiffeos->GetKernelType().c_str(), "nystrom") == 0) {
+    def->SetKernelType(Nystrom);
+  }
   else {
     if (itksys::SystemTools::Strucmp(paramDiffeos->GetKernelType().c_str(), "exact") != 0)
       std::cerr << "Unknown kernel type for the deformation : defaulting to exact." << std::endl;
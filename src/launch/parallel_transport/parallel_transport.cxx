@@ -219,6 +219,15 @@ void parallel_transport(std::shared_ptr<const def::io::XmlModel> xml_model) {
 def->SetKernelType(CUDAExact);
 }
 #endif
+  else if (itksys::SystemTools::Strucmp(paramDiffeos->GetKernelType().c_str(), "cauchy") == 0) {
+    def->SetKernelType(Cauchy);
+  }
+  else if (itksys::SystemTools::Strucmp(paramDiffeos->GetKernelType().c_str(), "wendland") == 0) {
+    def->SetKernelType(Wendland);
+  }
+  else if (itksys::SystemTools::Strucmp(paramDiffeos->GetKernelType().c_str(), "nystrom") == 0) {
+    def->SetKernelType(Nystrom);
+  }
   else {
     if (itksys::SystemTools::Strucmp(paramDiffeos->GetKernelType().c_str(), "exact") != 0)
       std::cerr << "Unknown kernel type for the deformation : defaulting to exact" << std::endl;
@@ -275,6 +284,15 @@ def->SetKernelType(CUDAExact);
 def->SetKernelType(CUDAExact);
 }
 #endif
+  else if (itksys::SystemTools::Strucmp(paramDiffeos->GetKernelType().c_str(), "cauchy") == 0) {
+    def->SetKernelType(Cauchy);
+  }
+  else if (itksys::SystemTools::Strucmp(paramDiffeos->GetKernelType().c_str(), "wendland") == 0) {
+    def->SetKernelType(Wendland);
+  }
+  else if (itksys::SystemTools::Strucmp(paramDiffeos->GetKernelType().c_str(), "nystrom") == 0) {
+    def->SetKernelType(Nystrom);
+  }
   else {
     if (itksys::SystemTools::Strucmp(paramDiffeos->GetKernelType().c_str(), "exact") != 0)
       std::cerr << "Unknown kernel type for the deformation : defaulting to exact" << std::endl;
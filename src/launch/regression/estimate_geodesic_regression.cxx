@@ -21,10 +21,12 @@
 
 /// Core files.
 #include <src/support/utilities/SimpleTimer.h>
+#include <src/support/utilities/GeneralSettings.h>
 #include "Regression.h"
 
 /// Non-core files.
 #include "DeformableObjectReader.h"
+#include "DeformableObjectLoader.h"
 #include "SparseDiffeoParametersXMLFile.h"
 
 #include "ProbabilityDistributions.h"
@@ -171,6 +173,13 @@ void estimateGeodesicRegression(SparseDiffeoParameters* paramDiffeos, int numObs
   def->SetPaddingFactor(paramDiffeos->GetP3MPaddingFactor()); // to define the bounding box
   if (not(paramDiffeos->UseImprovedEuler()))
     def->UseStandardEuler();
+  def->SetNumberOfTimeSlices(paramDiffeos->GetNumberOfTimeSlices());
+  def->SetPararealTolerance(paramDiffeos->GetPararealTolerance());
+  /// The regression deforms a single template : the landmark flow and the adjoint equations use all the threads.
+  def->SetNumberOfPointBlocks(def::utils::settings.number_of_threads);
+  /// The kernel matrix of frozen control points is computed once for the whole estimation.
+  if (paramDiffeos->FreezeCP())
+    def->SetFrozenStartPositions();
 
   if (paramDiffeos->ComputeTrueInverseFlow() == SparseDiffeoParameters::On) {
     std::cout << "Warning : the compute-true-inverse-flow integration scheme is indeed advised for image regression, "
@@ -196,6 +205,15 @@ void estimateGeodesicRegression(SparseDiffeoParameters* paramDiffeos, int numObs
     else if (itksys::SystemTools::Strucmp(paramDiffeos->GetKernelType().c_str(), "cudaexact") == 0)
       def->SetKernelType(CUDAExact);
 #endif
+  else if (itksys::SystemTools::Strucmp(paramDiffeos->GetKernelType().c_str(), "cauchy") == 0) {
+    def->SetKernelType(Cauchy);
+  }
+  else if (itksys::SystemTools::Strucmp(paramDiffeos->GetKernelType().c_str(), "wendland") == 0) {
+    def->SetKernelType(Wendland);
+  }
+  else if (itksys::SystemTools::Strucmp(paramDiffeos->GetKernelType().c_str(), "nystrom") == 0) {
+    def->SetKernelType(Nystrom);
+  }
   else {
     if (itksys::SystemTools::Strucmp(paramDiffeos->GetKernelType().c_str(), "exact") != 0)
       std::cerr << "Unknown kernel type for the deformation : defaulting to exact." << std::endl;
@@ -210,20 +228,17 @@ void estimateGeodesicRegression(SparseDiffeoParameters* paramDiffeos, int numObs
     targetObjectList[s] = Aux;
   }
 
-  // Scan the list of objects
-  typedef DeformableObjectReader<ScalarType, Dimension> ObjectReaderType;
+  // Read the template and target objects concurrently
+  DeformableObjectLoader<ScalarType, Dimension> loader;
+  std::vector<std::vector<std::size_t>> targetRequests(numObservations, std::vector<std::size_t>(numObjects));
+  std::vector<std::size_t> templateRequests(numObjects);
 
   std::vector<unsigned int> timeIndices;
   timeIndices.resize(numObservations);
 
   for (int i = 0; i < numObjects; i++) {
     for (int s = 0; s < numObservations; s++) {
-      ObjectReaderType *reader = new ObjectReaderType();
-      reader->SetObjectParameters(paramObjectsList[i]);
-      reader->SetFileName(observationfnList[s][i]);
-      reader->Update();
-
-      targetObjectList[s][i] = reader->GetOutput();
+      targetRequests[s][i] = loader.AddObject(paramObjectsList[i], observationfnList[s][i]);
 
       // Get time point information
       ScalarType timept = observationTimesList[s][i];
@@ -238,22 +253,23 @@ void estimateGeodesicRegression(SparseDiffeoParameters* paramDiffeos, int numObs
       timeIndices[s] = timeIndex;
     }
 
-    ObjectReaderType *reader = new ObjectReaderType();
-    reader->SetObjectParameters(paramObjectsList[i]);
-    reader->SetTemplateType();
-    reader->SetFileName(templatefnList[i]);
-    reader->Update();
-
-    templateObjectList[i] = reader->GetOutput();
+    templateRequests[i] = loader.AddObject(paramObjectsList[i], templatefnList[i], true);
   }
+  loader.Update();
+
+  for (int s = 0; s < numObservations; s++)
+    for (int i = 0; i < numObjects; i++)
+      targetObjectList[s][i] = loader.GetOutput(targetRequests[s][i]);
+  for (int i = 0; i < numObjects; i++)
+    templateObjectList[i] = loader.GetOutput(templateRequests[i]);
 
   // Creating multi-objects for template and targets
   typename std::vector<std::shared_ptr<DeformableMultiObjectType>> target(numObservations);
   for (unsigned int t = 0; t < numObservations; ++t) {
     target[t] = std::make_shared<DeformableMultiObjectType>();
     target[t]->SetObjectList(targetObjectList[t]);
-    target[t]->Update();
   }
+  DeformableObjectLoader<ScalarType, Dimension>::UpdateMultiObjects(target);
 
   std::shared_ptr<DeformableMultiObjectType> templateObjects = std::make_shared<DeformableMultiObjectType>();
   templateObjects->SetObjectList(templateObjectList);
@@ -0,0 +1,191 @@
+/***************************************************************************************
+*                                                                                      *
+*                                     Deformetrica                                     *
+*                                                                                      *
+*    Copyright Inria and the University of Utah.  All rights reserved. This file is    *
+*    distributed under the terms of the MIT License. This file is also distributed     *
+*    under the terms of the Inria Non-Commercial License Agreement.                    *
+*                                                                                      *
+*                                                                                      *
+****************************************************************************************/
+
+#include "MathFunctions.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+/// The SSE4.2 and AVX2 versions are compiled with the target attributes of GCC and Clang, whatever the compilation
+/// flags : the instruction set is chosen when running.
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define DEF_VEXP_X86
+#include <immintrin.h>
+#endif
+
+namespace fast_math {
+
+namespace {
+
+/// Arguments below kExpLow give results below 3.3e-308, flushed to zero. Above kExpHigh, 2^k would not be a normal
+/// number : those arguments are computed by std::exp.
+const double kExpLow = -708.0;
+const double kExpHigh = 708.0;
+
+const double kLog2e = 1.44269504088896338700e+00;
+/// ln(2) split in two parts : k * kLn2Hi is exact for |k| < 2^11 (Cody and Waite).
+const double kLn2Hi = 6.93147180369123816490e-01;
+const double kLn2Lo = 1.90821492927058770002e-10;
+
+/// Taylor coefficients 1/i! of exp(r).
+const double kExpCoefficients[kExpMaxDegree + 1] = {
+    1.0, 1.0, 1.0 / 2.0, 1.0 / 6.0, 1.0 / 24.0, 1.0 / 120.0, 1.0 / 720.0, 1.0 / 5040.0, 1.0 / 40320.0,
+    1.0 / 362880.0, 1.0 / 3628800.0, 1.0 / 39916800.0, 1.0 / 479001600.0, 1.0 / 6227020800.0};
+
+inline unsigned int clamp_degree(unsigned int degree) {
+  return std::min(std::max(degree, kExpMinDegree), kExpMaxDegree);
+}
+
+inline double exp_scalar(double x, unsigned int degree) {
+  if (x < kExpLow) return 0.0;
+  if (!(x <= kExpHigh)) return std::exp(x);
+
+  const double k = std::nearbyint(x * kLog2e);
+  const double r = (x - k * kLn2Hi) - k * kLn2Lo;
+
+  double p = kExpCoefficients[degree];
+  for (int i = degree - 1; i >= 0; i--)
+    p = p * r + kExpCoefficients[i];
+
+  /// 2^k, built from its exponent bits.
+  const std::int64_t bits = (static_cast<std::int64_t>(k) + 1023) << 52;
+  double scale;
+  std::memcpy(&scale, &bits, sizeof(scale));
+  return p * scale;
+}
+
+void vexp_scalar(const double *x, double *y, std::size_t n, unsigned int degree) {
+  for (std::size_t i = 0; i < n; i++)
+    y[i] = exp_scalar(x[i], degree);
+}
+
+#ifdef DEF_VEXP_X86
+
+__attribute__((target("sse4.2")))
+void vexp_sse42(const double *x, double *y, std::size_t n, unsigned int degree) {
+  const __m128d low = _mm_set1_pd(kExpLow);
+  const __m128d high = _mm_set1_pd(kExpHigh);
+  const __m128d log2e = _mm_set1_pd(kLog2e);
+  const __m128d ln2_hi = _mm_set1_pd(kLn2Hi);
+  const __m128d ln2_lo = _mm_set1_pd(kLn2Lo);
+  const __m128i bias = _mm_set1_epi64x(1023);
+
+  std::size_t i = 0;
+  for (; i + 2 <= n; i += 2) {
+    const __m128d xi = _mm_loadu_pd(x + i);
+    const __m128d xc = _mm_min_pd(_mm_max_pd(xi, low), high);
+
+    const __m128d k = _mm_round_pd(_mm_mul_pd(xc, log2e), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    const __m128d r = _mm_sub_pd(_mm_sub_pd(xc, _mm_mul_pd(k, ln2_hi)), _mm_mul_pd(k, ln2_lo));
+
+    __m128d p = _mm_set1_pd(kExpCoefficients[degree]);
+    for (int d = degree - 1; d >= 0; d--)
+      p = _mm_add_pd(_mm_mul_pd(p, r), _mm_set1_pd(kExpCoefficients[d]));
+
+    const __m128i e = _mm_slli_epi64(_mm_add_epi64(_mm_cvtepi32_epi64(_mm_cvtpd_epi32(k)), bias), 52);
+    __m128d yi = _mm_mul_pd(p, _mm_castsi128_pd(e));
+
+    yi = _mm_andnot_pd(_mm_cmplt_pd(xi, low), yi);
+    _mm_storeu_pd(y + i, yi);
+
+    /// Overflows and NaNs : rare, computed one at a time.
+    const int outside = _mm_movemask_pd(_mm_cmpnle_pd(xi, high));
+    if (outside) {
+      for (int l = 0; l < 2; l++)
+        if (outside & (1 << l)) y[i + l] = std::exp(x[i + l]);
+    }
+  }
+
+  vexp_scalar(x + i, y + i, n - i, degree);
+}
+
+__attribute__((target("avx2,fma")))
+void vexp_avx2(const double *x, double *y, std::size_t n, unsigned int degree) {
+  const __m256d low = _mm256_set1_pd(kExpLow);
+  const __m256d high = _mm256_set1_pd(kExpHigh);
+  const __m256d log2e = _mm256_set1_pd(kLog2e);
+  const __m256d ln2_hi = _mm256_set1_pd(kLn2Hi);
+  const __m256d ln2_lo = _mm256_set1_pd(kLn2Lo);
+  const __m256i bias = _mm256_set1_epi64x(1023);
+
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    const __m256d xi = _mm256_loadu_pd(x + i);
+    const __m256d xc = _mm256_min_pd(_mm256_max_pd(xi, low), high);
+
+    const __m256d k = _mm256_round_pd(_mm256_mul_pd(xc, log2e), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    const __m256d r = _mm256_fnmadd_pd(k, ln2_lo, _mm256_fnmadd_pd(k, ln2_hi, xc));
+
+    __m256d p = _mm256_set1_pd(kExpCoefficients[degree]);
+    for (int d = degree - 1; d >= 0; d--)
+      p = _mm256_fmadd_pd(p, r, _mm256_set1_pd(kExpCoefficients[d]));
+
+    const __m256i e = _mm256_slli_epi64(_mm256_add_epi64(_mm256_cvtepi32_epi64(_mm256_cvtpd_epi32(k)), bias), 52);
+    __m256d yi = _mm256_mul_pd(p, _mm256_castsi256_pd(e));
+
+    yi = _mm256_andnot_pd(_mm256_cmp_pd(xi, low, _CMP_LT_OQ), yi);
+    _mm256_storeu_pd(y + i, yi);
+
+    const int outside = _mm256_movemask_pd(_mm256_cmp_pd(xi, high, _CMP_NLE_UQ));
+    if (outside) {
+      for (int l = 0; l < 4; l++)
+        if (outside & (1 << l)) y[i + l] = std::exp(x[i + l]);
+    }
+  }
+
+  vexp_scalar(x + i, y + i, n - i, degree);
+}
+
+#endif
+
+ExpInstructionSet detect_instruction_set() {
+#ifdef DEF_VEXP_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return AVX2Exp;
+  if (__builtin_cpu_supports("sse4.2")) return SSE42Exp;
+#endif
+  return ScalarExp;
+}
+
+}
+
+ExpInstructionSet exp_instruction_set() {
+  static const ExpInstructionSet set = detect_instruction_set();
+  return set;
+}
+
+bool exp_instruction_set_supported(ExpInstructionSet set) {
+  return set <= exp_instruction_set();
+}
+
+void vexp(const double *x, double *y, std::size_t n, unsigned int degree) {
+  vexp(x, y, n, degree, exp_instruction_set());
+}
+
+void vexp(const double *x, double *y, std::size_t n, unsigned int degree, ExpInstructionSet set) {
+  degree = clamp_degree(degree);
+
+#ifdef DEF_VEXP_X86
+  if (set == AVX2Exp) {
+    vexp_avx2(x, y, n, degree);
+    return;
+  }
+  if (set == SSE42Exp) {
+    vexp_sse42(x, y, n, degree);
+    return;
+  }
+#endif
+
+  vexp_scalar(x, y, n, degree);
+}
+
+}
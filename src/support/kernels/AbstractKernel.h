@@ -13,8 +13,10 @@
 #define _AbstractKernel_h
 
 #include "LinearAlgebra.h"
+#include "KernelMatrix.h"
 #include <itkImage.h>
 
+#include <memory>
 #include <vector>
 
 #include <cassert>
@@ -92,13 +94,22 @@ class AbstractKernel {
 
   /// Returns the sources.
   MatrixType &GetSources() { return m_Sources; }
-  /// Sets the sources to \e X.
+  /// Sets the sources to \e X, and discards their kernel matrix.
   void SetSources(const MatrixType &X) {
     assert(X.cols() == PointDim);
     m_Sources = X;
+    m_SourcesKernelMatrix.reset();
     m_Modified = true;
   }
 
+  /// Sets the kernel matrix of the sources, computed beforehand for the same kernel (see KernelMatrixCache) : it is
+  /// used by ConvolveAtSources() until the sources change. A null pointer is allowed.
+  void SetSourcesKernelMatrix(std::shared_ptr<const KernelMatrix<ScalarType>> K) {
+    if (K && K->GetNumberOfPoints() != m_Sources.rows())
+      throw std::runtime_error("Kernel matrix and sources size mismatch");
+    m_SourcesKernelMatrix = K;
+  }
+
   /// Returns the weights.
   MatrixType &GetWeights() { return m_Weights; }
   /// Sets the weights to \e W.
@@ -132,6 +143,13 @@ class AbstractKernel {
   /// Computes convolution of the "weights" located at the "source" points with the kernel and provides results at output point \e X .
   virtual MatrixType Convolve(const MatrixType &X) = 0;
 
+  /// Computes Convolve() at the sources : a matrix product if their kernel matrix has been set (see
+  /// SetSourcesKernelMatrix()).
+  MatrixType ConvolveAtSources() {
+    if (m_SourcesKernelMatrix) return m_SourcesKernelMatrix->Multiply(m_Weights);
+    return this->Convolve(m_Sources);
+  }
+
   /// Derivative of convolved weight w in rows in direction dp in columns.
   virtual std::vector<MatrixType> ConvolveGradient(const MatrixType &X) = 0;
   /// TODO .
@@ -175,6 +193,9 @@ class AbstractKernel {
   ///	Matrix containing coordinates of the weights i.e. the momentas  (Size : NumberOfPoints x Dimension).
   MatrixType m_Weights;
 
+  /// Kernel matrix of the sources, if given (see SetSourcesKernelMatrix()).
+  std::shared_ptr<const KernelMatrix<ScalarType>> m_SourcesKernelMatrix;
+
   /// Size of the kernel.
   ScalarType m_KernelWidth;
 
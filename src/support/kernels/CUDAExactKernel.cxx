@@ -11,6 +11,7 @@
 
 #include "CUDAExactKernel.h"
 #include "SimpleTimer.h"
+#include "Profiler.h"
 #include "../../lib/cuda_convolutions/GpuConv1D.h"
 //#include "../../lib/cuda_convolutions/GpuConv2D.h"
 
@@ -42,39 +43,39 @@ template<class ScalarType, unsigned int PointDim>
 MatrixType
 CUDAExactKernel<ScalarType, PointDim>
 ::Convolve(const MatrixType &X) {
-
-  VectorType X_vec = X.vectorise_row_wise();
-  VectorType S_vec = this->GetSources().vectorise_row_wise();
-  VectorType W_vec = this->GetWeights().vectorise_row_wise();
+  DEF_PROFILE_SCOPE_SIZE("CUDAExactKernel::Convolve", X.rows() * this->GetSources().rows());
+  RowMajorMatrix<ScalarType> X_rm = X.row_major();
+  RowMajorMatrix<ScalarType> S_rm = this->GetSources().row_major();
+  RowMajorMatrix<ScalarType> W_rm = this->GetWeights().row_major();
 
   if (this->GetSources().rows() != this->GetWeights().rows())
     throw std::runtime_error("Sources and weights count mismatch");
 
   int DimVect = this->GetWeights().columns();
-  ScalarType *gammap = new ScalarType[X.rows() * DimVect];
+  RowMajorMatrix<ScalarType> gamma(X.rows(), DimVect);
 
   if (DimVect == PointDim) {
     GaussGpuEvalConv1D<ScalarType, PointDim, PointDim>(this->GetKernelWidth(),
-                                                       X_vec.memptr(),
-                                                       S_vec.memptr(),
-                                                       W_vec.memptr(),
-                                                       gammap,
+                                                       X_rm.memptr(),
+                                                       S_rm.memptr(),
+                                                       W_rm.memptr(),
+                                                       gamma.memptr(),
                                                        X.rows(),
                                                        this->GetSources().rows());
   } else if (DimVect == 2 * PointDim) {
     GaussGpuEvalConv1D<ScalarType, PointDim, (2 * PointDim)>(this->GetKernelWidth(),
-                                                             X_vec.memptr(),
-                                                             S_vec.memptr(),
-                                                             W_vec.memptr(),
-                                                             gammap,
+                                                             X_rm.memptr(),
+                                                             S_rm.memptr(),
+                                                             W_rm.memptr(),
+                                                             gamma.memptr(),
                                                              X.rows(),
                                                              this->GetSources().rows());
   } else if (DimVect == PointDim * (PointDim + 1) / 2) {
     GaussGpuEvalConv1D<ScalarType, PointDim, PointDim * (PointDim + 1) / 2>(this->GetKernelWidth(),
-                                                                            X_vec.memptr(),
-                                                                            S_vec.memptr(),
-                                                                            W_vec.memptr(),
-                                                                            gammap,
+                                                                            X_rm.memptr(),
+                                                                            S_rm.memptr(),
+                                                                            W_rm.memptr(),
+                                                                            gamma.memptr(),
                                                                             X.rows(),
                                                                             this->GetSources().rows());
   } else {
@@ -82,11 +83,7 @@ CUDAExactKernel<ScalarType, PointDim>
   }
 
 
-  MatrixType gamma(gammap, DimVect, X.rows());
-  //	return gamma.transpose();
-  MatrixType transpose = gamma.transpose();
-  delete[] gammap;
-  return transpose;
+  return MatrixType(gamma.view());
 }
 
 
@@ -166,62 +163,59 @@ template<class ScalarType, unsigned int PointDim>
 MatrixType
 CUDAExactKernel<ScalarType, PointDim>
 ::ConvolveGradient(const MatrixType &X, const MatrixType &alpha) {
+  DEF_PROFILE_SCOPE_SIZE("CUDAExactKernel::ConvolveGradient", X.rows() * this->GetSources().rows());
   int DimVect = this->GetWeights().columns();
-  ScalarType *gammap = new ScalarType[X.rows() * DimVect];
+  RowMajorMatrix<ScalarType> gamma(X.rows(), DimVect);
 
-  VectorType alpha_vec = alpha.vectorise_row_wise();
-  VectorType X_vec = X.vectorise_row_wise();
-  VectorType S_vec = this->GetSources().vectorise_row_wise();
-  VectorType W_vec = this->GetWeights().vectorise_row_wise();
+  RowMajorMatrix<ScalarType> alpha_rm = alpha.row_major();
+  RowMajorMatrix<ScalarType> X_rm = X.row_major();
+  RowMajorMatrix<ScalarType> S_rm = this->GetSources().row_major();
+  RowMajorMatrix<ScalarType> W_rm = this->GetWeights().row_major();
 
   if (DimVect == PointDim) {
     GaussGpuGrad1Conv1D<ScalarType, PointDim, PointDim>(this->GetKernelWidth(),
-                                                        alpha_vec.memptr(),
-                                                        X_vec.memptr(),
-                                                        S_vec.memptr(),
-                                                        W_vec.memptr(),
-                                                        gammap,
+                                                        alpha_rm.memptr(),
+                                                        X_rm.memptr(),
+                                                        S_rm.memptr(),
+                                                        W_rm.memptr(),
+                                                        gamma.memptr(),
                                                         X.rows(),
                                                         this->GetSources().rows());
   } else {
     throw std::runtime_error(
         "In CUDAExactKernel::ConvolveGradient(X, alpha) - Problem with the number of columns of beta !");
   }
-  MatrixType gamma(gammap, DimVect, X.rows());
-  MatrixType transpose = gamma.transpose();
-  delete[] gammap;
-  return transpose;
+  return MatrixType(gamma.view());
 }
 
 template<class ScalarType, unsigned int PointDim>
 MatrixType
 CUDAExactKernel<ScalarType, PointDim>
 ::ConvolveSpecialHessian(const MatrixType &xi) {
+  DEF_PROFILE_SCOPE_SIZE("CUDAExactKernel::ConvolveSpecialHessian", xi.rows() * this->GetSources().rows());
   if (this->GetSources().rows() != this->GetWeights().rows())
     throw std::runtime_error("Sources and weights count mismatch");
   if (this->GetSources().rows() != xi.rows())
     throw std::runtime_error("Y and Xi count mismatch");
 
   int DimVect = this->GetWeights().columns();
-  ScalarType *gamma_p = new ScalarType[xi.rows() * DimVect];
+  RowMajorMatrix<ScalarType> gamma(xi.rows(), DimVect);
 
-  VectorType S_vec = this->GetSources().vectorise_row_wise();
-  VectorType W_vec = this->GetWeights().vectorise_row_wise();
-  VectorType xi_vec = xi.vectorise_row_wise();
+  RowMajorMatrix<ScalarType> S_rm = this->GetSources().row_major();
+  RowMajorMatrix<ScalarType> W_rm = this->GetWeights().row_major();
+  RowMajorMatrix<ScalarType> xi_rm = xi.row_major();
 
   if (DimVect == PointDim) {
     GaussGpuGradDiffConv1D<ScalarType, PointDim, PointDim>(this->GetKernelWidth(),
-                                                           S_vec.memptr(),
-                                                           W_vec.memptr(),
-                                                           xi_vec.memptr(),
-                                                           gamma_p,
+                                                           S_rm.memptr(),
+                                                           W_rm.memptr(),
+                                                           xi_rm.memptr(),
+                                                           gamma.memptr(),
                                                            this->GetSources().rows());
   } else {
     throw std::runtime_error("In CUDAExactKernel::ConvolveSpecialHessian(xi) - Invalid number of columns of beta !");
   }
-  MatrixType gamma(gamma_p, DimVect, xi.rows());
-  auto ret = (-0.5f * gamma.transpose());
-  delete[] gamma_p;
+  auto ret = (-0.5f * MatrixType(gamma.view()));
   return ret;
 }
 
@@ -230,12 +224,12 @@ MatrixType
 CUDAExactKernel<ScalarType, PointDim>
 ::ConvolveGradient(const MatrixType &X, unsigned int dim) {
 
-  VectorType X_vec = X.vectorise_row_wise();
-  VectorType W_vec = this->GetWeights().vectorise_row_wise();
+  RowMajorMatrix<ScalarType> X_rm = X.row_major();
+  RowMajorMatrix<ScalarType> W_rm = this->GetWeights().row_major();
 
   int weightDim = this->GetWeights().columns();
 
-  ScalarType *gamma_p = new ScalarType[X.rows() * weightDim];
+  RowMajorMatrix<ScalarType> gamma(X.rows(), weightDim);
 
   if (X.rows() != this->GetWeights().rows())
     throw std::runtime_error("Sources and weights count mismatch");
@@ -243,59 +237,54 @@ CUDAExactKernel<ScalarType, PointDim>
     throw std::runtime_error("dimension index out of bounds");
 
   GaussGpuGradConv1D<ScalarType, PointDim, PointDim>(this->GetKernelWidth(),
-                                                     X_vec.memptr(),
-                                                     W_vec.memptr(),
+                                                     X_rm.memptr(),
+                                                     W_rm.memptr(),
                                                      dim,
-                                                     gamma_p,
+                                                     gamma.memptr(),
                                                      X.rows()
   );
 
-  MatrixType gamma(gamma_p, weightDim, X.rows());
-  MatrixType transpose = gamma.transpose();
-
-  delete[] gamma_p;
-  return transpose;
-
+  return MatrixType(gamma.view());
 }
 
 template<class ScalarType, unsigned int PointDim>
 std::vector<MatrixType>
 CUDAExactKernel<ScalarType, PointDim>
 ::ConvolveGradient(const MatrixType &X) {
-
-  VectorType X_vec = X.vectorise_row_wise();
-  VectorType Y_vec = this->GetSources().vectorise_row_wise();
-  VectorType W_vec = this->GetWeights().vectorise_row_wise();
+  DEF_PROFILE_SCOPE_SIZE("CUDAExactKernel::ConvolveGradient", X.rows() * this->GetSources().rows());
+  RowMajorMatrix<ScalarType> X_rm = X.row_major();
+  RowMajorMatrix<ScalarType> Y_rm = this->GetSources().row_major();
+  RowMajorMatrix<ScalarType> W_rm = this->GetWeights().row_major();
 
   if (this->GetSources().rows() != this->GetWeights().rows())
     throw std::runtime_error("Sources and weights count mismatch");
 
   unsigned int DimVect = this->GetWeights().columns();
 
-  ScalarType *gamma_p = new ScalarType[X.rows() * DimVect * PointDim];
+  RowMajorMatrix<ScalarType> gamma(X.rows(), DimVect * PointDim);
 
   if (DimVect == PointDim) {
     GaussGpuGradConv_varlin_1D<ScalarType, PointDim, PointDim>(this->GetKernelWidth(),
-                                                               X_vec.memptr(),
-                                                               Y_vec.memptr(),
-                                                               W_vec.memptr(),
-                                                               gamma_p,
+                                                               X_rm.memptr(),
+                                                               Y_rm.memptr(),
+                                                               W_rm.memptr(),
+                                                               gamma.memptr(),
                                                                X.rows(),
                                                                this->GetSources().rows());
   } else if (DimVect == 2 * PointDim) {
     GaussGpuGradConv_varlin_1D<ScalarType, PointDim, (2 * PointDim)>(this->GetKernelWidth(),
-                                                                     X_vec.memptr(),
-                                                                     Y_vec.memptr(),
-                                                                     W_vec.memptr(),
-                                                                     gamma_p,
+                                                                     X_rm.memptr(),
+                                                                     Y_rm.memptr(),
+                                                                     W_rm.memptr(),
+                                                                     gamma.memptr(),
                                                                      X.rows(),
                                                                      this->GetSources().rows());
   } else if (DimVect == PointDim * (PointDim + 1) / 2) {
     GaussGpuGradConv_varlin_1D<ScalarType, PointDim, PointDim * (PointDim + 1) / 2>(this->GetKernelWidth(),
-                                                                                    X_vec.memptr(),
-                                                                                    Y_vec.memptr(),
-                                                                                    W_vec.memptr(),
-                                                                                    gamma_p,
+                                                                                    X_rm.memptr(),
+                                                                                    Y_rm.memptr(),
+                                                                                    W_rm.memptr(),
+                                                                                    gamma.memptr(),
                                                                                     X.rows(),
                                                                                     this->GetSources().rows());
   } else {
@@ -309,13 +298,12 @@ CUDAExactKernel<ScalarType, PointDim>
 
     for (unsigned int k = 0; k < DimVect; k++) {
       for (unsigned int l = 0; l < PointDim; l++) {
-        Gi(k, l) = gamma_p[i * DimVect * PointDim + k * PointDim + l];
+        Gi(k, l) = gamma(i, k * PointDim + l);
       }
     }
     gradK.push_back(Gi);
   }
 
-  delete[] gamma_p;
   return gradK;
 }
 
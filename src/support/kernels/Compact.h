@@ -45,6 +45,10 @@ class Compact : public ExactKernel<ScalarType, PointDim> {
   typedef itk::Image<ScalarType, PointDim> ImageType;
   /// ITK image pointer type.
   typedef typename ImageType::Pointer ImageTypePointer;
+  /// Fixed-size vector type, for the points and the kernel gradients.
+  typedef typename Superclass::FixedVectorType FixedVectorType;
+  /// Fixed-size matrix type, for the kernel hessians.
+  typedef typename Superclass::FixedMatrixType FixedMatrixType;
 
 
   ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -163,6 +167,25 @@ class Compact : public ExactKernel<ScalarType, PointDim> {
         * H; //(-2.0f * exp(-dist_squared / Superclass::m_KernelWidthSquared) / Superclass::m_KernelWidthSquared ) * result;
   }
 
+  /// Evaluates \f$ K(x,y) \f$, for fixed-size points (no heap allocation).
+  virtual ScalarType EvaluateKernel(const FixedVectorType &x, const FixedVectorType &y) {
+    ScalarType distsq = (x - y).squared_magnitude();
+    if (distsq >= lambda2) return 0.0;
+
+    auto f = lambda2 - distsq;
+    return f*f*lambda_factor_f;
+  }
+
+  /// Evaluates the gradient of \f$ K(x,y) \f$ at \e x, for fixed-size points (no heap allocation).
+  virtual FixedVectorType EvaluateKernelGradient(const FixedVectorType &x, const FixedVectorType &y) {
+    FixedVectorType x_minus_y = x - y;
+    auto t = (lambda2 - x_minus_y.squared_magnitude())*lambda_factor_df;
+    return x_minus_y*t;
+  }
+
+  /// The hessian for fixed-size points is the one of the exact kernel, as for the dynamic ones above.
+  using Superclass::EvaluateKernelHessian;
+
   virtual MatrixType ConvolveImageFast(const MatrixType &X,const ImageTypePointer image);
   virtual std::vector<MatrixType> ConvolveGradientImageFast(const MatrixType &X, const ImageTypePointer image);
   virtual MatrixType ConvolveGradientImageFast(const MatrixType &X, const MatrixType &alpha, const ImageTypePointer img);
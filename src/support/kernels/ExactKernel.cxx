@@ -16,6 +16,7 @@
 #include <itkImageRegionIterator.h>
 
 #include "SimpleTimer.h"
+#include "Profiler.h"
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 // Constructor(s) / Destructor :
@@ -52,6 +53,7 @@ template<class ScalarType, unsigned int PointDim>
 MatrixType
 ExactKernel<ScalarType, PointDim>
 ::Convolve(const MatrixType &X) {
+  DEF_PROFILE_SCOPE_SIZE("ExactKernel::Convolve", X.rows() * this->GetSources().rows());
   MatrixType &Y = this->GetSources();
   MatrixType &W = this->GetWeights();
 
@@ -62,9 +64,13 @@ ExactKernel<ScalarType, PointDim>
 
   MatrixType V(X.rows(), weightDim, 0.0);
 
+  /// The points are gathered once in contiguous fixed-size rows.
+  const std::vector<FixedVectorType> x = X.get_fixed_rows<PointDim>();
+  const std::vector<FixedVectorType> y = Y.get_fixed_rows<PointDim>();
+
   for (unsigned int i = 0; i < X.rows(); i++) {
     for (unsigned int j = 0; j < Y.rows(); j++) {
-      ScalarType Kij = this->EvaluateKernel(X, Y, i, j);
+      ScalarType Kij = this->EvaluateKernel(x[i], y[j]);
       for (unsigned int k = 0; k < weightDim; k++)
         V(i, k) += W(j, k) * Kij;
     }
@@ -134,9 +140,11 @@ ExactKernel<ScalarType, PointDim>
 ::ComputeKernelMatrix(const MatrixType &Y) {
   const unsigned int N = Y.rows();
   MatrixType matKernel(N, N, 0.);
+  const std::vector<FixedVectorType> y = Y.get_fixed_rows<PointDim>();
   for (int i = 0; i < N; i++) {
-    for (int j = 0; j < N; j++) {
-      matKernel(i, j) = this->EvaluateKernel(Y, Y, i, j);
+    for (int j = 0; j <= i; j++) {
+      matKernel(i, j) = this->EvaluateKernel(y[i], y[j]);
+      matKernel(j, i) = matKernel(i, j);
     }
   }
   return matKernel;
@@ -167,7 +175,7 @@ template<class ScalarType, unsigned int PointDim>
 std::vector<MatrixType>
 ExactKernel<ScalarType, PointDim>
 ::ConvolveGradient(const MatrixType &X) {
-
+  DEF_PROFILE_SCOPE_SIZE("ExactKernel::ConvolveGradient", X.rows() * this->GetSources().rows());
   MatrixType &Y = this->GetSources();
   MatrixType &W = this->GetWeights();
 
@@ -177,16 +185,16 @@ ExactKernel<ScalarType, PointDim>
   unsigned int weightDim = W.columns();
 
   std::vector<MatrixType> gradK;
+  gradK.reserve(X.rows());
 
-  for (unsigned int i = 0; i < X.rows(); i++) {
-    // 	VectorType xi = X.get_row(i);
+  const std::vector<FixedVectorType> x = X.get_fixed_rows<PointDim>();
+  const std::vector<FixedVectorType> y = Y.get_fixed_rows<PointDim>();
 
+  for (unsigned int i = 0; i < X.rows(); i++) {
     MatrixType Gi(weightDim, PointDim, 0.0);
 
     for (unsigned int j = 0; j < Y.rows(); j++) {
-      // VectorType yj = Y.get_row(j);
-
-      VectorType g = this->EvaluateKernelGradient(X, Y, i, j);
+      const FixedVectorType g = this->EvaluateKernelGradient(x[i], y[j]);
       for (unsigned int k = 0; k < weightDim; k++) {
         ScalarType Wjk = W(j, k);
         for (unsigned int l = 0; l < PointDim; l++) {
@@ -248,7 +256,8 @@ ExactKernel<ScalarType, PointDim>
       unsigned int pixel_index = currentIndex[0] + sizeImage[0] * currentIndex[1];
       if (PointDim == 3) { pixel_index += sizeImage[0] * sizeImage[1] * currentIndex[2]; }
 
-      VectorType g = this->EvaluateKernelGradient(X, Y, pixel_index, control_point_index);
+      const FixedVectorType g = this->EvaluateKernelGradient(X.get_fixed_row<PointDim>(pixel_index),
+                                                             Y.get_fixed_row<PointDim>(control_point_index));
       for (unsigned int k = 0; k < weightDim; ++k) {
         ScalarType Wjk = W(control_point_index, k);
         for (unsigned int l = 0; l < PointDim; ++l) { gradK[pixel_index](k, l) += g[l] * Wjk; }
@@ -265,11 +274,30 @@ template<class ScalarType, unsigned int PointDim>
 MatrixType
 ExactKernel<ScalarType, PointDim>
 ::ConvolveGradient(const MatrixType &X, const MatrixType &alpha) {
-  std::vector<MatrixType> convolveGradient = this->ConvolveGradient(X);
+  DEF_PROFILE_SCOPE_SIZE("ExactKernel::ConvolveGradient", X.rows() * this->GetSources().rows());
+  MatrixType &Y = this->GetSources();
+  MatrixType &W = this->GetWeights();
+
+  if (Y.rows() != W.rows())
+    throw std::runtime_error("Sources and weights count mismatch");
+
+  unsigned int weightDim = W.columns();
+
+  /// Same as the contraction of ConvolveGradient(X) with alpha, without storing one gradient matrix per point.
+  const std::vector<FixedVectorType> x = X.get_fixed_rows<PointDim>();
+  const std::vector<FixedVectorType> y = Y.get_fixed_rows<PointDim>();
 
   MatrixType result(X.rows(), PointDim, 0);
-  for (unsigned int j = 0; j < X.rows(); j++)
-    result.set_row(j, convolveGradient[j].transpose() * alpha.get_row(j));
+  for (unsigned int i = 0; i < X.rows(); i++) {
+    FixedVectorType ri;
+    for (unsigned int j = 0; j < Y.rows(); j++) {
+      ScalarType Wj_alphai = 0.0;
+      for (unsigned int k = 0; k < weightDim; k++)
+        Wj_alphai += W(j, k) * alpha(i, k);
+      ri += this->EvaluateKernelGradient(x[i], y[j]) * Wj_alphai;
+    }
+    result.set_row(i, ri);
+  }
 
   return result;
 }
@@ -307,15 +335,14 @@ ExactKernel<ScalarType, PointDim>
 
   MatrixType gradK(X.rows(), weightDim, 0.0);
 
-  for (unsigned int i = 0; i < X.rows(); i++) {
-    VectorType xi = X.get_row(i);
+  const std::vector<FixedVectorType> x = X.get_fixed_rows<PointDim>();
+  const std::vector<FixedVectorType> y = Y.get_fixed_rows<PointDim>();
 
+  for (unsigned int i = 0; i < X.rows(); i++) {
     for (unsigned int j = 0; j < Y.rows(); j++) {
-      VectorType yj = Y.get_row(j);
-      VectorType wj = W.get_row(j);
-
-      VectorType g = this->EvaluateKernelGradient(xi, yj);
-      gradK.set_row(i, gradK.get_row(i) + g[dim] * wj);
+      const ScalarType gd = this->EvaluateKernelGradient(x[i], y[j])[dim];
+      for (unsigned int k = 0; k < weightDim; k++)
+        gradK(i, k) += gd * W(j, k);
     }
   }
 
@@ -344,19 +371,15 @@ ExactKernel<ScalarType, PointDim>
 
   VectorType gradK(numPoints, 0);
 
+  const std::vector<FixedVectorType> y = Y.get_fixed_rows<PointDim>();
+
   for (unsigned int i = 0; i < numPoints; i++) {
-    VectorType xi = X.get_row(i);
+    const FixedVectorType xi = X.get_fixed_row<PointDim>(i);
 
     gradK[i] = 0;
 
-    for (unsigned int j = 0; j < numPoints; j++) {
-      VectorType yj = Y.get_row(j);
-      VectorType wj = W.get_row(j);
-
-      VectorType g = this->EvaluateKernelGradient(xi, yj);
-
-      gradK[i] += wj[k] * g[dp];
-    }
+    for (unsigned int j = 0; j < numPoints; j++)
+      gradK[i] += W(j, k) * this->EvaluateKernelGradient(xi, y[j])[dp];
   }
 
   return gradK;
@@ -366,6 +389,7 @@ template<class ScalarType, unsigned int PointDim>
 std::vector<std::vector<MatrixType> >
 ExactKernel<ScalarType, PointDim>
 ::ConvolveHessian(const MatrixType &X) {
+  DEF_PROFILE_SCOPE_SIZE("ExactKernel::ConvolveHessian", X.rows() * this->GetSources().rows());
   MatrixType &Y = this->GetSources();
   MatrixType &W = this->GetWeights();
 
@@ -375,22 +399,30 @@ ExactKernel<ScalarType, PointDim>
   unsigned int weightDim = W.columns();
 
   std::vector<std::vector<MatrixType> > hessK;
+  hessK.reserve(X.rows());
 
-  for (unsigned int i = 0; i < X.rows(); i++) {
+  const std::vector<FixedVectorType> x = X.get_fixed_rows<PointDim>();
+  const std::vector<FixedVectorType> y = Y.get_fixed_rows<PointDim>();
 
-    std::vector<MatrixType> Hi;
+  /// The hessians are accumulated on the stack, and copied once per point.
+  std::vector<FixedMatrixType> Hi(weightDim);
+  for (unsigned int i = 0; i < X.rows(); i++) {
     for (unsigned int k = 0; k < weightDim; k++)
-      Hi.push_back(MatrixType(PointDim, PointDim, 0.0));
+      Hi[k].fill(0.0);
 
     for (unsigned int j = 0; j < Y.rows(); j++) {
-      VectorType wj = W.get_row(j);
-
-      MatrixType H = this->EvaluateKernelHessian(X, Y, i, j);
+      const FixedMatrixType H = this->EvaluateKernelHessian(x[i], y[j]);
       for (unsigned int k = 0; k < weightDim; k++)
-        Hi[k] = Hi[k] + H * wj[k];
+        Hi[k] += H * W(j, k);
     }
 
-    hessK.push_back(Hi);
+    std::vector<MatrixType> hessKi(weightDim, MatrixType(PointDim, PointDim));
+    for (unsigned int k = 0; k < weightDim; k++)
+      for (unsigned int p = 0; p < PointDim; p++)
+        for (unsigned int q = 0; q < PointDim; q++)
+          hessKi[k](p, q) = Hi[k](p, q);
+
+    hessK.push_back(hessKi);
   }
 
   return hessK;
@@ -412,15 +444,14 @@ ExactKernel<ScalarType, PointDim>
 
   MatrixType hessK(X.rows(), weightDim, 0.0);
 
-  for (unsigned int i = 0; i < X.rows(); i++) {
-    VectorType xi = X.get_row(i);
+  const std::vector<FixedVectorType> x = X.get_fixed_rows<PointDim>();
+  const std::vector<FixedVectorType> y = Y.get_fixed_rows<PointDim>();
 
+  for (unsigned int i = 0; i < X.rows(); i++) {
     for (unsigned int j = 0; j < Y.rows(); j++) {
-      VectorType yj = Y.get_row(j);
-      VectorType wj = W.get_row(j);
-
-      MatrixType H = this->EvaluateKernelHessian(xi, yj);
-      hessK.set_row(i, hessK.get_row(i) + wj * H(row, col));
+      const ScalarType Hrc = this->EvaluateKernelHessian(x[i], y[j])(row, col);
+      for (unsigned int k = 0; k < weightDim; k++)
+        hessK(i, k) += W(j, k) * Hrc;
     }
   }
 
@@ -450,20 +481,15 @@ ExactKernel<ScalarType, PointDim>
 
   VectorType hessK(numPoints, 0);
 
+  const std::vector<FixedVectorType> y = Y.get_fixed_rows<PointDim>();
+
   for (unsigned int i = 0; i < numPoints; i++) {
-    VectorType xi = X.get_row(i);
+    const FixedVectorType xi = X.get_fixed_row<PointDim>(i);
 
     hessK[i] = 0;
 
-    for (unsigned int j = 0; j < Y.rows(); j++) {
-      VectorType yj = Y.get_row(j);
-      VectorType wj = W.get_row(j);
-
-      MatrixType H = this->EvaluateKernelHessian(xi, yj);
-
-      hessK[i] += wj[k] * H(dp, dq);
-
-    }
+    for (unsigned int j = 0; j < Y.rows(); j++)
+      hessK[i] += W(j, k) * this->EvaluateKernelHessian(xi, y[j])(dp, dq);
   }
 
   return hessK;
@@ -44,6 +44,10 @@ class ExactKernel : public AbstractKernel<ScalarType, PointDim> {
   typedef itk::Image<ScalarType, PointDim> ImageType;
   /// ITK image pointer type.
   typedef typename ImageType::Pointer ImageTypePointer;
+  /// Fixed-size vector type, for the points and the kernel gradients.
+  typedef FixedVector<ScalarType, PointDim> FixedVectorType;
+  /// Fixed-size matrix type, for the kernel hessians.
+  typedef FixedMatrix<ScalarType, PointDim, PointDim> FixedMatrixType;
 
 
   ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -158,6 +162,31 @@ class ExactKernel : public AbstractKernel<ScalarType, PointDim> {
         * H; //(-2.0f * exp(-dist_squared / Superclass::m_KernelWidthSquared) / Superclass::m_KernelWidthSquared ) * result;
   }
 
+  /// Evaluates \f$ K(x,y) \f$, for fixed-size points (no heap allocation).
+  virtual ScalarType EvaluateKernel(const FixedVectorType &x, const FixedVectorType &y) {
+    return math_exp(-(x - y).squared_magnitude() / Superclass::m_KernelWidthSquared);
+  }
+
+  /// Evaluates the gradient of \f$ K(x,y) \f$ at \e x, for fixed-size points (no heap allocation).
+  virtual FixedVectorType EvaluateKernelGradient(const FixedVectorType &x, const FixedVectorType &y) {
+    FixedVectorType x_minus_y = x - y;
+    ScalarType k = math_exp(-x_minus_y.squared_magnitude() / Superclass::m_KernelWidthSquared);
+    return x_minus_y * (-2.0f * k / Superclass::m_KernelWidthSquared);
+  }
+
+  /// Evaluates the hessian of \f$ K(x,y) \f$ at \e x, for fixed-size points (no heap allocation).
+  virtual FixedMatrixType EvaluateKernelHessian(const FixedVectorType &x, const FixedVectorType &y) {
+    FixedVectorType x_minus_y = x - y;
+    ScalarType k = math_exp(-x_minus_y.squared_magnitude() / Superclass::m_KernelWidthSquared);
+
+    FixedMatrixType H = outer_product(x_minus_y, x_minus_y);
+    H *= 4.0 * k / (Superclass::m_KernelWidthSquared * Superclass::m_KernelWidthSquared);
+    for (unsigned int i = 0; i < PointDim; i++)
+      H(i, i) -= 2.0f * k / Superclass::m_KernelWidthSquared;
+
+    return H;
+  }
+
   virtual MatrixType ConvolveImageFast(const MatrixType &X,const ImageTypePointer image);
   virtual std::vector<MatrixType> ConvolveGradientImageFast(const MatrixType &X, const ImageTypePointer image);
   virtual MatrixType ConvolveGradientImageFast(const MatrixType &X, const MatrixType &alpha, const ImageTypePointer img);
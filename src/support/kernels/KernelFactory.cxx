@@ -14,6 +14,8 @@
 #include "ExactKernel.h"
 #include "P3MKernel.h"
 #include "Compact.h"
+#include "RadialKernel.h"
+#include "NystromKernel.h"
 
 #ifdef USE_CUDA
 #include "CUDAExactKernel.h"
@@ -98,7 +100,7 @@ KernelFactory<ScalarType, PointDim>
   // 	throw std::runtime_error("In KernelFactory::CreateKernelObject() - The type of the kernel is unknown");
 
   switch (kernelType) {
-    case Exact: return std::make_shared<ExactKernel<ScalarType, PointDim>>();
+    case Exact: return std::make_shared<GaussianKernel<ScalarType, PointDim>>();
 #ifdef USE_CUDA
     case CUDAExact:
         return std::make_shared<CUDAExactKernel<ScalarType, PointDim>>();
@@ -114,6 +116,9 @@ KernelFactory<ScalarType, PointDim>
       return obj;
     }
     case COMPACT: return std::make_shared<Compact<ScalarType, PointDim>>();
+    case Cauchy: return std::make_shared<CauchyKernel<ScalarType, PointDim>>();
+    case Wendland: return std::make_shared<WendlandKernel<ScalarType, PointDim>>();
+    case Nystrom: return std::make_shared<NystromKernel<ScalarType, PointDim>>();
     default: throw std::runtime_error("In KernelFactory::CreateKernelObject() - The type of the kernel is unknown");
   }
 }
@@ -126,7 +131,7 @@ KernelFactory<ScalarType, PointDim>
   // 	throw std::runtime_error("In KernelFactory::CreateKernelObject() - The type of the kernel is unknown");
 
   switch (kernelType) {
-    case Exact: return std::make_shared<ExactKernel<ScalarType, PointDim>>();
+    case Exact: return std::make_shared<GaussianKernel<ScalarType, PointDim>>();
 #ifdef USE_CUDA
     case CUDAExact:
         return std::make_shared<CUDAExactKernel<ScalarType, PointDim>>();
@@ -140,6 +145,9 @@ KernelFactory<ScalarType, PointDim>
       return obj;
     }
     case COMPACT: return std::make_shared<Compact<ScalarType, PointDim>>();
+    case Cauchy: return std::make_shared<CauchyKernel<ScalarType, PointDim>>();
+    case Wendland: return std::make_shared<WendlandKernel<ScalarType, PointDim>>();
+    case Nystrom: return std::make_shared<NystromKernel<ScalarType, PointDim>>();
     default: throw std::runtime_error("In KernelFactory::CreateKernelObject() - The type of the kernel is unknown");
   }
 }
@@ -153,7 +161,7 @@ KernelFactory<ScalarType, PointDim>
     ScalarType h,
     KernelEnumType kernelType) {
   switch (kernelType) {
-    case Exact: return std::make_shared<ExactKernel<ScalarType, PointDim>>(X, W, h);
+    case Exact: return std::make_shared<GaussianKernel<ScalarType, PointDim>>(X, W, h);
 #ifdef USE_CUDA
     case CUDAExact:
         return std::make_shared<CUDAExactKernel<ScalarType, PointDim>>(X, W, h);
@@ -168,6 +176,9 @@ KernelFactory<ScalarType, PointDim>
       return obj;
     }
     case COMPACT: return std::make_shared<Compact<ScalarType, PointDim>>();
+    case Cauchy: return std::make_shared<CauchyKernel<ScalarType, PointDim>>(X, W, h);
+    case Wendland: return std::make_shared<WendlandKernel<ScalarType, PointDim>>(X, W, h);
+    case Nystrom: return std::make_shared<NystromKernel<ScalarType, PointDim>>(X, W, h);
     default: throw std::runtime_error("In KernelFactory::CreateKernelObject() - The type of the kernel is unknown");
   }
 }
@@ -0,0 +1,109 @@
+/***************************************************************************************
+*                                                                                      *
+*                                     Deformetrica                                     *
+*                                                                                      *
+*    Copyright Inria and the University of Utah.  All rights reserved. This file is    *
+*    distributed under the terms of the Inria Non-Commercial License Agreement.        *
+*                                                                                      *
+*                                                                                      *
+****************************************************************************************/
+
+#include "KernelMatrix.h"
+
+#include <exception>
+#include <stdexcept>
+
+template<class ScalarType>
+constexpr double KernelMatrix<ScalarType>::kMaxSparseFill;
+
+template<class ScalarType>
+KernelMatrix<ScalarType>
+::KernelMatrix(const MatrixType &K) : m_NumberOfPoints(K.rows()) {
+  if (K.rows() != K.cols())
+    throw std::runtime_error("A kernel matrix must be square");
+
+  const unsigned int N = m_NumberOfPoints;
+  std::size_t nonZeros = 0;
+  for (unsigned int j = 0; j < N; j++)
+    for (unsigned int i = 0; i < N; i++)
+      if (K(i, j) != 0.0) nonZeros++;
+
+  if (nonZeros > kMaxSparseFill * N * N) {
+    m_Dense = K;
+    return;
+  }
+
+  m_RowStart.reserve(N + 1);
+  m_Columns.reserve(nonZeros);
+  m_Values.reserve(nonZeros);
+  m_RowStart.push_back(0);
+  for (unsigned int i = 0; i < N; i++) {
+    for (unsigned int j = 0; j < N; j++) {
+      if (K(i, j) == 0.0) continue;
+      m_Columns.push_back(j);
+      m_Values.push_back(K(i, j));
+    }
+    m_RowStart.push_back(m_Values.size());
+  }
+}
+
+template<class ScalarType>
+std::size_t
+KernelMatrix<ScalarType>
+::GetMemorySize() const {
+  if (!IsSparse())
+    return sizeof(ScalarType) * m_Dense.n_elem();
+  return sizeof(std::size_t) * m_RowStart.size() + (sizeof(unsigned int) + sizeof(ScalarType)) * m_Values.size();
+}
+
+template<class ScalarType>
+MatrixType
+KernelMatrix<ScalarType>
+::Multiply(const MatrixType &W) const {
+  if (W.rows() != m_NumberOfPoints)
+    throw std::runtime_error("Kernel matrix and weights size mismatch");
+
+  if (!IsSparse())
+    return m_Dense * W;
+
+  const unsigned int weightDim = W.cols();
+  const RowMajorMatrix<ScalarType> w = W.row_major();
+  RowMajorMatrix<ScalarType> V(m_NumberOfPoints, weightDim, 0.0);
+  for (unsigned int i = 0; i < m_NumberOfPoints; i++) {
+    ScalarType *Vi = V.row_ptr(i);
+    for (std::size_t l = m_RowStart[i]; l < m_RowStart[i + 1]; l++) {
+      const ScalarType Kij = m_Values[l];
+      const ScalarType *wj = w.row_ptr(m_Columns[l]);
+      for (unsigned int k = 0; k < weightDim; k++)
+        Vi[k] += Kij * wj[k];
+    }
+  }
+
+  return MatrixType(V.view());
+}
+
+template<class ScalarType>
+MatrixType
+KernelMatrix<ScalarType>
+::ToDense() const {
+  if (!IsSparse())
+    return m_Dense;
+
+  MatrixType K(m_NumberOfPoints, m_NumberOfPoints, 0.0);
+  for (unsigned int i = 0; i < m_NumberOfPoints; i++)
+    for (std::size_t l = m_RowStart[i]; l < m_RowStart[i + 1]; l++)
+      K(i, m_Columns[l]) = m_Values[l];
+  return K;
+}
+
+template<class ScalarType>
+std::shared_ptr<const MatrixType>
+KernelMatrix<ScalarType>
+::GetCholeskyFactor() const {
+  /// A failed factorization throws before anything is stored, so that a later call tries again.
+  std::lock_guard<std::mutex> lock(m_CholeskyMutex);
+  if (!m_CholeskyFactor) m_CholeskyFactor = std::make_shared<const MatrixType>(chol_regularized(ToDense()));
+  return m_CholeskyFactor;
+}
+
+template class KernelMatrix<double>;
@@ -0,0 +1,75 @@
+/***************************************************************************************
+*                                                                                      *
+*                                     Deformetrica                                     *
+*                                                                                      *
+*    Copyright Inria and the University of Utah.  All rights reserved. This file is    *
+*    distributed under the terms of the Inria Non-Commercial License Agreement.        *
+*                                                                                      *
+*                                                                                      *
+****************************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "LinearAlgebra.h"
+
+using namespace def::algebra;
+
+/**
+ *	\brief      Kernel matrix of a set of points.
+ *
+ *	\copyright  Inria and the University of Utah
+ *	\version    Deformetrica 2.0
+ *
+ *	\details    The KernelMatrix class stores the matrix \f$ K(y_i, y_j) \f$ of a set of points, e.g. frozen control
+ *	            points (see KernelMatrixCache) : the convolution of weights at the points is then a matrix product.
+ *	            The matrix is stored dense, or in the compressed sparse row format when most of its entries vanish,
+ *	            as for the kernels with a compact support.
+ */
+template<class ScalarType>
+class KernelMatrix {
+ public:
+
+  /// Stores \e K, in the sparse format if at most a quarter of its entries are non-zero.
+  explicit KernelMatrix(const MatrixType &K);
+
+  /// Returns the number of points.
+  unsigned int GetNumberOfPoints() const { return m_NumberOfPoints; }
+  /// Returns true if the matrix is stored in the sparse format.
+  bool IsSparse() const { return !m_RowStart.empty(); }
+  /// Returns the memory used by the matrix, in bytes.
+  std::size_t GetMemorySize() const;
+
+  /// Returns the product of the matrix with the weights \e W.
+  MatrixType Multiply(const MatrixType &W) const;
+
+  /// Returns the matrix in the dense format.
+  MatrixType ToDense() const;
+
+  /// Returns the upper Cholesky factor of the matrix (see chol_regularized), computed at the first call.
+  std::shared_ptr<const MatrixType> GetCholeskyFactor() const;
+
+ private:
+
+  /// Maximal ratio of non-zero entries of the matrices stored in the sparse format.
+  static constexpr double kMaxSparseFill = 0.25;
+
+  unsigned int m_NumberOfPoints;
+
+  /// Dense storage.
+  MatrixType m_Dense;
+
+  /// Sparse storage : the non-zero entries of the row \e i are m_Values[m_RowStart[i] .. m_RowStart[i + 1] - 1], in
+  /// the columns m_Columns[m_RowStart[i] .. m_RowStart[i + 1] - 1].
+  std::vector<std::size_t> m_RowStart;
+  std::vector<unsigned int> m_Columns;
+  std::vector<ScalarType> m_Values;
+
+  mutable std::mutex m_CholeskyMutex;
+  mutable std::shared_ptr<const MatrixType> m_CholeskyFactor;
+
+};
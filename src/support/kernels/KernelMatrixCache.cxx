@@ -0,0 +1,70 @@
+/***************************************************************************************
+*                                                                                      *
+*                                     Deformetrica                                     *
+*                                                                                      *
+*    Copyright Inria and the University of Utah.  All rights reserved. This file is    *
+*    distributed under the terms of the Inria Non-Commercial License Agreement.        *
+*                                                                                      *
+*                                                                                      *
+****************************************************************************************/
+
+#include "KernelMatrixCache.h"
+
+#include "KernelFactory.h"
+#include "Profiler.h"
+
+template<class ScalarType, unsigned int PointDim>
+KernelMatrixCache<ScalarType, PointDim> *
+KernelMatrixCache<ScalarType, PointDim>
+::instance() {
+  static KernelMatrixCache *instance = nullptr;
+  static std::once_flag flag;
+  std::call_once(flag, []() { instance = new KernelMatrixCache(); });
+  return instance;
+}
+
+template<class ScalarType, unsigned int PointDim>
+std::shared_ptr<const typename KernelMatrixCache<ScalarType, PointDim>::KernelMatrixType>
+KernelMatrixCache<ScalarType, PointDim>
+::Get(KernelEnumType kernelType, ScalarType kernelWidth, const MatrixType &Y) {
+  if (Y.rows() > kMaxNumberOfPoints || !IsCachedKernel(kernelType))
+    return nullptr;
+
+  /// The matrix is computed under the lock : the threads shooting the subjects from the same control points wait for
+  /// the first one instead of computing the same matrix.
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  for (auto it = m_Entries.begin(); it != m_Entries.end(); ++it) {
+    if (it->kernelType == kernelType && it->kernelWidth == kernelWidth && it->points == Y) {
+      m_Entries.splice(m_Entries.begin(), m_Entries, it);
+      return m_Entries.front().matrix;
+    }
+  }
+
+  DEF_PROFILE_SCOPE_SIZE("KernelMatrixCache::Get", Y.rows() * Y.rows());
+  KernelFactory<ScalarType, PointDim> *kfac = KernelFactory<ScalarType, PointDim>::Instantiate();
+  std::shared_ptr<ExactKernel<ScalarType, PointDim>> kernel = kfac->CreateKernelObject(kernelType);
+  kernel->SetKernelWidth(kernelWidth);
+
+  Entry entry;
+  entry.kernelType = kernelType;
+  entry.kernelWidth = kernelWidth;
+  entry.points = Y;
+  entry.matrix = std::make_shared<const KernelMatrixType>(kernel->ComputeKernelMatrix(Y));
+
+  m_Entries.push_front(entry);
+  if (m_Entries.size() > kMaxEntries)
+    m_Entries.pop_back();
+
+  return entry.matrix;
+}
+
+template<class ScalarType, unsigned int PointDim>
+void
+KernelMatrixCache<ScalarType, PointDim>
+::Clear() {
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  m_Entries.clear();
+}
+
+template class KernelMatrixCache<double, 2>;
+template class KernelMatrixCache<double, 3>;
@@ -0,0 +1,89 @@
+/***************************************************************************************
+*                                                                                      *
+*                                     Deformetrica                                     *
+*                                                                                      *
+*    Copyright Inria and the University of Utah.  All rights reserved. This file is    *
+*    distributed under the terms of the Inria Non-Commercial License Agreement.        *
+*                                                                                      *
+*                                                                                      *
+****************************************************************************************/
+
+#pragma once
+
+#include <list>
+#include <memory>
+#include <mutex>
+
+#include "KernelMatrix.h"
+#include "KernelType.h"
+#include "LinearAlgebra.h"
+
+using namespace def::algebra;
+
+/**
+ *	\brief      Cache of the kernel matrices of frozen control points.
+ *
+ *	\copyright  Inria and the University of Utah
+ *	\version    Deformetrica 2.0
+ *
+ *	\details    When the control points are frozen, only the momenta change between the iterations of the
+ *	            estimation : the kernel matrix of the control points is computed once and kept by the
+ *	            KernelMatrixCache class, so that the convolutions at the control points become matrix products (see
+ *	            AbstractKernel::SetSourcesKernelMatrix()). The matrices are looked up by the kernel type and width
+ *	            and by the values of the points, so that the copies of the control points made by the models share
+ *	            the same matrix, and that points which have changed get a new one. The least recently used matrices
+ *	            are dropped beyond a few entries.
+ */
+template<class ScalarType, unsigned int PointDim>
+class KernelMatrixCache {
+ public:
+
+  typedef KernelMatrix<ScalarType> KernelMatrixType;
+
+  KernelMatrixCache(const KernelMatrixCache &) = delete;
+  KernelMatrixCache(KernelMatrixCache &&) = delete;
+
+  KernelMatrixCache &operator=(const KernelMatrixCache &) = delete;
+  KernelMatrixCache &operator=(KernelMatrixCache &&) = delete;
+
+  static KernelMatrixCache *instance();
+
+  /// Returns the kernel matrix of the points \e Y, for the kernel of type \e kernelType and width \e kernelWidth,
+  /// computed at the first call. Returns nullptr beyond kMaxNumberOfPoints points, or for a kernel which is not
+  /// computed exactly on the CPU (see IsCachedKernel) : the caller then convolves as usual.
+  std::shared_ptr<const KernelMatrixType> Get(KernelEnumType kernelType, ScalarType kernelWidth, const MatrixType &Y);
+
+  /// Returns true for the kernels whose matrices are cached. The matrix holds the exact values of the kernel : it
+  /// would silently replace the approximation of the P3M and Nystrom kernels, or the GPU computation of CUDAExact.
+  static bool IsCachedKernel(KernelEnumType kernelType) {
+    return kernelType == Exact || kernelType == COMPACT || kernelType == Cauchy || kernelType == Wendland;
+  }
+
+  /// Drops all the matrices.
+  void Clear();
+
+  /// Maximum number of points of the cached matrices (128 MB for a dense matrix).
+  static const unsigned int kMaxNumberOfPoints = 4096;
+
+ protected:
+
+  KernelMatrixCache() {}
+  ~KernelMatrixCache() {}
+
+ private:
+
+  struct Entry {
+    KernelEnumType kernelType;
+    ScalarType kernelWidth;
+    MatrixType points;
+    std::shared_ptr<const KernelMatrixType> matrix;
+  };
+
+  /// Maximum number of matrices in the cache.
+  static const std::size_t kMaxEntries = 4;
+
+  std::mutex m_Mutex;
+  /// Entries, from the most recently used.
+  std::list<Entry> m_Entries;
+
+};
@@ -19,12 +19,15 @@
 ///	Possible type of kernels.
 typedef enum {
   null,        /*!< Default value. */
-  Exact,        /*!< Kernel with exact computation (see ExactKernel). */
+  Exact,        /*!< Kernel with exact computation, compiled Gaussian profile (see ExactKernel, RadialKernel). */
 #ifdef USE_CUDA
   CUDAExact,	/*!< Kernel with exact computation on GPU (see ExactKernel). */
 #endif
   P3M,            /*!< Kernel with linearly spaced grid computation (see P3MKernel). */
-  COMPACT       /*!< Compact kernel. */
+  COMPACT,      /*!< Compact kernel. */
+  Cauchy,       /*!< Exact computation with the Cauchy profile (see RadialKernel). */
+  Wendland,     /*!< Exact computation with the compactly supported Wendland profile (see RadialKernel). */
+  Nystrom       /*!< Gaussian kernel approximated at a low rank (see NystromKernel). */
 } KernelEnumType;
 
 #endif /* _KernelType_h */
@@ -0,0 +1,209 @@
+/***************************************************************************************
+*                                                                                      *
+*                                     Deformetrica                                     *
+*                                                                                      *
+*    Copyright Inria and the University of Utah.  All rights reserved. This file is    *
+*    distributed under the terms of the Inria Non-Commercial License Agreement.        *
+*                                                                                      *
+*                                                                                      *
+****************************************************************************************/
+
+#include "NystromKernel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <stdexcept>
+
+#include "GeneralSettings.h"
+#include "Profiler.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Constructor(s) / Destructor :
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+template<class ScalarType, unsigned int PointDim>
+NystromKernel<ScalarType, PointDim>
+::NystromKernel(const NystromKernel &o)
+    : Superclass(o), m_Tolerance(o.m_Tolerance), m_FactorSources(o.m_FactorSources),
+      m_FactorKernelWidth(o.m_FactorKernelWidth), m_FactorTolerance(o.m_FactorTolerance),
+      m_Landmarks(o.m_Landmarks), m_Factor(o.m_Factor), m_LandmarkKernel(o.m_LandmarkKernel) {}
+
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Other method(s) :
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+template<class ScalarType, unsigned int PointDim>
+MatrixType
+NystromKernel<ScalarType, PointDim>
+::Convolve(const MatrixType &X) {
+  return UpdateLandmarkKernel().Convolve(X);
+}
+
+template<class ScalarType, unsigned int PointDim>
+std::vector<MatrixType>
+NystromKernel<ScalarType, PointDim>
+::ConvolveGradient(const MatrixType &X) {
+  return UpdateLandmarkKernel().ConvolveGradient(X);
+}
+
+template<class ScalarType, unsigned int PointDim>
+MatrixType
+NystromKernel<ScalarType, PointDim>
+::ConvolveGradient(const MatrixType &X, const MatrixType &alpha) {
+  return UpdateLandmarkKernel().ConvolveGradient(X, alpha);
+}
+
+template<class ScalarType, unsigned int PointDim>
+VectorType
+NystromKernel<ScalarType, PointDim>
+::ConvolveGradient(const MatrixType &X, unsigned int k, unsigned int dp) {
+  if (k >= this->GetWeights().columns())
+    throw std::runtime_error("Invalid weight index");
+
+  /// The exact kernels assume that X are the sources, which are not the sources of the landmark kernel.
+  return UpdateLandmarkKernel().ConvolveGradient(X, dp).get_column(k);
+}
+
+template<class ScalarType, unsigned int PointDim>
+MatrixType
+NystromKernel<ScalarType, PointDim>
+::ConvolveGradient(const MatrixType &X, unsigned int dim) {
+  return UpdateLandmarkKernel().ConvolveGradient(X, dim);
+}
+
+template<class ScalarType, unsigned int PointDim>
+std::vector<std::vector<MatrixType> >
+NystromKernel<ScalarType, PointDim>
+::ConvolveHessian(const MatrixType &X) {
+  return UpdateLandmarkKernel().ConvolveHessian(X);
+}
+
+template<class ScalarType, unsigned int PointDim>
+VectorType
+NystromKernel<ScalarType, PointDim>
+::ConvolveHessian(const MatrixType &X, unsigned int k, unsigned int dp, unsigned int dq) {
+  return UpdateLandmarkKernel().ConvolveHessian(X, k, dp, dq);
+}
+
+template<class ScalarType, unsigned int PointDim>
+MatrixType
+NystromKernel<ScalarType, PointDim>
+::ConvolveHessian(const MatrixType &X, unsigned int row, unsigned int col) {
+  return UpdateLandmarkKernel().ConvolveHessian(X, row, col);
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Protected method(s) :
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+template<class ScalarType, unsigned int PointDim>
+void
+NystromKernel<ScalarType, PointDim>
+::Init() {
+  m_Tolerance = def::utils::settings.nystrom_tolerance;
+  m_FactorKernelWidth = 0.0;
+  m_FactorTolerance = 0.0;
+}
+
+template<class ScalarType, unsigned int PointDim>
+void
+NystromKernel<ScalarType, PointDim>
+::UpdateFactor() {
+  MatrixType &Y = this->GetSources();
+  if (m_FactorKernelWidth == this->GetKernelWidth() && m_FactorTolerance == m_Tolerance && m_FactorSources == Y)
+    return;
+
+  DEF_PROFILE_SCOPE_SIZE("NystromKernel::UpdateFactor", Y.rows());
+  const unsigned int N = Y.rows();
+  const std::vector<FixedVectorType> y = Y.get_fixed_rows<PointDim>();
+
+  /// Pivoted Cholesky factorization, stopped when the residuals are below the tolerance squared (or are round-off
+  /// errors) : the column of the pivot p is (K(Y, y_p) - L L(p, :)^T) / sqrt(residual(p)).
+  const ScalarType minResidual = std::max<ScalarType>(m_Tolerance * m_Tolerance, 1e-14);
+  std::vector<ScalarType> residual(N);
+  for (unsigned int j = 0; j < N; j++)
+    residual[j] = this->EvaluateKernel(y[j], y[j]);
+
+  m_Landmarks.clear();
+  m_Factor.clear();
+  while (m_Landmarks.size() < N) {
+    const unsigned int p = std::max_element(residual.begin(), residual.end()) - residual.begin();
+    if (residual[p] <= minResidual)
+      break;
+
+    const ScalarType norm = std::sqrt(residual[p]);
+    std::vector<ScalarType> column(N);
+    for (unsigned int j = 0; j < N; j++) {
+      ScalarType Kjp = this->EvaluateKernel(y[j], y[p]);
+      for (unsigned int l = 0; l < m_Factor.size(); l++)
+        Kjp -= m_Factor[l][j] * m_Factor[l][p];
+      column[j] = Kjp / norm;
+      residual[j] -= column[j] * column[j];
+    }
+    residual[p] = 0.0;
+
+    m_Landmarks.push_back(p);
+    m_Factor.push_back(std::move(column));
+  }
+
+  MatrixType Z(m_Landmarks.size(), PointDim);
+  for (unsigned int l = 0; l < m_Landmarks.size(); l++)
+    for (unsigned int d = 0; d < PointDim; d++)
+      Z(l, d) = Y(m_Landmarks[l], d);
+
+  m_LandmarkKernel.SetKernelWidth(this->GetKernelWidth());
+  m_LandmarkKernel.SetSources(Z);
+
+  m_FactorSources = Y;
+  m_FactorKernelWidth = this->GetKernelWidth();
+  m_FactorTolerance = m_Tolerance;
+}
+
+template<class ScalarType, unsigned int PointDim>
+typename NystromKernel<ScalarType, PointDim>::LandmarkKernelType &
+NystromKernel<ScalarType, PointDim>
+::UpdateLandmarkKernel() {
+  UpdateFactor();
+
+  MatrixType &W = this->GetWeights();
+  if (this->GetSources().rows() != W.rows())
+    throw std::runtime_error("Sources and weights count mismatch");
+
+  const unsigned int N = W.rows();
+  const unsigned int rank = m_Landmarks.size();
+  const unsigned int weightDim = W.columns();
+
+  /// With L_Z the rows of L at the landmarks, K(Z,Z) = L_Z L_Z^T and L = K(Y,Z) L_Z^-T, so that the weights of
+  /// the landmarks K(Z,Z)^-1 K(Z,Y) W are the solution A of L_Z^T A = L^T W (L_Z^T is upper triangular).
+  MatrixType A(rank, weightDim, 0.0);
+  for (unsigned int l = 0; l < rank; l++) {
+    const std::vector<ScalarType> &Ll = m_Factor[l];
+    for (unsigned int k = 0; k < weightDim; k++) {
+      ScalarType LtW = 0.0;
+      for (unsigned int j = 0; j < N; j++)
+        LtW += Ll[j] * W(j, k);
+      A(l, k) = LtW;
+    }
+  }
+
+  for (int a = int(rank) - 1; a >= 0; a--) {
+    const ScalarType *La = m_Factor[a].data();
+    for (unsigned int k = 0; k < weightDim; k++) {
+      ScalarType Aak = A(a, k);
+      for (unsigned int b = a + 1; b < rank; b++)
+        Aak -= La[m_Landmarks[b]] * A(b, k);
+      A(a, k) = Aak / La[m_Landmarks[a]];
+    }
+  }
+
+  m_LandmarkKernel.SetWeights(A);
+  return m_LandmarkKernel;
+}
+
+template class NystromKernel<double, 2>;
+template class NystromKernel<double, 3>;
@@ -0,0 +1,143 @@
+/***************************************************************************************
+*                                                                                      *
+*                                     Deformetrica                                     *
+*                                                                                      *
+*    Copyright Inria and the University of Utah.  All rights reserved. This file is    *
+*    distributed under the terms of the Inria Non-Commercial License Agreement.        *
+*                                                                                      *
+*                                                                                      *
+****************************************************************************************/
+
+#pragma once
+
+#include <vector>
+
+#include "ExactKernel.h"
+#include "RadialKernel.h"
+
+/**
+ *	\brief      Gaussian kernel approximated at a low rank.
+ *
+ *	\copyright  Inria and the University of Utah
+ *	\version    Deformetrica 2.0
+ *
+ *	\details    When the kernel width is large with respect to the spacing of the sources, the kernel matrix of the
+ *	            sources is numerically low rank. The NystromKernel class inherited from ExactKernel replaces the
+ *	            Gaussian kernel by its Nystr&ouml;m approximation
+ *	            \f$ \tilde{K}(x,y) = K(x,Z) K(Z,Z)^{-1} K(Z,y) \f$ on a few landmarks \e Z chosen among the sources :
+ *	            the weights \e W of the sources are reduced to the weights \f$ A = K(Z,Z)^{-1} K(Z,Y) W \f$ of the
+ *	            landmarks, and all the convolutions are exact convolutions of \e A at \e Z (see GaussianKernel).
+ *	            With \e N sources, \e M points and \e r landmarks, a convolution costs O((N+M) r) instead of O(NM).
+ *
+ *	            The landmarks are the pivots of the incomplete Cholesky factorization \f$ K(Y,Y) \approx L L^T \f$,
+ *	            which picks the source of largest residual \f$ K(y,y) - \tilde{K}(y,y) \f$ until all the residuals
+ *	            are below the square of the tolerance : then \f$ |K(x,y) - \tilde{K}(x,y)| \f$ is below the
+ *	            tolerance for any point \e x and any source \e y, so that the rank follows from the tolerance only.
+ *	            The factorization costs O(N r^2) and is redone when the sources change; the kernel evaluations
+ *	            (EvaluateKernel() etc.) and ComputeKernelMatrix() stay exact.
+ */
+template<class ScalarType, unsigned int PointDim>
+class NystromKernel : public ExactKernel<ScalarType, PointDim> {
+ public:
+
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+  // typedef :
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+
+  /// Exact kernel type.
+  typedef ExactKernel<ScalarType, PointDim> Superclass;
+  /// Fixed-size vector type, for the points and the kernel gradients.
+  typedef typename Superclass::FixedVectorType FixedVectorType;
+  /// Exact kernel type of the convolutions at the landmarks.
+  typedef GaussianKernel<ScalarType, PointDim> LandmarkKernelType;
+
+
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Constructor(s) / Destructor :
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+
+  NystromKernel() : Superclass() { Init(); }
+  /// Copy constructor.
+  NystromKernel(const NystromKernel &o);
+  /// See AbstractKernel::AbstractKernel(const MatrixType& X, double h).
+  NystromKernel(const MatrixType &X, double h) : Superclass(X, h) { Init(); }
+  /// See AbstractKernel::AbstractKernel(const MatrixType& X, const MatrixType& W, double h).
+  NystromKernel(const MatrixType &X, const MatrixType &W, double h) : Superclass(X, W, h) { Init(); }
+
+  virtual NystromKernel *Clone() const { return new NystromKernel(*this); }
+
+  virtual ~NystromKernel() {}
+
+
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Encapsulation method(s) :
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+
+  /// Returns the maximal error on the kernel values.
+  ScalarType GetTolerance() const { return m_Tolerance; }
+  /// Sets the maximal error on the kernel values to \e tol : the lower, the higher the rank.
+  void SetTolerance(ScalarType tol) {
+    if (tol < 0.0)
+      throw std::runtime_error("The tolerance of the low rank kernel must be non-negative");
+    m_Tolerance = tol;
+  }
+
+  /// Returns the number of landmarks for the current sources, kernel width and tolerance.
+  unsigned int GetRank() {
+    UpdateFactor();
+    return m_Landmarks.size();
+  }
+
+
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Other method(s) :
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+
+  virtual MatrixType Convolve(const MatrixType &X);
+
+  virtual std::vector<MatrixType> ConvolveGradient(const MatrixType &X);
+  virtual MatrixType ConvolveGradient(const MatrixType &X, const MatrixType &alpha);
+  virtual VectorType ConvolveGradient(const MatrixType &X, unsigned int k, unsigned int dp);
+  virtual MatrixType ConvolveGradient(const MatrixType &X, unsigned int dim);
+
+  virtual std::vector<std::vector<MatrixType> > ConvolveHessian(const MatrixType &X);
+  virtual VectorType ConvolveHessian(const MatrixType &X, unsigned int k, unsigned int dp, unsigned int dq);
+  virtual MatrixType ConvolveHessian(const MatrixType &X, unsigned int row, unsigned int col);
+
+ protected:
+
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Method(s) :
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+
+  /// Sets the default tolerance, and marks the factorization as out of date.
+  void Init();
+
+  /// Computes the landmarks and the factor of the sources, unless they are up to date.
+  void UpdateFactor();
+
+  /// Sets the landmark kernel up with the weights of the landmarks, computed from the current weights.
+  LandmarkKernelType &UpdateLandmarkKernel();
+
+
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Attribute(s)
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+
+  /// Maximal error on the kernel values.
+  ScalarType m_Tolerance;
+
+  /// Sources, kernel width and tolerance of the current factorization.
+  MatrixType m_FactorSources;
+  ScalarType m_FactorKernelWidth;
+  ScalarType m_FactorTolerance;
+
+  /// Indices of the landmarks among the sources, in the order of the factorization.
+  std::vector<unsigned int> m_Landmarks;
+  /// Columns of the factor \e L (one per landmark, of the size of the sources).
+  std::vector<std::vector<ScalarType> > m_Factor;
+
+  /// Gaussian kernel whose sources are the landmarks.
+  LandmarkKernelType m_LandmarkKernel;
+
+}; /* class NystromKernel */
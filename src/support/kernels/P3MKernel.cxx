@@ -39,6 +39,8 @@
 #include "itkSmoothingRecursiveGaussianImageFilter.h"
 #include "itkImageDuplicator.h"
 
+#include "Profiler.h"
+
 #include <exception>
 #include <stdexcept>
 
@@ -111,16 +113,6 @@ std::vector<std::vector<typename P3MKernel<ScalarType, PointDim>::ComplexImagePo
     P3MKernel<ScalarType, PointDim>::m_CacheFFTHessianKernelImages;
 
 
-///// For profiling.
-//template<class ScalarType, unsigned int PointDim> ScalarType P3MKernel<ScalarType, PointDim>::m_ConvolveTime;
-//template<class ScalarType, unsigned int PointDim> ScalarType P3MKernel<ScalarType, PointDim>::m_ConvolveGradientTime;
-//template<class ScalarType, unsigned int PointDim> ScalarType P3MKernel<ScalarType, PointDim>::m_ConvolveHessianTime;
-//
-//template<class ScalarType, unsigned int PointDim> ScalarType P3MKernel<ScalarType, PointDim>::m_UpdateGridTime;
-//template<class ScalarType, unsigned int PointDim> ScalarType P3MKernel<ScalarType, PointDim>::m_ApplyKernelFftTime;
-//template<class ScalarType, unsigned int PointDim> ScalarType P3MKernel<ScalarType, PointDim>::m_InterpolateTime;
-
-
 // Methods
 
 template<class ScalarType, unsigned int PointDim>
@@ -235,6 +227,7 @@ template<class ScalarType, unsigned int PointDim>
 void
 P3MKernel<ScalarType, PointDim>
 ::UpdateGrids() {
+  DEF_PROFILE_SCOPE_SIZE("P3MKernel::UpdateGrids", this->GetSources().rows());
 
   // Update grid size and spacing
   this->DetermineGrids();
@@ -1086,6 +1079,7 @@ template<class ScalarType, unsigned int PointDim>
 typename P3MKernel<ScalarType, PointDim>::ImagePointer
 P3MKernel<ScalarType, PointDim>
 ::ApplyKernelFFT(ComplexImageType *kernelImg, ImageType *img) {
+  DEF_PROFILE_SCOPE("P3MKernel::ApplyKernelFFT");
   if (kernelImg == 0) {
 
     std::cout << "no kernelImg!... implementation doubtful..." << std::endl;
@@ -1180,6 +1174,7 @@ template<class ScalarType, unsigned int PointDim>
 typename P3MKernel<ScalarType, PointDim>::ImagePointer
 P3MKernel<ScalarType, PointDim>
 ::ApplyKernelFFT(ComplexImageType *kernelImg, ComplexImageType *img) {
+  DEF_PROFILE_SCOPE("P3MKernel::ApplyKernelFFT");
   if (kernelImg == 0)
     throw std::runtime_error("should give kernelImg");
 
@@ -1243,19 +1238,12 @@ template<class ScalarType, unsigned int PointDim>
 MatrixType
 P3MKernel<ScalarType, PointDim>
 ::Convolve(const MatrixType &X) {
-//	/// For profiling.
-//	std::chrono::high_resolution_clock::time_point t1 = std::chrono::high_resolution_clock::now();
-
+  DEF_PROFILE_SCOPE_SIZE("P3MKernel::Convolve", X.rows() * this->GetSources().rows());
   if (this->IsModified()) {
     this->UpdateGrids();
     this->UnsetModified();
   }
 
-//    /// For profiling.
-//    std::chrono::high_resolution_clock::time_point tg = std::chrono::high_resolution_clock::now();
-//    auto dg = std::chrono::duration_cast<std::chrono::milliseconds>(tg-t1).count();
-//    m_UpdateGridTime += dg;
-
   MatrixType &Y = this->GetSources();
   MatrixType &W = this->GetWeights();
 
@@ -1274,19 +1262,11 @@ P3MKernel<ScalarType, PointDim>
   //   nearThres += m_GridSpacing[d]*m_GridSpacing[d];
   // nearThres *= m_NearThresholdScale*m_NearThresholdScale;
 
-//	/// For profiling.
-//	std::chrono::high_resolution_clock::time_point t3 = std::chrono::high_resolution_clock::now();
-
   // Convolve weights splatted on mesh with kernel
   std::vector<ImagePointer> img(weightDim);
   for (unsigned int k = 0; k < weightDim; k++)
     img[k] = this->ApplyKernelFFT(m_FFTKernel, m_MeshListFFT[k]);
 
-//    /// For profiling.
-//    std::chrono::high_resolution_clock::time_point t4 = std::chrono::high_resolution_clock::now();
-//    auto da = std::chrono::duration_cast<std::chrono::milliseconds>(t4-t3).count();
-//    m_ApplyKernelFftTime += da;
-
   for (unsigned int i = 0; i < X.rows(); i++) {
     VectorType xi = X.get_row(i);
 
@@ -1340,14 +1320,6 @@ P3MKernel<ScalarType, PointDim>
     V.set_row(i, vi);
   }
 
-//	/// For profiling.
-//	std::chrono::high_resolution_clock::time_point t2 = std::chrono::high_resolution_clock::now();
-//	auto d = std::chrono::duration_cast<std::chrono::milliseconds>(t2-t1).count();
-//	m_ConvolveTime += d;
-//
-//    auto di = std::chrono::duration_cast<std::chrono::milliseconds>(t2-t4).count();
-//    m_InterpolateTime += di;
-
   return V;
 }
 
@@ -1355,6 +1327,7 @@ template<class ScalarType, unsigned int PointDim>
 MatrixType
 P3MKernel<ScalarType, PointDim>
 ::ConvolveGradient(const MatrixType &X, const MatrixType &alpha) {
+  DEF_PROFILE_SCOPE_SIZE("P3MKernel::ConvolveGradient", X.rows() * this->GetSources().rows());
   std::vector<MatrixType> gradMom = this->ConvolveGradient(X);
 
   MatrixType result(X.rows(), PointDim, 0);
@@ -1368,19 +1341,12 @@ template<class ScalarType, unsigned int PointDim>
 std::vector<MatrixType>
 P3MKernel<ScalarType, PointDim>
 ::ConvolveGradient(const MatrixType &X) {
-//     /// For profiling.
-//     std::chrono::high_resolution_clock::time_point t1 = std::chrono::high_resolution_clock::now();
-
+  DEF_PROFILE_SCOPE_SIZE("P3MKernel::ConvolveGradient", X.rows() * this->GetSources().rows());
   if (this->IsModified()) {
     this->UpdateGrids();
     this->UnsetModified();
   }
 
-//     /// For profiling.
-//     std::chrono::high_resolution_clock::time_point tg = std::chrono::high_resolution_clock::now();
-//     auto dg = std::chrono::duration_cast<std::chrono::milliseconds>(tg-t1).count();
-//     m_UpdateGridTime += dg;
-
   MatrixType &Y = this->GetSources();
   MatrixType &W = this->GetWeights();
 
@@ -1400,19 +1366,11 @@ P3MKernel<ScalarType, PointDim>
   std::vector<MatrixType> gradK(
       X.rows(), MatrixType(weightDim, PointDim, 0.0));
 
-//     /// For profiling.
-//     std::chrono::high_resolution_clock::time_point t3 = std::chrono::high_resolution_clock::now();
-
   std::vector<ImagePointer> img(weightDim * PointDim);
   for (unsigned int k = 0; k < weightDim; k++)
     for (unsigned int p = 0; p < PointDim; p++)
       img[p + PointDim * k] = this->ApplyKernelFFT(m_FFTGradientKernels[p], m_MeshListFFT[k]);
 
-//     /// For profiling.
-//     std::chrono::high_resolution_clock::time_point t4 = std::chrono::high_resolution_clock::now();
-//     auto da = std::chrono::duration_cast<std::chrono::milliseconds>(t4-t3).count();
-//     m_ApplyKernelFftTime += da;
-
   for (unsigned int i = 0; i < X.rows(); i++) {
     VectorType xi = X.get_row(i);
 
@@ -1425,14 +1383,6 @@ P3MKernel<ScalarType, PointDim>
 
   }
 
-//     /// For profiling.
-//     std::chrono::high_resolution_clock::time_point t2 = std::chrono::high_resolution_clock::now();
-//     auto d = std::chrono::duration_cast<std::chrono::milliseconds>(t2-t1).count();
-//     m_ConvolveGradientTime += d;
-//
-//     auto di = std::chrono::duration_cast<std::chrono::milliseconds>(t2-t4).count();
-//     m_InterpolateTime += di;
-
   return gradK;
 
 }
@@ -1441,19 +1391,12 @@ template<class ScalarType, unsigned int PointDim>
 MatrixType
 P3MKernel<ScalarType, PointDim>
 ::ConvolveGradient(const MatrixType &X, unsigned int dim) {
-//    /// For profiling.
-//    std::chrono::high_resolution_clock::time_point t1 = std::chrono::high_resolution_clock::now();
 
   if (this->IsModified()) {
     this->UpdateGrids();
     this->UnsetModified();
   }
 
-//    /// For profiling.
-//    std::chrono::high_resolution_clock::time_point tg = std::chrono::high_resolution_clock::now();
-//    auto dg = std::chrono::duration_cast<std::chrono::milliseconds>(tg-t1).count();
-//    m_UpdateGridTime += dg;
-
   MatrixType &Y = this->GetSources();
   MatrixType &W = this->GetWeights();
 
@@ -1469,18 +1412,10 @@ P3MKernel<ScalarType, PointDim>
 
   MatrixType gradK(X.rows(), weightDim, 0.0);
 
-//    /// For profiling.
-//    std::chrono::high_resolution_clock::time_point t3 = std::chrono::high_resolution_clock::now();
-
   std::vector<ImagePointer> img(weightDim);
   for (unsigned int k = 0; k < weightDim; k++)
     img[k] = this->ApplyKernelFFT(m_FFTGradientKernels[dim], m_MeshListFFT[k]);
 
-//    /// For profiling.
-//    std::chrono::high_resolution_clock::time_point t4 = std::chrono::high_resolution_clock::now();
-//    auto da = std::chrono::duration_cast<std::chrono::milliseconds>(t4-t3).count();
-//    m_ApplyKernelFftTime += da;
-
   for (unsigned int i = 0; i < X.rows(); i++) {
     VectorType xi = X.get_row(i);
 
@@ -1489,14 +1424,6 @@ P3MKernel<ScalarType, PointDim>
     gradK.set_row(i, wi);
   }
 
-//    /// For profiling.
-//    std::chrono::high_resolution_clock::time_point t2 = std::chrono::high_resolution_clock::now();
-//    auto d = std::chrono::duration_cast<std::chrono::milliseconds>(t2-t1).count();
-//    m_ConvolveGradientTime += d;
-//
-//    auto di = std::chrono::duration_cast<std::chrono::milliseconds>(t2-t4).count();
-//    m_InterpolateTime += di;
-
   return gradK;
 }
 
@@ -1504,19 +1431,12 @@ template<class ScalarType, unsigned int PointDim>
 VectorType
 P3MKernel<ScalarType, PointDim>
 ::ConvolveGradient(const MatrixType &X, unsigned int k, unsigned int dp) {
-//    /// For profiling.
-//    std::chrono::high_resolution_clock::time_point t1 = std::chrono::high_resolution_clock::now();
 
   if (this->IsModified()) {
     this->UpdateGrids();
     this->UnsetModified();
   }
 
-//    /// For profiling.
-//    std::chrono::high_resolution_clock::time_point tg = std::chrono::high_resolution_clock::now();
-//    auto dg = std::chrono::duration_cast<std::chrono::milliseconds>(tg-t1).count();
-//    m_UpdateGridTime += dg;
-
   MatrixType &Y = this->GetSources();
   MatrixType &W = this->GetWeights();
 
@@ -1535,11 +1455,6 @@ P3MKernel<ScalarType, PointDim>
 
   VectorType gradK(X.rows(), 0.0);
 
-//    /// For profiling.
-//    std::chrono::high_resolution_clock::time_point t2 = std::chrono::high_resolution_clock::now();
-//    auto d = std::chrono::duration_cast<std::chrono::milliseconds>(t2-t1).count();
-//    m_ConvolveGradientTime += d;
-
   return gradK;
 }
 
@@ -1547,9 +1462,7 @@ template<class ScalarType, unsigned int PointDim>
 std::vector<std::vector<MatrixType> >
 P3MKernel<ScalarType, PointDim>
 ::ConvolveHessian(const MatrixType &X) {
-//    /// For profiling.
-//    std::chrono::high_resolution_clock::time_point t1 = std::chrono::high_resolution_clock::now();
-
+  DEF_PROFILE_SCOPE_SIZE("P3MKernel::ConvolveHessian", X.rows() * this->GetSources().rows());
   if (this->IsModified()) {
     this->UpdateGrids();
     this->UnsetModified();
@@ -1558,11 +1471,6 @@ P3MKernel<ScalarType, PointDim>
   if (!m_HessianUpdated)
     this->UpdateHessianGrids();
 
-//    /// For profiling.
-//    std::chrono::high_resolution_clock::time_point tg = std::chrono::high_resolution_clock::now();
-//    auto dg = std::chrono::duration_cast<std::chrono::milliseconds>(tg-t1).count();
-//    m_UpdateGridTime += dg;
-
   MatrixType &Y = this->GetSources();
   MatrixType &W = this->GetWeights();
 
@@ -1581,20 +1489,12 @@ P3MKernel<ScalarType, PointDim>
     hessK.push_back(H);
   }
 
-//    /// For profiling.
-//    std::chrono::high_resolution_clock::time_point t3 = std::chrono::high_resolution_clock::now();
-
   int ptsD2 = PointDim * (PointDim + 1) / 2;
   std::vector<ImagePointer> img(weightDim * ptsD2);
   for (unsigned int p = 0; p < ptsD2; p++)
     for (unsigned int k = 0; k < weightDim; k++)
       img[k + weightDim * p] = this->ApplyKernelFFT(m_FFTHessianKernels[p], m_MeshListFFT[k]);
 
-//    /// For profiling.
-//    std::chrono::high_resolution_clock::time_point t4 = std::chrono::high_resolution_clock::now();
-//    auto da = std::chrono::duration_cast<std::chrono::milliseconds>(t4-t3).count();
-//    m_ApplyKernelFftTime += da;
-
   for (unsigned int i = 0; i < X.rows(); i++) {
     VectorType xi = X.get_row(i);
     VectorType w = this->Interpolate(xi, img);
@@ -1620,8 +1520,6 @@ template<class ScalarType, unsigned int PointDim>
 MatrixType
 P3MKernel<ScalarType, PointDim>
 ::ConvolveHessian(const MatrixType &X, unsigned int row, unsigned int col) {
-//    /// For profiling.
-//    std::chrono::high_resolution_clock::time_point t1 = std::chrono::high_resolution_clock::now();
 
   if (this->IsModified()) {
     this->UpdateGrids();
@@ -1631,11 +1529,6 @@ P3MKernel<ScalarType, PointDim>
   if (!m_HessianUpdated)
     this->UpdateHessianGrids();
 
-//    /// For profiling.
-//    std::chrono::high_resolution_clock::time_point tg = std::chrono::high_resolution_clock::now();
-//    auto dg = std::chrono::duration_cast<std::chrono::milliseconds>(tg-t1).count();
-//    m_UpdateGridTime += dg;
-
   MatrixType &Y = this->GetSources();
   MatrixType &W = this->GetWeights();
 
@@ -1651,20 +1544,12 @@ P3MKernel<ScalarType, PointDim>
 
   MatrixType hessK(X.rows(), weightDim, 0.0);
 
-//    /// For profiling.
-//    std::chrono::high_resolution_clock::time_point t3 = std::chrono::high_resolution_clock::now();
-
   int index =
       (row <= col) ? (col + PointDim * row - row * (row + 1) / 2) : (row + PointDim * col - col * (col + 1) / 2);
   std::vector<ImagePointer> img(weightDim);
   for (unsigned int k = 0; k < weightDim; k++)
     img[k] = this->ApplyKernelFFT(m_FFTHessianKernels[index], m_MeshListFFT[k]);
 
-//    /// For profiling.
-//    std::chrono::high_resolution_clock::time_point t4 = std::chrono::high_resolution_clock::now();
-//    auto da = std::chrono::duration_cast<std::chrono::milliseconds>(t4-t3).count();
-//    m_ApplyKernelFftTime += da;
-
   for (int i = 0; i < X.rows(); i++) {
     VectorType xi = X.get_row(i);
     VectorType wi = this->Interpolate(xi, img);
@@ -1672,14 +1557,6 @@ P3MKernel<ScalarType, PointDim>
     hessK.set_row(i, wi);
   }
 
-//    /// For profiling.
-//    std::chrono::high_resolution_clock::time_point t2 = std::chrono::high_resolution_clock::now();
-//    auto d = std::chrono::duration_cast<std::chrono::milliseconds>(t2-t1).count();
-//    m_ConvolveHessianTime += d;
-//
-//    auto di = std::chrono::duration_cast<std::chrono::milliseconds>(t2-t4).count();
-//    m_InterpolateTime += di;
-
   return hessK;
 }
 
@@ -1688,8 +1565,6 @@ VectorType
 P3MKernel<ScalarType, PointDim>
 ::ConvolveHessian(const MatrixType &X, unsigned int k,
                   unsigned int dp, unsigned int dq) {
-//    /// For profiling.
-//    std::chrono::high_resolution_clock::time_point t1 = std::chrono::high_resolution_clock::now();
 
   if (this->IsModified()) {
     this->UpdateGrids();
@@ -1699,11 +1574,6 @@ P3MKernel<ScalarType, PointDim>
   if (!m_HessianUpdated)
     this->UpdateHessianGrids();
 
-//    /// For profiling.
-//    std::chrono::high_resolution_clock::time_point tg = std::chrono::high_resolution_clock::now();
-//    auto dg = std::chrono::duration_cast<std::chrono::milliseconds>(tg-t1).count();
-//    m_UpdateGridTime += dg;
-
   MatrixType &Y = this->GetSources();
   MatrixType &W = this->GetWeights();
 
@@ -271,16 +271,6 @@ class P3MKernel : public ExactKernel<ScalarType, PointDim> {
   static std::vector<ImageSizeType> m_CacheFFTHessianKernelSizes;
   static std::vector<std::vector<ComplexImagePointer> > m_CacheFFTHessianKernelImages;
 
-//public:
-//    /// For profiling.
-//    static ScalarType m_ConvolveTime;
-//    static ScalarType m_ConvolveGradientTime;
-//    static ScalarType m_ConvolveHessianTime;
-//
-//    static ScalarType m_UpdateGridTime;
-//    static ScalarType m_ApplyKernelFftTime;
-//    static ScalarType m_InterpolateTime;
-
   /// \endcond
 
 }; /* class P3MKernel */
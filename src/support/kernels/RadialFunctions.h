@@ -0,0 +1,228 @@
+/***************************************************************************************
+*                                                                                      *
+*                                     Deformetrica                                     *
+*                                                                                      *
+*    Copyright Inria and the University of Utah.  All rights reserved. This file is    *
+*    distributed under the terms of the Inria Non-Commercial License Agreement.        *
+*                                                                                      *
+*                                                                                      *
+****************************************************************************************/
+
+#pragma once
+
+#ifndef DEFORMETRICA_CONFIG
+#include "DeformetricaConfig.h"
+#endif
+
+#include <cmath>
+#include <cstddef>
+
+#include "GeneralSettings.h"
+#include "MathFunctions.h"
+
+/**
+ *	\brief      Radial profiles of the CPU kernels.
+ *
+ *	\copyright  Inria and the University of Utah
+ *	\version    Deformetrica 2.0
+ *
+ *	\details    The radial profiles define kernels of the form \f$ K(x,y) = f(u) \f$ with \f$ u = |x-y|^2 \f$, as the
+ *	            radial functions of lib/cuda_convolutions. They are template parameters of RadialKernel rather than
+ *	            classes with virtual methods : Eval(), Diff() and DiffDiff2() are inlined in the loops over the pairs
+ *	            of points. The gradient and the hessian of the kernel at \e x follow from the derivatives of \e f :
+ *	            \f[
+ *	            \nabla_x K = 2 f'(u) (x-y), \qquad H_x K = 4 f''(u) (x-y)(x-y)^T + 2 f'(u) I.
+ *	            \f]
+ *	            The batch methods EvalBatch(), DiffBatch() and DiffDiff2Batch() compute the profile at all the squared
+ *	            distances between a point and the sources at once, so that the Gaussian profile uses the vectorized
+ *	            exponential fast_math::vexp().
+ */
+
+/// Gaussian profile \f$ f(u) = \exp(-u / \sigma^2) \f$, the kernel of ExactKernel.
+template<class ScalarType>
+class GaussianFunction {
+ public:
+
+  GaussianFunction() { SetKernelWidth(1.0); }
+
+  /// Sets the kernel width \f$ \sigma \f$.
+  void SetKernelWidth(ScalarType sigma) { m_ooSigma2 = 1.0 / (sigma * sigma); }
+
+  /// Computes \f$ f(u) \f$.
+  inline ScalarType Eval(ScalarType u) const { return Exp(-u * m_ooSigma2); }
+  /// Computes \f$ f'(u) \f$.
+  inline ScalarType Diff(ScalarType u) const { return -m_ooSigma2 * Exp(-u * m_ooSigma2); }
+  /// Stores \f$ f'(u) \f$ in \e d1 and \f$ f''(u) \f$ in \e d2.
+  inline void DiffDiff2(ScalarType u, ScalarType &d1, ScalarType &d2) const {
+    d1 = -m_ooSigma2 * Exp(-u * m_ooSigma2);
+    d2 = -m_ooSigma2 * d1;
+  }
+
+  /// Stores \f$ f(u_j) \f$ in \e f[j], for j < n.
+  inline void EvalBatch(const ScalarType *u, ScalarType *f, std::size_t n) const {
+    for (std::size_t j = 0; j < n; j++)
+      f[j] = -u[j] * m_ooSigma2;
+    ExpBatch(f, n);
+  }
+  /// Stores \f$ f'(u_j) \f$ in \e d1[j], for j < n.
+  inline void DiffBatch(const ScalarType *u, ScalarType *d1, std::size_t n) const {
+    EvalBatch(u, d1, n);
+    for (std::size_t j = 0; j < n; j++)
+      d1[j] *= -m_ooSigma2;
+  }
+  /// Stores \f$ f'(u_j) \f$ in \e d1[j] and \f$ f''(u_j) \f$ in \e d2[j], for j < n.
+  inline void DiffDiff2Batch(const ScalarType *u, ScalarType *d1, ScalarType *d2, std::size_t n) const {
+    DiffBatch(u, d1, n);
+    for (std::size_t j = 0; j < n; j++)
+      d2[j] = -m_ooSigma2 * d1[j];
+  }
+
+  /// The Gaussian has no compact support.
+  inline bool IsOutOfSupport(ScalarType u) const { return false; }
+
+ private:
+
+  /// Exponential chosen at compile time (see MathFunctions.h), so that it is inlined.
+  static inline ScalarType Exp(ScalarType x) {
+#ifdef USE_FAST_MATH
+    return fast_math::fast_exp(x);
+#else
+    return std::exp(x);
+#endif
+  }
+
+  /// Exponential of the \e n values of \e x, in place. Its accuracy is set by the polynomial degree of
+  /// def::utils::settings.
+  static inline void ExpBatch(ScalarType *x, std::size_t n) {
+#ifdef USE_FAST_MATH
+    for (std::size_t j = 0; j < n; j++)
+      x[j] = fast_math::fast_exp(x[j]);
+#else
+    fast_math::vexp(x, x, n, def::utils::settings.exp_polynomial_degree);
+#endif
+  }
+
+  ScalarType m_ooSigma2;
+
+};
+
+/// Cauchy profile \f$ f(u) = 1 / (1 + u / \sigma^2) \f$, with heavier tails than the Gaussian.
+template<class ScalarType>
+class CauchyFunction {
+ public:
+
+  CauchyFunction() { SetKernelWidth(1.0); }
+
+  /// Sets the kernel width \f$ \sigma \f$.
+  void SetKernelWidth(ScalarType sigma) { m_ooSigma2 = 1.0 / (sigma * sigma); }
+
+  /// Computes \f$ f(u) \f$.
+  inline ScalarType Eval(ScalarType u) const { return 1.0 / (1.0 + u * m_ooSigma2); }
+  /// Computes \f$ f'(u) \f$.
+  inline ScalarType Diff(ScalarType u) const {
+    const ScalarType f = 1.0 / (1.0 + u * m_ooSigma2);
+    return -m_ooSigma2 * f * f;
+  }
+  /// Stores \f$ f'(u) \f$ in \e d1 and \f$ f''(u) \f$ in \e d2.
+  inline void DiffDiff2(ScalarType u, ScalarType &d1, ScalarType &d2) const {
+    const ScalarType f = 1.0 / (1.0 + u * m_ooSigma2);
+    d1 = -m_ooSigma2 * f * f;
+    d2 = -2.0 * m_ooSigma2 * d1 * f;
+  }
+
+  /// See GaussianFunction::EvalBatch().
+  inline void EvalBatch(const ScalarType *u, ScalarType *f, std::size_t n) const {
+    for (std::size_t j = 0; j < n; j++)
+      f[j] = Eval(u[j]);
+  }
+  /// See GaussianFunction::DiffBatch().
+  inline void DiffBatch(const ScalarType *u, ScalarType *d1, std::size_t n) const {
+    for (std::size_t j = 0; j < n; j++)
+      d1[j] = Diff(u[j]);
+  }
+  /// See GaussianFunction::DiffDiff2Batch().
+  inline void DiffDiff2Batch(const ScalarType *u, ScalarType *d1, ScalarType *d2, std::size_t n) const {
+    for (std::size_t j = 0; j < n; j++)
+      DiffDiff2(u[j], d1[j], d2[j]);
+  }
+
+  /// The Cauchy kernel has no compact support.
+  inline bool IsOutOfSupport(ScalarType u) const { return false; }
+
+ private:
+
+  ScalarType m_ooSigma2;
+
+};
+
+/// Wendland profile \f$ \phi_{3,2}(s) = (1-s)_+^6 (35 s^2 + 18 s + 3) / 3 \f$ with \f$ s = |x-y| / \sigma \f$ : a
+/// compactly supported kernel, positive definite up to dimension 3 and \f$ C^4 \f$, so that its hessian is defined
+/// everywhere. Its support is the ball of radius \f$ \sigma \f$, as for the Compact kernel.
+template<class ScalarType>
+class WendlandFunction {
+ public:
+
+  WendlandFunction() { SetKernelWidth(1.0); }
+
+  /// Sets the support radius \f$ \sigma \f$.
+  void SetKernelWidth(ScalarType sigma) {
+    m_Sigma2 = sigma * sigma;
+    m_ooSigma = 1.0 / sigma;
+    m_ooSigma2 = 1.0 / m_Sigma2;
+  }
+
+  /// Computes \f$ f(u) = \phi(\sqrt{u} / \sigma) \f$.
+  inline ScalarType Eval(ScalarType u) const {
+    if (u >= m_Sigma2) return 0.0;
+    const ScalarType s = std::sqrt(u) * m_ooSigma;
+    const ScalarType t = 1.0 - s;
+    const ScalarType t3 = t * t * t;
+    return t3 * t3 * (35.0 * s * s + 18.0 * s + 3.0) / 3.0;
+  }
+  /// Computes \f$ f'(u) = -\frac{28}{3 \sigma^2} (1-s)^5 (5 s + 1) \f$.
+  inline ScalarType Diff(ScalarType u) const {
+    if (u >= m_Sigma2) return 0.0;
+    const ScalarType s = std::sqrt(u) * m_ooSigma;
+    const ScalarType t = 1.0 - s;
+    const ScalarType t2 = t * t;
+    return -28.0 / 3.0 * m_ooSigma2 * t2 * t2 * t * (5.0 * s + 1.0);
+  }
+  /// Stores \f$ f'(u) \f$ in \e d1 and \f$ f''(u) = \frac{140}{\sigma^4} (1-s)^4 \f$ in \e d2.
+  inline void DiffDiff2(ScalarType u, ScalarType &d1, ScalarType &d2) const {
+    if (u >= m_Sigma2) {
+      d1 = d2 = 0.0;
+      return;
+    }
+    const ScalarType s = std::sqrt(u) * m_ooSigma;
+    const ScalarType t = 1.0 - s;
+    const ScalarType t4 = t * t * t * t;
+    d1 = -28.0 / 3.0 * m_ooSigma2 * t4 * t * (5.0 * s + 1.0);
+    d2 = 140.0 * m_ooSigma2 * m_ooSigma2 * t4;
+  }
+
+  /// See GaussianFunction::EvalBatch().
+  inline void EvalBatch(const ScalarType *u, ScalarType *f, std::size_t n) const {
+    for (std::size_t j = 0; j < n; j++)
+      f[j] = Eval(u[j]);
+  }
+  /// See GaussianFunction::DiffBatch().
+  inline void DiffBatch(const ScalarType *u, ScalarType *d1, std::size_t n) const {
+    for (std::size_t j = 0; j < n; j++)
+      d1[j] = Diff(u[j]);
+  }
+  /// See GaussianFunction::DiffDiff2Batch().
+  inline void DiffDiff2Batch(const ScalarType *u, ScalarType *d1, ScalarType *d2, std::size_t n) const {
+    for (std::size_t j = 0; j < n; j++)
+      DiffDiff2(u[j], d1[j], d2[j]);
+  }
+
+  /// Returns true if the pairs at squared distance \e u do not interact.
+  inline bool IsOutOfSupport(ScalarType u) const { return u >= m_Sigma2; }
+
+ private:
+
+  ScalarType m_Sigma2;
+  ScalarType m_ooSigma;
+  ScalarType m_ooSigma2;
+
+};
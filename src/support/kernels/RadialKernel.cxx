@@ -0,0 +1,387 @@
+/***************************************************************************************
+*                                                                                      *
+*                                     Deformetrica                                     *
+*                                                                                      *
+*    Copyright Inria and the University of Utah.  All rights reserved. This file is    *
+*    distributed under the terms of the Inria Non-Commercial License Agreement.        *
+*                                                                                      *
+*                                                                                      *
+****************************************************************************************/
+
+#include "RadialKernel.h"
+
+#include <algorithm>
+#include <exception>
+#include <stdexcept>
+
+#include "Profiler.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Other method(s) :
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+template<class ScalarType, unsigned int PointDim, class RadialFunctionType>
+MatrixType
+RadialKernel<ScalarType, PointDim, RadialFunctionType>
+::Convolve(const MatrixType &X) {
+  DEF_PROFILE_SCOPE_SIZE("RadialKernel::Convolve", X.rows() * this->GetSources().rows());
+  MatrixType &Y = this->GetSources();
+  MatrixType &W = this->GetWeights();
+
+  if (Y.rows() != W.rows())
+    throw std::runtime_error("Sources and weights count mismatch");
+
+  const unsigned int weightDim = W.columns();
+
+  /// The points and the weights of each source are gathered once in contiguous rows.
+  const std::vector<FixedVectorType> x = X.get_fixed_rows<PointDim>();
+  const std::vector<FixedVectorType> y = Y.get_fixed_rows<PointDim>();
+  const RowMajorMatrix<ScalarType> w = W.row_major();
+
+  /// The profile is computed at once for all the sources of each point (see RadialFunctions.h).
+  std::vector<ScalarType> u(Y.rows()), K(Y.rows());
+
+  MatrixType V(X.rows(), weightDim, 0.0);
+  std::vector<ScalarType> Vi(weightDim);
+  for (unsigned int i = 0; i < X.rows(); i++) {
+    for (unsigned int j = 0; j < Y.rows(); j++)
+      u[j] = (x[i] - y[j]).squared_magnitude();
+    m_Function.EvalBatch(u.data(), K.data(), Y.rows());
+
+    std::fill(Vi.begin(), Vi.end(), 0.0);
+    for (unsigned int j = 0; j < Y.rows(); j++) {
+      if (m_Function.IsOutOfSupport(u[j])) continue;
+
+      const ScalarType *wj = w.row_ptr(j);
+      for (unsigned int k = 0; k < weightDim; k++)
+        Vi[k] += K[j] * wj[k];
+    }
+    for (unsigned int k = 0; k < weightDim; k++)
+      V(i, k) = Vi[k];
+  }
+
+  return V;
+}
+
+template<class ScalarType, unsigned int PointDim, class RadialFunctionType>
+std::vector<MatrixType>
+RadialKernel<ScalarType, PointDim, RadialFunctionType>
+::ConvolveGradient(const MatrixType &X) {
+  DEF_PROFILE_SCOPE_SIZE("RadialKernel::ConvolveGradient", X.rows() * this->GetSources().rows());
+  MatrixType &Y = this->GetSources();
+  MatrixType &W = this->GetWeights();
+
+  if (Y.rows() != W.rows())
+    throw std::runtime_error("Sources and weights count mismatch");
+
+  const unsigned int weightDim = W.columns();
+
+  const std::vector<FixedVectorType> x = X.get_fixed_rows<PointDim>();
+  const std::vector<FixedVectorType> y = Y.get_fixed_rows<PointDim>();
+  const RowMajorMatrix<ScalarType> w = W.row_major();
+
+  std::vector<MatrixType> gradK;
+  gradK.reserve(X.rows());
+
+  std::vector<ScalarType> u(Y.rows()), d1(Y.rows());
+
+  std::vector<FixedVectorType> Gi(weightDim);
+  for (unsigned int i = 0; i < X.rows(); i++) {
+    for (unsigned int j = 0; j < Y.rows(); j++)
+      u[j] = (x[i] - y[j]).squared_magnitude();
+    m_Function.DiffBatch(u.data(), d1.data(), Y.rows());
+
+    for (unsigned int k = 0; k < weightDim; k++)
+      Gi[k].fill(0.0);
+
+    for (unsigned int j = 0; j < Y.rows(); j++) {
+      if (m_Function.IsOutOfSupport(u[j])) continue;
+
+      const FixedVectorType g = (x[i] - y[j]) * (2.0 * d1[j]);
+      const ScalarType *wj = w.row_ptr(j);
+      for (unsigned int k = 0; k < weightDim; k++)
+        Gi[k] += g * wj[k];
+    }
+
+    MatrixType gradKi(weightDim, PointDim);
+    for (unsigned int k = 0; k < weightDim; k++)
+      for (unsigned int l = 0; l < PointDim; l++)
+        gradKi(k, l) = Gi[k][l];
+    gradK.push_back(gradKi);
+  }
+
+  return gradK;
+}
+
+template<class ScalarType, unsigned int PointDim, class RadialFunctionType>
+MatrixType
+RadialKernel<ScalarType, PointDim, RadialFunctionType>
+::ConvolveGradient(const MatrixType &X, const MatrixType &alpha) {
+  DEF_PROFILE_SCOPE_SIZE("RadialKernel::ConvolveGradient", X.rows() * this->GetSources().rows());
+  MatrixType &Y = this->GetSources();
+  MatrixType &W = this->GetWeights();
+
+  if (Y.rows() != W.rows())
+    throw std::runtime_error("Sources and weights count mismatch");
+
+  const unsigned int weightDim = W.columns();
+
+  const std::vector<FixedVectorType> x = X.get_fixed_rows<PointDim>();
+  const std::vector<FixedVectorType> y = Y.get_fixed_rows<PointDim>();
+  const RowMajorMatrix<ScalarType> w = W.row_major();
+  const RowMajorMatrix<ScalarType> a = alpha.row_major();
+
+  std::vector<ScalarType> u(Y.rows()), d1(Y.rows());
+
+  MatrixType result(X.rows(), PointDim, 0);
+  for (unsigned int i = 0; i < X.rows(); i++) {
+    for (unsigned int j = 0; j < Y.rows(); j++)
+      u[j] = (x[i] - y[j]).squared_magnitude();
+    m_Function.DiffBatch(u.data(), d1.data(), Y.rows());
+
+    const ScalarType *ai = a.row_ptr(i);
+    FixedVectorType ri;
+    for (unsigned int j = 0; j < Y.rows(); j++) {
+      if (m_Function.IsOutOfSupport(u[j])) continue;
+
+      const ScalarType *wj = w.row_ptr(j);
+      ScalarType Wj_alphai = 0.0;
+      for (unsigned int k = 0; k < weightDim; k++)
+        Wj_alphai += wj[k] * ai[k];
+      ri += (x[i] - y[j]) * (2.0 * d1[j] * Wj_alphai);
+    }
+    result.set_row(i, ri);
+  }
+
+  return result;
+}
+
+template<class ScalarType, unsigned int PointDim, class RadialFunctionType>
+VectorType
+RadialKernel<ScalarType, PointDim, RadialFunctionType>
+::ConvolveGradient(const MatrixType &X, unsigned int k, unsigned int dp) {
+  MatrixType &Y = this->GetSources();
+  MatrixType &W = this->GetWeights();
+
+  if (Y.rows() != W.rows())
+    throw std::runtime_error("Sources and weights count mismatch");
+  if (k >= W.columns())
+    throw std::runtime_error("Invalid weight index");
+  if (dp >= PointDim)
+    throw std::runtime_error("Invalid derivative direction");
+
+  /// As in ExactKernel, X holds one point per source.
+  const unsigned int numPoints = Y.rows();
+
+  const std::vector<FixedVectorType> y = Y.get_fixed_rows<PointDim>();
+  const VectorType wk = W.get_column(k);
+
+  std::vector<ScalarType> u(numPoints), d1(numPoints);
+
+  VectorType gradK(numPoints, 0);
+  for (unsigned int i = 0; i < numPoints; i++) {
+    const FixedVectorType xi = X.get_fixed_row<PointDim>(i);
+    for (unsigned int j = 0; j < numPoints; j++)
+      u[j] = (xi - y[j]).squared_magnitude();
+    m_Function.DiffBatch(u.data(), d1.data(), numPoints);
+
+    ScalarType gi = 0.0;
+    for (unsigned int j = 0; j < numPoints; j++) {
+      if (m_Function.IsOutOfSupport(u[j])) continue;
+      gi += wk[j] * 2.0 * d1[j] * (xi[dp] - y[j][dp]);
+    }
+    gradK[i] = gi;
+  }
+
+  return gradK;
+}
+
+template<class ScalarType, unsigned int PointDim, class RadialFunctionType>
+MatrixType
+RadialKernel<ScalarType, PointDim, RadialFunctionType>
+::ConvolveGradient(const MatrixType &X, unsigned int dim) {
+  MatrixType &Y = this->GetSources();
+  MatrixType &W = this->GetWeights();
+
+  if (Y.rows() != W.rows())
+    throw std::runtime_error("Sources and weights count mismatch");
+  if (dim >= PointDim)
+    throw std::runtime_error("dimension index out of bounds");
+
+  const unsigned int weightDim = W.columns();
+
+  const std::vector<FixedVectorType> x = X.get_fixed_rows<PointDim>();
+  const std::vector<FixedVectorType> y = Y.get_fixed_rows<PointDim>();
+  const RowMajorMatrix<ScalarType> w = W.row_major();
+
+  std::vector<ScalarType> u(Y.rows()), d1(Y.rows());
+
+  MatrixType gradK(X.rows(), weightDim, 0.0);
+  std::vector<ScalarType> Gi(weightDim);
+  for (unsigned int i = 0; i < X.rows(); i++) {
+    for (unsigned int j = 0; j < Y.rows(); j++)
+      u[j] = (x[i] - y[j]).squared_magnitude();
+    m_Function.DiffBatch(u.data(), d1.data(), Y.rows());
+
+    std::fill(Gi.begin(), Gi.end(), 0.0);
+    for (unsigned int j = 0; j < Y.rows(); j++) {
+      if (m_Function.IsOutOfSupport(u[j])) continue;
+
+      const ScalarType gd = 2.0 * d1[j] * (x[i][dim] - y[j][dim]);
+      const ScalarType *wj = w.row_ptr(j);
+      for (unsigned int k = 0; k < weightDim; k++)
+        Gi[k] += gd * wj[k];
+    }
+    for (unsigned int k = 0; k < weightDim; k++)
+      gradK(i, k) = Gi[k];
+  }
+
+  return gradK;
+}
+
+template<class ScalarType, unsigned int PointDim, class RadialFunctionType>
+std::vector<std::vector<MatrixType> >
+RadialKernel<ScalarType, PointDim, RadialFunctionType>
+::ConvolveHessian(const MatrixType &X) {
+  DEF_PROFILE_SCOPE_SIZE("RadialKernel::ConvolveHessian", X.rows() * this->GetSources().rows());
+  MatrixType &Y = this->GetSources();
+  MatrixType &W = this->GetWeights();
+
+  if (Y.rows() != W.rows())
+    throw std::runtime_error("Sources and weights count mismatch");
+
+  const unsigned int weightDim = W.columns();
+
+  const std::vector<FixedVectorType> x = X.get_fixed_rows<PointDim>();
+  const std::vector<FixedVectorType> y = Y.get_fixed_rows<PointDim>();
+  const RowMajorMatrix<ScalarType> w = W.row_major();
+
+  std::vector<std::vector<MatrixType> > hessK;
+  hessK.reserve(X.rows());
+
+  std::vector<ScalarType> u(Y.rows()), d1(Y.rows()), d2(Y.rows());
+
+  std::vector<FixedMatrixType> Hi(weightDim);
+  for (unsigned int i = 0; i < X.rows(); i++) {
+    for (unsigned int j = 0; j < Y.rows(); j++)
+      u[j] = (x[i] - y[j]).squared_magnitude();
+    m_Function.DiffDiff2Batch(u.data(), d1.data(), d2.data(), Y.rows());
+
+    for (unsigned int k = 0; k < weightDim; k++)
+      Hi[k].fill(0.0);
+
+    for (unsigned int j = 0; j < Y.rows(); j++) {
+      if (m_Function.IsOutOfSupport(u[j])) continue;
+
+      const FixedVectorType x_minus_y = x[i] - y[j];
+      FixedMatrixType H = outer_product(x_minus_y, x_minus_y);
+      H *= 4.0 * d2[j];
+      for (unsigned int p = 0; p < PointDim; p++)
+        H(p, p) += 2.0 * d1[j];
+
+      const ScalarType *wj = w.row_ptr(j);
+      for (unsigned int k = 0; k < weightDim; k++)
+        Hi[k] += H * wj[k];
+    }
+
+    std::vector<MatrixType> hessKi;
+    hessKi.reserve(weightDim);
+    for (unsigned int k = 0; k < weightDim; k++)
+      hessKi.push_back(this->ToMatrix(Hi[k]));
+    hessK.push_back(hessKi);
+  }
+
+  return hessK;
+}
+
+template<class ScalarType, unsigned int PointDim, class RadialFunctionType>
+VectorType
+RadialKernel<ScalarType, PointDim, RadialFunctionType>
+::ConvolveHessian(const MatrixType &X, unsigned int k, unsigned int dp, unsigned int dq) {
+  MatrixType &Y = this->GetSources();
+  MatrixType &W = this->GetWeights();
+
+  if (Y.rows() != W.rows())
+    throw std::runtime_error("Sources and weights count mismatch");
+  if (k >= W.columns())
+    throw std::runtime_error("Invalid weight index");
+  if (dp >= PointDim || dq >= PointDim)
+    throw std::runtime_error("Invalid derivative direction");
+
+  const unsigned int numPoints = X.rows();
+
+  const std::vector<FixedVectorType> y = Y.get_fixed_rows<PointDim>();
+  const VectorType wk = W.get_column(k);
+
+  std::vector<ScalarType> u(Y.rows()), d1(Y.rows()), d2(Y.rows());
+
+  VectorType hessK(numPoints, 0);
+  for (unsigned int i = 0; i < numPoints; i++) {
+    const FixedVectorType xi = X.get_fixed_row<PointDim>(i);
+    for (unsigned int j = 0; j < Y.rows(); j++)
+      u[j] = (xi - y[j]).squared_magnitude();
+    m_Function.DiffDiff2Batch(u.data(), d1.data(), d2.data(), Y.rows());
+
+    ScalarType hi = 0.0;
+    for (unsigned int j = 0; j < Y.rows(); j++) {
+      if (m_Function.IsOutOfSupport(u[j])) continue;
+
+      const FixedVectorType x_minus_y = xi - y[j];
+      hi += wk[j] * (4.0 * d2[j] * x_minus_y[dp] * x_minus_y[dq] + (dp == dq ? 2.0 * d1[j] : 0.0));
+    }
+    hessK[i] = hi;
+  }
+
+  return hessK;
+}
+
+template<class ScalarType, unsigned int PointDim, class RadialFunctionType>
+MatrixType
+RadialKernel<ScalarType, PointDim, RadialFunctionType>
+::ConvolveHessian(const MatrixType &X, unsigned int row, unsigned int col) {
+  MatrixType &Y = this->GetSources();
+  MatrixType &W = this->GetWeights();
+
+  if (Y.rows() != W.rows())
+    throw std::runtime_error("Sources and weights count mismatch");
+  if (row >= PointDim || col >= PointDim)
+    throw std::runtime_error("Dimension index out of bounds");
+
+  const unsigned int weightDim = W.columns();
+
+  const std::vector<FixedVectorType> x = X.get_fixed_rows<PointDim>();
+  const std::vector<FixedVectorType> y = Y.get_fixed_rows<PointDim>();
+  const RowMajorMatrix<ScalarType> w = W.row_major();
+
+  std::vector<ScalarType> u(Y.rows()), d1(Y.rows()), d2(Y.rows());
+
+  MatrixType hessK(X.rows(), weightDim, 0.0);
+  std::vector<ScalarType> Hi(weightDim);
+  for (unsigned int i = 0; i < X.rows(); i++) {
+    for (unsigned int j = 0; j < Y.rows(); j++)
+      u[j] = (x[i] - y[j]).squared_magnitude();
+    m_Function.DiffDiff2Batch(u.data(), d1.data(), d2.data(), Y.rows());
+
+    std::fill(Hi.begin(), Hi.end(), 0.0);
+    for (unsigned int j = 0; j < Y.rows(); j++) {
+      if (m_Function.IsOutOfSupport(u[j])) continue;
+
+      const FixedVectorType x_minus_y = x[i] - y[j];
+      const ScalarType Hrc = 4.0 * d2[j] * x_minus_y[row] * x_minus_y[col] + (row == col ? 2.0 * d1[j] : 0.0);
+      const ScalarType *wj = w.row_ptr(j);
+      for (unsigned int k = 0; k < weightDim; k++)
+        Hi[k] += Hrc * wj[k];
+    }
+    for (unsigned int k = 0; k < weightDim; k++)
+      hessK(i, k) = Hi[k];
+  }
+
+  return hessK;
+}
+
+template class RadialKernel<double, 2, GaussianFunction<double>>;
+template class RadialKernel<double, 3, GaussianFunction<double>>;
+template class RadialKernel<double, 2, CauchyFunction<double>>;
+template class RadialKernel<double, 3, CauchyFunction<double>>;
+template class RadialKernel<double, 2, WendlandFunction<double>>;
+template class RadialKernel<double, 3, WendlandFunction<double>>;
@@ -0,0 +1,178 @@
+/***************************************************************************************
+*                                                                                      *
+*                                     Deformetrica                                     *
+*                                                                                      *
+*    Copyright Inria and the University of Utah.  All rights reserved. This file is    *
+*    distributed under the terms of the Inria Non-Commercial License Agreement.        *
+*                                                                                      *
+*                                                                                      *
+****************************************************************************************/
+
+#pragma once
+
+#include "ExactKernel.h"
+#include "RadialFunctions.h"
+
+/**
+ *	\brief      An exact kernel with a compiled radial profile.
+ *
+ *	\copyright  Inria and the University of Utah
+ *	\version    Deformetrica 2.0
+ *
+ *	\details    The RadialKernel class inherited from ExactKernel computes the convolutions exactly, for the kernel
+ *	            \f$ K(x,y) = f(|x-y|^2) \f$ whose profile \e f is given by the template parameter
+ *	            \e RadialFunctionType (see RadialFunctions.h). The loops over the pairs of points call the profile
+ *	            directly instead of the virtual EvaluateKernel*() methods, so that it is inlined and the loops can be
+ *	            vectorized. RadialKernel<ScalarType, PointDim, GaussianFunction<ScalarType>> computes the same
+ *	            values as ExactKernel.
+ */
+template<class ScalarType, unsigned int PointDim, class RadialFunctionType>
+class RadialKernel : public ExactKernel<ScalarType, PointDim> {
+ public:
+
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+  // typedef :
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+
+  /// Exact kernel type.
+  typedef ExactKernel<ScalarType, PointDim> Superclass;
+  /// Fixed-size vector type, for the points and the kernel gradients.
+  typedef typename Superclass::FixedVectorType FixedVectorType;
+  /// Fixed-size matrix type, for the kernel hessians.
+  typedef typename Superclass::FixedMatrixType FixedMatrixType;
+
+
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Constructor(s) / Destructor :
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+
+  RadialKernel() : Superclass() { m_Function.SetKernelWidth(this->GetKernelWidth()); }
+  /// Copy constructor.
+  RadialKernel(const RadialKernel &o) : Superclass(o) { m_Function.SetKernelWidth(this->GetKernelWidth()); }
+  /// See AbstractKernel::AbstractKernel(const MatrixType& X, double h).
+  RadialKernel(const MatrixType &X, double h) : Superclass(X, h) { m_Function.SetKernelWidth(this->GetKernelWidth()); }
+  /// See AbstractKernel::AbstractKernel(const MatrixType& X, const MatrixType& W, double h).
+  RadialKernel(const MatrixType &X, const MatrixType &W, double h) : Superclass(X, W, h) {
+    m_Function.SetKernelWidth(this->GetKernelWidth());
+  }
+
+  virtual RadialKernel *Clone() const { return new RadialKernel(*this); }
+
+  virtual ~RadialKernel() {}
+
+
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Encapsulation method(s) :
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+
+  virtual void SetKernelWidth(double h) {
+    Superclass::SetKernelWidth(h);
+    m_Function.SetKernelWidth(this->GetKernelWidth());
+  }
+
+
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Other method(s) :
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+
+  virtual ScalarType EvaluateKernel(const VectorType &x, const VectorType &y) {
+    return m_Function.Eval((x - y).squared_magnitude());
+  }
+
+  /// Evaluates \f$ K(x_{row_x},y_{row_y}) \f$.
+  virtual ScalarType EvaluateKernel(const MatrixType &X, const MatrixType &Y, size_t row_x, size_t row_y) {
+    return EvaluateKernel(X.get_fixed_row<PointDim>(row_x), Y.get_fixed_row<PointDim>(row_y));
+  }
+
+  virtual VectorType EvaluateKernelGradient(const VectorType &x, const VectorType &y) {
+    return (x - y) * (2.0 * m_Function.Diff((x - y).squared_magnitude()));
+  }
+
+  /// Evaluates the gradient of \f$ K(x_{row_x},y_{row_y}) \f$ at \e \f$ x_{row_x} \f$.
+  virtual VectorType EvaluateKernelGradient(const MatrixType &X, const MatrixType &Y, size_t row_x, size_t row_y) {
+    const FixedVectorType g = EvaluateKernelGradient(X.get_fixed_row<PointDim>(row_x),
+                                                     Y.get_fixed_row<PointDim>(row_y));
+    VectorType result(PointDim);
+    for (unsigned int d = 0; d < PointDim; d++)
+      result(d) = g[d];
+    return result;
+  }
+
+  // Hessian of kernel(x-y) at x
+  virtual MatrixType EvaluateKernelHessian(const VectorType &x, const VectorType &y) {
+    FixedVectorType fx, fy;
+    for (unsigned int d = 0; d < PointDim; d++) {
+      fx[d] = x[d];
+      fy[d] = y[d];
+    }
+    return ToMatrix(EvaluateKernelHessian(fx, fy));
+  }
+
+  /// Evaluates the hessian of \f$ K(x_{row_x},y_{row_y}) \f$ at \e \f$ x_{row_x} \f$.
+  virtual MatrixType EvaluateKernelHessian(const MatrixType &X, const MatrixType &Y, size_t row_x, size_t row_y) {
+    return ToMatrix(EvaluateKernelHessian(X.get_fixed_row<PointDim>(row_x), Y.get_fixed_row<PointDim>(row_y)));
+  }
+
+  /// Evaluates \f$ K(x,y) \f$, for fixed-size points (no heap allocation).
+  virtual ScalarType EvaluateKernel(const FixedVectorType &x, const FixedVectorType &y) {
+    return m_Function.Eval((x - y).squared_magnitude());
+  }
+
+  /// Evaluates the gradient of \f$ K(x,y) \f$ at \e x, for fixed-size points (no heap allocation).
+  virtual FixedVectorType EvaluateKernelGradient(const FixedVectorType &x, const FixedVectorType &y) {
+    const FixedVectorType x_minus_y = x - y;
+    return x_minus_y * (2.0 * m_Function.Diff(x_minus_y.squared_magnitude()));
+  }
+
+  /// Evaluates the hessian of \f$ K(x,y) \f$ at \e x, for fixed-size points (no heap allocation).
+  virtual FixedMatrixType EvaluateKernelHessian(const FixedVectorType &x, const FixedVectorType &y) {
+    const FixedVectorType x_minus_y = x - y;
+    ScalarType d1, d2;
+    m_Function.DiffDiff2(x_minus_y.squared_magnitude(), d1, d2);
+
+    FixedMatrixType H = outer_product(x_minus_y, x_minus_y);
+    H *= 4.0 * d2;
+    for (unsigned int i = 0; i < PointDim; i++)
+      H(i, i) += 2.0 * d1;
+
+    return H;
+  }
+
+  virtual MatrixType Convolve(const MatrixType &X);
+
+  virtual std::vector<MatrixType> ConvolveGradient(const MatrixType &X);
+  virtual MatrixType ConvolveGradient(const MatrixType &X, const MatrixType &alpha);
+  virtual VectorType ConvolveGradient(const MatrixType &X, unsigned int k, unsigned int dp);
+  virtual MatrixType ConvolveGradient(const MatrixType &X, unsigned int dim);
+
+  virtual std::vector<std::vector<MatrixType> > ConvolveHessian(const MatrixType &X);
+  virtual VectorType ConvolveHessian(const MatrixType &X, unsigned int k, unsigned int dp, unsigned int dq);
+  virtual MatrixType ConvolveHessian(const MatrixType &X, unsigned int row, unsigned int col);
+
+ protected:
+
+  /// Copies a fixed-size hessian into a matrix.
+  static MatrixType ToMatrix(const FixedMatrixType &H) {
+    MatrixType result(PointDim, PointDim);
+    for (unsigned int p = 0; p < PointDim; p++)
+      for (unsigned int q = 0; q < PointDim; q++)
+        result(p, q) = H(p, q);
+    return result;
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Attribute(s)
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+
+  /// Radial profile of the kernel, set up from the kernel width.
+  RadialFunctionType m_Function;
+
+}; /* class RadialKernel */
+
+/// Exact kernels with the Gaussian, Cauchy and Wendland profiles.
+template<class ScalarType, unsigned int PointDim>
+using GaussianKernel = RadialKernel<ScalarType, PointDim, GaussianFunction<ScalarType>>;
+template<class ScalarType, unsigned int PointDim>
+using CauchyKernel = RadialKernel<ScalarType, PointDim, CauchyFunction<ScalarType>>;
+template<class ScalarType, unsigned int PointDim>
+using WendlandKernel = RadialKernel<ScalarType, PointDim, WendlandFunction<ScalarType>>;
@@ -10,6 +10,7 @@
 
 /// Support files.
 #include "ArmadilloMatrixWrapper.h"
+#include <stdexcept>
 
 #ifndef DEFORMETRICA_CONFIG
 #include "DeformetricaConfig.h"
@@ -109,6 +110,26 @@ template<class ScalarType>
 ArmadilloMatrixWrapper<ScalarType> chol(ArmadilloMatrixWrapper<ScalarType> const &M) {
   return ArmadilloMatrixWrapper<ScalarType>(arma::chol(M.toArmadillo()));
 }
+template<class ScalarType>
+bool chol(ArmadilloMatrixWrapper<ScalarType> &R, ArmadilloMatrixWrapper<ScalarType> const &M) {
+  return arma::chol(R.get_aramadillo_mat(), M.toArmadillo());
+}
+template<class ScalarType>
+ArmadilloMatrixWrapper<ScalarType> chol_regularized(ArmadilloMatrixWrapper<ScalarType> const &M) {
+  ArmadilloMatrixWrapper<ScalarType> R;
+  if (chol(R, M)) return R;
+
+  /// The jitter is relative to the mean diagonal, and grows tenfold from 1e-10 to 1e-4 of it.
+  ScalarType scale = (M.rows() > 0) ? arma::mean(M.toArmadillo().diag()) : ScalarType(1);
+  if (!(scale > 0)) scale = 1;
+  for (ScalarType jitter = 1e-10 * scale; jitter < 2e-4 * scale; jitter *= 10) {
+    arma::Mat<ScalarType> jittered = M.toArmadillo();
+    jittered.diag() += jitter;
+    if (arma::chol(R.get_aramadillo_mat(), jittered)) return R;
+  }
+
+  throw std::runtime_error("The Cholesky factorization failed, even with a diagonal jitter");
+}
 
 template<class ScalarType>
 ArmadilloMatrixWrapper<ScalarType> inverse(ArmadilloMatrixWrapper<ScalarType> const &M) {
@@ -155,6 +176,27 @@ ArmadilloMatrixWrapper<ScalarType> solve(ArmadilloMatrixWrapper<ScalarType> cons
   return ArmadilloMatrixWrapper<ScalarType>(arma::solve(A.toArmadillo(), B.toArmadillo()));
 }
 
+template<class ScalarType>
+ArmadilloVectorWrapper<ScalarType> solve_cholesky(ArmadilloMatrixWrapper<ScalarType> const &R,
+                                                  ArmadilloVectorWrapper<ScalarType> const &b) {
+  const arma::Col<ScalarType> y = arma::solve(arma::trimatl(R.toArmadillo().t()), b.toArmadillo());
+  return ArmadilloVectorWrapper<ScalarType>(arma::Col<ScalarType>(arma::solve(arma::trimatu(R.toArmadillo()), y)));
+}
+
+template<class ScalarType>
+ArmadilloMatrixWrapper<ScalarType> solve_cholesky(ArmadilloMatrixWrapper<ScalarType> const &R,
+                                                  ArmadilloMatrixWrapper<ScalarType> const &B) {
+  const arma::Mat<ScalarType> Y = arma::solve(arma::trimatl(R.toArmadillo().t()), B.toArmadillo());
+  return ArmadilloMatrixWrapper<ScalarType>(arma::Mat<ScalarType>(arma::solve(arma::trimatu(R.toArmadillo()), Y)));
+}
+
+template<class ScalarType>
+ArmadilloMatrixWrapper<ScalarType> solve_upper_triangular(ArmadilloMatrixWrapper<ScalarType> const &R,
+                                                          ArmadilloMatrixWrapper<ScalarType> const &B) {
+  return ArmadilloMatrixWrapper<ScalarType>(arma::Mat<ScalarType>(arma::solve(arma::trimatu(R.toArmadillo()),
+                                                                              B.toArmadillo())));
+}
+
 /// Determinant of the input matrix \e M.
 template<class ScalarType>
 inline ScalarType det(ArmadilloMatrixWrapper<ScalarType> const &M) { return arma::det(M.toArmadillo()); }
@@ -183,10 +225,15 @@ template ArmadilloMatrixWrapper<double> operator/(ScalarPrecisionType const &lef
 template double trace<double>(ArmadilloMatrixWrapper<double> const &M);
 template ArmadilloVectorWrapper<double> solve<double>(ArmadilloMatrixWrapper<double> const &A, ArmadilloVectorWrapper<double> const &b);
 template ArmadilloMatrixWrapper<double> solve<double>(ArmadilloMatrixWrapper<double> const &A, ArmadilloMatrixWrapper<double> const &B);
+template ArmadilloVectorWrapper<double> solve_cholesky<double>(ArmadilloMatrixWrapper<double> const &R, ArmadilloVectorWrapper<double> const &b);
+template ArmadilloMatrixWrapper<double> solve_cholesky<double>(ArmadilloMatrixWrapper<double> const &R, ArmadilloMatrixWrapper<double> const &B);
+template ArmadilloMatrixWrapper<double> solve_upper_triangular<double>(ArmadilloMatrixWrapper<double> const &R, ArmadilloMatrixWrapper<double> const &B);
 template ArmadilloMatrixWrapper<double> diagonal_matrix<double>(unsigned N, double const &value);
 template ArmadilloMatrixWrapper<double> diagonal_matrix<double>(unsigned N, ScalarPrecisionType const &value);
 template ArmadilloMatrixWrapper<double> diagonal_matrix<double>(ArmadilloVectorWrapper<double> const &values);
 template ArmadilloMatrixWrapper<double> chol<double>(ArmadilloMatrixWrapper<double> const &M);
+template bool chol<double>(ArmadilloMatrixWrapper<double> &R, ArmadilloMatrixWrapper<double> const &M);
+template ArmadilloMatrixWrapper<double> chol_regularized<double>(ArmadilloMatrixWrapper<double> const &M);
 template ArmadilloMatrixWrapper<double> inverse<double>(ArmadilloMatrixWrapper<double> const &M);
 template ArmadilloMatrixWrapper<double> inverse_sympd<double>(ArmadilloMatrixWrapper<double> const &M);
 template ArmadilloVectorWrapper<double> eigenvalues_sym<double>(ArmadilloMatrixWrapper<double> const &M);
@@ -13,6 +13,8 @@
 
 /// Support files.
 #include "ArmadilloVectorWrapper.h"
+#include "FixedSizeAlgebra.h"
+#include "RowMajorMatrix.h"
 
 /// Libraries files.
 #include "assert.h"
@@ -118,6 +120,10 @@ class ArmadilloMatrixWrapper : public Tolerance<ArmadilloMatrixWrapper<ScalarTyp
   /// Copy constructor.
   ArmadilloMatrixWrapper(const ArmadilloMatrixWrapper<ScalarType> &other) : m_Matrix(other.m_Matrix) {}
 
+  /// Constructor from a matrix stored row by row (see row_major()).
+  explicit ArmadilloMatrixWrapper(const RowMajorMatrixView<ScalarType> &v)
+      : m_Matrix(ArmadilloMatrixType(const_cast<ScalarType *>(v.memptr()), v.cols(), v.rows(), false, true).t()) {}
+
   /// Special constructor (do not use it in Deformetrica!).
   ArmadilloMatrixWrapper(const ArmadilloMatrixType &M) : m_Matrix(M) {}
 
@@ -146,15 +152,17 @@ class ArmadilloMatrixWrapper : public Tolerance<ArmadilloMatrixWrapper<ScalarTyp
 
   /// Returns the number of elements (This equals to rows() * cols()).
   unsigned n_elem() const { return m_Matrix.n_elem; }
-/*
-  ScalarType       * memory_pointer_col_wise() const {  ArmadilloVectorType result = arma::vectorise(m_Matrix, 0); return result.memptr(); }
 
-	/// Access the contiguous block storing the elements in the matrix row-wise.
-	ScalarType      * memory_pointer_row_wise() {  ArmadilloVectorRowType result = arma::vectorise(m_Matrix, 1); return result.memptr(); }
+  /// Returns a copy of the matrix stored row by row (e.g. points with interleaved coordinates).
+  /// \warning The matrix itself is stored column by column : there is no row-wise pointer on its memory.
+  RowMajorMatrix<ScalarType> row_major() const {
+    RowMajorMatrix<ScalarType> out(m_Matrix.n_rows, m_Matrix.n_cols);
+    /// The row-major storage of the matrix is the column-major storage of its transpose, written in place.
+    ArmadilloMatrixType alias(out.memptr(), m_Matrix.n_cols, m_Matrix.n_rows, false, true);
+    alias = m_Matrix.t();
+    return out;
+  }
 
-	/// Access the contiguous block storing the elements in the matrix row-wise.
-	ScalarType const* memory_pointer_row_wise() const { ArmadilloVectorRowType result = arma::vectorise(m_Matrix, 1); return result.memptr(); }
-*/
   /// Resize to r rows by c columns. Old data lost.
   bool set_size(unsigned r, unsigned c) {
     m_Matrix.set_size(r, c);
@@ -222,6 +230,41 @@ class ArmadilloMatrixWrapper : public Tolerance<ArmadilloMatrixWrapper<ScalarTyp
     m_Matrix.row(i) += v.toArmadillo().t();
   }
 
+  /// Gets the \e r-th row as a fixed-size vector, on the stack (the matrix must have \e Dim columns).
+  template<unsigned int Dim>
+  FixedVector<ScalarType, Dim> get_fixed_row(unsigned r) const {
+    assert(m_Matrix.n_cols == Dim);
+    FixedVector<ScalarType, Dim> v;
+    for (unsigned int d = 0; d < Dim; ++d) v[d] = m_Matrix.at(r, d);
+    return v;
+  }
+
+  /// Gets all the rows as fixed-size vectors, stored contiguously (the matrix must have \e Dim columns).
+  template<unsigned int Dim>
+  std::vector<FixedVector<ScalarType, Dim>> get_fixed_rows() const {
+    assert(m_Matrix.n_cols == Dim);
+    std::vector<FixedVector<ScalarType, Dim>> rows(m_Matrix.n_rows);
+    for (unsigned int d = 0; d < Dim; ++d) {
+      const ScalarType *col = m_Matrix.colptr(d);
+      for (unsigned int r = 0; r < m_Matrix.n_rows; ++r) rows[r][d] = col[r];
+    }
+    return rows;
+  }
+
+  /// Sets the \e i-th row to the fixed-size vector \e v.
+  template<unsigned int Dim>
+  void set_row(unsigned i, FixedVector<ScalarType, Dim> const &v) {
+    assert(m_Matrix.n_cols == Dim);
+    for (unsigned int d = 0; d < Dim; ++d) m_Matrix.at(i, d) = v[d];
+  }
+
+  /// Adds the fixed-size vector \e v to the \e i-th row.
+  template<unsigned int Dim>
+  void increment_row(unsigned i, FixedVector<ScalarType, Dim> const &v) {
+    assert(m_Matrix.n_cols == Dim);
+    for (unsigned int d = 0; d < Dim; ++d) m_Matrix.at(i, d) += v[d];
+  }
+
   /// Multiplies each column d by \e v[d].
   void multiply_cols(ArmadilloVectorWrapper<ScalarType> const &v) {
     for (unsigned int d = 0; d < m_Matrix.n_cols; ++d) { m_Matrix.col(d) *= v[d]; }
@@ -349,8 +392,11 @@ class ArmadilloMatrixWrapper : public Tolerance<ArmadilloMatrixWrapper<ScalarTyp
   void save(Archive &ar, const unsigned int version) const {
     ScalarType *mem = (ScalarType *) m_Matrix.memptr();
 
-    ar & m_Matrix.n_rows;
-    ar & m_Matrix.n_cols;
+    /// Same integer type as in load(), as binary archives do not convert between types.
+    unsigned int rows = m_Matrix.n_rows;
+    unsigned int cols = m_Matrix.n_cols;
+    ar & rows;
+    ar & cols;
     ar & boost::serialization::make_binary_object(mem, m_Matrix.n_rows * m_Matrix.n_cols * sizeof(ScalarType));
   }
 
@@ -429,6 +475,17 @@ ScalarType trace(ArmadilloMatrixWrapper<ScalarType> const &M);
 template<class ScalarType>
 ArmadilloMatrixWrapper<ScalarType> chol(ArmadilloMatrixWrapper<ScalarType> const &M);
 
+/// Computes the upper Cholesky factor \e R of the symmetric matrix \e M. Returns false, instead of throwing,
+/// if \e M is not numerically positive definite.
+template<class ScalarType>
+bool chol(ArmadilloMatrixWrapper<ScalarType> &R, ArmadilloMatrixWrapper<ScalarType> const &M);
+
+/// Upper Cholesky factor of the symmetric positive semi-definite matrix \e M (e.g. a kernel matrix). If \e M is
+/// numerically singular, a growing jitter is added to its diagonal until the factorization succeeds.
+/// \warning Throws std::runtime_error if it still fails with a jitter of 1e-4 times the mean diagonal.
+template<class ScalarType>
+ArmadilloMatrixWrapper<ScalarType> chol_regularized(ArmadilloMatrixWrapper<ScalarType> const &M);
+
 template<class ScalarType>
 ArmadilloMatrixWrapper<ScalarType> inverse(ArmadilloMatrixWrapper<ScalarType> const &M);
 
@@ -459,6 +516,19 @@ template<class ScalarType>
 ArmadilloMatrixWrapper<ScalarType> solve(ArmadilloMatrixWrapper<ScalarType> const &A,
                                          ArmadilloMatrixWrapper<ScalarType> const &B);
 
+/// Solves (R^T * R) * x = b, given the upper Cholesky factor \e R (see chol), with two triangular solves.
+template<class ScalarType>
+ArmadilloVectorWrapper<ScalarType> solve_cholesky(ArmadilloMatrixWrapper<ScalarType> const &R,
+                                                  ArmadilloVectorWrapper<ScalarType> const &b);
+/// Solves (R^T * R) * X = B, given the upper Cholesky factor \e R (see chol), with two triangular solves.
+template<class ScalarType>
+ArmadilloMatrixWrapper<ScalarType> solve_cholesky(ArmadilloMatrixWrapper<ScalarType> const &R,
+                                                  ArmadilloMatrixWrapper<ScalarType> const &B);
+/// Solves R * X = B, given the upper triangular matrix \e R (e.g. a Cholesky factor), by back-substitution.
+template<class ScalarType>
+ArmadilloMatrixWrapper<ScalarType> solve_upper_triangular(ArmadilloMatrixWrapper<ScalarType> const &R,
+                                                          ArmadilloMatrixWrapper<ScalarType> const &B);
+
 /// Determinant of the input matrix \e M.
 template<class ScalarType>
 ScalarType det(ArmadilloMatrixWrapper<ScalarType> const &M);
@@ -316,7 +316,9 @@ class ArmadilloVectorWrapper : public Tolerance<ArmadilloVectorWrapper<ScalarTyp
   void save(Archive &ar, const unsigned int version) const {
     ScalarType *mem = (ScalarType *) m_Vector.memptr();
 
-    ar & m_Vector.n_rows;
+    /// Same integer type as in load(), as binary archives do not convert between types.
+    unsigned int rows = m_Vector.n_rows;
+    ar & rows;
     ar & boost::serialization::make_binary_object(mem, m_Vector.n_rows * sizeof(ScalarType));
   }
 
@@ -0,0 +1,209 @@
+/***************************************************************************************
+ *                                                                                      *
+ *                                     Deformetrica                                     *
+ *                                                                                      *
+ *    Copyright Inria and the University of Utah.  All rights reserved. This file is    *
+ *    distributed under the terms of the Inria Non-Commercial License Agreement.        *
+ *                                                                                      *
+ *                                                                                      *
+ ****************************************************************************************/
+
+#ifndef _FixedSizeAlgebra_h
+#define _FixedSizeAlgebra_h
+
+/**
+ *  \brief      Fixed-size mathematical vector class.
+ *
+ *  \copyright  Inria and the University of Utah
+ *  \version    Deformetrica 2.0
+ *
+ *  \details    The FixedVector class stores \e Dim elements on the stack. It is meant for the points, tangents and
+ *              kernel gradients of the inner loops (\e Dim being the dimension of the ambient space), where an
+ *              ArmadilloVectorWrapper would cost one heap allocation per temporary. All operations are inlined.
+ */
+template<class ScalarType, unsigned int Dim>
+class FixedVector {
+ public:
+
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Constructor(s) :
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+
+  /// Default constructor, with all elements equal to zero.
+  FixedVector() : m_Data() {}
+
+  /// Constructor with all elements equal to \e v0.
+  explicit FixedVector(ScalarType const &v0) { fill(v0); }
+
+
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Methods :
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+
+  /// Returns the number of elements.
+  static constexpr unsigned int size() { return Dim; }
+
+  /// Sets all elements to \e v.
+  void fill(ScalarType const &v) { for (unsigned int d = 0; d < Dim; ++d) m_Data[d] = v; }
+
+  /// Returns the squared euclidean norm.
+  ScalarType squared_magnitude() const {
+    ScalarType result = 0;
+    for (unsigned int d = 0; d < Dim; ++d) result += m_Data[d] * m_Data[d];
+    return result;
+  }
+
+  ScalarType *memptr() { return m_Data; }
+  ScalarType const *memptr() const { return m_Data; }
+
+  ScalarType &operator[](unsigned int d) { return m_Data[d]; }
+  ScalarType const &operator[](unsigned int d) const { return m_Data[d]; }
+  ScalarType &operator()(unsigned int d) { return m_Data[d]; }
+  ScalarType const &operator()(unsigned int d) const { return m_Data[d]; }
+
+
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Arithmetic operations :
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+
+  FixedVector &operator+=(FixedVector const &v) {
+    for (unsigned int d = 0; d < Dim; ++d) m_Data[d] += v.m_Data[d];
+    return *this;
+  }
+  FixedVector &operator-=(FixedVector const &v) {
+    for (unsigned int d = 0; d < Dim; ++d) m_Data[d] -= v.m_Data[d];
+    return *this;
+  }
+  FixedVector &operator*=(ScalarType const &s) {
+    for (unsigned int d = 0; d < Dim; ++d) m_Data[d] *= s;
+    return *this;
+  }
+  FixedVector &operator/=(ScalarType const &s) {
+    for (unsigned int d = 0; d < Dim; ++d) m_Data[d] /= s;
+    return *this;
+  }
+
+  FixedVector operator+(FixedVector const &v) const { return FixedVector(*this) += v; }
+  FixedVector operator-(FixedVector const &v) const { return FixedVector(*this) -= v; }
+  FixedVector operator*(ScalarType const &s) const { return FixedVector(*this) *= s; }
+  FixedVector operator/(ScalarType const &s) const { return FixedVector(*this) /= s; }
+  FixedVector operator-() const { return FixedVector(*this) *= -1; }
+
+ private:
+
+  ScalarType m_Data[Dim];
+
+};
+
+
+/**
+ *  \brief      Fixed-size mathematical matrix class.
+ *
+ *  \details    The FixedMatrix class stores \e Rows x \e Cols elements on the stack, in row-major order. It is meant
+ *              for the kernel hessians and jacobians of the inner loops.
+ */
+template<class ScalarType, unsigned int Rows, unsigned int Cols>
+class FixedMatrix {
+ public:
+
+  /// Default constructor, with all elements equal to zero.
+  FixedMatrix() : m_Data() {}
+
+  /// Constructor with all elements equal to \e v0.
+  explicit FixedMatrix(ScalarType const &v0) { fill(v0); }
+
+  static constexpr unsigned int rows() { return Rows; }
+  static constexpr unsigned int cols() { return Cols; }
+
+  /// Sets all elements to \e v.
+  void fill(ScalarType const &v) { for (unsigned int k = 0; k < Rows * Cols; ++k) m_Data[k] = v; }
+
+  ScalarType &operator()(unsigned int i, unsigned int j) { return m_Data[i * Cols + j]; }
+  ScalarType const &operator()(unsigned int i, unsigned int j) const { return m_Data[i * Cols + j]; }
+
+  FixedMatrix &operator+=(FixedMatrix const &M) {
+    for (unsigned int k = 0; k < Rows * Cols; ++k) m_Data[k] += M.m_Data[k];
+    return *this;
+  }
+  FixedMatrix &operator*=(ScalarType const &s) {
+    for (unsigned int k = 0; k < Rows * Cols; ++k) m_Data[k] *= s;
+    return *this;
+  }
+
+  FixedMatrix operator+(FixedMatrix const &M) const { return FixedMatrix(*this) += M; }
+  FixedMatrix operator*(ScalarType const &s) const { return FixedMatrix(*this) *= s; }
+
+  /// Returns the product with the vector \e v.
+  FixedVector<ScalarType, Rows> operator*(FixedVector<ScalarType, Cols> const &v) const {
+    FixedVector<ScalarType, Rows> result;
+    for (unsigned int i = 0; i < Rows; ++i)
+      for (unsigned int j = 0; j < Cols; ++j)
+        result[i] += m_Data[i * Cols + j] * v[j];
+    return result;
+  }
+
+  /// Returns the transposed matrix.
+  FixedMatrix<ScalarType, Cols, Rows> transpose() const {
+    FixedMatrix<ScalarType, Cols, Rows> result;
+    for (unsigned int i = 0; i < Rows; ++i)
+      for (unsigned int j = 0; j < Cols; ++j)
+        result(j, i) = m_Data[i * Cols + j];
+    return result;
+  }
+
+ private:
+
+  ScalarType m_Data[Rows * Cols];
+
+};
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Useful non-member operators and functions :
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+template<class ScalarType, unsigned int Dim>
+inline FixedVector<ScalarType, Dim> operator*(ScalarType const &s, FixedVector<ScalarType, Dim> const &v) {
+  return v * s;
+}
+
+template<class ScalarType, unsigned int Rows, unsigned int Cols>
+inline FixedMatrix<ScalarType, Rows, Cols> operator*(ScalarType const &s,
+                                                     FixedMatrix<ScalarType, Rows, Cols> const &M) {
+  return M * s;
+}
+
+template<class ScalarType, unsigned int Dim>
+inline ScalarType dot_product(FixedVector<ScalarType, Dim> const &v1, FixedVector<ScalarType, Dim> const &v2) {
+  ScalarType result = 0;
+  for (unsigned int d = 0; d < Dim; ++d) result += v1[d] * v2[d];
+  return result;
+}
+
+/// Returns the cross product of two vectors of the 3D space. Only defined for vectors of size 3 : a call on other
+/// sizes does not compile.
+template<class ScalarType>
+inline FixedVector<ScalarType, 3> cross_3d(FixedVector<ScalarType, 3> const &v1,
+                                           FixedVector<ScalarType, 3> const &v2) {
+  FixedVector<ScalarType, 3> result;
+  ScalarType const *a = v1.memptr(), *b = v2.memptr();
+  ScalarType *c = result.memptr();
+  c[0] = a[1] * b[2] - a[2] * b[1];
+  c[1] = a[2] * b[0] - a[0] * b[2];
+  c[2] = a[0] * b[1] - a[1] * b[0];
+  return result;
+}
+
+/// Returns the matrix v1 * v2^T.
+template<class ScalarType, unsigned int Rows, unsigned int Cols>
+inline FixedMatrix<ScalarType, Rows, Cols> outer_product(FixedVector<ScalarType, Rows> const &v1,
+                                                         FixedVector<ScalarType, Cols> const &v2) {
+  FixedMatrix<ScalarType, Rows, Cols> result;
+  for (unsigned int i = 0; i < Rows; ++i)
+    for (unsigned int j = 0; j < Cols; ++j)
+      result(i, j) = v1[i] * v2[j];
+  return result;
+}
+
+
+#endif /* _FixedSizeAlgebra_h */
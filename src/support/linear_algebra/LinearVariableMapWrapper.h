@@ -204,12 +204,20 @@ class LinearVariableMapWrapper : public Tolerance<LinearVariableMapWrapper<Scala
   /// Clears the map, removing all elements.
   void clear() { m_RawLinearVariableMap.clear(); }
 
-  /// Vectorizes the linear variable map.
+  /// Returns the number of scalar elements of the linear variable map.
+  unsigned int n_elem() const {
+    unsigned int n = 0;
+    for (auto it = m_RawLinearVariableMap.begin(); it != m_RawLinearVariableMap.end(); ++it)
+      n += it->second.n_elem();
+    return n;
+  }
+
+  /// Vectorizes the linear variable map, in a single allocation.
   VectorType vectorize() const {
-    VectorType out;
-    for (auto it = m_RawLinearVariableMap.begin(); it != m_RawLinearVariableMap.end(); ++it) {
-      out.push_back(it->second.vectorize());
-    }
+    VectorType out(n_elem());
+    ScalarType *ptr = out.memptr();
+    for (auto it = m_RawLinearVariableMap.begin(); it != m_RawLinearVariableMap.end(); ++it)
+      ptr += it->second.vectorize_into(ptr);
     return out;
   }
 
@@ -242,6 +250,21 @@ class LinearVariableMapWrapper : public Tolerance<LinearVariableMapWrapper<Scala
     return result;
   }
 
+  /// Adds \e alpha times \e x to the linear variable map in situ, without allocating any temporary.
+  LinearVariableMapWrapper<ScalarType> &axpy(ScalarType const &alpha, LinearVariableMapWrapper<ScalarType> const &x) {
+    for (iterator it = m_RawLinearVariableMap.begin(); it != m_RawLinearVariableMap.end(); ++it)
+      it->second.axpy(alpha, x.m_RawLinearVariableMap.at(it->first));
+    return *this;
+  }
+  /// Adds \e alpha(k) times the k-th entry of \e x to the k-th entry of the linear variable map in situ.
+  LinearVariableMapWrapper<ScalarType> &axpy(VectorType const &alpha, LinearVariableMapWrapper<ScalarType> const &x) {
+    assert(size() == alpha.size());
+    unsigned int k = 0;
+    for (iterator it = m_RawLinearVariableMap.begin(); it != m_RawLinearVariableMap.end(); ++it, ++k)
+      it->second.axpy(alpha(k), x.m_RawLinearVariableMap.at(it->first));
+    return *this;
+  }
+
   /// Returns the mean squares.
   VectorType mean_squares() const {
     sum_of_squares_visitor<ScalarType> ss_visitor;
@@ -327,6 +327,84 @@ class insitu_subtraction_visitor : public boost::static_visitor<> {
 }; /* class insitu_subtraction_visitor */
 
 
+template<class ScalarType>
+class insitu_axpy_visitor : public boost::static_visitor<> {
+ public:
+
+  typedef ArmadilloVectorWrapper<ScalarType> VectorType;
+  typedef ArmadilloMatrixWrapper<ScalarType> MatrixType;
+  typedef MatrixListWrapper<ScalarType> MatrixListType;
+
+  /// Constructor.
+  insitu_axpy_visitor(ScalarType const &alpha) : m_Alpha(alpha) {}
+
+  /// Adds \e alpha times \e right to \e left, without any temporary.
+  void operator()(ScalarType &left, ScalarType const &right) const { left += m_Alpha * right; }
+  void operator()(VectorType &left, VectorType const &right) const {
+    left.toArmadillo() += m_Alpha * right.toArmadillo();
+  }
+  void operator()(MatrixType &left, MatrixType const &right) const {
+    left.get_aramadillo_mat() += m_Alpha * right.toArmadillo();
+  }
+  void operator()(MatrixListType &left, MatrixListType const &right) const {
+    for (unsigned int k = 0; k < left.size(); ++k)
+      operator()(left[k], right[k]);
+  }
+
+  template<typename VariantType1, typename VariantType2>
+  void operator()(VariantType1 &, const VariantType2 &) const {
+    std::cerr << "Exception: attempt to add in situ incompatible data structures during the manipulation"
+        " of boost::variant<ScalarType, VectorType, MatrixType, MatrixListType> type." << std::endl;
+  }
+
+ private:
+  ScalarType m_Alpha;
+
+}; /* class insitu_axpy_visitor */
+
+
+template<class ScalarType>
+class vectorize_into_visitor : public boost::static_visitor<unsigned int> {
+ public:
+
+  typedef ArmadilloVectorWrapper<ScalarType> VectorType;
+  typedef ArmadilloMatrixWrapper<ScalarType> MatrixType;
+  typedef MatrixListWrapper<ScalarType> MatrixListType;
+
+  /// Constructor.
+  vectorize_into_visitor(ScalarType *out) : m_Out(out) {}
+
+  /// Writes the elements at \e m_Out in the order of vectorize_visitor (row by row for the matrices), and returns
+  /// their number.
+  unsigned int operator()(ScalarType const &var) const {
+    m_Out[0] = var;
+    return 1;
+  }
+  unsigned int operator()(VectorType const &var) const {
+    const ScalarType *in = var.memptr();
+    for (unsigned int i = 0; i < var.size(); ++i) m_Out[i] = in[i];
+    return var.size();
+  }
+  unsigned int operator()(MatrixType const &var) const {
+    const unsigned int rows = var.rows(), cols = var.cols();
+    for (unsigned int i = 0; i < rows; ++i)
+      for (unsigned int j = 0; j < cols; ++j)
+        m_Out[i * cols + j] = var(i, j);
+    return rows * cols;
+  }
+  unsigned int operator()(MatrixListType const &var) const {
+    unsigned int offset = 0;
+    for (unsigned int k = 0; k < var.size(); ++k)
+      offset += vectorize_into_visitor(m_Out + offset)(var[k]);
+    return offset;
+  }
+
+ private:
+  ScalarType *m_Out;
+
+}; /* class vectorize_into_visitor */
+
+
 template<class ScalarType>
 class unary_minus_visitor : public boost::static_visitor<boost::variant<ScalarType,
                                                                         ArmadilloVectorWrapper<ScalarType>,
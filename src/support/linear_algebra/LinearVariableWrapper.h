@@ -243,6 +243,19 @@ class LinearVariableWrapper : public Tolerance<LinearVariableWrapper<ScalarType>
     boost::apply_visitor(visitor)(m_RawLinearVariable);
   }
 
+  /// Writes the vectorized linear variable (see vectorize()) at \e out, and returns the number of written elements.
+  unsigned int vectorize_into(ScalarType *out) const {
+    vectorize_into_visitor<ScalarType> visitor(out);
+    return boost::apply_visitor(visitor)(m_RawLinearVariable);
+  }
+
+  /// Adds \e alpha times \e x to the linear variable in situ, without allocating any temporary.
+  LinearVariableWrapper<ScalarType> &axpy(ScalarType const &alpha, LinearVariableWrapper<ScalarType> const &x) {
+    insitu_axpy_visitor<ScalarType> visitor(alpha);
+    boost::apply_visitor(visitor, m_RawLinearVariable, x.m_RawLinearVariable);
+    return *this;
+  }
+
   /// Returns an iterator on the first scalar element of the linear variable.
   iterator begin() {
     iterator_begin_visitor<ScalarType> visitor;
@@ -229,6 +229,21 @@ class LinearVariablesMapWrapper : public Tolerance<LinearVariablesMapWrapper<Sca
     return result;
   }
 
+  /// Adds \e alpha times \e x to the linear variables map in situ, without allocating any temporary.
+  LinearVariablesMapWrapper<ScalarType> &axpy(ScalarType const &alpha, LinearVariablesMapWrapper<ScalarType> const &x) {
+    for (auto it = m_RawLinearVariablesMap.begin(); it != m_RawLinearVariablesMap.end(); ++it)
+      it->second.axpy(alpha, x.m_RawLinearVariablesMap.at(it->first));
+    return *this;
+  }
+  /// Adds \e alpha(k) times the k-th entry of \e x to the k-th entry of the linear variables map in situ.
+  LinearVariablesMapWrapper<ScalarType> &axpy(VectorType const &alpha, LinearVariablesMapWrapper<ScalarType> const &x) {
+    assert(size() == alpha.size());
+    unsigned int k = 0;
+    for (auto it = m_RawLinearVariablesMap.begin(); it != m_RawLinearVariablesMap.end(); ++it, ++k)
+      it->second.axpy(alpha(k), x.m_RawLinearVariablesMap.at(it->first));
+    return *this;
+  }
+
   ////////////////////////////////////////////////////////////////////////////////////////////////////
   // Operator overloading :
   ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -152,6 +152,14 @@ class LinearVariablesWrapper : public Tolerance<LinearVariablesWrapper<ScalarTyp
     return result / length;
   }
 
+  /// Adds \e alpha times \e x to the linear variables in situ, without allocating any temporary.
+  inline LinearVariablesWrapper<ScalarType> &axpy(ScalarType const &alpha,
+                                                  LinearVariablesWrapper<ScalarType> const &x) {
+    for (unsigned long k = 0; k < m_RawLinearVariables.size(); ++k)
+      m_RawLinearVariables[k].axpy(alpha, x.m_RawLinearVariables[k]);
+    return *this;
+  }
+
 
   ////////////////////////////////////////////////////////////////////////////////////////////////////
   // Operator overloading :
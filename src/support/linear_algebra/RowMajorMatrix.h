@@ -0,0 +1,101 @@
+/***************************************************************************************
+ *                                                                                      *
+ *                                     Deformetrica                                     *
+ *                                                                                      *
+ *    Copyright Inria and the University of Utah.  All rights reserved. This file is    *
+ *    distributed under the terms of the Inria Non-Commercial License Agreement.        *
+ *                                                                                      *
+ *                                                                                      *
+ ****************************************************************************************/
+
+#ifndef _RowMajorMatrix_h
+#define _RowMajorMatrix_h
+
+#include <cstddef>
+#include <vector>
+
+
+/**
+ *  \brief      Read-only row-major matrix view.
+ *
+ *  \copyright  Inria and the University of Utah
+ *  \version    Deformetrica 2.0
+ *
+ *  \details    The RowMajorMatrixView class gives access to a block of memory storing a matrix row by row, e.g. a set
+ *              of points with interleaved coordinates (x0 y0 z0 x1 y1 z1 ...) as expected by the CUDA kernels and
+ *              VTK. It does not own the memory : it is obtained from a RowMajorMatrix, or wraps a buffer owned
+ *              by a third-party library, and must not outlive it.
+ */
+template<class ScalarType>
+class RowMajorMatrixView {
+ public:
+
+  RowMajorMatrixView(ScalarType const *data, unsigned rows, unsigned cols)
+      : m_Data(data), m_Rows(rows), m_Cols(cols) {}
+
+  unsigned rows() const { return m_Rows; }
+  unsigned cols() const { return m_Cols; }
+
+  /// Returns the contiguous block storing the elements row by row.
+  ScalarType const *memptr() const { return m_Data; }
+  /// Returns a pointer on the first element of the \e i-th row, followed by the other elements of the row.
+  ScalarType const *row_ptr(unsigned i) const { return m_Data + std::size_t(i) * m_Cols; }
+
+  ScalarType const &operator()(unsigned i, unsigned j) const { return m_Data[std::size_t(i) * m_Cols + j]; }
+
+ private:
+
+  ScalarType const *m_Data;
+  unsigned m_Rows;
+  unsigned m_Cols;
+
+};
+
+
+/**
+ *  \brief      Row-major matrix.
+ *
+ *  \details    The RowMajorMatrix class owns a matrix stored row by row (point-interleaved storage). The matrices of
+ *              Deformetrica are column-major (see ArmadilloMatrixWrapper) : the conversions are explicit, through
+ *              ArmadilloMatrixWrapper::row_major() and the ArmadilloMatrixWrapper constructor from a view, and cost
+ *              one transposition each. They are meant for the boundaries with libraries which need interleaved
+ *              coordinates, instead of the copies and transpositions hand-written at each call.
+ */
+template<class ScalarType>
+class RowMajorMatrix {
+ public:
+
+  RowMajorMatrix() : m_Rows(0), m_Cols(0) {}
+
+  /// Matrix of size \e rows by \e cols, with all elements equal to \e v0.
+  RowMajorMatrix(unsigned rows, unsigned cols, ScalarType const &v0 = 0)
+      : m_Data(std::size_t(rows) * cols, v0), m_Rows(rows), m_Cols(cols) {}
+
+  unsigned rows() const { return m_Rows; }
+  unsigned cols() const { return m_Cols; }
+
+  /// Returns the contiguous block storing the elements row by row.
+  ScalarType *memptr() { return m_Data.data(); }
+  ScalarType const *memptr() const { return m_Data.data(); }
+
+  /// Returns a pointer on the first element of the \e i-th row, followed by the other elements of the row.
+  ScalarType *row_ptr(unsigned i) { return m_Data.data() + std::size_t(i) * m_Cols; }
+  ScalarType const *row_ptr(unsigned i) const { return m_Data.data() + std::size_t(i) * m_Cols; }
+
+  ScalarType &operator()(unsigned i, unsigned j) { return m_Data[std::size_t(i) * m_Cols + j]; }
+  ScalarType const &operator()(unsigned i, unsigned j) const { return m_Data[std::size_t(i) * m_Cols + j]; }
+
+  /// Returns a view on the matrix, valid as long as the matrix is neither destroyed nor resized.
+  RowMajorMatrixView<ScalarType> view() const { return RowMajorMatrixView<ScalarType>(memptr(), m_Rows, m_Cols); }
+  operator RowMajorMatrixView<ScalarType>() const { return view(); }
+
+ private:
+
+  std::vector<ScalarType> m_Data;
+  unsigned m_Rows;
+  unsigned m_Cols;
+
+};
+
+
+#endif /* _RowMajorMatrix_h */
@@ -0,0 +1,349 @@
+/***************************************************************************************
+*                                                                                      *
+*                                     Deformetrica                                     *
+*                                                                                      *
+*    Copyright Inria and the University of Utah.  All rights reserved. This file is    *
+*    distributed under the terms of the Inria Non-Commercial License Agreement.        *
+*                                                                                      *
+*                                                                                      *
+****************************************************************************************/
+
+#include "CovarianceOperators.h"
+
+#include "KernelFactory.h"
+#include "RandomNumberGenerator.h"
+
+#include <cmath>
+
+namespace {
+
+/// Log-determinant of R^T * R, for an upper triangular R.
+template<class ScalarType>
+ScalarType CholeskyLogDeterminant(MatrixType const &R) {
+  ScalarType out = 0.0;
+  for (unsigned int i = 0; i < R.rows(); ++i)
+    out += 2.0 * std::log(R(i, i));
+  return out;
+}
+
+
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// AbstractCovarianceOperator :
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+template<class ScalarType>
+template<class ProductType>
+MatrixType
+AbstractCovarianceOperator<ScalarType>
+::Densify(ProductType const &product) const {
+  const unsigned int n = GetSize();
+  MatrixType out(n, n, 0.0);
+  for (unsigned int j = 0; j < n; ++j) {
+    VectorType e(n, 0.0);
+    e(j) = 1.0;
+    out.set_column(j, product(e));
+  }
+  return out;
+}
+
+template<class ScalarType>
+MatrixType
+AbstractCovarianceOperator<ScalarType>
+::GetCovariance() const {
+  std::call_once(m_CovarianceOnce, [this]() {
+    m_DenseCovariance = Densify([this](VectorType const &v) { return Multiply(v); });
+  });
+  return m_DenseCovariance;
+}
+
+template<class ScalarType>
+MatrixType
+AbstractCovarianceOperator<ScalarType>
+::GetCovarianceSqrt() const {
+  std::call_once(m_CovarianceSqrtOnce, [this]() { m_DenseCovarianceSqrt = chol(GetCovariance()).transpose(); });
+  return m_DenseCovarianceSqrt;
+}
+
+template<class ScalarType>
+MatrixType
+AbstractCovarianceOperator<ScalarType>
+::GetCovarianceInverse() const {
+  std::call_once(m_CovarianceInverseOnce, [this]() {
+    m_DenseCovarianceInverse = Densify([this](VectorType const &v) { return MultiplyInverse(v); });
+  });
+  return m_DenseCovarianceInverse;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// DenseCovarianceOperator :
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+template<class ScalarType>
+std::shared_ptr<DenseCovarianceOperator<ScalarType>>
+DenseCovarianceOperator<ScalarType>
+::FromCovariance(MatrixType const &cov) {
+  return std::shared_ptr<DenseCovarianceOperator>(
+      new DenseCovarianceOperator(cov, chol(cov).transpose(), inverse_sympd(cov)));
+}
+
+template<class ScalarType>
+std::shared_ptr<DenseCovarianceOperator<ScalarType>>
+DenseCovarianceOperator<ScalarType>
+::FromCovarianceSqrt(MatrixType const &covSqrt) {
+  const MatrixType cov = covSqrt * covSqrt.transpose();
+  return std::shared_ptr<DenseCovarianceOperator>(new DenseCovarianceOperator(cov, covSqrt, inverse_sympd(cov)));
+}
+
+template<class ScalarType>
+std::shared_ptr<DenseCovarianceOperator<ScalarType>>
+DenseCovarianceOperator<ScalarType>
+::FromCovarianceInverse(MatrixType const &covInv) {
+  const MatrixType cov = inverse_sympd(covInv);
+  return std::shared_ptr<DenseCovarianceOperator>(new DenseCovarianceOperator(cov, chol(cov).transpose(), covInv));
+}
+
+template<class ScalarType>
+VectorType
+DenseCovarianceOperator<ScalarType>
+::SampleCentered() const {
+  return m_CovarianceSqrt * RandomNumberGenerator::instance()->NormalVector(GetSize());
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// DiagonalCovarianceOperator :
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+template<class ScalarType>
+DiagonalCovarianceOperator<ScalarType>
+::DiagonalCovarianceOperator(VectorType const &variances) : m_Variances(variances), m_LogDeterminant(0.0) {
+  for (unsigned int i = 0; i < m_Variances.size(); ++i)
+    m_LogDeterminant += std::log(m_Variances(i));
+}
+
+template<class ScalarType>
+VectorType
+DiagonalCovarianceOperator<ScalarType>
+::Multiply(VectorType const &v) const {
+  VectorType out = v;
+  for (unsigned int i = 0; i < out.size(); ++i) out(i) *= m_Variances(i);
+  return out;
+}
+
+template<class ScalarType>
+VectorType
+DiagonalCovarianceOperator<ScalarType>
+::MultiplyInverse(VectorType const &v) const {
+  VectorType out = v;
+  for (unsigned int i = 0; i < out.size(); ++i) out(i) /= m_Variances(i);
+  return out;
+}
+
+template<class ScalarType>
+VectorType
+DiagonalCovarianceOperator<ScalarType>
+::SampleCentered() const {
+  VectorType out = RandomNumberGenerator::instance()->NormalVector(GetSize());
+  for (unsigned int i = 0; i < out.size(); ++i) out(i) *= std::sqrt(m_Variances(i));
+  return out;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// LowRankPlusDiagonalCovarianceOperator :
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+template<class ScalarType>
+LowRankPlusDiagonalCovarianceOperator<ScalarType>
+::LowRankPlusDiagonalCovarianceOperator(VectorType const &variances, MatrixType const &factor)
+    : m_Variances(variances), m_Factor(factor), m_LogDeterminant(0.0) {
+  const unsigned int n = m_Variances.size();
+  const unsigned int r = m_Factor.cols();
+  if (m_Factor.rows() != n)
+    throw std::runtime_error("Low-rank factor and diagonal size mismatch in LowRankPlusDiagonalCovarianceOperator");
+
+  for (unsigned int i = 0; i < n; ++i)
+    m_LogDeterminant += std::log(m_Variances(i));
+  if (!r) return;
+
+  MatrixType scaledFactor = m_Factor;
+  for (unsigned int i = 0; i < n; ++i)
+    for (unsigned int k = 0; k < r; ++k)
+      scaledFactor(i, k) /= m_Variances(i);
+
+  const MatrixType capacitance = diagonal_matrix<ScalarType>(r, 1.0) + m_Factor.transpose() * scaledFactor;
+  m_CapacitanceInverse = inverse_sympd(capacitance);
+  m_LogDeterminant += log_det(capacitance);
+}
+
+template<class ScalarType>
+VectorType
+LowRankPlusDiagonalCovarianceOperator<ScalarType>
+::Multiply(VectorType const &v) const {
+  VectorType out = v;
+  for (unsigned int i = 0; i < out.size(); ++i) out(i) *= m_Variances(i);
+  if (m_Factor.cols()) out += m_Factor * (m_Factor.transpose() * v);
+  return out;
+}
+
+template<class ScalarType>
+VectorType
+LowRankPlusDiagonalCovarianceOperator<ScalarType>
+::MultiplyInverse(VectorType const &v) const {
+  /// Woodbury identity : (D + U U^T)^-1 = D^-1 - D^-1 U (I + U^T D^-1 U)^-1 U^T D^-1.
+  VectorType out = v;
+  for (unsigned int i = 0; i < out.size(); ++i) out(i) /= m_Variances(i);
+  if (m_Factor.cols()) {
+    VectorType correction = m_Factor * (m_CapacitanceInverse * (m_Factor.transpose() * out));
+    for (unsigned int i = 0; i < out.size(); ++i) out(i) -= correction(i) / m_Variances(i);
+  }
+  return out;
+}
+
+template<class ScalarType>
+VectorType
+LowRankPlusDiagonalCovarianceOperator<ScalarType>
+::SampleCentered() const {
+  RandomNumberGenerator *rng = RandomNumberGenerator::instance();
+  VectorType out = rng->NormalVector(GetSize());
+  for (unsigned int i = 0; i < out.size(); ++i) out(i) *= std::sqrt(m_Variances(i));
+  if (m_Factor.cols()) out += m_Factor * rng->NormalVector(m_Factor.cols());
+  return out;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// KroneckerCovarianceOperator :
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+template<class ScalarType>
+KroneckerCovarianceOperator<ScalarType>
+::KroneckerCovarianceOperator(MatrixType const &rowCovariance, MatrixType const &columnCovariance)
+    : m_RowCovariance(rowCovariance), m_ColumnCovariance(columnCovariance) {
+  m_RowCholesky = chol(m_RowCovariance);
+  m_ColumnCholesky = chol(m_ColumnCovariance);
+  m_LogDeterminant = m_ColumnCovariance.rows() * CholeskyLogDeterminant<ScalarType>(m_RowCholesky)
+      + m_RowCovariance.rows() * CholeskyLogDeterminant<ScalarType>(m_ColumnCholesky);
+}
+
+template<class ScalarType>
+VectorType
+KroneckerCovarianceOperator<ScalarType>
+::Multiply(VectorType const &v) const {
+  /// (A (x) B) vec(V) = vec(A V B^T) for the row-wise vectorization.
+  const MatrixType V = v.unvectorize(m_RowCovariance.rows(), m_ColumnCovariance.rows());
+  return (m_RowCovariance * V * m_ColumnCovariance.transpose()).vectorize();
+}
+
+template<class ScalarType>
+VectorType
+KroneckerCovarianceOperator<ScalarType>
+::MultiplyInverse(VectorType const &v) const {
+  const MatrixType V = v.unvectorize(m_RowCovariance.rows(), m_ColumnCovariance.rows());
+  const MatrixType aux = solve_cholesky(m_RowCholesky, V);
+  return solve_cholesky(m_ColumnCholesky, aux.transpose()).transpose().vectorize();
+}
+
+template<class ScalarType>
+VectorType
+KroneckerCovarianceOperator<ScalarType>
+::SampleCentered() const {
+  const unsigned int n = m_RowCovariance.rows(), m = m_ColumnCovariance.rows();
+  const MatrixType Z = RandomNumberGenerator::instance()->NormalVector(n * m).unvectorize(n, m);
+  return (m_RowCholesky.transpose() * Z * m_ColumnCholesky).vectorize();
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// KernelCovarianceOperator :
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+template<class ScalarType, unsigned int Dimension>
+KernelCovarianceOperator<ScalarType, Dimension>
+::KernelCovarianceOperator(KernelEnumType kernelType, ScalarType kernelWidth,
+                           MatrixType const &points, unsigned int numberOfComponents)
+    : m_KernelType(kernelType), m_KernelWidth(kernelWidth), m_Points(points),
+      m_NumberOfComponents(numberOfComponents) {}
+
+template<class ScalarType, unsigned int Dimension>
+VectorType
+KernelCovarianceOperator<ScalarType, Dimension>
+::MultiplyInverse(VectorType const &v) const {
+  typedef KernelFactory<ScalarType, Dimension> KernelFactoryType;
+  typedef typename KernelFactoryType::KernelBaseType KernelType;
+
+  std::shared_ptr<KernelType> kernel = KernelFactoryType::Instantiate()->CreateKernelObject(m_KernelType);
+  kernel->SetKernelWidth(m_KernelWidth);
+  kernel->SetSources(m_Points);
+  kernel->SetWeights(v.unvectorize(m_Points.rows(), m_NumberOfComponents));
+  return kernel->Convolve(m_Points).vectorize();
+}
+
+template<class ScalarType, unsigned int Dimension>
+VectorType
+KernelCovarianceOperator<ScalarType, Dimension>
+::Multiply(VectorType const &v) const {
+  const MatrixType V = v.unvectorize(m_Points.rows(), m_NumberOfComponents);
+  return solve_cholesky(GetKernelCholesky(), V).vectorize();
+}
+
+template<class ScalarType, unsigned int Dimension>
+ScalarType
+KernelCovarianceOperator<ScalarType, Dimension>
+::GetLogDeterminant() const {
+  return -1.0 * m_NumberOfComponents * CholeskyLogDeterminant<ScalarType>(GetKernelCholesky());
+}
+
+template<class ScalarType, unsigned int Dimension>
+VectorType
+KernelCovarianceOperator<ScalarType, Dimension>
+::SampleCentered() const {
+  /// With K = R^T R, the columns of R^-1 Z have the covariance K^-1.
+  const unsigned int n = m_Points.rows();
+  const MatrixType Z = RandomNumberGenerator::instance()->NormalVector(n * m_NumberOfComponents)
+      .unvectorize(n, m_NumberOfComponents);
+  return solve_upper_triangular(GetKernelCholesky(), Z).vectorize();
+}
+
+template<class ScalarType, unsigned int Dimension>
+MatrixType const &
+KernelCovarianceOperator<ScalarType, Dimension>
+::GetKernelCholesky() const {
+  std::call_once(m_CholeskyOnce, [this]() {
+    typedef KernelFactory<ScalarType, Dimension> KernelFactoryType;
+    typedef typename KernelFactoryType::KernelBaseType KernelType;
+
+    std::shared_ptr<KernelType> kernel = KernelFactoryType::Instantiate()->CreateKernelObject(m_KernelType);
+    kernel->SetKernelWidth(m_KernelWidth);
+
+    const unsigned int n = m_Points.rows();
+    MatrixType K(n, n, 0.0);
+    for (unsigned int i = 0; i < n; ++i) {
+      const VectorType Pi = m_Points.get_row(i);
+      for (unsigned int j = 0; j <= i; ++j) {
+        K(i, j) = kernel->EvaluateKernel(Pi, m_Points.get_row(j));
+        K(j, i) = K(i, j);
+      }
+    }
+    m_KernelCholesky = chol(K);
+  });
+  return m_KernelCholesky;
+}
+
+
+template class AbstractCovarianceOperator<double>;
+template class DenseCovarianceOperator<double>;
+template class DiagonalCovarianceOperator<double>;
+template class LowRankPlusDiagonalCovarianceOperator<double>;
+template class KroneckerCovarianceOperator<double>;
+template class KernelCovarianceOperator<double, 2>;
+template class KernelCovarianceOperator<double, 3>;
@@ -0,0 +1,265 @@
+/***************************************************************************************
+*                                                                                      *
+*                                     Deformetrica                                     *
+*                                                                                      *
+*    Copyright Inria and the University of Utah.  All rights reserved. This file is    *
+*    distributed under the terms of the Inria Non-Commercial License Agreement.        *
+*                                                                                      *
+*                                                                                      *
+****************************************************************************************/
+
+#ifndef _CovarianceOperators_h
+#define _CovarianceOperators_h
+
+#include <memory>
+#include <mutex>
+
+/// Support files.
+#include "LinearAlgebra.h"
+#include "KernelType.h"
+
+using namespace def::algebra;
+
+
+/**
+ *  \brief      Abstract covariance operator.
+ *
+ *  \copyright  Inria and the University of Utah
+ *  \version    Deformetrica 2.0
+ *
+ *  \details    The AbstractCovarianceOperator class describes the covariance matrix of a normal distribution by the
+ *              products, log-determinant and sampling it allows, so that structured covariances never have to be
+ *              stored as dense matrices. The dense matrices are only built on request, once, for the algorithms that
+ *              still need them. Operators are immutable once built, and may be shared between distributions.
+ */
+template<class ScalarType>
+class AbstractCovarianceOperator {
+ public:
+
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Constructor(s) / Destructor :
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+
+  AbstractCovarianceOperator() {}
+  virtual ~AbstractCovarianceOperator() {}
+
+  AbstractCovarianceOperator(const AbstractCovarianceOperator &) = delete;
+  AbstractCovarianceOperator &operator=(const AbstractCovarianceOperator &) = delete;
+
+
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Other method(s) :
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+
+  /// Returns the size of the covariance matrix.
+  virtual unsigned int GetSize() const = 0;
+
+  /// Returns the product of the covariance matrix with \e v.
+  virtual VectorType Multiply(VectorType const &v) const = 0;
+  /// Returns the product of the inverse of the covariance matrix with \e v.
+  virtual VectorType MultiplyInverse(VectorType const &v) const = 0;
+  /// Returns the log-determinant of the covariance matrix.
+  virtual ScalarType GetLogDeterminant() const = 0;
+  /// Draws from the centered normal distribution with this covariance.
+  virtual VectorType SampleCentered() const = 0;
+
+  /// Returns the dense covariance matrix.
+  virtual MatrixType GetCovariance() const;
+  /// Returns a dense square root S of the covariance matrix, i.e. such that S * S^T is the covariance matrix.
+  virtual MatrixType GetCovarianceSqrt() const;
+  /// Returns the dense inverse of the covariance matrix.
+  virtual MatrixType GetCovarianceInverse() const;
+
+
+ protected:
+
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Method(s) :
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+
+  /// Builds the dense matrix whose columns are the products of \e product with the canonical basis.
+  template<class ProductType>
+  MatrixType Densify(ProductType const &product) const;
+
+
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Attribute(s)
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+
+  /// Dense matrices, built on request.
+  mutable std::once_flag m_CovarianceOnce, m_CovarianceSqrtOnce, m_CovarianceInverseOnce;
+  mutable MatrixType m_DenseCovariance, m_DenseCovarianceSqrt, m_DenseCovarianceInverse;
+
+};
+
+
+/**
+ *  \brief      Dense covariance operator.
+ *
+ *  \details    Stores the covariance matrix, a square root and the inverse of it, as the normal distributions
+ *              always did. Used for the covariances without any structure, e.g. the estimated ones.
+ */
+template<class ScalarType>
+class DenseCovarianceOperator : public AbstractCovarianceOperator<ScalarType> {
+ public:
+
+  /// Builds the operator from the covariance matrix.
+  static std::shared_ptr<DenseCovarianceOperator> FromCovariance(MatrixType const &cov);
+  /// Builds the operator from a square root S of the covariance matrix, i.e. the covariance matrix is S * S^T.
+  static std::shared_ptr<DenseCovarianceOperator> FromCovarianceSqrt(MatrixType const &covSqrt);
+  /// Builds the operator from the inverse of the covariance matrix.
+  static std::shared_ptr<DenseCovarianceOperator> FromCovarianceInverse(MatrixType const &covInv);
+
+  virtual unsigned int GetSize() const { return m_Covariance.rows(); }
+
+  virtual VectorType Multiply(VectorType const &v) const { return m_Covariance * v; }
+  virtual VectorType MultiplyInverse(VectorType const &v) const { return m_CovarianceInverse * v; }
+  virtual ScalarType GetLogDeterminant() const { return m_LogDeterminant; }
+  virtual VectorType SampleCentered() const;
+
+  virtual MatrixType GetCovariance() const { return m_Covariance; }
+  virtual MatrixType GetCovarianceSqrt() const { return m_CovarianceSqrt; }
+  virtual MatrixType GetCovarianceInverse() const { return m_CovarianceInverse; }
+
+ protected:
+
+  DenseCovarianceOperator(MatrixType const &cov, MatrixType const &covSqrt, MatrixType const &covInv)
+      : m_Covariance(cov), m_CovarianceSqrt(covSqrt), m_CovarianceInverse(covInv), m_LogDeterminant(log_det(cov)) {}
+
+  MatrixType m_Covariance;
+  MatrixType m_CovarianceSqrt;
+  MatrixType m_CovarianceInverse;
+  ScalarType m_LogDeterminant;
+
+};
+
+
+/**
+ *  \brief      Diagonal covariance operator.
+ *
+ *  \details    Independent coordinates of given variances, e.g. the priors on the control point positions.
+ */
+template<class ScalarType>
+class DiagonalCovarianceOperator : public AbstractCovarianceOperator<ScalarType> {
+ public:
+
+  /// Builds the operator from the vector of the variances.
+  explicit DiagonalCovarianceOperator(VectorType const &variances);
+
+  virtual unsigned int GetSize() const { return m_Variances.size(); }
+
+  virtual VectorType Multiply(VectorType const &v) const;
+  virtual VectorType MultiplyInverse(VectorType const &v) const;
+  virtual ScalarType GetLogDeterminant() const { return m_LogDeterminant; }
+  virtual VectorType SampleCentered() const;
+
+ protected:
+
+  VectorType m_Variances;
+  ScalarType m_LogDeterminant;
+
+};
+
+
+/**
+ *  \brief      Low-rank plus diagonal covariance operator.
+ *
+ *  \details    Covariance D + U * U^T, with D diagonal and U of few columns (e.g. a few principal modes on top of
+ *              an isotropic noise). The inverse and the log-determinant follow from the Woodbury identity and the
+ *              matrix determinant lemma, for a cost linear in the size of the covariance.
+ */
+template<class ScalarType>
+class LowRankPlusDiagonalCovarianceOperator : public AbstractCovarianceOperator<ScalarType> {
+ public:
+
+  /// Builds the operator from the diagonal \e variances and the low-rank factor \e factor.
+  LowRankPlusDiagonalCovarianceOperator(VectorType const &variances, MatrixType const &factor);
+
+  virtual unsigned int GetSize() const { return m_Variances.size(); }
+
+  virtual VectorType Multiply(VectorType const &v) const;
+  virtual VectorType MultiplyInverse(VectorType const &v) const;
+  virtual ScalarType GetLogDeterminant() const { return m_LogDeterminant; }
+  virtual VectorType SampleCentered() const;
+
+ protected:
+
+  VectorType m_Variances;
+  MatrixType m_Factor;
+  /// Inverse of the capacitance matrix I + U^T * D^-1 * U.
+  MatrixType m_CapacitanceInverse;
+  ScalarType m_LogDeterminant;
+
+};
+
+
+/**
+ *  \brief      Kronecker product covariance operator.
+ *
+ *  \details    Covariance A (x) B, for vectors which are the row-wise vectorizations of n x m matrices (e.g. momenta),
+ *              A being of size n and B of size m. Only the two small factors and their Cholesky factors are stored.
+ */
+template<class ScalarType>
+class KroneckerCovarianceOperator : public AbstractCovarianceOperator<ScalarType> {
+ public:
+
+  KroneckerCovarianceOperator(MatrixType const &rowCovariance, MatrixType const &columnCovariance);
+
+  virtual unsigned int GetSize() const { return m_RowCovariance.rows() * m_ColumnCovariance.rows(); }
+
+  virtual VectorType Multiply(VectorType const &v) const;
+  virtual VectorType MultiplyInverse(VectorType const &v) const;
+  virtual ScalarType GetLogDeterminant() const { return m_LogDeterminant; }
+  virtual VectorType SampleCentered() const;
+
+ protected:
+
+  MatrixType m_RowCovariance, m_ColumnCovariance;
+  /// Upper Cholesky factors R of the two factors, i.e. such that R^T * R is the factor.
+  MatrixType m_RowCholesky, m_ColumnCholesky;
+  ScalarType m_LogDeterminant;
+
+};
+
+
+/**
+ *  \brief      Kernel-induced covariance operator.
+ *
+ *  \details    Covariance whose inverse is K (x) I, K being the kernel matrix of a set of points and I the identity
+ *              of size \e numberOfComponents : the usual prior on the momenta attached to control points (one
+ *              component per dimension), or on the weights of a parametric template (one component).
+ *              Products with the inverse go through the kernel convolution, which may be the fast P3M or CUDA one ;
+ *              the Cholesky factor of K, needed for the log-determinant and the sampling only, is computed once
+ *              on first use.
+ */
+template<class ScalarType, unsigned int Dimension>
+class KernelCovarianceOperator : public AbstractCovarianceOperator<ScalarType> {
+ public:
+
+  KernelCovarianceOperator(KernelEnumType kernelType, ScalarType kernelWidth,
+                           MatrixType const &points, unsigned int numberOfComponents);
+
+  virtual unsigned int GetSize() const { return m_Points.rows() * m_NumberOfComponents; }
+
+  virtual VectorType Multiply(VectorType const &v) const;
+  virtual VectorType MultiplyInverse(VectorType const &v) const;
+  virtual ScalarType GetLogDeterminant() const;
+  virtual VectorType SampleCentered() const;
+
+ protected:
+
+  /// Returns the upper Cholesky factor R of the kernel matrix, i.e. such that R^T * R is the kernel matrix.
+  MatrixType const &GetKernelCholesky() const;
+
+  KernelEnumType m_KernelType;
+  ScalarType m_KernelWidth;
+  MatrixType m_Points;
+  unsigned int m_NumberOfComponents;
+
+  mutable std::once_flag m_CholeskyOnce;
+  mutable MatrixType m_KernelCholesky;
+
+};
+
+
+#endif /* _CovarianceOperators_h */
@@ -43,12 +43,7 @@ template<class ScalarType>
 VectorType
 DisplacementFieldNormalDistribution<ScalarType>
 ::Sample() const {
-  /// Initialization of the random number generator.
-  std::random_device rd;
-  std::mt19937_64 generator(rd());
-  std::normal_distribution<ScalarType> stdNormal(0, 1);
-
-  /// Further initializations.
+  /// Initializations.
   const unsigned int numberOfShapePoints = Superclass::m_Mean.size() / m_ShapeDimension;
   const unsigned int numberOfShapeControlPoints = 1 + (numberOfShapePoints - 1) / m_SubsamplingStepSize;
   const MatrixType shapePoints = Superclass::m_Mean.unvectorize(numberOfShapePoints, m_ShapeDimension);
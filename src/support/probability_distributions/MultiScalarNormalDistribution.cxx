@@ -9,6 +9,7 @@
  ****************************************************************************************/
 
 #include "MultiScalarNormalDistribution.h"
+#include "RandomNumberGenerator.h"
 
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -46,16 +47,7 @@ template<class ScalarType>
 VectorType
 MultiScalarNormalDistribution<ScalarType>
 ::Sample() const {
-  std::random_device rd;
-  std::mt19937_64 generator(rd());
-  std::normal_distribution<ScalarType> stdNormal(0, 1);
-
-  const unsigned int N = Superclass::m_Mean.size();
-  VectorType aux(N);
-
-  for (unsigned int i = 0; i < N; ++i)
-    aux(i) = stdNormal(generator);
-
+  const VectorType aux = RandomNumberGenerator::instance()->NormalVector(Superclass::m_Mean.size());
   return Superclass::m_Mean + m_VarianceSqrt * aux;
 }
 
@@ -18,12 +18,7 @@
 template<class ScalarType>
 NormalDistribution<ScalarType>
 ::NormalDistribution() {
-  m_Covariance.set_size(1, 1);
-  m_Covariance(0, 0) = 1.0;
-  m_CovarianceSqrt.set_size(1, 1);
-  m_CovarianceSqrt(0, 0) = 1.0;
-  m_CovarianceInverse.set_size(1, 1);
-  m_CovarianceInverse(0, 0) = 1.0;
+  m_CovarianceOperator = DenseCovarianceOperatorType::FromCovariance(MatrixType(1, 1, 1.0));
 }
 
 template<class ScalarType>
@@ -33,9 +28,7 @@ NormalDistribution<ScalarType>
 template<class ScalarType>
 NormalDistribution<ScalarType>
 ::NormalDistribution(const NormalDistribution &other) : Superclass(other) {
-  m_Covariance = other.m_Covariance;
-  m_CovarianceSqrt = other.m_CovarianceSqrt;
-  m_CovarianceInverse = other.m_CovarianceInverse;
+  m_CovarianceOperator = other.m_CovarianceOperator;
 }
 
 
@@ -47,17 +40,7 @@ template<class ScalarType>
 VectorType
 NormalDistribution<ScalarType>
 ::Sample() const {
-  std::random_device rd;
-  std::mt19937_64 generator(rd());
-  std::normal_distribution<ScalarType> stdNormal(0, 1);
-
-  const unsigned int N = Superclass::m_Mean.size();
-  VectorType aux(N);
-
-  for (int i = 0; i < N; i++)
-    aux(i) = stdNormal(generator);
-
-  return Superclass::m_Mean + m_CovarianceSqrt * aux;
+  return Superclass::m_Mean + m_CovarianceOperator->SampleCentered();
 }
 
 template<class ScalarType>
@@ -65,8 +48,9 @@ ScalarType
 NormalDistribution<ScalarType>
 ::ComputeLogLikelihood(VectorType const &obs,
                        ScalarType const &temperature) const {
-  return -0.5 * dot_product(obs - Superclass::m_Mean, (m_CovarianceInverse / temperature) * (obs - Superclass::m_Mean))
-      - 0.5 * (m_CovarianceLogDeterminant + Superclass::m_Mean.size() * std::log(temperature));
+  const VectorType residual = obs - Superclass::m_Mean;
+  return -0.5 * dot_product(residual, m_CovarianceOperator->MultiplyInverse(residual)) / temperature
+      - 0.5 * (m_CovarianceOperator->GetLogDeterminant() + Superclass::m_Mean.size() * std::log(temperature));
 }
 
 template class NormalDistribution<double>;
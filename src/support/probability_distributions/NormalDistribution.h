@@ -14,6 +14,9 @@
 /// Class file.
 #include "AbstractNormalDistribution.h"
 
+/// Support files.
+#include "CovarianceOperators.h"
+
 /**
  *  \brief      NormalDistribution class
  *
@@ -33,6 +36,11 @@ class NormalDistribution : public AbstractNormalDistribution<ScalarType> {
   /// Abstract probability distribution type.
   typedef AbstractNormalDistribution<ScalarType> Superclass;
 
+  /// Covariance operator type.
+  typedef AbstractCovarianceOperator<ScalarType> CovarianceOperatorType;
+  /// Dense covariance operator type.
+  typedef DenseCovarianceOperator<ScalarType> DenseCovarianceOperatorType;
+
 
   ////////////////////////////////////////////////////////////////////////////////////////////////////
   // Constructor(s) / Destructor :
@@ -56,35 +64,34 @@ class NormalDistribution : public AbstractNormalDistribution<ScalarType> {
   ////////////////////////////////////////////////////////////////////////////////////////////////////
 
   /// Returns the covariance matrix of the normal distribution.
-  virtual MatrixType GetCovariance() const { return m_Covariance; }
+  virtual MatrixType GetCovariance() const { return m_CovarianceOperator->GetCovariance(); }
   /// Sets the covariance matrix of the normal distribution.
   virtual void SetCovariance(MatrixType const &cov) {
-    m_Covariance = cov;
-    m_CovarianceSqrt = chol(cov);
-    m_CovarianceInverse = inverse_sympd(cov);
-    m_CovarianceLogDeterminant = log_det(cov);
+    m_CovarianceOperator = DenseCovarianceOperatorType::FromCovariance(cov);
   }
 
-  /// Returns the cholesky squared root of the covariance matrix.
-  virtual MatrixType GetCovarianceSqrt() const { return m_CovarianceSqrt; }
-  /// Sets the cholesky squared root of the covariance matrix.
+  /// Returns a square root S of the covariance matrix, i.e. such that S * S^T is the covariance matrix.
+  virtual MatrixType GetCovarianceSqrt() const { return m_CovarianceOperator->GetCovarianceSqrt(); }
+  /// Sets a square root S of the covariance matrix, i.e. such that S * S^T is the covariance matrix.
   virtual void SetCovarianceSqrt(MatrixType const &covSqrt) {
-    m_CovarianceSqrt = covSqrt;
-    m_Covariance = covSqrt * covSqrt.transpose();
-    m_CovarianceInverse = inverse_sympd(m_Covariance);
-    m_CovarianceLogDeterminant = log_det(m_Covariance);
+    m_CovarianceOperator = DenseCovarianceOperatorType::FromCovarianceSqrt(covSqrt);
   }
 
   /// Returns the inverse of the covariance matrix.
-  virtual MatrixType GetCovarianceInverse() const { return m_CovarianceInverse; }
+  virtual MatrixType GetCovarianceInverse() const { return m_CovarianceOperator->GetCovarianceInverse(); }
   /// Sets the the inverse of the covariance matrix.
   virtual void SetCovarianceInverse(MatrixType const &covInv) {
-    m_CovarianceInverse = covInv;
-    m_Covariance = inverse_sympd(covInv);
-    m_CovarianceSqrt = chol(m_Covariance);
-    m_CovarianceLogDeterminant = log_det(m_Covariance);
+    m_CovarianceOperator = DenseCovarianceOperatorType::FromCovarianceInverse(covInv);
   }
 
+  /// Returns the covariance operator of the normal distribution.
+  std::shared_ptr<const CovarianceOperatorType> GetCovarianceOperator() const { return m_CovarianceOperator; }
+  /// Sets a (possibly structured) covariance operator, which is then used instead of dense matrices.
+  void SetCovarianceOperator(std::shared_ptr<const CovarianceOperatorType> op) { m_CovarianceOperator = op; }
+
+  /// Returns the product of the inverse of the covariance matrix with \e v.
+  VectorType MultiplyByCovarianceInverse(VectorType const &v) const { return m_CovarianceOperator->MultiplyInverse(v); }
+
 
   ////////////////////////////////////////////////////////////////////////////////////////////////////
   // Other public method(s) :
@@ -119,14 +126,8 @@ class NormalDistribution : public AbstractNormalDistribution<ScalarType> {
   // Protected attribute(s)
   ////////////////////////////////////////////////////////////////////////////////////////////////////
 
-  /// Covariance matrix of the normal distribution.
-  MatrixType m_Covariance;
-  /// Square root of the covariance matrix (Cholesky square root).
-  MatrixType m_CovarianceSqrt;
-  /// Inverse of the covariance matrix.
-  MatrixType m_CovarianceInverse;
-  /// Log-determinant of the covariance matrix.
-  ScalarType m_CovarianceLogDeterminant;
+  /// Covariance operator of the normal distribution (immutable, hence shared between the copies).
+  std::shared_ptr<const CovarianceOperatorType> m_CovarianceOperator;
 
 }; /* class NormalDistribution */
 
@@ -21,6 +21,7 @@
 #include "MultiScalarInverseWishartDistribution.h"
 #include "DirichletDistribution.h"
 #include "AutomaticRelevanceDeterminationDistribution.h"
+#include "RandomNumberGenerator.h"
 
 namespace def {
 namespace proba {
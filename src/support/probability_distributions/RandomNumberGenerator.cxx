@@ -0,0 +1,165 @@
+/***************************************************************************************
+*                                                                                      *
+*                                     Deformetrica                                     *
+*                                                                                      *
+*    Copyright Inria and the University of Utah.  All rights reserved. This file is    *
+*    distributed under the terms of the Inria Non-Commercial License Agreement.        *
+*                                                                                      *
+*                                                                                      *
+****************************************************************************************/
+
+#include "RandomNumberGenerator.h"
+#include "SerializeDeformationState.h"
+
+#include <cmath>
+#include <random>
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// RandomStream :
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+std::array<std::uint32_t, 4>
+RandomStream
+::Philox(std::uint64_t position) const {
+  const std::uint32_t M0 = 0xD2511F53, M1 = 0xCD9E8D57;
+  const std::uint32_t W0 = 0x9E3779B9, W1 = 0xBB67AE85;
+
+  std::uint32_t c0 = std::uint32_t(position), c1 = std::uint32_t(position >> 32);
+  std::uint32_t c2 = std::uint32_t(m_StreamId), c3 = std::uint32_t(m_StreamId >> 32);
+  std::uint32_t k0 = std::uint32_t(m_Seed), k1 = std::uint32_t(m_Seed >> 32);
+
+  for (unsigned int round = 0; round < 10; ++round) {
+    const std::uint64_t p0 = std::uint64_t(M0) * c0;
+    const std::uint64_t p1 = std::uint64_t(M1) * c2;
+    const std::uint32_t n0 = std::uint32_t(p1 >> 32) ^ c1 ^ k0;
+    const std::uint32_t n2 = std::uint32_t(p0 >> 32) ^ c3 ^ k1;
+    c1 = std::uint32_t(p1);
+    c3 = std::uint32_t(p0);
+    c0 = n0;
+    c2 = n2;
+    k0 += W0;
+    k1 += W1;
+  }
+
+  return {{c0, c1, c2, c3}};
+}
+
+void
+RandomStream
+::FillUniform(double *out, std::size_t n) {
+  for (std::size_t k = 0; k < n; k += 2) {
+    const std::array<std::uint32_t, 4> r = NextBlock();
+    out[k] = ToUnitInterval((std::uint64_t(r[0]) << 32) | r[1]);
+    if (k + 1 < n) out[k + 1] = ToUnitInterval((std::uint64_t(r[2]) << 32) | r[3]);
+  }
+}
+
+void
+RandomStream
+::FillNormal(double *out, std::size_t n) {
+  const double twoPi = 6.283185307179586476925286766559;
+
+  /// Uniform draws first, so that the transform below runs on contiguous memory.
+  const std::size_t even = n - n % 2;
+  FillUniform(out, even);
+  for (std::size_t k = 0; k < even; k += 2) {
+    const double radius = std::sqrt(-2.0 * std::log(1.0 - out[k]));
+    const double angle = twoPi * out[k + 1];
+    out[k] = radius * std::cos(angle);
+    out[k + 1] = radius * std::sin(angle);
+  }
+
+  /// Odd sizes : the last pair is drawn in full, only its first normal is kept.
+  if (n % 2) {
+    double extra[2];
+    FillUniform(extra, 2);
+    out[n - 1] = std::sqrt(-2.0 * std::log(1.0 - extra[0])) * std::cos(twoPi * extra[1]);
+  }
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// RandomNumberGenerator :
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+RandomNumberGenerator
+::RandomNumberGenerator() : m_MainStream(RandomSeed()) {}
+
+void
+RandomNumberGenerator
+::SetSeed(std::uint64_t seed) {
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  m_MainStream = RandomStream(seed);
+}
+
+RandomStream *&
+RandomNumberGenerator
+::ThreadStream() {
+  static thread_local RandomStream *stream = nullptr;
+  return stream;
+}
+
+double
+RandomNumberGenerator
+::Uniform() {
+  if (RandomStream *stream = ThreadStream()) return stream->Uniform();
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  return m_MainStream.Uniform();
+}
+
+double
+RandomNumberGenerator
+::Normal() {
+  if (RandomStream *stream = ThreadStream()) return stream->Normal();
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  return m_MainStream.Normal();
+}
+
+VectorType
+RandomNumberGenerator
+::NormalVector(std::size_t n) {
+  if (RandomStream *stream = ThreadStream()) return stream->NormalVector(n);
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  return m_MainStream.NormalVector(n);
+}
+
+std::uint64_t
+RandomNumberGenerator
+::Bits() {
+  if (RandomStream *stream = ThreadStream()) return (*stream)();
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  return m_MainStream();
+}
+
+void
+RandomNumberGenerator
+::SaveState(def::utils::DeformationState &state) const {
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  const std::uint64_t seed = m_MainStream.GetSeed();
+  const std::uint64_t position = m_MainStream.GetPosition();
+  def::utils::DeformationState::VecUIntType words = {
+      (unsigned int) (seed >> 32), (unsigned int) seed, (unsigned int) (position >> 32), (unsigned int) position};
+  state << words;
+}
+
+void
+RandomNumberGenerator
+::RecoverState(def::utils::DeformationState &state) {
+  def::utils::DeformationState::VecUIntType words;
+  state >> words;
+  if (words.size() != 4)
+    throw std::runtime_error("Corrupted random number generator state");
+
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  m_MainStream = RandomStream((std::uint64_t(words[0]) << 32) | words[1], 0,
+                              (std::uint64_t(words[2]) << 32) | words[3]);
+}
+
+std::uint64_t
+RandomNumberGenerator
+::RandomSeed() {
+  std::random_device rd;
+  return (std::uint64_t(rd()) << 32) | rd();
+}
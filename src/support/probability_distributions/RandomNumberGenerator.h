@@ -0,0 +1,239 @@
+/***************************************************************************************
+*                                                                                      *
+*                                     Deformetrica                                     *
+*                                                                                      *
+*    Copyright Inria and the University of Utah.  All rights reserved. This file is    *
+*    distributed under the terms of the Inria Non-Commercial License Agreement.        *
+*                                                                                      *
+*                                                                                      *
+****************************************************************************************/
+
+#ifndef _RandomNumberGenerator_h
+#define _RandomNumberGenerator_h
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+
+/// Support files.
+#include "LinearAlgebra.h"
+
+using namespace def::algebra;
+
+namespace def {
+namespace utils {
+class DeformationState;
+}
+}
+
+
+/**
+ *  \brief      Counter-based random stream.
+ *
+ *  \copyright  Inria and the University of Utah
+ *  \version    Deformetrica 2.0
+ *
+ *  \details    The RandomStream class draws random numbers with the Philox4x32-10 counter-based generator
+ *              (Salmon et al., "Parallel random numbers: as easy as 1, 2, 3", 2011). Its whole state is the run seed
+ *              (the key), the stream identifier and a 64 bits position : streams with different identifiers are
+ *              independent, cost nothing to create, and any of them can be replayed exactly from the seed.
+ *              It fulfills the UniformRandomBitGenerator requirements, so that it may feed the std distributions.
+ */
+class RandomStream {
+ public:
+
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+  // typedef :
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+
+  typedef std::uint64_t result_type;
+
+
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Constructor(s) / Destructor :
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+
+  /// Creates the stream \e streamId of the run seeded with \e seed, at the position \e position.
+  RandomStream(std::uint64_t seed = 0, std::uint64_t streamId = 0, std::uint64_t position = 0)
+      : m_Seed(seed), m_StreamId(streamId), m_Position(position) {}
+
+
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Encapsulation method(s) :
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+
+  std::uint64_t GetSeed() const { return m_Seed; }
+  std::uint64_t GetStreamId() const { return m_StreamId; }
+
+  /// Returns the number of Philox blocks consumed so far.
+  std::uint64_t GetPosition() const { return m_Position; }
+  void SetPosition(std::uint64_t position) { m_Position = position; }
+
+
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Other method(s) :
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+
+  static constexpr result_type min() { return 0; }
+  static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+  /// Returns 64 random bits.
+  result_type operator()() {
+    const std::array<std::uint32_t, 4> r = NextBlock();
+    return (std::uint64_t(r[0]) << 32) | r[1];
+  }
+
+  /// Draws from the uniform distribution on [0, 1).
+  double Uniform() { return ToUnitInterval(operator()()); }
+
+  /// Draws from the standard normal distribution.
+  double Normal() {
+    double out[2];
+    FillNormal(out, 2);
+    return out[0];
+  }
+
+  /// Fills \e out with \e n independent draws of the uniform distribution on [0, 1).
+  void FillUniform(double *out, std::size_t n);
+
+  /// Fills \e out with \e n independent draws of the standard normal distribution (batched Box-Muller transform).
+  void FillNormal(double *out, std::size_t n);
+
+  /// Returns a vector of \e n independent standard normal draws.
+  VectorType NormalVector(std::size_t n) {
+    VectorType out(n);
+    FillNormal(out.memptr(), n);
+    return out;
+  }
+
+
+ protected:
+
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Method(s) :
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+
+  /// Returns the Philox4x32-10 block at the current position, and moves to the next one.
+  std::array<std::uint32_t, 4> NextBlock() { return Philox(m_Position++); }
+
+  /// Philox4x32-10 bijection of the counter (position, stream identifier) under the seed key.
+  std::array<std::uint32_t, 4> Philox(std::uint64_t position) const;
+
+  /// Maps 64 random bits to [0, 1) with 53 bits of precision.
+  static double ToUnitInterval(std::uint64_t bits) { return (bits >> 11) * (1.0 / 9007199254740992.0); }
+
+
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Attribute(s)
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+
+  /// Run seed, used as the Philox key.
+  std::uint64_t m_Seed;
+  /// Identifier of the stream, stored in the high half of the Philox counter.
+  std::uint64_t m_StreamId;
+  /// Position in the stream, stored in the low half of the Philox counter.
+  std::uint64_t m_Position;
+
+};
+
+
+/**
+ *  \brief      Random number service of a run.
+ *
+ *  \copyright  Inria and the University of Utah
+ *  \version    Deformetrica 2.0
+ *
+ *  \details    The RandomNumberGenerator singleton holds the seed of the run and its main stream, which is used by the
+ *              Sample() methods of the probability distributions. Concurrent tasks get their own independent streams
+ *              from Stream(), and activate them on their thread with a ScopedRandomStream : their draws then do not
+ *              depend on the thread scheduling. The seed and the main stream position are saved in the deformation
+ *              state, so that a resumed run draws exactly the numbers the uninterrupted one would have drawn.
+ */
+class RandomNumberGenerator {
+ public:
+
+  RandomNumberGenerator(const RandomNumberGenerator &) = delete;
+  RandomNumberGenerator(RandomNumberGenerator &&) = delete;
+
+  RandomNumberGenerator &operator=(const RandomNumberGenerator &) = delete;
+  RandomNumberGenerator &operator=(RandomNumberGenerator &&) = delete;
+
+  static RandomNumberGenerator *instance() {
+    static RandomNumberGenerator *instance = nullptr;
+    if (instance) return instance;
+    return (instance = new RandomNumberGenerator());
+  }
+
+
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Encapsulation method(s) :
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+
+  /// Sets the seed of the run, and rewinds the main stream.
+  void SetSeed(std::uint64_t seed);
+  std::uint64_t GetSeed() const { return m_MainStream.GetSeed(); }
+
+  /// Returns the independent stream \e streamId of the run (e.g. one per subject and iteration).
+  RandomStream Stream(std::uint64_t streamId) const { return RandomStream(GetSeed(), streamId + 1); }
+
+
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Other method(s) :
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+
+  /// Draws from the uniform distribution on [0, 1), with the stream active on the calling thread.
+  double Uniform();
+  /// Draws from the standard normal distribution, with the stream active on the calling thread.
+  double Normal();
+  /// Returns \e n independent standard normal draws, with the stream active on the calling thread.
+  VectorType NormalVector(std::size_t n);
+  /// Returns 64 random bits, with the stream active on the calling thread.
+  std::uint64_t Bits();
+
+  /// Saves the seed and the position of the main stream into \e state.
+  void SaveState(def::utils::DeformationState &state) const;
+  /// Recovers the seed and the position of the main stream from \e state.
+  void RecoverState(def::utils::DeformationState &state);
+
+  /// Returns a seed drawn from the hardware entropy source.
+  static std::uint64_t RandomSeed();
+
+
+ protected:
+
+  friend class ScopedRandomStream;
+
+  RandomNumberGenerator();
+  ~RandomNumberGenerator() {}
+
+  /// Stream activated on the calling thread by a ScopedRandomStream, if any.
+  static RandomStream *&ThreadStream();
+
+  /// Main stream of the run, shared by the threads without an active stream.
+  RandomStream m_MainStream;
+  /// Protects the main stream.
+  mutable std::mutex m_Mutex;
+
+};
+
+
+/**
+ *  \brief      Activates a random stream on the current thread for the lifetime of the object.
+ */
+class ScopedRandomStream {
+ public:
+  explicit ScopedRandomStream(RandomStream &stream) : m_Previous(RandomNumberGenerator::ThreadStream()) {
+    RandomNumberGenerator::ThreadStream() = &stream;
+  }
+  ~ScopedRandomStream() { RandomNumberGenerator::ThreadStream() = m_Previous; }
+
+  ScopedRandomStream(const ScopedRandomStream &) = delete;
+  ScopedRandomStream &operator=(const ScopedRandomStream &) = delete;
+
+ private:
+  RandomStream *m_Previous;
+};
+
+
+#endif /* _RandomNumberGenerator_h */
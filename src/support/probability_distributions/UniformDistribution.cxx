@@ -9,6 +9,7 @@
  ****************************************************************************************/
 
 #include "UniformDistribution.h"
+#include "RandomNumberGenerator.h"
 
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -49,16 +50,13 @@ template<class ScalarType>
 VectorType
 UniformDistribution<ScalarType>
 ::Sample() const {
-  std::random_device rd;
-  std::mt19937_64 generator(rd());
+  RandomNumberGenerator *rng = RandomNumberGenerator::instance();
 
   const unsigned int N = m_LowerBounds.size();
   VectorType out(N);
 
-  for (unsigned int k = 0; k < m_LowerBounds.size(); ++k) {
-    std::uniform_real_distribution<ScalarType> distribution(m_LowerBounds(k), m_UpperBounds(k));
-    out(k) = distribution(generator);
-  }
+  for (unsigned int k = 0; k < N; ++k)
+    out(k) = m_LowerBounds(k) + (m_UpperBounds(k) - m_LowerBounds(k)) * rng->Uniform();
 
   return out;
 }
@@ -16,6 +16,13 @@
 namespace def {
 namespace utils {
 
+/// Possible formats of the serialized deformation state.
+typedef enum {
+  TextArchive,        /*!< Boost text archive (legacy format). */
+  BinaryArchive,      /*!< Boost binary archive. */
+  CompressedArchive   /*!< Boost binary archive with fast gzip compression. */
+} StateFormatType;
+
 struct GeneralSettings {
   bool save_state;
   bool load_state;
@@ -23,6 +30,26 @@ struct GeneralSettings {
   std::string output_state_filename;
   std::string output_dir;
   unsigned int number_of_threads;
+  /// Format used when writing the deformation state (reading detects it automatically).
+  StateFormatType state_format = BinaryArchive;
+  /// Writes the deformation state from a background thread during the estimation.
+  bool async_state_saving = true;
+  /// Writes the model matrices (control points, momenta...) in the binary matrix format instead of text.
+  bool binary_matrix_output = false;
+  /// Writes the model outputs (matrices, meshes, images) from a background thread (see AsyncOutputWriter).
+  bool async_output_writing = false;
+  /// Writes the meshes in the binary legacy VTK format instead of ASCII.
+  bool binary_vtk_output = false;
+  /// Records the timings of the hot paths and prints their summary at each displayed iteration (see Profiler).
+  /// Only effective when compiled with the USE_PROFILING option.
+  bool profiling = false;
+  /// If not empty, the recorded timings are also written to this file in the Chrome trace format.
+  std::string trace_filename;
+  /// Degree of the polynomial of the vectorized exponential used by the Gaussian kernels (see fast_math::vexp()) :
+  /// 13 is accurate to 1 ulp, lower degrees are faster and less accurate.
+  unsigned int exp_polynomial_degree = 13;
+  /// Maximal error on the kernel values of the low rank kernels (see NystromKernel).
+  double nystrom_tolerance = 1e-4;
 };
 
 class SingletonGeneralSettings {
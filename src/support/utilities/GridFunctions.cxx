@@ -9,7 +9,38 @@
  ****************************************************************************************/
 
 #include "GridFunctions.h"
+#include <algorithm>
 #include <chrono>
+#include <cmath>
+
+namespace {
+
+/// Replaces \e line[i] by the extremum, in the sense of \e extremum, of the values \e line[i - radius] to
+/// \e line[i + radius] clipped to the line. The line is padded with its end values, cut into blocks of 2 * radius + 1
+/// values, and each window is covered by the suffix extremum of one block and the prefix extremum of the next one
+/// (van Herk/Gil-Werman) : three evaluations of \e extremum per value, whatever \e radius.
+template<class ScalarType, class ExtremumType>
+void RunningExtremum(std::vector<ScalarType> &line, long radius, ExtremumType extremum,
+                     std::vector<ScalarType> &prefix, std::vector<ScalarType> &suffix) {
+  const long n = line.size();
+  const long w = 2 * radius + 1;
+  const long m = ((n + 2 * radius + w - 1) / w) * w;
+
+  prefix.resize(m);
+  suffix.resize(m);
+  for (long j = 0; j < m; ++j)
+    prefix[j] = suffix[j] = line[std::min(std::max(j - radius, 0L), n - 1)];
+
+  for (long j = 0; j < m; ++j)
+    if (j % w) prefix[j] = extremum(prefix[j - 1], prefix[j]);
+  for (long j = m - 2; j >= 0; --j)
+    if ((j + 1) % w) suffix[j] = extremum(suffix[j + 1], suffix[j]);
+
+  for (long i = 0; i < n; ++i)
+    line[i] = extremum(suffix[i], prefix[i + w - 1]);
+}
+
+}
 
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -241,6 +272,61 @@ GridFunctions<ScalarType, Dimension>
   return Yup;
 }
 
+template<class ScalarType, unsigned int Dimension>
+typename GridFunctions<ScalarType, Dimension>::ImagePointer
+GridFunctions<ScalarType, Dimension>
+::LocalIntensityDeviation(const ImageType *img, ScalarType radius) {
+  const ImageSizeType size = img->GetLargestPossibleRegion().GetSize();
+  const ImageSpacingType spacing = img->GetSpacing();
+  const long numVoxels = img->GetLargestPossibleRegion().GetNumberOfPixels();
+
+  /// The buffer is ordered with the first dimension varying fastest.
+  std::vector<ScalarType> minValues(img->GetBufferPointer(), img->GetBufferPointer() + numVoxels);
+  std::vector<ScalarType> maxValues(minValues);
+
+  const auto min = [](ScalarType a, ScalarType b) { return std::min(a, b); };
+  const auto max = [](ScalarType a, ScalarType b) { return std::max(a, b); };
+  std::vector<ScalarType> minLine, maxLine, prefix, suffix;
+
+  long stride = 1;
+  for (unsigned int d = 0; d < Dimension; ++d) {
+    const long n = size[d];
+    const long r = std::min(static_cast<long>(std::round(radius / spacing[d])), n - 1);
+
+    if (r > 0) {
+      minLine.resize(n);
+      maxLine.resize(n);
+      for (long outer = 0; outer < numVoxels; outer += n * stride)
+        for (long inner = 0; inner < stride; ++inner) {
+          const long first = outer + inner;
+          for (long i = 0; i < n; ++i) {
+            minLine[i] = minValues[first + i * stride];
+            maxLine[i] = maxValues[first + i * stride];
+          }
+          RunningExtremum(minLine, r, min, prefix, suffix);
+          RunningExtremum(maxLine, r, max, prefix, suffix);
+          for (long i = 0; i < n; ++i) {
+            minValues[first + i * stride] = minLine[i];
+            maxValues[first + i * stride] = maxLine[i];
+          }
+        }
+    }
+    stride *= n;
+  }
+
+  ImagePointer deviation = ImageType::New();
+  deviation->SetRegions(img->GetLargestPossibleRegion());
+  deviation->CopyInformation(img);
+  deviation->Allocate();
+
+  const ScalarType *values = img->GetBufferPointer();
+  ScalarType *deviations = deviation->GetBufferPointer();
+  for (long i = 0; i < numVoxels; ++i)
+    deviations[i] = std::max(maxValues[i] - values[i], values[i] - minValues[i]);
+
+  return deviation;
+}
+
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 // Protected method(s) :
@@ -89,6 +89,12 @@ class GridFunctions {
   static MatrixType UpsampleImagePoints(const ImageType *img, const ImageType *downSampledImg,
                                         const MatrixType &downSampledPos);
 
+  /// Returns the image of the largest absolute difference between the intensity of each voxel of \e img and the
+  /// intensities in the box of half-width \e radius (in physical units, rounded to whole voxels) centered on it.
+  /// The box minima and maxima are computed dimension by dimension with the van Herk/Gil-Werman running extrema,
+  /// whose cost does not depend on \e radius.
+  static ImagePointer LocalIntensityDeviation(const ImageType *img, ScalarType radius);
+
  protected:
 
   ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,157 @@
+/***************************************************************************************
+ *                                                                                      *
+ *                                     Deformetrica                                     *
+ *                                                                                      *
+ *    Copyright Inria and the University of Utah. All rights reserved. This file is     *
+ *    distributed under the terms of the Inria Non-Commercial License Agreement.        *
+ *                                                                                      *
+ *                                                                                      *
+ ****************************************************************************************/
+
+#include "Profiler.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <stdexcept>
+
+namespace def {
+namespace utils {
+
+namespace {
+/// Origin of the trace timestamps, taken at the initialization of the library rather than at the first record.
+const Profiler::ClockType::time_point kTraceOrigin = Profiler::ClockType::now();
+}
+
+Profiler *Profiler::instance() {
+  static Profiler *instance = nullptr;
+  static std::once_flag flag;
+  std::call_once(flag, []() { instance = new Profiler(); });
+  return instance;
+}
+
+Profiler::Profiler() : m_Origin(kTraceOrigin), m_DroppedTraceEvents(0) {}
+
+unsigned int Profiler::ThreadIndex() {
+  auto it = m_Threads.find(std::this_thread::get_id());
+  if (it != m_Threads.end()) return it->second;
+  const unsigned int index = m_Threads.size();
+  m_Threads[std::this_thread::get_id()] = index;
+  return index;
+}
+
+void Profiler::AddScope(const char *name, ClockType::time_point start, ClockType::time_point end, std::uint64_t size) {
+  const double duration_ms = std::chrono::duration<double, std::milli>(end - start).count();
+
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  ScopeStatistics &stats = m_Scopes[name];
+  stats.calls++;
+  stats.total_ms += duration_ms;
+  stats.max_ms = std::max(stats.max_ms, duration_ms);
+  stats.size = std::max(stats.size, size);
+
+  if (settings.trace_filename.empty()) return;
+  if (m_TraceEvents.size() >= kMaxTraceEvents) {
+    m_DroppedTraceEvents++;
+    return;
+  }
+  TraceEvent event;
+  event.name = name;
+  event.is_counter = false;
+  event.start_us = std::chrono::duration_cast<std::chrono::microseconds>(start - m_Origin).count();
+  event.duration_us = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+  event.value = size;
+  event.thread = ThreadIndex();
+  m_TraceEvents.push_back(event);
+}
+
+void Profiler::AddCount(const char *name, std::uint64_t n) {
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  m_Counters[name] += n;
+}
+
+void Profiler::PrintSummary(std::ostream &os, unsigned int iteration) {
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  if (m_Scopes.empty() && m_Counters.empty()) return;
+
+  /// Sorts the scopes by decreasing total time.
+  std::vector<std::pair<std::string, ScopeStatistics>> scopes(m_Scopes.begin(), m_Scopes.end());
+  std::sort(scopes.begin(), scopes.end(), [](const std::pair<std::string, ScopeStatistics> &a,
+                                             const std::pair<std::string, ScopeStatistics> &b) {
+    return a.second.total_ms > b.second.total_ms;
+  });
+
+  const std::ios_base::fmtflags flags = os.flags();
+  const std::streamsize precision = os.precision();
+
+  os << ">> Profiling summary (iteration " << iteration << ") :" << std::endl;
+  os << std::fixed << std::setprecision(2);
+  for (const auto &scope : scopes) {
+    const ScopeStatistics &stats = scope.second;
+    os << "   " << std::left << std::setw(48) << scope.first << std::right
+       << std::setw(8) << stats.calls << " calls "
+       << std::setw(12) << stats.total_ms << " ms total "
+       << std::setw(10) << stats.total_ms / stats.calls << " ms mean "
+       << std::setw(10) << stats.max_ms << " ms max";
+    if (stats.size) os << "   (max size " << stats.size << ")";
+    os << std::endl;
+  }
+  for (const auto &counter : m_Counters)
+    os << "   " << std::left << std::setw(48) << counter.first << std::right << std::setw(8) << counter.second
+       << std::endl;
+
+  os.flags(flags);
+  os.precision(precision);
+
+  /// The counters of the interval are kept in the trace, at the time of the summary.
+  if (!settings.trace_filename.empty()) {
+    const std::int64_t now_us = std::chrono::duration_cast<std::chrono::microseconds>(
+        ClockType::now() - m_Origin).count();
+    for (const auto &counter : m_Counters) {
+      if (m_TraceEvents.size() >= kMaxTraceEvents) {
+        m_DroppedTraceEvents++;
+        continue;
+      }
+      TraceEvent event;
+      event.name = counter.first;
+      event.is_counter = true;
+      event.start_us = now_us;
+      event.duration_us = 0;
+      event.value = counter.second;
+      event.thread = ThreadIndex();
+      m_TraceEvents.push_back(event);
+    }
+  }
+
+  m_Scopes.clear();
+  m_Counters.clear();
+}
+
+void Profiler::WriteTrace() {
+  if (settings.trace_filename.empty()) return;
+
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  std::ofstream file(settings.trace_filename);
+  if (!file.is_open())
+    throw std::runtime_error("Unable to open the trace file " + settings.trace_filename);
+
+  /// The scope names are string literals of the code : they never need to be escaped.
+  file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[" << std::endl;
+  for (std::size_t i = 0; i < m_TraceEvents.size(); ++i) {
+    const TraceEvent &event = m_TraceEvents[i];
+    file << "{\"name\":\"" << event.name << "\",\"pid\":1,\"tid\":" << event.thread << ",\"ts\":" << event.start_us;
+    if (event.is_counter)
+      file << ",\"ph\":\"C\",\"args\":{\"value\":" << event.value << "}}";
+    else
+      file << ",\"ph\":\"X\",\"dur\":" << event.duration_us << ",\"args\":{\"size\":" << event.value << "}}";
+    file << (i + 1 < m_TraceEvents.size() ? ",\n" : "\n");
+  }
+  file << "]}" << std::endl;
+
+  if (m_DroppedTraceEvents)
+    std::cerr << "Warning: " << m_DroppedTraceEvents << " events were dropped from the trace "
+              << settings.trace_filename << " (limit of " << kMaxTraceEvents << " events)" << std::endl;
+}
+
+}
+}
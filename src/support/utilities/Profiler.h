@@ -0,0 +1,162 @@
+/***************************************************************************************
+ *                                                                                      *
+ *                                     Deformetrica                                     *
+ *                                                                                      *
+ *    Copyright Inria and the University of Utah. All rights reserved. This file is     *
+ *    distributed under the terms of the Inria Non-Commercial License Agreement.        *
+ *                                                                                      *
+ *                                                                                      *
+ ****************************************************************************************/
+
+#ifndef _Profiler_h_
+#define _Profiler_h_
+
+#ifndef DEFORMETRICA_CONFIG
+#include "DeformetricaConfig.h"
+#endif
+
+#include "GeneralSettings.h"
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace def {
+namespace utils {
+
+/**
+ *  \brief      Hot-path instrumentation.
+ *
+ *  \copyright  Inria and the University of Utah
+ *  \version    Deformetrica 2.0
+ *
+ *  \details    The Profiler class accumulates the durations of the scopes instrumented with DEF_PROFILE_SCOPE and the
+ *              values of the DEF_PROFILE_COUNT counters, as soon as GeneralSettings::profiling is set. The estimators
+ *              print their summary at each displayed iteration, and the recorded scopes are written in the Chrome
+ *              trace format (chrome://tracing, Perfetto) when GeneralSettings::trace_filename is given. The
+ *              instrumentation is only compiled with the USE_PROFILING option : without it, the macros are empty.
+ */
+class Profiler {
+ public:
+
+  typedef std::chrono::steady_clock ClockType;
+
+  Profiler(const Profiler &) = delete;
+  Profiler(Profiler &&) = delete;
+  Profiler &operator=(const Profiler &) = delete;
+  Profiler &operator=(Profiler &&) = delete;
+
+  static Profiler *instance();
+
+  /// Returns true if the instrumented scopes and counters are recorded.
+  static bool IsEnabled() { return settings.profiling; }
+
+  /// Records a scope named \e name, of size \e size (e.g. number of points times number of sources, or 0).
+  void AddScope(const char *name, ClockType::time_point start, ClockType::time_point end, std::uint64_t size);
+  /// Adds \e n to the counter named \e name.
+  void AddCount(const char *name, std::uint64_t n);
+
+  /// Prints the statistics of the scopes and counters recorded since the previous summary, then resets them.
+  void PrintSummary(std::ostream &os, unsigned int iteration);
+  /// Writes all the recorded scopes and counter summaries to GeneralSettings::trace_filename, if given.
+  void WriteTrace();
+
+ private:
+
+  Profiler();
+
+  struct ScopeStatistics {
+    std::uint64_t calls = 0;
+    double total_ms = 0.0;
+    double max_ms = 0.0;
+    std::uint64_t size = 0;
+  };
+
+  /// Complete event ('X') when \e name is a scope, counter event ('C') otherwise.
+  struct TraceEvent {
+    std::string name;
+    bool is_counter;
+    std::int64_t start_us;
+    std::int64_t duration_us;
+    std::uint64_t value;
+    unsigned int thread;
+  };
+
+  /// Returns the small integer identifying the calling thread in the trace (must be called under the lock).
+  unsigned int ThreadIndex();
+
+  /// Maximum number of events kept in memory for the trace : beyond, the events are dropped and counted.
+  static const std::size_t kMaxTraceEvents = 1 << 22;
+
+  ClockType::time_point m_Origin;
+  std::mutex m_Mutex;
+  std::map<std::string, ScopeStatistics> m_Scopes;
+  std::map<std::string, std::uint64_t> m_Counters;
+  std::map<std::thread::id, unsigned int> m_Threads;
+  std::vector<TraceEvent> m_TraceEvents;
+  std::size_t m_DroppedTraceEvents;
+
+};
+
+/**
+ *  \brief      Scoped timer.
+ *
+ *  \details    The ScopedProfile class records the time spent between its construction and its destruction in the
+ *              Profiler. When the profiling is disabled at runtime, it costs one test of GeneralSettings::profiling.
+ */
+class ScopedProfile {
+ public:
+
+  explicit ScopedProfile(const char *name, std::uint64_t size = 0)
+      : m_Name(Profiler::IsEnabled() ? name : nullptr), m_Size(size) {
+    if (m_Name) m_Start = Profiler::ClockType::now();
+  }
+
+  ~ScopedProfile() {
+    if (m_Name) Profiler::instance()->AddScope(m_Name, m_Start, Profiler::ClockType::now(), m_Size);
+  }
+
+  ScopedProfile(const ScopedProfile &) = delete;
+  ScopedProfile &operator=(const ScopedProfile &) = delete;
+
+ private:
+
+  const char *m_Name;
+  std::uint64_t m_Size;
+  Profiler::ClockType::time_point m_Start;
+
+};
+
+}
+}
+
+#define DEF_PROFILE_CONCAT_(a, b) a##b
+#define DEF_PROFILE_CONCAT(a, b) DEF_PROFILE_CONCAT_(a, b)
+
+#ifdef USE_PROFILING
+/// Times the enclosing scope under \e name.
+#define DEF_PROFILE_SCOPE(name) \
+  def::utils::ScopedProfile DEF_PROFILE_CONCAT(def_profile_scope_, __LINE__)(name)
+/// Times the enclosing scope under \e name, and records the size of the processed problem.
+#define DEF_PROFILE_SCOPE_SIZE(name, size) \
+  def::utils::ScopedProfile DEF_PROFILE_CONCAT(def_profile_scope_, __LINE__)(name, size)
+/// Adds \e n to the counter \e name.
+#define DEF_PROFILE_COUNT(name, n) \
+  do { if (def::utils::Profiler::IsEnabled()) def::utils::Profiler::instance()->AddCount(name, n); } while (0)
+/// Prints and resets the statistics recorded since the previous summary.
+#define DEF_PROFILE_SUMMARY(iteration) \
+  do { if (def::utils::Profiler::IsEnabled()) def::utils::Profiler::instance()->PrintSummary(std::cout, iteration); } \
+  while (0)
+#else
+#define DEF_PROFILE_SCOPE(name) do {} while (0)
+#define DEF_PROFILE_SCOPE_SIZE(name, size) do {} while (0)
+#define DEF_PROFILE_COUNT(name, n) do {} while (0)
+#define DEF_PROFILE_SUMMARY(iteration) do {} while (0)
+#endif
+
+#endif /* _Profiler_h_ */
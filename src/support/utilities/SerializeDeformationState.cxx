@@ -9,11 +9,94 @@
  ****************************************************************************************/
 
 #include "SerializeDeformationState.h"
+#include "AsyncOutputWriter.h"
+
+#include <cstdio>
+#include <boost/archive/binary_oarchive.hpp>
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
+#include <boost/iostreams/filter/gzip.hpp>
+
 namespace def {
 namespace utils {
 
 DeformationState serialize;
 
+void DeformationState::save(const std::string &file, StateFormatType format) const {
+  AsyncOutputWriter::instance()->Wait();
+  write(file, format);
+}
+
+void DeformationState::save_and_reset(const std::string &file, bool asynchronous) {
+  if (!asynchronous) {
+    save(file);
+    reset();
+    return;
+  }
+
+  std::shared_ptr<DeformationState> snapshot = std::make_shared<DeformationState>();
+  std::swap(*this, *snapshot);
+
+  /// At most one snapshot is held besides the state being filled : a new one first waits for the previous one.
+  static std::weak_ptr<const DeformationState> pendingSnapshot;
+  if (!pendingSnapshot.expired()) AsyncOutputWriter::instance()->Wait();
+  pendingSnapshot = snapshot;
+
+  const StateFormatType format = settings.state_format;
+  AsyncOutputWriter::instance()->Submit([snapshot, file, format]() { snapshot->write(file, format); }, true);
+}
+
+void DeformationState::load(const std::string &file) {
+  AsyncOutputWriter::instance()->Wait();
+
+  const StateFormatType format = detect_format(file);
+  std::ifstream ifs(file, std::ios::binary);
+
+  DeformationState *df = new DeformationState;
+  if (format == TextArchive) {
+    boost::archive::text_iarchive ia(ifs);
+    ia >> *df;
+  } else if (format == BinaryArchive) {
+    boost::archive::binary_iarchive ia(ifs);
+    ia >> *df;
+  } else {
+    boost::iostreams::filtering_istream in;
+    in.push(boost::iostreams::gzip_decompressor());
+    in.push(ifs);
+    boost::archive::binary_iarchive ia(in);
+    ia >> *df;
+  }
+  std::swap(*this, *df);
+  delete df;
+}
+
+void DeformationState::write(const std::string &file, StateFormatType format) const {
+  const std::string tmp_file = file + ".tmp";
+  {
+    std::ofstream ofs(tmp_file, std::ios::binary);
+    if (format == TextArchive) {
+      boost::archive::text_oarchive oa(ofs);
+      oa << *this;
+    } else if (format == BinaryArchive) {
+      boost::archive::binary_oarchive oa(ofs);
+      oa << *this;
+    } else {
+      boost::iostreams::filtering_ostream out;
+      out.push(boost::iostreams::gzip_compressor(boost::iostreams::gzip_params(boost::iostreams::gzip::best_speed)));
+      out.push(ofs);
+      {
+        boost::archive::binary_oarchive oa(out);
+        oa << *this;
+      }
+      /// Flushes the compressor and writes the gzip footer before the file is closed.
+      out.reset();
+    }
+  }
+
+  if (std::rename(tmp_file.c_str(), file.c_str()) != 0)
+    throw std::runtime_error("Could not rename the deformation state file " + tmp_file + " to " + file);
+}
+
 std::ostream& operator<<(std::ostream& os, const DeformationState& ser) {
 #define PR(t,n) os << std::endl << "##n" << std::endl; std::copy(n.begin(),n.end(),std::ostream_iterator<t>(os," "));
   PR(bool, ser.bool_type_)
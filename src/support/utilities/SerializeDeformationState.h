@@ -11,6 +11,8 @@
 #pragma once
 
 #include <fstream>
+#include <cctype>
+#include <memory>
 #include <boost/archive/text_oarchive.hpp>
 #include <boost/archive/text_iarchive.hpp>
 #include <boost/serialization/vector.hpp>
@@ -19,6 +21,7 @@
 #include <boost/serialization/version.hpp>
 #include <src/support/linear_algebra/LinearAlgebra.h>
 #include <src/support/linear_algebra/Tolerance.hpp>
+#include <src/support/utilities/GeneralSettings.h>
 #include <deque>
 #include <vector>
 
@@ -59,29 +62,26 @@ class DeformationState : public Tolerance<DeformationState> {
     delete df;
   }
 
-  void save(const std::string &file) {
-    std::ofstream ofs(file);
+  /// Writes the state to \e file, waiting first for any pending background write.
+  void save(const std::string &file, StateFormatType format = settings.state_format) const;
 
-    boost::archive::text_oarchive oa(ofs);
-    oa << *this;
-  }
-
-  void save_and_reset(const std::string &file) {
-    std::ofstream ofs(file);
+  /// Writes the state to \e file and empties it. When \e asynchronous is set, the content is moved into a snapshot
+  /// which is written from a background thread, so the caller may fill the state again right away.
+  void save_and_reset(const std::string &file, bool asynchronous = settings.async_state_saving);
 
-    boost::archive::text_oarchive oa(ofs);
-    oa << *this;
-    reset();
-  }
+  /// Reads the state from \e file, whatever format it has been written with.
+  void load(const std::string &file);
 
-  void load(const std::string &file) {
-    std::ifstream ifs(file);
+  /// Returns the format of a state file by looking at its first bytes.
+  static StateFormatType detect_format(const std::string &file) {
+    std::ifstream ifs(file, std::ios::binary);
+    const int c0 = ifs.get();
+    const int c1 = ifs.get();
 
-    DeformationState *df = new DeformationState;
-    boost::archive::text_iarchive ia(ifs);
-    ia >> *df;
-    std::swap(*this, *df);
-    delete df;
+    /// Gzip magic number, then the text archive signature which starts with its (decimal) length.
+    if (c0 == 0x1f && c1 == 0x8b) return CompressedArchive;
+    if (c0 != EOF && std::isdigit(c0)) return TextArchive;
+    return BinaryArchive;
   }
 
   void deformation(DeformationState&& t) {
@@ -206,6 +206,11 @@ class DeformationState : public Tolerance<DeformationState> {
   friend std::ostream& operator<<(std::ostream& os, const DeformationState& ser);
 
     private:
+
+  /// Serializes the state to \e file.tmp, then renames it to \e file so that an interrupted run never leaves a
+  /// truncated state file behind.
+  void write(const std::string &file, StateFormatType format) const;
+
   friend class boost::serialization::access;
   template<class Archive>
   void serialize(Archive & ar, const unsigned int version)
@@ -0,0 +1,170 @@
+/***************************************************************************************
+*                                                                                      *
+*                                     Deformetrica                                     *
+*                                                                                      *
+*    Copyright Inria and the University of Utah.  All rights reserved. This file is    *
+*    distributed under the terms of the Inria Non-Commercial License Agreement.        *
+*                                                                                      *
+*                                                                                      *
+****************************************************************************************/
+
+#include "TestPointBlocks.h"
+#include "DeformableObjectReader.h"
+#include "KernelType.h"
+#include "Regression.h"
+#include "TimeSeriesDataSet.h"
+#include <cmath>
+
+namespace def {
+namespace test {
+
+void TestPointBlocks::SetUp() {
+    Test::SetUp();
+
+    DeformableObjectParameters::Pointer param = DeformableObjectParameters::New();
+    param->SetDeformableObjectType("Landmark");
+    param->SetAnatomicalCoordinateSystem("LPS");
+
+    DeformableObjectReader<double, 3> reader;
+    reader.SetObjectParameters(param);
+    reader.SetFileName(UNIT_TESTS_DIR"/geometries/data/VolumeDisk.vtk");
+    reader.Update();
+
+    std::vector<std::shared_ptr<AbstractGeometry<double, 3>>> objectList(1, reader.GetOutput());
+    m_Disk = std::make_shared<DeformableMultiObjectType>();
+    m_Disk->SetObjectList(objectList);
+    m_Disk->Update();
+}
+
+std::shared_ptr<TestPointBlocks::DiffeosType> TestPointBlocks::CreateDiskDeformation() const {
+    MatrixType controlPoints(9, 3, 0.0), momenta(9, 3, 0.0);
+    for (unsigned int i = 0; i < 9; ++i) {
+        controlPoints(i, 0) = 0.8 * ((i % 3) - 1.0);
+        controlPoints(i, 1) = 0.8 * ((i / 3) - 1.0);
+        momenta(i, 0) = 0.3 * std::sin(1.0 + i);
+        momenta(i, 1) = 0.3 * std::cos(2.0 * i);
+        momenta(i, 2) = 0.1 * std::sin(3.0 * i);
+    }
+
+    std::shared_ptr<DiffeosType> def = std::make_shared<DiffeosType>();
+    def->SetKernelWidth(0.8);
+    def->SetKernelType(Exact);
+    def->SetNumberOfTimePoints(11);
+    def->SetStartPositions(controlPoints);
+    def->SetStartMomentas(momenta);
+    def->SetDeformableMultiObject(m_Disk);
+    MatrixType dataDomain = m_Disk->GetBoundingBox();
+    for (unsigned int d = 0; d < 3; ++d) {
+        dataDomain(d, 0) -= 2.0;
+        dataDomain(d, 1) += 2.0;
+    }
+    def->SetDataDomain(dataDomain);
+    return def;
+}
+
+TEST_F(TestPointBlocks, BlockedLandmarkFlow) {
+    std::shared_ptr<DiffeosType> serial = CreateDiskDeformation();
+    serial->Update();
+    ASSERT_FALSE(serial->OutOfBox());
+
+    /// The blocks of points are flowed independently : the trajectories are the serial ones, whatever the blocks.
+    for (unsigned int numberOfBlocks : {2u, 7u, 1000u}) {
+        std::shared_ptr<DiffeosType> blocked = CreateDiskDeformation();
+        blocked->SetNumberOfPointBlocks(numberOfBlocks);
+        blocked->Update();
+        for (unsigned int t = 0; t < 11; ++t) {
+            const MatrixType expected = serial->GetDeformedObjectAt(t)->GetLandmarkPoints();
+            ASSERT_LE((blocked->GetDeformedObjectAt(t)->GetLandmarkPoints() - expected).frobenius_norm(), 1e-12);
+        }
+    }
+
+    /// The opt-in survives the copies of the deformation.
+    std::shared_ptr<DiffeosType> blocked = CreateDiskDeformation();
+    blocked->SetNumberOfPointBlocks(4);
+    ASSERT_EQ(blocked->Clone()->GetNumberOfPointBlocks(), 4u);
+    ASSERT_EQ(serial->GetNumberOfPointBlocks(), 1u);
+}
+
+TEST_F(TestPointBlocks, BlockedAdjointEquations) {
+    MatrixType finalCondition(m_Disk->GetLandmarkPoints().rows(), 3, 0.0);
+    for (unsigned int i = 0; i < finalCondition.rows(); ++i) {
+        finalCondition(i, 0) = std::cos(0.5 * i);
+        finalCondition(i, 1) = std::sin(0.3 * i);
+    }
+    MatrixType noImage;
+
+    std::shared_ptr<DiffeosType> serial = CreateDiskDeformation();
+    serial->Update();
+    serial->IntegrateAdjointEquations(finalCondition, noImage);
+
+    for (unsigned int numberOfBlocks : {2u, 7u, 1000u}) {
+        std::shared_ptr<DiffeosType> blocked = CreateDiskDeformation();
+        blocked->SetNumberOfPointBlocks(numberOfBlocks);
+        blocked->Update();
+        blocked->IntegrateAdjointEquations(finalCondition, noImage);
+
+        const ScalarType tolerance = 1e-10 * serial->GetAdjointMomAt0().frobenius_norm();
+        ASSERT_LE((blocked->GetAdjointPosAt0() - serial->GetAdjointPosAt0()).frobenius_norm(), tolerance);
+        ASSERT_LE((blocked->GetAdjointMomAt0() - serial->GetAdjointMomAt0()).frobenius_norm(), tolerance);
+        ASSERT_LE((blocked->GetAdjointLandmarkPointsAt0() - serial->GetAdjointLandmarkPointsAt0()).frobenius_norm(),
+                  1e-10 * finalCondition.frobenius_norm());
+    }
+}
+
+TEST_F(TestPointBlocks, BlockedRegressionDataTerms) {
+    /// The observations are the disk deformed by the reference deformation; the regression starts from half of it.
+    std::shared_ptr<DiffeosType> reference = CreateDiskDeformation();
+    reference->Update();
+    const std::vector<unsigned int> timeIndices = {3, 6, 10};
+    std::vector<std::shared_ptr<DeformableMultiObjectType>> targets;
+    for (unsigned int t : timeIndices)
+        targets.push_back(reference->GetDeformedObjectAt(t));
+
+    TimeSeriesDataSet<double, 3> dataSet;
+    dataSet.SetDeformableMultiObjects(targets);
+    dataSet.SetTimeIndices(timeIndices);
+    dataSet.Update();
+
+    auto computeDataTerms = [&](unsigned int numberOfBlocks, std::vector<ScalarType> &residuals, VectorType &gradient) {
+        std::shared_ptr<DiffeosType> def = CreateDiskDeformation();
+        def->SetNumberOfPointBlocks(numberOfBlocks);
+
+        Regression<double, 3> model;
+        model.SetDiffeos(def);
+        model.SetTemplate(m_Disk);
+        model.SetFreezeTemplateFlag(true);
+        model.SetControlPoints(reference->GetStartPositions());
+        model.SetInitialMomenta(0.5 * reference->GetStartMomentas());
+        model.SetDataSigmaSquared(VectorType(1, 0.01));
+        model.Update();
+
+        LinearVariableMapType popRER, popGrad;
+        LinearVariablesMapType indRER, indGrad;
+        std::vector<std::vector<ScalarType>> observationResiduals;
+        ASSERT_FALSE(model.ComputeResiduals(&dataSet, popRER, indRER, observationResiduals));
+        residuals.clear();
+        for (auto const &r : observationResiduals)
+            residuals.insert(residuals.end(), r.begin(), r.end());
+
+        model.ComputeCompleteLogLikelihoodGradient(&dataSet, popRER, indRER, popGrad, indGrad);
+        gradient = popGrad.vectorize();
+    };
+
+    std::vector<ScalarType> serialResiduals;
+    VectorType serialGradient;
+    computeDataTerms(1, serialResiduals, serialGradient);
+    ASSERT_EQ(serialResiduals.size(), timeIndices.size());
+    ASSERT_GT(serialGradient.magnitude(), 0.0);
+
+    std::vector<ScalarType> blockedResiduals;
+    VectorType blockedGradient;
+    computeDataTerms(4, blockedResiduals, blockedGradient);
+    ASSERT_EQ(blockedResiduals.size(), serialResiduals.size());
+    for (unsigned int i = 0; i < serialResiduals.size(); ++i)
+        ASSERT_NEAR(blockedResiduals[i], serialResiduals[i], 1e-10 * std::abs(serialResiduals[i]));
+    ASSERT_EQ(blockedGradient.size(), serialGradient.size());
+    ASSERT_LE((blockedGradient - serialGradient).magnitude(), 1e-10 * serialGradient.magnitude());
+}
+
+}
+}
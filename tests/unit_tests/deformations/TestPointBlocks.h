@@ -0,0 +1,37 @@
+/***************************************************************************************
+*                                                                                      *
+*                                     Deformetrica                                     *
+*                                                                                      *
+*    Copyright Inria and the University of Utah.  All rights reserved. This file is    *
+*    distributed under the terms of the Inria Non-Commercial License Agreement.        *
+*                                                                                      *
+*                                                                                      *
+****************************************************************************************/
+
+#pragma once
+
+#include "gtest/gtest.h"
+
+#include <memory>
+
+#include "Diffeos.h"
+#include "DeformableMultiObject.h"
+
+namespace def {
+namespace test {
+
+    class TestPointBlocks : public ::testing::Test {
+    public:
+        typedef Diffeos<double, 3> DiffeosType;
+        typedef DeformableMultiObject<double, 3> DeformableMultiObjectType;
+
+    protected:
+        virtual void SetUp();
+
+        /// Returns a deformation of the landmark disk of the geometries data, shot from a few control points.
+        std::shared_ptr<DiffeosType> CreateDiskDeformation() const;
+
+        std::shared_ptr<DeformableMultiObjectType> m_Disk;
+    };
+}
+}
@@ -0,0 +1,81 @@
+/***************************************************************************************
+*                                                                                      *
+*                                     Deformetrica                                     *
+*                                                                                      *
+*    Copyright Inria and the University of Utah.  All rights reserved. This file is    *
+*    distributed under the terms of the Inria Non-Commercial License Agreement.        *
+*                                                                                      *
+*                                                                                      *
+****************************************************************************************/
+
+#include "TestParallelTempering.h"
+#include "ParallelTempering.h"
+#include <cmath>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace def {
+namespace test {
+
+void TestParallelTempering::SetUp() {
+    Test::SetUp();
+}
+
+/// Toy model : a scalar random effect of prior N(0, 1), observed once at 3 with a unit noise, so that the posterior
+/// is N(1.5, 0.5). As in the McmcSaem estimator, each chain tempers both the data term and the prior, and runs a
+/// random walk Metropolis sampler; the exchanges alternate between the even and the odd pairs of chains.
+/// Returns the mean and the variance of the samples of the cold chain.
+static std::pair<double, double> SampleColdChain(bool withPrior) {
+    const std::vector<double> temperatures = {1.0, 2.15, 4.64, 10.0};
+    const unsigned int numberOfChains = temperatures.size();
+    const unsigned int numberOfIterations = 200000, burnIn = 1000;
+
+    auto dataTerm = [](double x) { return -0.5 * (x - 3.0) * (x - 3.0); };
+    auto prior = [](double x) { return -0.5 * x * x; };
+    auto energy = [&](double x) { return dataTerm(x) + (withPrior ? prior(x) : 0.0); };
+
+    std::mt19937_64 generator(42);
+    std::normal_distribution<double> normal;
+    std::uniform_real_distribution<double> uniform;
+
+    std::vector<double> states(numberOfChains, 0.0);
+    double sum = 0.0, sumOfSquares = 0.0;
+    for (unsigned int iter = 0; iter < numberOfIterations; ++iter) {
+        for (unsigned int k = 0; k < numberOfChains; ++k) {
+            const double candidate = states[k] + 1.5 * std::sqrt(temperatures[k]) * normal(generator);
+            const double logRatio = (dataTerm(candidate) + prior(candidate)
+                - dataTerm(states[k]) - prior(states[k])) / temperatures[k];
+            if (std::log(uniform(generator)) < logRatio) states[k] = candidate;
+        }
+
+        for (unsigned int k = iter % 2; k + 1 < numberOfChains; k += 2) {
+            const double logRatio = ChainsSwapLogRatio<double>(
+                temperatures[k], temperatures[k + 1], energy(states[k]), energy(states[k + 1]));
+            if (std::log(uniform(generator)) < logRatio) std::swap(states[k], states[k + 1]);
+        }
+
+        if (iter >= burnIn) {
+            sum += states[0];
+            sumOfSquares += states[0] * states[0];
+        }
+    }
+
+    const double mean = sum / (numberOfIterations - burnIn);
+    return std::make_pair(mean, sumOfSquares / (numberOfIterations - burnIn) - mean * mean);
+}
+
+TEST_F(TestParallelTempering, ColdChainMoments) {
+    const std::pair<double, double> moments = SampleColdChain(true);
+    ASSERT_NEAR(moments.first, 1.5, 0.05);
+    ASSERT_NEAR(moments.second, 0.5, 0.05);
+}
+
+TEST_F(TestParallelTempering, TemperedPriorsDoNotCancelOut) {
+    /// Leaving the tempered prior out of the energies biases the cold chain towards the data.
+    const std::pair<double, double> moments = SampleColdChain(false);
+    ASSERT_GT(std::abs(moments.first - 1.5), 0.2);
+}
+
+}
+}
@@ -0,0 +1,57 @@
+/***************************************************************************************
+*                                                                                      *
+*                                     Deformetrica                                     *
+*                                                                                      *
+*    Copyright Inria and the University of Utah.  All rights reserved. This file is    *
+*    distributed under the terms of the Inria Non-Commercial License Agreement.        *
+*                                                                                      *
+*                                                                                      *
+****************************************************************************************/
+
+#include "TestDeformableObjectLoader.h"
+#include "DeformableObjectLoader.h"
+
+namespace def {
+namespace test {
+
+void TestDeformableObjectLoader::SetUp() {
+    Test::SetUp();
+}
+
+TEST_F(TestDeformableObjectLoader, SharedIdenticalFiles) {
+    const std::string square = UNIT_TESTS_DIR"/geometries/data/SimpleSurfaceSquare.vtk";
+    const std::string disk = UNIT_TESTS_DIR"/geometries/data/VolumeDisk.vtk";
+
+    DeformableObjectParameters::Pointer param = DeformableObjectParameters::New();
+    param->SetDeformableObjectType("Landmark");
+    param->SetAnatomicalCoordinateSystem("LPS");
+
+    DeformableObjectLoader<double, 3> loader;
+    std::vector<std::size_t> requests;
+    requests.push_back(loader.AddObject(param, square));
+    requests.push_back(loader.AddObject(param, disk));
+    requests.push_back(loader.AddObject(param, square));
+    requests.push_back(loader.AddObject(param, square, true));
+    loader.Update();
+
+    /// The square is parsed once as an observation and once as a template.
+    ASSERT_EQ(loader.GetNumberOfParsedObjects(), 3u);
+    ASSERT_EQ(loader.GetOutput(requests[0]), loader.GetOutput(requests[2]));
+    ASSERT_NE(loader.GetOutput(requests[0]), loader.GetOutput(requests[3]));
+    ASSERT_NE(loader.GetOutput(requests[0]), loader.GetOutput(requests[1]));
+
+    DeformableObjectReader<double, 3> reader;
+    reader.SetObjectParameters(param);
+    reader.SetFileName(square);
+    reader.Update();
+    ASSERT_EQ(loader.GetOutput(requests[0])->GetNumberOfPoints(), reader.GetOutput()->GetNumberOfPoints());
+
+    /// Already parsed files are taken from the cache by later updates.
+    const std::size_t again = loader.AddObject(param, disk);
+    loader.Update();
+    ASSERT_EQ(loader.GetNumberOfParsedObjects(), 0u);
+    ASSERT_NE(loader.GetOutput(again), nullptr);
+}
+
+}
+}
@@ -0,0 +1,119 @@
+/***************************************************************************************
+*                                                                                      *
+*                                     Deformetrica                                     *
+*                                                                                      *
+*    Copyright Inria and the University of Utah.  All rights reserved. This file is    *
+*    distributed under the terms of the Inria Non-Commercial License Agreement.        *
+*                                                                                      *
+*                                                                                      *
+****************************************************************************************/
+
+#include "TestMatrixIO.h"
+#include <cstdio>
+#include "MatrixDLM.h"
+#include "AsyncOutputWriter.h"
+#include "GeneralSettings.h"
+
+namespace def {
+namespace test {
+
+void TestMatrixIO::SetUp() {
+    Test::SetUp();
+}
+
+TEST_F(TestMatrixIO, TextAndBinaryMatrix) {
+    const std::string txt_file = UNIT_TESTS_DIR"/serialize/data_empty_dir/matrix.txt";
+    const std::string bin_file = UNIT_TESTS_DIR"/serialize/data_empty_dir/matrix" + BINARY_MATRIX_EXTENSION;
+
+    MatrixType M(7, 3, 0);
+    for (unsigned int i = 0; i < M.rows(); ++i)
+        for (unsigned int j = 0; j < M.cols(); ++j)
+            M(i, j) = 0.25 * i - 1.5 * j;
+
+    ASSERT_FALSE(isMatrixBinaryFile(txt_file));
+    ASSERT_TRUE(isMatrixBinaryFile(bin_file));
+
+    writeMatrixDLM<double>(txt_file, M);
+    writeMatrixDLM<double>(bin_file, M);
+
+    MatrixType M_txt = readMatrixDLM<double>(txt_file.c_str());
+    MatrixType M_bin = readMatrixDLM<double>(bin_file.c_str());
+    ASSERT_EQ(M_txt, M);
+    ASSERT_EQ(M_bin, M);
+
+    /// The matrices own their memory: modifying a matrix does not alter the file, and rewriting the file does not
+    /// alter the matrices read before.
+    M_bin(0, 0) = 42.0;
+    ASSERT_EQ(readMatrixDLM<double>(bin_file.c_str()), M);
+
+    MatrixType M_read = readMatrixDLM<double>(bin_file.c_str());
+    writeMatrixDLM<double>(bin_file, MatrixType(7, 3, 1.0));
+    ASSERT_EQ(M_read, M);
+    ASSERT_EQ(readMatrixDLM<double>(bin_file.c_str()), MatrixType(7, 3, 1.0));
+
+    std::remove(txt_file.c_str());
+    std::remove(bin_file.c_str());
+}
+
+TEST_F(TestMatrixIO, TextAndBinaryMatrixList) {
+    const std::string txt_file = UNIT_TESTS_DIR"/serialize/data_empty_dir/matrices.txt";
+    const std::string bin_file = UNIT_TESTS_DIR"/serialize/data_empty_dir/matrices" + BINARY_MATRIX_EXTENSION;
+
+    MatrixListType L(4);
+    for (unsigned int k = 0; k < L.size(); ++k)
+        L[k] = MatrixType(5, 2, 0.5 * k + 1.0);
+
+    writeMultipleMatrixDLM<double>(txt_file, L);
+    writeMultipleMatrixDLM<double>(bin_file, L);
+
+    std::vector<MatrixType> L_txt = readMultipleMatrixDLM<double>(txt_file.c_str());
+    std::vector<MatrixType> L_bin = readMultipleMatrixDLM<double>(bin_file.c_str());
+    ASSERT_EQ(L_txt.size(), L.size());
+    ASSERT_EQ(L_bin.size(), L.size());
+    for (unsigned int k = 0; k < L.size(); ++k) {
+        ASSERT_EQ(L_txt[k], L[k]);
+        ASSERT_EQ(L_bin[k], L[k]);
+    }
+
+    /// A list cannot be read as a single matrix.
+    ASSERT_THROW(readMatrixDLM<double>(bin_file.c_str()), std::runtime_error);
+
+    std::remove(txt_file.c_str());
+    std::remove(bin_file.c_str());
+}
+
+TEST_F(TestMatrixIO, AsynchronousWriting) {
+    const std::string txt_file = UNIT_TESTS_DIR"/serialize/data_empty_dir/async.txt";
+    const std::string bin_file = UNIT_TESTS_DIR"/serialize/data_empty_dir/async" + BINARY_MATRIX_EXTENSION;
+    const bool async = def::utils::settings.async_output_writing;
+    def::utils::settings.async_output_writing = true;
+
+    /// The writers work on copies : the matrices may be modified as soon as they return.
+    MatrixType M(50, 3, 0);
+    for (unsigned int i = 0; i < M.rows(); ++i)
+        for (unsigned int j = 0; j < M.cols(); ++j)
+            M(i, j) = 0.5 * i + j;
+    const MatrixType expected = M;
+    writeMatrixDLM<double>(txt_file, M);
+    writeMatrixDLM<double>(bin_file, M);
+    M.fill(-1.0);
+
+    /// The readers wait for the pending files.
+    ASSERT_EQ(readMatrixDLM<double>(txt_file.c_str()), expected);
+    ASSERT_EQ(readMatrixDLM<double>(bin_file.c_str()), expected);
+
+    /// The errors of the background writer are reported to the estimator when it waits for the outputs.
+    MatrixListType invalid(2);
+    invalid[0] = MatrixType(2, 2, 0.0);
+    invalid[1] = MatrixType(3, 2, 0.0);
+    writeMultipleMatrixDLM<double>(bin_file, invalid);
+    ASSERT_THROW(AsyncOutputWriter::instance()->Wait(), std::runtime_error);
+    ASSERT_NO_THROW(AsyncOutputWriter::instance()->Wait());
+
+    def::utils::settings.async_output_writing = async;
+    std::remove(txt_file.c_str());
+    std::remove(bin_file.c_str());
+}
+
+}
+}
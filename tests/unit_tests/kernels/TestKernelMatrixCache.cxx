@@ -0,0 +1,116 @@
+/***************************************************************************************
+*                                                                                      *
+*                                     Deformetrica                                     *
+*                                                                                      *
+*    Copyright Inria and the University of Utah.  All rights reserved. This file is    *
+*    distributed under the terms of the Inria Non-Commercial License Agreement.        *
+*                                                                                      *
+*                                                                                      *
+****************************************************************************************/
+
+#include "TestKernelMatrixCache.h"
+
+namespace def {
+namespace test {
+
+// Dense kernel matrix
+TEST_F(TestKernelMatrixCache, gaussian_ConvolveAtSources) {
+  const std::shared_ptr<const KernelMatrix<ScalarType>> K
+      = KernelMatrixCache<ScalarType, 3>::instance()->Get(Exact, kernel_width, Y3D);
+  ASSERT_TRUE(K != nullptr);
+  ASSERT_FALSE(K->IsSparse());
+
+  MatrixType result_made_by_convolution = gaussianKernel3D.Convolve(Y3D);
+  gaussianKernel3D.SetSourcesKernelMatrix(K);
+  MatrixType result_made_by_kernel_matrix = gaussianKernel3D.ConvolveAtSources();
+  CompareAndDisp(result_made_by_convolution, result_made_by_kernel_matrix, eps_tol, "convolution", "kernel matrix");
+}
+
+// Sparse kernel matrix of a compactly supported kernel
+TEST_F(TestKernelMatrixCache, wendland_ConvolveAtSources) {
+  const std::shared_ptr<const KernelMatrix<ScalarType>> K
+      = KernelMatrixCache<ScalarType, 3>::instance()->Get(Wendland, wendland_width, Y3D);
+  ASSERT_TRUE(K != nullptr);
+  ASSERT_TRUE(K->IsSparse());
+  ASSERT_LT(K->GetMemorySize(), sizeof(ScalarType) * Y_ROW * Y_ROW);
+
+  MatrixType result_made_by_convolution = wendlandKernel3D.Convolve(Y3D);
+  wendlandKernel3D.SetSourcesKernelMatrix(K);
+  MatrixType result_made_by_kernel_matrix = wendlandKernel3D.ConvolveAtSources();
+  CompareAndDisp(result_made_by_convolution, result_made_by_kernel_matrix, eps_tol, "convolution", "kernel matrix");
+
+  MatrixType dense = K->ToDense();
+  MatrixType exact = wendlandKernel3D.ComputeKernelMatrix(Y3D);
+  CompareAndDisp(exact, dense, eps_tol, "kernel matrix", "sparse kernel matrix");
+}
+
+// Cholesky factor
+TEST_F(TestKernelMatrixCache, CholeskyFactor) {
+  const std::shared_ptr<const KernelMatrix<ScalarType>> K
+      = KernelMatrixCache<ScalarType, 3>::instance()->Get(Wendland, wendland_width, Y3D);
+  const std::shared_ptr<const MatrixType> R = K->GetCholeskyFactor();
+  ASSERT_EQ(R, K->GetCholeskyFactor());
+
+  MatrixType product = R->transpose() * (*R);
+  MatrixType dense = K->ToDense();
+  CompareAndDisp(dense, product, eps_tol, "kernel matrix", "cholesky product");
+}
+
+// Cholesky factor of a singular kernel matrix
+TEST_F(TestKernelMatrixCache, SingularCholeskyFactor) {
+  /// Two coincident points.
+  MatrixType Y = Y3D;
+  Y.set_row(1, Y.get_row(0));
+  const std::shared_ptr<const KernelMatrix<ScalarType>> K
+      = KernelMatrixCache<ScalarType, 3>::instance()->Get(Exact, kernel_width, Y);
+  const std::shared_ptr<const MatrixType> R = K->GetCholeskyFactor();
+  ASSERT_TRUE(R != nullptr);
+  ASSERT_EQ(R, K->GetCholeskyFactor());
+
+  /// Up to the diagonal jitter.
+  MatrixType product = R->transpose() * (*R);
+  MatrixType dense = K->ToDense();
+  CompareAndDisp(dense, product, 1e-4, "kernel matrix", "regularized cholesky product");
+}
+
+// Lookup by the values of the points
+TEST_F(TestKernelMatrixCache, lookup) {
+  KernelMatrixCache<ScalarType, 3> *cache = KernelMatrixCache<ScalarType, 3>::instance();
+  const std::shared_ptr<const KernelMatrix<ScalarType>> K = cache->Get(Exact, kernel_width, Y3D);
+
+  /// A copy of the points gets the same matrix.
+  const MatrixType Y3D_copy = Y3D;
+  ASSERT_EQ(K, cache->Get(Exact, kernel_width, Y3D_copy));
+
+  /// Other points, or another kernel, get another matrix.
+  MatrixType Y3D_moved = Y3D;
+  Y3D_moved(0, 0) += 1e-3;
+  ASSERT_NE(K, cache->Get(Exact, kernel_width, Y3D_moved));
+  ASSERT_NE(K, cache->Get(Exact, 2.0 * kernel_width, Y3D));
+  ASSERT_NE(K, cache->Get(Cauchy, kernel_width, Y3D));
+
+  /// Too many points.
+  MatrixType Y_large(KernelMatrixCache<ScalarType, 3>::kMaxNumberOfPoints + 1, 3, 0.0);
+  ASSERT_TRUE(cache->Get(Exact, kernel_width, Y_large) == nullptr);
+
+  /// Approximate kernels.
+  ASSERT_TRUE(cache->Get(P3M, kernel_width, Y3D) == nullptr);
+  ASSERT_TRUE(cache->Get(Nystrom, kernel_width, Y3D) == nullptr);
+}
+
+// New sources discard the kernel matrix
+TEST_F(TestKernelMatrixCache, SetSources) {
+  gaussianKernel3D.SetSourcesKernelMatrix(KernelMatrixCache<ScalarType, 3>::instance()->Get(Exact, kernel_width, Y3D));
+
+  MatrixType Y3D_moved = Y3D * 1.1;
+  gaussianKernel3D.SetSources(Y3D_moved);
+  MatrixType result_made_by_convolution = gaussianKernel3D.Convolve(Y3D_moved);
+  MatrixType result_made_by_sources = gaussianKernel3D.ConvolveAtSources();
+  CompareAndDisp(result_made_by_convolution, result_made_by_sources, eps_tol, "convolution", "sources");
+
+  ASSERT_THROW(gaussianKernel3D.SetSourcesKernelMatrix(
+      KernelMatrixCache<ScalarType, 3>::instance()->Get(Exact, kernel_width, X3D)), std::runtime_error);
+}
+
+}
+}
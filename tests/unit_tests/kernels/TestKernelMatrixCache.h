@@ -0,0 +1,46 @@
+/***************************************************************************************
+*                                                                                      *
+*                                     Deformetrica                                     *
+*                                                                                      *
+*    Copyright Inria and the University of Utah.  All rights reserved. This file is    *
+*    distributed under the terms of the Inria Non-Commercial License Agreement.        *
+*                                                                                      *
+*                                                                                      *
+****************************************************************************************/
+
+#pragma once
+
+#include "AbstractTestKernelPrecision.h"
+#include "src/support/kernels/KernelMatrixCache.h"
+#include "src/support/kernels/RadialKernel.h"
+
+namespace def {
+namespace test {
+
+class TestKernelMatrixCache : public AbstractTestKernelPrecision {
+ public:
+  // Constructor : initialize data and kernel used in the tests
+  TestKernelMatrixCache() {
+    gaussianKernel3D.SetKernelWidth(kernel_width);
+    gaussianKernel3D.SetSources(Y3D);
+    gaussianKernel3D.SetWeights(W3D);
+
+    /// Small with respect to the extent of the points, so that the kernel matrix is sparse.
+    wendlandKernel3D.SetKernelWidth(wendland_width);
+    wendlandKernel3D.SetSources(Y3D);
+    wendlandKernel3D.SetWeights(W3D);
+
+    KernelMatrixCache<ScalarType, 3>::instance()->Clear();
+  }
+
+ protected:
+
+  GaussianKernel<ScalarType, 3> gaussianKernel3D;
+  WendlandKernel<ScalarType, 3> wendlandKernel3D;
+
+  ScalarType wendland_width = 0.1;
+
+};
+
+}
+}
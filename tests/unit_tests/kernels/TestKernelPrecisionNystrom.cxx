@@ -0,0 +1,141 @@
+/***************************************************************************************
+*                                                                                      *
+*                                     Deformetrica                                     *
+*                                                                                      *
+*    Copyright Inria and the University of Utah.  All rights reserved. This file is    *
+*    distributed under the terms of the Inria Non-Commercial License Agreement.        *
+*                                                                                      *
+*                                                                                      *
+****************************************************************************************/
+
+#include "TestKernelPrecisionNystrom.h"
+
+#include "src/support/kernels/KernelFactory.h"
+
+namespace def {
+namespace test {
+
+// Convolve
+TEST_F(TestKernelPrecisionNystrom, nystrom_vs_exact_Convolve) {
+  /// The kernel width is large with respect to the extent of the points : the rank is low.
+  ASSERT_LT(nystromKernel3D.GetRank(), Y_ROW);
+
+  /// Each kernel value is within the tolerance, and the weights are below 1.
+  MatrixType result_made_by_nystrom_kernel = nystromKernel3D.Convolve(X3D);
+  MatrixType result_made_by_exact_kernel = exactKernel3D.Convolve(X3D);
+  CompareAndDisp(result_made_by_exact_kernel, result_made_by_nystrom_kernel, nystrom_tol * Y_ROW, "nystrom", "exact");
+
+  result_made_by_nystrom_kernel = nystromKernel3D.Convolve(Y3D);
+  result_made_by_exact_kernel = exactKernel3D.Convolve(Y3D);
+  CompareAndDisp(result_made_by_exact_kernel, result_made_by_nystrom_kernel, nystrom_tol * Y_ROW, "nystrom", "exact");
+}
+
+// ConvolveGradient
+TEST_F(TestKernelPrecisionNystrom, nystrom_vs_exact_ConvolveGradient) {
+  MatrixType result_made_by_nystrom_kernel = nystromKernel3D.ConvolveGradient(X3D, Z3D);
+  MatrixType result_made_by_exact_kernel = exactKernel3D.ConvolveGradient(X3D, Z3D);
+  CompareAndDisp(result_made_by_exact_kernel, result_made_by_nystrom_kernel, derivative_tol, "nystrom", "exact");
+
+  std::vector<MatrixType> gradients_made_by_nystrom_kernel = nystromKernel3D.ConvolveGradient(X3D);
+  std::vector<MatrixType> gradients_made_by_exact_kernel = exactKernel3D.ConvolveGradient(X3D);
+  ASSERT_EQ(gradients_made_by_exact_kernel.size(), gradients_made_by_nystrom_kernel.size());
+  for (unsigned int i = 0; i < X3D.rows(); i++)
+    CompareAndDisp(gradients_made_by_exact_kernel[i], gradients_made_by_nystrom_kernel[i], derivative_tol,
+                   "nystrom", "exact");
+
+  for (unsigned int d = 0; d < 3; d++) {
+    MatrixType result_made_by_nystrom_kernel_d = nystromKernel3D.ConvolveGradient(Y3D, d);
+    MatrixType result_made_by_exact_kernel_d = exactKernel3D.ConvolveGradient(Y3D, d);
+    CompareAndDisp(result_made_by_exact_kernel_d, result_made_by_nystrom_kernel_d, derivative_tol, "nystrom", "exact");
+
+    MatrixType result_made_by_nystrom_kernel_kd = nystromKernel3D.ConvolveGradient(Y3D, 1, d);
+    MatrixType result_made_by_exact_kernel_kd = exactKernel3D.ConvolveGradient(Y3D, 1, d);
+    CompareAndDisp(result_made_by_exact_kernel_kd, result_made_by_nystrom_kernel_kd, derivative_tol,
+                   "nystrom", "exact");
+  }
+}
+
+// ConvolveHessian
+TEST_F(TestKernelPrecisionNystrom, nystrom_vs_exact_ConvolveHessian) {
+  std::vector<std::vector<MatrixType> > hessians_made_by_nystrom_kernel = nystromKernel3D.ConvolveHessian(X3D);
+  std::vector<std::vector<MatrixType> > hessians_made_by_exact_kernel = exactKernel3D.ConvolveHessian(X3D);
+  ASSERT_EQ(hessians_made_by_exact_kernel.size(), hessians_made_by_nystrom_kernel.size());
+  for (unsigned int i = 0; i < X3D.rows(); i++)
+    for (unsigned int k = 0; k < 3; k++)
+      CompareAndDisp(hessians_made_by_exact_kernel[i][k], hessians_made_by_nystrom_kernel[i][k], derivative_tol,
+                     "nystrom", "exact");
+
+  for (unsigned int p = 0; p < 3; p++) {
+    for (unsigned int q = 0; q < 3; q++) {
+      MatrixType result_made_by_nystrom_kernel = nystromKernel3D.ConvolveHessian(X3D, p, q);
+      MatrixType result_made_by_exact_kernel = exactKernel3D.ConvolveHessian(X3D, p, q);
+      CompareAndDisp(result_made_by_exact_kernel, result_made_by_nystrom_kernel, derivative_tol, "nystrom", "exact");
+
+      MatrixType result_made_by_nystrom_kernel_k = nystromKernel3D.ConvolveHessian(X3D, 2, p, q);
+      MatrixType result_made_by_exact_kernel_k = exactKernel3D.ConvolveHessian(X3D, 2, p, q);
+      CompareAndDisp(result_made_by_exact_kernel_k, result_made_by_nystrom_kernel_k, derivative_tol,
+                     "nystrom", "exact");
+    }
+  }
+
+  MatrixType result_made_by_nystrom_kernel = nystromKernel3D.ConvolveSpecialHessian(W3D);
+  MatrixType result_made_by_exact_kernel = exactKernel3D.ConvolveSpecialHessian(W3D);
+  CompareAndDisp(result_made_by_exact_kernel, result_made_by_nystrom_kernel, derivative_tol, "nystrom", "exact");
+}
+
+// Rank
+TEST_F(TestKernelPrecisionNystrom, rank_from_tolerance) {
+  unsigned int previous_rank = 0;
+  for (ScalarType tolerance : {1e-1, 1e-2, 1e-3, 1e-4}) {
+    nystromKernel3D.SetTolerance(tolerance);
+    ASSERT_GE(nystromKernel3D.GetRank(), previous_rank);
+    previous_rank = nystromKernel3D.GetRank();
+  }
+  ASSERT_GT(previous_rank, 1u);
+
+  /// With a narrow kernel, the rank is full and the convolutions are exact.
+  nystromKernel3D.SetKernelWidth(0.2);
+  exactKernel3D.SetKernelWidth(0.2);
+  nystromKernel3D.SetTolerance(0.0);
+  ASSERT_EQ(nystromKernel3D.GetRank(), Y_ROW);
+
+  MatrixType result_made_by_nystrom_kernel = nystromKernel3D.Convolve(X3D);
+  MatrixType result_made_by_exact_kernel = exactKernel3D.Convolve(X3D);
+  CompareAndDisp(result_made_by_exact_kernel, result_made_by_nystrom_kernel, eps_tol, "nystrom", "exact");
+
+  ASSERT_THROW(nystromKernel3D.SetTolerance(-1.0), std::runtime_error);
+}
+
+// New sources
+TEST_F(TestKernelPrecisionNystrom, SetSources) {
+  nystromKernel3D.Convolve(X3D);
+
+  MatrixType Y3D_moved = Y3D * 1.5;
+  nystromKernel3D.SetSources(Y3D_moved);
+  exactKernel3D.SetSources(Y3D_moved);
+
+  MatrixType result_made_by_nystrom_kernel = nystromKernel3D.Convolve(X3D);
+  MatrixType result_made_by_exact_kernel = exactKernel3D.Convolve(X3D);
+  CompareAndDisp(result_made_by_exact_kernel, result_made_by_nystrom_kernel, nystrom_tol * Y_ROW, "nystrom", "exact");
+
+  /// A copy keeps the factorization.
+  std::unique_ptr<NystromKernel<ScalarType, 3>> copy(nystromKernel3D.Clone());
+  MatrixType result_made_by_copy = copy->Convolve(X3D);
+  CompareAndDisp(result_made_by_nystrom_kernel, result_made_by_copy, eps_tol, "nystrom", "copy");
+}
+
+// KernelFactory
+TEST_F(TestKernelPrecisionNystrom, KernelFactory) {
+  KernelFactory<ScalarType, 3> *kfac = KernelFactory<ScalarType, 3>::Instantiate();
+  std::shared_ptr<ExactKernel<ScalarType, 3>> kernel = kfac->CreateKernelObject(Y3D, W3D, kernel_width, Nystrom);
+  auto nystromKernel = std::dynamic_pointer_cast<NystromKernel<ScalarType, 3>>(kernel);
+  ASSERT_TRUE(nystromKernel != nullptr);
+
+  nystromKernel->SetTolerance(nystrom_tol);
+  MatrixType result_made_by_factory_kernel = kernel->Convolve(X3D);
+  MatrixType result_made_by_exact_kernel = exactKernel3D.Convolve(X3D);
+  CompareAndDisp(result_made_by_exact_kernel, result_made_by_factory_kernel, nystrom_tol * Y_ROW, "nystrom", "exact");
+}
+
+}
+}
@@ -0,0 +1,51 @@
+/***************************************************************************************
+*                                                                                      *
+*                                     Deformetrica                                     *
+*                                                                                      *
+*    Copyright Inria and the University of Utah.  All rights reserved. This file is    *
+*    distributed under the terms of the Inria Non-Commercial License Agreement.        *
+*                                                                                      *
+*                                                                                      *
+****************************************************************************************/
+
+#pragma once
+
+#include "AbstractTestKernelPrecision.h"
+#include <src/support/kernels/ExactKernel.h>
+#include "src/support/kernels/NystromKernel.h"
+
+namespace def {
+namespace test {
+
+class TestKernelPrecisionNystrom : public AbstractTestKernelPrecision {
+ public:
+  // Constructor : initialize data and kernel used in the tests
+  TestKernelPrecisionNystrom() {
+    exactKernel3D.SetSources(Y3D);
+    exactKernel3D.SetKernelWidth(kernel_width);
+    exactKernel3D.SetWeights(W3D);
+
+    nystromKernel3D.SetSources(Y3D);
+    nystromKernel3D.SetKernelWidth(kernel_width);
+    nystromKernel3D.SetWeights(W3D);
+    nystromKernel3D.SetTolerance(nystrom_tol);
+  }
+
+ protected:
+
+  ExactKernel<ScalarType, 3> exactKernel3D;
+  NystromKernel<ScalarType, 3> nystromKernel3D;
+
+#ifdef USE_DOUBLE_PRECISION
+  /// Tolerance of the kernel values, and precision expected from the derivatives.
+  ScalarType nystrom_tol = 1e-8;
+  ScalarType derivative_tol = 1e-6;
+#else
+  ScalarType nystrom_tol = 1e-4;
+  ScalarType derivative_tol = 1e-2;
+#endif
+
+};
+
+}
+}
@@ -0,0 +1,177 @@
+/***************************************************************************************
+*                                                                                      *
+*                                     Deformetrica                                     *
+*                                                                                      *
+*    Copyright Inria and the University of Utah.  All rights reserved. This file is    *
+*    distributed under the terms of the Inria Non-Commercial License Agreement.        *
+*                                                                                      *
+*                                                                                      *
+****************************************************************************************/
+
+#include "TestKernelPrecisionRadial.h"
+
+#include <cmath>
+#include <limits>
+
+namespace def {
+namespace test {
+
+void TestKernelPrecisionRadial::CheckDerivatives(ExactKernel<ScalarType, 3> &kernel, const std::string &msg) {
+  kernel.SetWeights(W3D);
+
+  for (unsigned int d = 0; d < 3; d++) {
+    MatrixType Xp = X3D, Xm = X3D;
+    for (unsigned int i = 0; i < X3D.rows(); i++) {
+      Xp(i, d) += fd_step;
+      Xm(i, d) -= fd_step;
+    }
+
+    /// Each row of the convolution only depends on the matching point : one shift of all the points gives the
+    /// derivatives at all the points.
+    MatrixType numericalGradient = (kernel.Convolve(Xp) - kernel.Convolve(Xm)) / (2.0 * fd_step);
+    MatrixType gradient = kernel.ConvolveGradient(X3D, d);
+    CompareAndDisp(numericalGradient, gradient, fd_tol, msg + " ConvolveGradient", "finite differences");
+
+    MatrixType numericalAlphaGradient(X3D.rows(), 1);
+    for (unsigned int i = 0; i < X3D.rows(); i++)
+      numericalAlphaGradient(i, 0) = dot_product(numericalGradient.get_row(i), Z3D.get_row(i));
+    MatrixType alphaGradient = kernel.ConvolveGradient(X3D, Z3D).get_column(d);
+    CompareAndDisp(numericalAlphaGradient, alphaGradient, fd_tol, msg + " ConvolveGradient(alpha)",
+                   "finite differences");
+
+    for (unsigned int p = 0; p < 3; p++) {
+      MatrixType numericalHessian = (kernel.ConvolveGradient(Xp, p) - kernel.ConvolveGradient(Xm, p))
+          / (2.0 * fd_step);
+      MatrixType hessian = kernel.ConvolveHessian(X3D, p, d);
+      CompareAndDisp(numericalHessian, hessian, fd_tol, msg + " ConvolveHessian", "finite differences");
+    }
+  }
+}
+
+// Convolve
+TEST_F(TestKernelPrecisionRadial, gaussian_vs_exact_Convolve) {
+  gaussianKernel2D.SetWeights(W2D);
+  exactKernel2D.SetWeights(W2D);
+  MatrixType result_made_by_gaussian_kernel2D = gaussianKernel2D.Convolve(X2D);
+  MatrixType result_made_by_exact_kernel2D = exactKernel2D.Convolve(X2D);
+  CompareAndDisp(result_made_by_exact_kernel2D, result_made_by_gaussian_kernel2D, eps_tol, "gaussian", "exact");
+
+  gaussianKernel3D.SetWeights(W6D);
+  exactKernel3D.SetWeights(W6D);
+  MatrixType result_made_by_gaussian_kernel3D = gaussianKernel3D.Convolve(X3D);
+  MatrixType result_made_by_exact_kernel3D = exactKernel3D.Convolve(X3D);
+  CompareAndDisp(result_made_by_exact_kernel3D, result_made_by_gaussian_kernel3D, eps_tol, "gaussian", "exact");
+}
+
+// ConvolveGradient
+TEST_F(TestKernelPrecisionRadial, gaussian_vs_exact_ConvolveGradient) {
+  gaussianKernel3D.SetWeights(W3D);
+  exactKernel3D.SetWeights(W3D);
+
+  MatrixType result_made_by_gaussian_kernel = gaussianKernel3D.ConvolveGradient(X3D, Z3D);
+  MatrixType result_made_by_exact_kernel = exactKernel3D.ConvolveGradient(X3D, Z3D);
+  CompareAndDisp(result_made_by_exact_kernel, result_made_by_gaussian_kernel, eps_tol, "gaussian", "exact");
+
+  for (unsigned int d = 0; d < 3; d++) {
+    MatrixType result_made_by_gaussian_kernel_d = gaussianKernel3D.ConvolveGradient(Y3D, d);
+    MatrixType result_made_by_exact_kernel_d = exactKernel3D.ConvolveGradient(Y3D, d);
+    CompareAndDisp(result_made_by_exact_kernel_d, result_made_by_gaussian_kernel_d, eps_tol, "gaussian", "exact");
+  }
+
+  std::vector<MatrixType> gradients_made_by_gaussian_kernel = gaussianKernel3D.ConvolveGradient(X3D);
+  std::vector<MatrixType> gradients_made_by_exact_kernel = exactKernel3D.ConvolveGradient(X3D);
+  for (unsigned int i = 0; i < X3D.rows(); i++)
+    CompareAndDisp(gradients_made_by_exact_kernel[i], gradients_made_by_gaussian_kernel[i], eps_tol,
+                   "gaussian", "exact");
+}
+
+// ConvolveSpecialHessian, which goes through all the ConvolveHessian methods
+TEST_F(TestKernelPrecisionRadial, gaussian_vs_exact_ConvolveSpecialHessian) {
+  gaussianKernel3D.SetWeights(W3D);
+  exactKernel3D.SetWeights(W3D);
+
+  MatrixType result_made_by_gaussian_kernel = gaussianKernel3D.ConvolveSpecialHessian(W3D);
+  MatrixType result_made_by_exact_kernel = exactKernel3D.ConvolveSpecialHessian(W3D);
+  CompareAndDisp(result_made_by_exact_kernel, result_made_by_gaussian_kernel, eps_tol, "gaussian", "exact");
+}
+
+// Derivatives of the other profiles
+TEST_F(TestKernelPrecisionRadial, cauchy_derivatives) {
+  CheckDerivatives(cauchyKernel3D, "cauchy");
+}
+
+TEST_F(TestKernelPrecisionRadial, wendland_derivatives) {
+  CheckDerivatives(wendlandKernel3D, "wendland");
+}
+
+// Compact support
+TEST_F(TestKernelPrecisionRadial, wendland_support) {
+  VectorType x(3, 0.0), y(3, 0.0);
+  y[0] = 0.5;
+  ASSERT_EQ(wendlandKernel3D.EvaluateKernel(x, y), 0.0);
+  y[0] = 0.0;
+  ASSERT_NEAR(wendlandKernel3D.EvaluateKernel(x, y), 1.0, eps_tol);
+}
+
+// Vectorized exponential, on all the instruction sets of the processor
+TEST_F(TestKernelPrecisionRadial, vectorized_exp_accuracy) {
+  std::mt19937 gen(1);
+  std::uniform_real_distribution<double> distribution(-708.0, 708.0);
+  /// An odd size, so that the remainder of the vectorized loops is tested.
+  std::vector<double> x(10001), y(x.size());
+  for (double &xi : x)
+    xi = distribution(gen);
+
+  for (auto set : {fast_math::ScalarExp, fast_math::SSE42Exp, fast_math::AVX2Exp}) {
+    if (!fast_math::exp_instruction_set_supported(set)) continue;
+
+    fast_math::vexp(x.data(), y.data(), x.size(), fast_math::kExpMaxDegree, set);
+    for (std::size_t i = 0; i < x.size(); i++) {
+      const double expected = std::exp(x[i]);
+      const double ulp = std::nextafter(expected, std::numeric_limits<double>::infinity()) - expected;
+      ASSERT_LE(std::abs(y[i] - expected), 2.0 * ulp) << "instruction set " << set << ", exp(" << x[i] << ")";
+    }
+
+    /// The lower degrees trade accuracy for speed.
+    fast_math::vexp(x.data(), y.data(), x.size(), 7, set);
+    for (std::size_t i = 0; i < x.size(); i++)
+      ASSERT_LE(std::abs(y[i] - std::exp(x[i])) / std::exp(x[i]), 1e-8) << "instruction set " << set;
+  }
+}
+
+TEST_F(TestKernelPrecisionRadial, vectorized_exp_special_values) {
+  const double inf = std::numeric_limits<double>::infinity();
+  const std::vector<double> x = {0.0, -0.0, 1e-300, -1e-20, -708.0, 708.0, 709.5, 710.0, inf, -inf, -800.0,
+                                 std::numeric_limits<double>::quiet_NaN()};
+
+  for (auto set : {fast_math::ScalarExp, fast_math::SSE42Exp, fast_math::AVX2Exp}) {
+    if (!fast_math::exp_instruction_set_supported(set)) continue;
+
+    std::vector<double> y(x.size());
+    fast_math::vexp(x.data(), y.data(), x.size(), fast_math::kExpMaxDegree, set);
+    for (std::size_t i = 0; i < 7; i++)
+      ASSERT_NEAR(y[i] / std::exp(x[i]), 1.0, 1e-15) << "instruction set " << set << ", exp(" << x[i] << ")";
+    ASSERT_EQ(y[7], inf);
+    ASSERT_EQ(y[8], inf);
+    ASSERT_EQ(y[9], 0.0);
+    ASSERT_EQ(y[10], 0.0);
+    ASSERT_TRUE(std::isnan(y[11]));
+  }
+}
+
+// Gaussian kernel with a lower degree of the exponential
+TEST_F(TestKernelPrecisionRadial, gaussian_vs_exact_exp_degree) {
+  const unsigned int degree = def::utils::settings.exp_polynomial_degree;
+  def::utils::settings.exp_polynomial_degree = 9;
+
+  gaussianKernel3D.SetWeights(W3D);
+  exactKernel3D.SetWeights(W3D);
+  MatrixType result_made_by_gaussian_kernel = gaussianKernel3D.Convolve(X3D);
+  MatrixType result_made_by_exact_kernel = exactKernel3D.Convolve(X3D);
+  def::utils::settings.exp_polynomial_degree = degree;
+
+  CompareAndDisp(result_made_by_exact_kernel, result_made_by_gaussian_kernel, 1e-10, "gaussian (degree 9)", "exact");
+}
+
+}
+}
@@ -0,0 +1,66 @@
+/***************************************************************************************
+*                                                                                      *
+*                                     Deformetrica                                     *
+*                                                                                      *
+*    Copyright Inria and the University of Utah.  All rights reserved. This file is    *
+*    distributed under the terms of the Inria Non-Commercial License Agreement.        *
+*                                                                                      *
+*                                                                                      *
+****************************************************************************************/
+
+#pragma once
+
+#include "AbstractTestKernelPrecision.h"
+#include <src/support/kernels/ExactKernel.h>
+#include "src/support/kernels/RadialKernel.h"
+
+namespace def {
+namespace test {
+
+class TestKernelPrecisionRadial : public AbstractTestKernelPrecision {
+ public:
+  // Constructor : initialize data and kernel used in the tests
+  TestKernelPrecisionRadial() {
+    exactKernel2D.SetSources(Y2D);
+    exactKernel2D.SetKernelWidth(kernel_width);
+    exactKernel3D.SetSources(Y3D);
+    exactKernel3D.SetKernelWidth(kernel_width);
+
+    gaussianKernel2D.SetSources(Y2D);
+    gaussianKernel2D.SetKernelWidth(kernel_width);
+    gaussianKernel3D.SetSources(Y3D);
+    gaussianKernel3D.SetKernelWidth(kernel_width);
+
+    cauchyKernel3D.SetSources(Y3D);
+    cauchyKernel3D.SetKernelWidth(kernel_width);
+
+    /// Smaller than the extent of the points, so that the support of the Wendland kernel is tested.
+    wendlandKernel3D.SetSources(Y3D);
+    wendlandKernel3D.SetKernelWidth(0.5);
+  }
+
+  /// Compares the gradients and hessians of \e kernel with the finite differences of its convolutions.
+  void CheckDerivatives(ExactKernel<ScalarType, 3> &kernel, const std::string &msg);
+
+ protected:
+
+  ExactKernel<ScalarType, 2> exactKernel2D;
+  ExactKernel<ScalarType, 3> exactKernel3D;
+
+  GaussianKernel<ScalarType, 2> gaussianKernel2D;
+  GaussianKernel<ScalarType, 3> gaussianKernel3D;
+  CauchyKernel<ScalarType, 3> cauchyKernel3D;
+  WendlandKernel<ScalarType, 3> wendlandKernel3D;
+
+#ifdef USE_DOUBLE_PRECISION
+  ScalarType fd_step = 1e-5;
+  ScalarType fd_tol = 1e-5;
+#else
+  ScalarType fd_step = 1e-2;
+  ScalarType fd_tol = 5e-2;
+#endif
+
+};
+
+}
+}
@@ -150,6 +150,16 @@ TEST_F(TestBoostWrappers, TestLinearVariableMapAlgebra) {
   lvm *= 2;
   ASSERT_EQ(lvm.sum_of_squares(), lvm_mult.sum_of_squares());
 
+  LinearVariableMapType lvm_axpy = lvm;
+  lvm_axpy.axpy(0.5, lvm_plus);
+  ASSERT_DOUBLE_EQ(lvm_axpy.sum_of_squares(), (lvm + lvm_plus * 0.5).sum_of_squares());
+
+  VectorType concatenated;
+  for (auto it = lvm.begin(); it != lvm.end(); ++it)
+    concatenated.push_back(it->second.vectorize());
+  ASSERT_EQ(lvm.n_elem(), concatenated.size());
+  ASSERT_EQ(lvm.vectorize(), concatenated);
+
 }
 
 TEST_F(TestBoostWrappers, TestLinearVariablesMapAlgebra) {
@@ -209,6 +219,10 @@ TEST_F(TestBoostWrappers, TestLinearVariablesMapAlgebra) {
   ASSERT_EQ(lvm.sum_of_squares(), lvm_div.sum_of_squares());
   lvm *= 2;
   ASSERT_EQ(lvm.sum_of_squares(), lvm_mult.sum_of_squares());
+
+  LinearVariablesMapType lvm_axpy = lvm;
+  lvm_axpy.axpy(0.5, lvm_plus);
+  ASSERT_DOUBLE_EQ(lvm_axpy.sum_of_squares(), (lvm + lvm_plus * 0.5).sum_of_squares());
 }
 
 TEST_F(TestBoostWrappers, TestLinearVariableVectorization) {
@@ -249,6 +263,68 @@ TEST_F(TestBoostWrappers, TestLinearVariableVectorization) {
   ASSERT_EQ(unvectorize(lv_ml_vec, struct_ml).vectorize(), lv_ml_vec);
 }
 
+TEST_F(TestBoostWrappers, TestFixedSizeRows) {
+
+  MatrixType mat(4, 3, 0.0);
+  for (unsigned int i = 0; i < 4; ++i)
+    for (unsigned int j = 0; j < 3; ++j)
+      mat(i, j) = 1.0 + i - 2.0 * j;
+
+  const std::vector<FixedVector<ScalarType, 3>> rows = mat.get_fixed_rows<3>();
+  ASSERT_EQ(rows.size(), 4u);
+  for (unsigned int i = 0; i < 4; ++i) {
+    const FixedVector<ScalarType, 3> row = mat.get_fixed_row<3>(i);
+    for (unsigned int j = 0; j < 3; ++j) {
+      ASSERT_EQ(row[j], mat(i, j));
+      ASSERT_EQ(rows[i][j], mat(i, j));
+    }
+  }
+
+  const VectorType v0 = mat.get_row(0), v1 = mat.get_row(1);
+  const FixedVector<ScalarType, 3> f0 = rows[0], f1 = rows[1];
+  ASSERT_EQ(dot_product(f0, f1), dot_product(v0, v1));
+  ASSERT_EQ((f0 - f1).squared_magnitude(), (v0 - v1).squared_magnitude());
+
+  const VectorType cross = cross_3d(v0, v1);
+  const FixedVector<ScalarType, 3> fixedCross = cross_3d(f0, f1);
+  for (unsigned int j = 0; j < 3; ++j) ASSERT_EQ(fixedCross[j], cross[j]);
+
+  MatrixType updated = mat;
+  updated.increment_row(2, f0);
+  updated.set_row(3, f1 * 2.0);
+  for (unsigned int j = 0; j < 3; ++j) {
+    ASSERT_EQ(updated(2, j), mat(2, j) + mat(0, j));
+    ASSERT_EQ(updated(3, j), 2.0 * mat(1, j));
+  }
+}
+
+TEST_F(TestBoostWrappers, TestRowMajorConversions) {
+
+  MatrixType mat(5, 3, 0.0);
+  for (unsigned int i = 0; i < 5; ++i)
+    for (unsigned int j = 0; j < 3; ++j)
+      mat(i, j) = 0.5 * i + 3.0 * j;
+
+  const RowMajorMatrix<ScalarType> interleaved = mat.row_major();
+  ASSERT_EQ(interleaved.rows(), 5u);
+  ASSERT_EQ(interleaved.cols(), 3u);
+  for (unsigned int i = 0; i < 5; ++i)
+    for (unsigned int j = 0; j < 3; ++j) {
+      ASSERT_EQ(interleaved(i, j), mat(i, j));
+      ASSERT_EQ(interleaved.memptr()[3 * i + j], mat(i, j));
+      ASSERT_EQ(interleaved.row_ptr(i)[j], mat(i, j));
+    }
+
+  /// A view on a buffer owned elsewhere, and the conversion back to the column-major storage.
+  const RowMajorMatrixView<ScalarType> view(interleaved.memptr(), 5, 3);
+  const MatrixType back(view);
+  ASSERT_EQ(back.rows(), 5u);
+  ASSERT_EQ(back.cols(), 3u);
+  for (unsigned int i = 0; i < 5; ++i)
+    for (unsigned int j = 0; j < 3; ++j)
+      ASSERT_EQ(back(i, j), mat(i, j));
+}
+
 }
 }
 
@@ -0,0 +1,145 @@
+/***************************************************************************************
+*                                                                                      *
+*                                     Deformetrica                                     *
+*                                                                                      *
+*    Copyright Inria and the University of Utah.  All rights reserved. This file is    *
+*    distributed under the terms of the Inria Non-Commercial License Agreement.        *
+*                                                                                      *
+*                                                                                      *
+****************************************************************************************/
+
+#include "TestBayesianAtlasMixture.h"
+#include "DeformableObjectReader.h"
+#include "KernelType.h"
+#include <cmath>
+
+namespace def {
+namespace test {
+
+void TestBayesianAtlasMixture::SetUp() {
+    Test::SetUp();
+
+    DeformableObjectParameters::Pointer param = DeformableObjectParameters::New();
+    param->SetDeformableObjectType("Landmark");
+    param->SetAnatomicalCoordinateSystem("LPS");
+
+    DeformableObjectReader<double, 3> reader;
+    reader.SetObjectParameters(param);
+    reader.SetFileName(UNIT_TESTS_DIR"/geometries/data/VolumeDisk.vtk");
+    reader.Update();
+
+    std::vector<std::shared_ptr<AbstractGeometry<double, 3>>> objectList(1, reader.GetOutput());
+    m_Disk = std::make_shared<DeformableMultiObjectType>();
+    m_Disk->SetObjectList(objectList);
+    m_Disk->Update();
+
+    /// Four subjects, dilations of the disk.
+    std::vector<std::shared_ptr<DeformableMultiObjectType>> targets;
+    for (unsigned int i = 0; i < 4; ++i) {
+        MatrixListType data = m_Disk->GetImageIntensityAndLandmarkPointCoordinates();
+        data[0] *= 1.0 + 0.05 * i;
+        std::shared_ptr<DeformableMultiObjectType> target = m_Disk->Clone();
+        target->UpdateImageIntensityAndLandmarkPointCoordinates(data);
+        target->Update();
+        targets.push_back(target);
+    }
+
+    m_DataSet = std::make_shared<CrossSectionalDataSetType>();
+    m_DataSet->SetDeformableMultiObjects(targets);
+    m_DataSet->Update();
+}
+
+std::shared_ptr<TestBayesianAtlasMixture::BayesianAtlasMixtureType>
+TestBayesianAtlasMixture::CreateModel(double responsibilityThreshold, unsigned int refreshPeriod) const {
+    MatrixType controlPoints(9, 3, 0.0);
+    for (unsigned int i = 0; i < 9; ++i) {
+        controlPoints(i, 0) = 0.8 * ((i % 3) - 1.0);
+        controlPoints(i, 1) = 0.8 * ((i / 3) - 1.0);
+    }
+
+    std::vector<std::shared_ptr<BayesianAtlasType>> atlases(2);
+    for (unsigned int k = 0; k < 2; ++k) {
+        std::shared_ptr<DeformableMultiObjectType> temp = m_Disk->Clone();
+        MatrixListType data = temp->GetImageIntensityAndLandmarkPointCoordinates();
+        data[0] *= 1.0 + 0.1 * k;
+        temp->UpdateImageIntensityAndLandmarkPointCoordinates(data);
+        temp->Update();
+
+        std::shared_ptr<Diffeos<double, 3>> def = std::make_shared<Diffeos<double, 3>>();
+        def->SetKernelWidth(0.8);
+        def->SetKernelType(Exact);
+        def->SetNumberOfTimePoints(6);
+
+        atlases[k] = std::make_shared<BayesianAtlasType>();
+        atlases[k]->SetTemplate(temp);
+        atlases[k]->SetControlPoints(controlPoints);
+        atlases[k]->SetDiffeos(def);
+    }
+
+    std::shared_ptr<BayesianAtlasMixtureType> model = std::make_shared<BayesianAtlasMixtureType>();
+    model->SetAtlases(atlases);
+    model->SetResponsibilityThreshold(responsibilityThreshold);
+    model->SetPrunedPairsRefreshPeriod(refreshPeriod);
+    model->Update();
+    for (unsigned int k = 0; k < 2; ++k)
+        atlases[k]->SetDataSigmaSquared(VectorType(1, 0.01));
+    return model;
+}
+
+void TestBayesianAtlasMixture::GetRandomEffectsRealizations(double scale, LinearVariablesMapType &indRER) const {
+    const unsigned int numberOfSubjects = m_DataSet->GetNumberOfSubjects();
+    for (unsigned int k = 0; k < 2; ++k) {
+        std::vector<MatrixType> momentas(numberOfSubjects);
+        for (unsigned int i = 0; i < numberOfSubjects; ++i) {
+            momentas[i] = MatrixType(9, 3, 0.0);
+            for (unsigned int j = 0; j < 9; ++j) {
+                momentas[i](j, 0) = scale * 0.1 * std::sin(1.0 + j + i + k);
+                momentas[i](j, 1) = scale * 0.1 * std::cos(2.0 * j + i);
+            }
+        }
+        indRER["Momenta_Atlas" + std::to_string(k)] = momentas;
+    }
+
+    std::vector<VectorType> mixtureCoefficients(numberOfSubjects, VectorType(2, 0.5));
+    for (unsigned int i = 0; i < 2; ++i) {
+        mixtureCoefficients[i](0) = 0.99;
+        mixtureCoefficients[i](1) = 0.01;
+    }
+    indRER["MixtureCoefficients"] = mixtureCoefficients;
+}
+
+TEST_F(TestBayesianAtlasMixture, PrunedPairsLikelihood) {
+    /// The second evaluation prunes the pairs of the first two subjects for the second atlas, the third one
+    /// refreshes them.
+    std::shared_ptr<BayesianAtlasMixtureType> pruned = CreateModel(0.05, 3);
+    std::shared_ptr<BayesianAtlasMixtureType> unpruned = CreateModel(0.0, 3);
+    const LinearVariableMapType popRER;
+    LinearVariablesMapType indRER, candidateIndRER;
+    GetRandomEffectsRealizations(1.0, indRER);
+    GetRandomEffectsRealizations(1.001, candidateIndRER);
+
+    std::vector<double> prunedContributions, unprunedContributions;
+    pruned->ComputeModelLogLikelihood(m_DataSet.get(), popRER, indRER, prunedContributions);
+    unpruned->ComputeModelLogLikelihood(m_DataSet.get(), popRER, indRER, unprunedContributions);
+    for (unsigned int i = 0; i < 4; ++i)
+        ASSERT_NEAR(prunedContributions[i], unprunedContributions[i], 1e-12 * std::abs(unprunedContributions[i]));
+
+    /// The pruned pairs keep their last residuals, weighted by a negligible mixture coefficient.
+    const double prunedLikelihood
+        = pruned->ComputeModelLogLikelihood(m_DataSet.get(), popRER, candidateIndRER, prunedContributions);
+    const double unprunedLikelihood
+        = unpruned->ComputeModelLogLikelihood(m_DataSet.get(), popRER, candidateIndRER, unprunedContributions);
+    for (unsigned int i = 0; i < 2; ++i)
+        ASSERT_NEAR(prunedContributions[i], unprunedContributions[i], 1e-3 * std::abs(unprunedContributions[i]));
+    for (unsigned int i = 2; i < 4; ++i)
+        ASSERT_NEAR(prunedContributions[i], unprunedContributions[i], 1e-12 * std::abs(unprunedContributions[i]));
+    ASSERT_NEAR(prunedLikelihood, unprunedLikelihood, 1e-3 * std::abs(unprunedLikelihood));
+
+    /// Refresh.
+    pruned->ComputeModelLogLikelihood(m_DataSet.get(), popRER, candidateIndRER, prunedContributions);
+    for (unsigned int i = 0; i < 4; ++i)
+        ASSERT_NEAR(prunedContributions[i], unprunedContributions[i], 1e-12 * std::abs(unprunedContributions[i]));
+}
+
+}
+}
@@ -0,0 +1,46 @@
+/***************************************************************************************
+*                                                                                      *
+*                                     Deformetrica                                     *
+*                                                                                      *
+*    Copyright Inria and the University of Utah.  All rights reserved. This file is    *
+*    distributed under the terms of the Inria Non-Commercial License Agreement.        *
+*                                                                                      *
+*                                                                                      *
+****************************************************************************************/
+
+#pragma once
+
+#include "gtest/gtest.h"
+
+#include <memory>
+
+#include "BayesianAtlasMixture.h"
+#include "CrossSectionalDataSet.h"
+
+namespace def {
+namespace test {
+
+    class TestBayesianAtlasMixture : public ::testing::Test {
+    public:
+        typedef BayesianAtlasMixture<double, 3> BayesianAtlasMixtureType;
+        typedef BayesianAtlas<double, 3> BayesianAtlasType;
+        typedef CrossSectionalDataSet<double, 3> CrossSectionalDataSetType;
+        typedef DeformableMultiObject<double, 3> DeformableMultiObjectType;
+
+    protected:
+        virtual void SetUp();
+
+        /// Returns a mixture of two atlases of the landmark disk of the geometries data, the second template being
+        /// dilated, with the given responsibility threshold and refresh period of the pruned pairs.
+        std::shared_ptr<BayesianAtlasMixtureType> CreateModel(double responsibilityThreshold,
+                                                              unsigned int refreshPeriod) const;
+
+        /// Individual random effects realizations of the models returned by CreateModel(), the momenta being
+        /// scaled by \e scale. The first two subjects have a negligible responsibility for the second atlas.
+        void GetRandomEffectsRealizations(double scale, LinearVariablesMapType &indRER) const;
+
+        std::shared_ptr<DeformableMultiObjectType> m_Disk;
+        std::shared_ptr<CrossSectionalDataSetType> m_DataSet;
+    };
+}
+}
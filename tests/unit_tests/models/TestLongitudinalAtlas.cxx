@@ -0,0 +1,251 @@
+/***************************************************************************************
+*                                                                                      *
+*                                     Deformetrica                                     *
+*                                                                                      *
+*    Copyright Inria and the University of Utah.  All rights reserved. This file is    *
+*    distributed under the terms of the Inria Non-Commercial License Agreement.        *
+*                                                                                      *
+*                                                                                      *
+****************************************************************************************/
+
+#include "TestLongitudinalAtlas.h"
+#include "DeformableObjectReader.h"
+#include "GeneralSettings.h"
+#include "KernelType.h"
+#include "ProbabilityDistributions.h"
+#include "RandomNumberGenerator.h"
+#include "SrwMhwgSampler.h"
+#include <cmath>
+
+namespace def {
+namespace test {
+
+void TestLongitudinalAtlas::SetUp() {
+    Test::SetUp();
+
+    DeformableObjectParameters::Pointer param = DeformableObjectParameters::New();
+    param->SetDeformableObjectType("Landmark");
+    param->SetAnatomicalCoordinateSystem("LPS");
+
+    DeformableObjectReader<double, 3> reader;
+    reader.SetObjectParameters(param);
+    reader.SetFileName(UNIT_TESTS_DIR"/geometries/data/VolumeDisk.vtk");
+    reader.Update();
+
+    std::vector<std::shared_ptr<AbstractGeometry<double, 3>>> objectList(1, reader.GetOutput());
+    m_Disk = std::make_shared<DeformableMultiObjectType>();
+    m_Disk->SetObjectList(objectList);
+    m_Disk->Update();
+
+    /// Three subjects observed twice, the observations being dilations of the disk.
+    std::vector<std::vector<std::shared_ptr<DeformableMultiObjectType>>> targets(3);
+    std::vector<std::vector<double>> times(3);
+    for (unsigned int i = 0; i < 3; ++i) {
+        for (unsigned int t = 0; t < 2; ++t) {
+            MatrixListType data = m_Disk->GetImageIntensityAndLandmarkPointCoordinates();
+            data[0] *= 1.0 + 0.05 * (i + t);
+            std::shared_ptr<DeformableMultiObjectType> target = m_Disk->Clone();
+            target->UpdateImageIntensityAndLandmarkPointCoordinates(data);
+            target->Update();
+            targets[i].push_back(target);
+            times[i].push_back(-0.5 + 0.25 * i + 0.5 * t);
+        }
+    }
+
+    m_DataSet = std::make_shared<LongitudinalDataSetType>();
+    m_DataSet->SetDeformableMultiObjects(targets);
+    m_DataSet->SetTimes(times);
+    m_DataSet->SetSubjectIds({"s0", "s1", "s2"});
+    m_DataSet->Update();
+}
+
+std::shared_ptr<TestLongitudinalAtlas::LongitudinalAtlasType> TestLongitudinalAtlas::CreateModel() const {
+    MatrixType controlPoints(9, 3, 0.0), momenta(9, 3, 0.0), modulationMatrix(27, 1, 0.0);
+    for (unsigned int i = 0; i < 9; ++i) {
+        controlPoints(i, 0) = 0.8 * ((i % 3) - 1.0);
+        controlPoints(i, 1) = 0.8 * ((i / 3) - 1.0);
+        momenta(i, 0) = 0.2 * std::sin(1.0 + i);
+        momenta(i, 1) = 0.2 * std::cos(2.0 * i);
+    }
+    for (unsigned int k = 0; k < 27; ++k)
+        modulationMatrix(k, 0) = 0.05 * std::cos(0.7 * k);
+
+    std::shared_ptr<Diffeos<double, 3>> def = std::make_shared<Diffeos<double, 3>>();
+    def->SetKernelWidth(0.8);
+    def->SetKernelType(Exact);
+    def->SetNumberOfTimePoints(6);
+
+    std::shared_ptr<LongitudinalAtlasType> model = std::make_shared<LongitudinalAtlasType>();
+    model->SetNumberOfSources(1);
+    model->SetReferenceTime(0.0);
+    model->SetConcentrationOfTimePointsForReferenceGeodesic(10);
+    model->SetNumberOfTimePointsForExponentiation(6);
+    model->SetMarginOnGeodesicLength(0.1);
+    model->SetTemplate(m_Disk->Clone());
+    model->SetControlPoints(controlPoints);
+    model->SetMomenta(momenta);
+    model->SetModulationMatrix(modulationMatrix);
+    model->SetDiffeos(def);
+    model->Update();
+
+    MatrixType dataDomain = model->GetBoundingBox();
+    for (unsigned int d = 0; d < 3; ++d) {
+        dataDomain(d, 0) -= 2.0;
+        dataDomain(d, 1) += 2.0;
+    }
+    model->SetBoundingBox(dataDomain);
+    return model;
+}
+
+void TestLongitudinalAtlas::GetRandomEffectsRealizations(const LongitudinalAtlasType &model,
+                                                         LinearVariableMapType &popRER,
+                                                         LinearVariablesMapType &indRER) const {
+    popRER["TemplateData"] = model.GetTemplateData();
+    popRER["ControlPoints"] = model.GetControlPoints();
+    popRER["Momenta"] = model.GetMomenta();
+    popRER["ModulationMatrix"] = model.GetModulationMatrix();
+
+    const unsigned int numberOfSubjects = m_DataSet->GetNumberOfSubjects();
+    std::vector<LinearVariableType> sources(numberOfSubjects), logAccelerations(numberOfSubjects);
+    std::vector<LinearVariableType> timeShifts(numberOfSubjects);
+    for (unsigned int i = 0; i < numberOfSubjects; ++i) {
+        sources[i] = VectorType(1, 1.0 - i);
+        logAccelerations[i] = 0.1 * i;
+        timeShifts[i] = 0.05 * i;
+    }
+    indRER["Sources"] = sources;
+    indRER["LogAcceleration"] = logAccelerations;
+    indRER["TimeShift"] = timeShifts;
+}
+
+std::shared_ptr<TestLongitudinalAtlas::LongitudinalAtlasType>
+TestLongitudinalAtlas::RunSampler(unsigned int numberOfThreads, LinearVariableMapType &popRER,
+                                  LinearVariablesMapType &indRER, std::vector<VectorType> &acceptanceRates) const {
+    std::shared_ptr<LongitudinalAtlasType> model = CreateModel();
+    GetRandomEffectsRealizations(*model, popRER, indRER);
+
+    /// The population realizations are drawn as a single block each, the individual ones with wide proposals so
+    /// that both acceptances and rejections occur.
+    AbstractNormalDistributionMapType popPD, indPD;
+    for (auto it = popRER.begin(); it != popRER.end(); ++it) {
+        std::vector<unsigned int> sizeParams;
+        auto pd = std::make_shared<MultiScalarNormalDistributionType>();
+        pd->SetMean(VectorType(vectorize(it->second, sizeParams).size(), 0.0));
+        pd->SetVarianceSqrt(1e-3);
+        popPD[it->first] = pd;
+    }
+    const std::vector<std::string> indNames = {"Sources", "LogAcceleration", "TimeShift"};
+    const std::vector<double> indStds = {0.5, 0.2, 0.2};
+    for (unsigned int k = 0; k < indNames.size(); ++k) {
+        auto pd = std::make_shared<MultiScalarNormalDistributionType>();
+        pd->SetMean(VectorType(1, 0.0));
+        pd->SetVarianceSqrt(indStds[k]);
+        indPD[indNames[k]] = pd;
+    }
+
+    SrwMhwgSampler<double, 3> sampler;
+    sampler.SetStatisticalModel(model);
+    sampler.SetDataSet(m_DataSet.get());
+    sampler.SetPopulationProposalDistribution(popPD);
+    sampler.SetIndividualProposalDistribution(indPD);
+
+    const unsigned int defaultNumberOfThreads = def::utils::settings.number_of_threads;
+    def::utils::settings.number_of_threads = numberOfThreads;
+    RandomNumberGenerator::instance()->SetSeed(42);
+    acceptanceRates.assign(3, VectorType(popRER.size() + indRER.size(), 0.0));
+    for (unsigned int iter = 0; iter < 3; ++iter)
+        sampler.Sample(popRER, indRER, acceptanceRates[iter]);
+    def::utils::settings.number_of_threads = defaultNumberOfThreads;
+
+    return model;
+}
+
+TEST_F(TestLongitudinalAtlas, IncrementalTemplateDataLikelihood) {
+    std::shared_ptr<LongitudinalAtlasType> incremental = CreateModel();
+    LinearVariableMapType popRER;
+    LinearVariablesMapType indRER;
+    GetRandomEffectsRealizations(*incremental, popRER, indRER);
+
+    std::vector<double> initialContributions;
+    incremental->ComputeModelLogLikelihood(m_DataSet.get(), popRER, indRER, 1.0, "All", initialContributions);
+
+    /// A block of template points is moved : the model updates its likelihood incrementally.
+    LinearVariableMapType candidatePopRER = popRER;
+    MatrixListType templateData = incremental->GetTemplateData();
+    for (unsigned int k = 0; k < 10; ++k)
+        templateData[0](k, 0) += 0.02;
+    candidatePopRER["TemplateData"] = templateData;
+    std::vector<double> incrementalContributions;
+    const double incrementalLikelihood = incremental->ComputeModelLogLikelihood(
+        m_DataSet.get(), candidatePopRER, indRER, 1.0, "TemplateData", incrementalContributions);
+
+    /// A full recomputation, from a model without any memorized state.
+    std::vector<double> fullContributions;
+    const double fullLikelihood = CreateModel()->ComputeModelLogLikelihood(
+        m_DataSet.get(), candidatePopRER, indRER, 1.0, "All", fullContributions);
+
+    ASSERT_EQ(incrementalContributions.size(), fullContributions.size());
+    for (unsigned int i = 0; i < fullContributions.size(); ++i) {
+        ASSERT_NEAR(incrementalContributions[i], fullContributions[i], 1e-10 * std::abs(fullContributions[i]));
+        ASSERT_NE(incrementalContributions[i], initialContributions[i]);
+    }
+    ASSERT_NEAR(incrementalLikelihood, fullLikelihood, 1e-10 * std::abs(fullLikelihood));
+
+    /// Once the proposal rejected, the memorized residuals of the initial state are used again.
+    incremental->RecoverMemorizedState();
+    std::vector<double> recoveredContributions;
+    incremental->ComputeModelLogLikelihood(m_DataSet.get(), popRER, indRER, 1.0, "Sources", recoveredContributions);
+    for (unsigned int i = 0; i < initialContributions.size(); ++i)
+        ASSERT_NEAR(recoveredContributions[i], initialContributions[i], 1e-10 * std::abs(initialContributions[i]));
+}
+
+TEST_F(TestLongitudinalAtlas, SubjectParallelProposals) {
+    LinearVariableMapType serialPopRER, parallelPopRER;
+    LinearVariablesMapType serialIndRER, parallelIndRER;
+    std::vector<VectorType> serialAcceptanceRates, parallelAcceptanceRates;
+    std::shared_ptr<LongitudinalAtlasType> serial = RunSampler(1, serialPopRER, serialIndRER, serialAcceptanceRates);
+    std::shared_ptr<LongitudinalAtlasType> parallel
+        = RunSampler(4, parallelPopRER, parallelIndRER, parallelAcceptanceRates);
+
+    /// Same accept-reject decisions.
+    for (unsigned int iter = 0; iter < serialAcceptanceRates.size(); ++iter)
+        for (unsigned int k = 0; k < serialAcceptanceRates[iter].size(); ++k)
+            ASSERT_EQ(serialAcceptanceRates[iter](k), parallelAcceptanceRates[iter](k));
+
+    /// Same realizations.
+    for (auto it = serialIndRER.begin(); it != serialIndRER.end(); ++it) {
+        for (unsigned int i = 0; i < it->second.size(); ++i) {
+            std::vector<unsigned int> sizeParams;
+            const VectorType serialRER = vectorize(it->second[i], sizeParams);
+            const VectorType parallelRER = vectorize(parallelIndRER.at(it->first)[i], sizeParams);
+            for (unsigned int k = 0; k < serialRER.size(); ++k)
+                ASSERT_EQ(serialRER(k), parallelRER(k));
+        }
+    }
+    for (auto it = serialPopRER.begin(); it != serialPopRER.end(); ++it) {
+        std::vector<unsigned int> sizeParams;
+        const VectorType serialRER = vectorize(it->second, sizeParams);
+        const VectorType parallelRER = vectorize(parallelPopRER.at(it->first), sizeParams);
+        for (unsigned int k = 0; k < serialRER.size(); ++k)
+            ASSERT_EQ(serialRER(k), parallelRER(k));
+    }
+
+    /// The memorized states of both models, after the partial recoveries of the rejected subjects, give the
+    /// likelihood of a full recomputation.
+    std::vector<double> fullContributions, serialContributions, parallelContributions;
+    const double fullLikelihood = CreateModel()->ComputeModelLogLikelihood(
+        m_DataSet.get(), serialPopRER, serialIndRER, 1.0, "All", fullContributions);
+    const double serialLikelihood = serial->ComputeModelLogLikelihood(
+        m_DataSet.get(), serialPopRER, serialIndRER, 1.0, "Sources", serialContributions);
+    const double parallelLikelihood = parallel->ComputeModelLogLikelihood(
+        m_DataSet.get(), parallelPopRER, parallelIndRER, 1.0, "Sources", parallelContributions);
+    for (unsigned int i = 0; i < fullContributions.size(); ++i) {
+        ASSERT_NEAR(serialContributions[i], fullContributions[i], 1e-10 * std::abs(fullContributions[i]));
+        ASSERT_EQ(serialContributions[i], parallelContributions[i]);
+    }
+    ASSERT_NEAR(serialLikelihood, fullLikelihood, 1e-10 * std::abs(fullLikelihood));
+    ASSERT_EQ(serialLikelihood, parallelLikelihood);
+}
+
+}
+}
@@ -0,0 +1,50 @@
+/***************************************************************************************
+*                                                                                      *
+*                                     Deformetrica                                     *
+*                                                                                      *
+*    Copyright Inria and the University of Utah.  All rights reserved. This file is    *
+*    distributed under the terms of the Inria Non-Commercial License Agreement.        *
+*                                                                                      *
+*                                                                                      *
+****************************************************************************************/
+
+#pragma once
+
+#include "gtest/gtest.h"
+
+#include <memory>
+
+#include "LongitudinalAtlas.h"
+#include "LongitudinalDataSet.h"
+
+namespace def {
+namespace test {
+
+    class TestLongitudinalAtlas : public ::testing::Test {
+    public:
+        typedef LongitudinalAtlas<double, 3> LongitudinalAtlasType;
+        typedef LongitudinalDataSet<double, 3> LongitudinalDataSetType;
+        typedef DeformableMultiObject<double, 3> DeformableMultiObjectType;
+
+    protected:
+        virtual void SetUp();
+
+        /// Returns a longitudinal atlas of the landmark disk of the geometries data, with non-zero momenta and
+        /// modulation matrix, initialized on m_DataSet.
+        std::shared_ptr<LongitudinalAtlasType> CreateModel() const;
+
+        /// Population and individual random effects realizations of the models returned by CreateModel().
+        void GetRandomEffectsRealizations(const LongitudinalAtlasType &model,
+                                          LinearVariableMapType &popRER, LinearVariablesMapType &indRER) const;
+
+        /// Runs three iterations of the SRW-MHwG sampler from a fixed seed with \e numberOfThreads threads, starting
+        /// from a model returned by CreateModel(). Returns the model, with the realizations and acceptance rates.
+        std::shared_ptr<LongitudinalAtlasType> RunSampler(unsigned int numberOfThreads, LinearVariableMapType &popRER,
+                                                          LinearVariablesMapType &indRER,
+                                                          std::vector<VectorType> &acceptanceRates) const;
+
+        std::shared_ptr<DeformableMultiObjectType> m_Disk;
+        std::shared_ptr<LongitudinalDataSetType> m_DataSet;
+    };
+}
+}
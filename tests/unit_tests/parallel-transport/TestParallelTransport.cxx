@@ -80,6 +80,55 @@ namespace def {
                   ASSERT_LE(std::abs(lastMomentas(j, k) - groundTruthMom(j, k)), 1e-4);
                 }
             }
+
+            ///A second transport, and a transport by a copy, reuse the cached kernel factorizations of the geodesic.
+            std::shared_ptr<Diffeos<double,2>> copy = def->Clone();
+            MatrixListType velocitiesAgain, velocitiesCopy;
+            MatrixType again = def->ParallelTransport(MomMatching, CPMatching, 0., targetTimes, velocitiesAgain).at(9);
+            MatrixType fromCopy = copy->ParallelTransport(MomMatching, CPMatching, 0., targetTimes, velocitiesCopy).at(9);
+            ASSERT_LE((again - lastMomentas).frobenius_norm(), 1e-12);
+            ASSERT_LE((fromCopy - lastMomentas).frobenius_norm(), 1e-12);
+
+            ///The batched transport of several vectors matches their separate transports.
+            std::vector<MatrixType> batch = {MomMatching, 0.5 * MomMatching, MatrixType(MomMatching.rows(), 2, 0.)};
+            std::vector<MatrixListType> batchVelocities;
+            std::vector<MatrixListType> batchTransport
+                = def->ParallelTransport(batch, CPMatching, 0., targetTimes, batchVelocities);
+            ASSERT_EQ(batchTransport.size(), 3u);
+            for (unsigned int s = 0; s < 2; ++s) {
+              MatrixListType separate = def->ParallelTransport(batch[s], CPMatching, 0., targetTimes, velocitiesAgain);
+              for (unsigned int t = 0; t < targetTimes.size(); ++t)
+                ASSERT_LE((batchTransport[s][t] - separate[t]).frobenius_norm(), 1e-10);
+            }
+            ASSERT_LE(batchTransport[2][9].frobenius_norm(), 1e-12);
+
+            ///The deformed objects along the geodesic are built once, shared by the copies, and rebuilt after a new shot.
+            std::shared_ptr<DeformableMultiObject<double,2>> shared = def->GetSharedDeformedObjectAt(10);
+            ASSERT_EQ(shared, def->GetSharedDeformedObjectAt(10));
+            ASSERT_EQ(shared, copy->GetSharedDeformedObjectAt(10));
+            copy->SetStartMomentas(0.5 * MomRegression);
+            copy->Update();
+            ASSERT_NE(shared, copy->GetSharedDeformedObjectAt(10));
+            ASSERT_EQ(shared, def->GetSharedDeformedObjectAt(10));
+
+            ///The Parareal shooting matches the sequential one : exactly once all the slices are corrected, and up to
+            ///its tolerance otherwise.
+            MatrixListType sequentialPos = def->GetTrajectoryPositions();
+            MatrixListType sequentialMom = def->GetTrajectoryMomentas();
+            for (double tolerance : {0.0, 1e-8}) {
+              std::shared_ptr<Diffeos<double,2>> parareal = def->Clone();
+              parareal->SetNumberOfTimeSlices(4);
+              parareal->SetPararealTolerance(tolerance);
+              parareal->Update();
+              MatrixListType pararealPos = parareal->GetTrajectoryPositions();
+              MatrixListType pararealMom = parareal->GetTrajectoryMomentas();
+              ASSERT_EQ(pararealPos.size(), sequentialPos.size());
+              const double posScale = sequentialPos[0].frobenius_norm(), momScale = sequentialMom[0].frobenius_norm();
+              for (unsigned int t = 0; t < sequentialPos.size(); ++t) {
+                ASSERT_LE((pararealPos[t] - sequentialPos[t]).frobenius_norm(), 1e-6 * posScale);
+                ASSERT_LE((pararealMom[t] - sequentialMom[t]).frobenius_norm(), 1e-6 * momScale);
+              }
+            }
         }
     }
 }
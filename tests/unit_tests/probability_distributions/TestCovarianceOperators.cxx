@@ -0,0 +1,140 @@
+/***************************************************************************************
+*                                                                                      *
+*                                     Deformetrica                                     *
+*                                                                                      *
+*    Copyright Inria and the University of Utah.  All rights reserved. This file is    *
+*    distributed under the terms of the Inria Non-Commercial License Agreement.        *
+*                                                                                      *
+*                                                                                      *
+****************************************************************************************/
+
+#include "TestCovarianceOperators.h"
+#include "CovarianceOperators.h"
+#include "KernelFactory.h"
+#include "NormalDistribution.h"
+#include "RandomNumberGenerator.h"
+#include <cmath>
+
+namespace def {
+namespace test {
+
+namespace {
+
+/// Checks the structured operator against the dense algebra on its own dense covariance.
+void CheckAgainstDense(AbstractCovarianceOperator<double> const &op, MatrixType const &cov) {
+    const unsigned int n = cov.rows();
+    ASSERT_EQ(op.GetSize(), n);
+
+    RandomStream stream(11);
+    const VectorType v = stream.NormalVector(n);
+
+    const VectorType expected = cov * v;
+    const VectorType actual = op.Multiply(v);
+    const VectorType expectedInverse = solve(cov, v);
+    const VectorType actualInverse = op.MultiplyInverse(v);
+    for (unsigned int i = 0; i < n; ++i) {
+        ASSERT_NEAR(expected(i), actual(i), 1e-10);
+        ASSERT_NEAR(expectedInverse(i), actualInverse(i), 1e-8 * (1.0 + std::fabs(expectedInverse(i))));
+    }
+
+    ASSERT_NEAR(op.GetLogDeterminant(), log_det(cov), 1e-8);
+
+    const MatrixType S = op.GetCovarianceSqrt();
+    const MatrixType SSt = S * S.transpose();
+    for (unsigned int i = 0; i < n; ++i)
+        for (unsigned int j = 0; j < n; ++j)
+            ASSERT_NEAR(SSt(i, j), cov(i, j), 1e-8);
+}
+
+MatrixType RandomSymmetricPositiveDefinite(unsigned int n, RandomStream &stream) {
+    const MatrixType A = stream.NormalVector(n * n).unvectorize(n, n);
+    return A * A.transpose() + diagonal_matrix<double>(n, 1.0 * n);
+}
+
+}
+
+void TestCovarianceOperators::SetUp() {
+    Test::SetUp();
+}
+
+TEST_F(TestCovarianceOperators, DiagonalAndLowRank) {
+    const unsigned int n = 12, r = 3;
+    RandomStream stream(3);
+
+    VectorType variances(n);
+    for (unsigned int i = 0; i < n; ++i) variances(i) = 0.5 + stream.Uniform();
+    CheckAgainstDense(DiagonalCovarianceOperator<double>(variances), diagonal_matrix<double>(variances));
+
+    const MatrixType U = stream.NormalVector(n * r).unvectorize(n, r);
+    CheckAgainstDense(LowRankPlusDiagonalCovarianceOperator<double>(variances, U),
+                      diagonal_matrix<double>(variances) + U * U.transpose());
+}
+
+TEST_F(TestCovarianceOperators, Kronecker) {
+    const unsigned int n = 5, m = 3;
+    RandomStream stream(5);
+    const MatrixType A = RandomSymmetricPositiveDefinite(n, stream);
+    const MatrixType B = RandomSymmetricPositiveDefinite(m, stream);
+
+    /// Dense Kronecker product, for the row-wise vectorization.
+    MatrixType cov(n * m, n * m, 0.0);
+    for (unsigned int i = 0; i < n; ++i)
+        for (unsigned int j = 0; j < n; ++j)
+            for (unsigned int k = 0; k < m; ++k)
+                for (unsigned int l = 0; l < m; ++l)
+                    cov(i * m + k, j * m + l) = A(i, j) * B(k, l);
+
+    CheckAgainstDense(KroneckerCovarianceOperator<double>(A, B), cov);
+}
+
+TEST_F(TestCovarianceOperators, KernelInducedPrior) {
+    const unsigned int nbPoints = 7, dim = 2;
+    const double width = 1.5;
+    RandomStream stream(7);
+    const MatrixType points = stream.NormalVector(nbPoints * dim).unvectorize(nbPoints, dim);
+
+    std::shared_ptr<ExactKernel<double, 2>> kernel
+        = KernelFactory<double, 2>::Instantiate()->CreateKernelObject(Exact);
+    kernel->SetKernelWidth(width);
+    MatrixType K(nbPoints, nbPoints, 0.0);
+    for (unsigned int i = 0; i < nbPoints; ++i)
+        for (unsigned int j = 0; j < nbPoints; ++j)
+            K(i, j) = kernel->EvaluateKernel(points.get_row(i), points.get_row(j));
+
+    /// Covariance (K (x) I)^-1, for momenta attached to the points.
+    MatrixType precision(nbPoints * dim, nbPoints * dim, 0.0);
+    for (unsigned int i = 0; i < nbPoints; ++i)
+        for (unsigned int j = 0; j < nbPoints; ++j)
+            for (unsigned int k = 0; k < dim; ++k)
+                precision(i * dim + k, j * dim + k) = K(i, j);
+
+    CheckAgainstDense(KernelCovarianceOperator<double, 2>(Exact, width, points, dim), inverse_sympd(precision));
+}
+
+TEST_F(TestCovarianceOperators, NormalDistributionLogLikelihood) {
+    const unsigned int n = 6;
+    RandomStream stream(13);
+    VectorType variances(n);
+    for (unsigned int i = 0; i < n; ++i) variances(i) = 0.5 + stream.Uniform();
+    const VectorType mean = stream.NormalVector(n);
+    const VectorType obs = stream.NormalVector(n);
+
+    NormalDistribution<double> dense, structured;
+    dense.SetMean(mean);
+    dense.SetCovariance(diagonal_matrix<double>(variances));
+    structured.SetMean(mean);
+    structured.SetCovarianceOperator(std::make_shared<DiagonalCovarianceOperator<double>>(variances));
+
+    ASSERT_NEAR(dense.ComputeLogLikelihood(obs, 2.0), structured.ComputeLogLikelihood(obs, 2.0), 1e-10);
+
+    /// Samples are drawn with the same random numbers, and a lower triangular square root in both cases.
+    RandomNumberGenerator::instance()->SetSeed(17);
+    const VectorType a = dense.Sample();
+    RandomNumberGenerator::instance()->SetSeed(17);
+    const VectorType b = structured.Sample();
+    for (unsigned int i = 0; i < n; ++i)
+        ASSERT_NEAR(a(i), b(i), 1e-10);
+}
+
+}
+}
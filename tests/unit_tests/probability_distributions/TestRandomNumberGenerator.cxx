@@ -0,0 +1,101 @@
+/***************************************************************************************
+*                                                                                      *
+*                                     Deformetrica                                     *
+*                                                                                      *
+*    Copyright Inria and the University of Utah.  All rights reserved. This file is    *
+*    distributed under the terms of the Inria Non-Commercial License Agreement.        *
+*                                                                                      *
+*                                                                                      *
+****************************************************************************************/
+
+#include "TestRandomNumberGenerator.h"
+#include "RandomNumberGenerator.h"
+#include "SerializeDeformationState.h"
+#include <array>
+#include <cmath>
+#include <cstdint>
+
+namespace def {
+namespace test {
+
+void TestRandomNumberGenerator::SetUp() {
+    Test::SetUp();
+}
+
+/// Exposes the Philox4x32-10 block function of a stream.
+class PhiloxStream : public RandomStream {
+public:
+    using RandomStream::RandomStream;
+    using RandomStream::Philox;
+};
+
+TEST_F(TestRandomNumberGenerator, PhiloxKnownAnswers) {
+    /// Published Random123 vectors. The counter words are (position low, position high, stream low, stream high)
+    /// and the key words are (seed low, seed high).
+    typedef std::array<std::uint32_t, 4> BlockType;
+
+    ASSERT_EQ(PhiloxStream(0, 0).Philox(0),
+              (BlockType{{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8}}));
+
+    ASSERT_EQ(PhiloxStream(0xffffffffffffffff, 0xffffffffffffffff).Philox(0xffffffffffffffff),
+              (BlockType{{0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd}}));
+
+    ASSERT_EQ(PhiloxStream(0x299f31d0a4093822, 0x0370734413198a2e).Philox(0x85a308d3243f6a88),
+              (BlockType{{0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}}));
+}
+
+TEST_F(TestRandomNumberGenerator, ReproducibleStreams) {
+    RandomStream a(42, 7), b(42, 7), c(42, 8), d(43, 7);
+
+    const VectorType va = a.NormalVector(101);
+    ASSERT_EQ(va, b.NormalVector(101));
+    ASSERT_FALSE(va == c.NormalVector(101));
+    ASSERT_FALSE(va == d.NormalVector(101));
+
+    /// Jumping to a position replays the stream from there.
+    RandomStream e(42, 7);
+    e.SetPosition(a.GetPosition());
+    ASSERT_EQ(a(), e());
+}
+
+TEST_F(TestRandomNumberGenerator, NormalMoments) {
+    RandomStream stream(2017);
+    const std::size_t n = 200000;
+    std::vector<double> x(n);
+    stream.FillNormal(x.data(), n);
+
+    double mean = 0.0, variance = 0.0;
+    for (double v : x) mean += v;
+    mean /= n;
+    for (double v : x) variance += (v - mean) * (v - mean);
+    variance /= n;
+
+    ASSERT_NEAR(mean, 0.0, 0.01);
+    ASSERT_NEAR(variance, 1.0, 0.01);
+}
+
+TEST_F(TestRandomNumberGenerator, SaveAndRecoverState) {
+    RandomNumberGenerator *rng = RandomNumberGenerator::instance();
+    rng->SetSeed(123456789);
+    rng->Normal();
+
+    def::utils::DeformationState state;
+    rng->SaveState(state);
+    const VectorType expected = rng->NormalVector(10);
+
+    rng->SetSeed(1);
+    rng->RecoverState(state);
+    ASSERT_EQ(rng->GetSeed(), 123456789u);
+    ASSERT_EQ(rng->NormalVector(10), expected);
+
+    /// An active stream takes precedence over the main one on its thread.
+    RandomStream stream = rng->Stream(3);
+    RandomStream replay = rng->Stream(3);
+    {
+        ScopedRandomStream scope(stream);
+        ASSERT_EQ(rng->Uniform(), replay.Uniform());
+    }
+}
+
+}
+}
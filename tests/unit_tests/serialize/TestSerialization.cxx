@@ -173,6 +173,41 @@ TEST_F(TestSerialization, SingletonUse) {
 
 }
 
+TEST_F(TestSerialization, BinaryAndCompressedFormats) {
+  stmpfile tmpnam = stmpfile();
+
+  MatrixType testMat(100, 3, 1.0014);
+  MatrixListType testMatList(4);
+  for (ScalarType k = 0 ; k < 4 ; ++k) {
+    testMatList[k] = testMat*k;
+  }
+  LinearVariableMapType testLinVarMap;
+  testLinVarMap["TestMatrix"] = testMat;
+  testLinVarMap["TestMatrixList"] = testMatList;
+
+  for (StateFormatType format : {TextArchive, BinaryArchive, CompressedArchive}) {
+    DeformationState state_store;
+    state_store << true << 42 << testMat << testMatList << testLinVarMap;
+    state_store.save(tmpnam.file, format);
+    ASSERT_EQ(DeformationState::detect_format(tmpnam.file), format);
+
+    DeformationState state_load;
+    state_load.load(tmpnam.file);
+    ASSERT_EQ(state_store, state_load);
+  }
+
+  /// The asynchronous save empties the state straight away and is flushed by the next load.
+  DeformationState state_store;
+  state_store << testMat << testLinVarMap;
+  DeformationState state_ref = state_store;
+  state_store.save_and_reset(tmpnam.file, true);
+  ASSERT_EQ(state_store, DeformationState());
+
+  DeformationState state_load;
+  state_load.load(tmpnam.file);
+  ASSERT_EQ(state_ref, state_load);
+}
+
 TEST_F(TestSerialization, Tolerance) {
 
   const float good_tolerance = 1e-5;
@@ -0,0 +1,89 @@
+/***************************************************************************************
+*                                                                                      *
+*                                     Deformetrica                                     *
+*                                                                                      *
+*    Copyright Inria and the University of Utah.  All rights reserved. This file is    *
+*    distributed under the terms of the Inria Non-Commercial License Agreement.        *
+*                                                                                      *
+*                                                                                      *
+****************************************************************************************/
+
+#include "TestGridFunctions.h"
+#include "GridFunctions.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <random>
+
+namespace def {
+namespace test {
+
+namespace {
+
+/// Compares GridFunctions::LocalIntensityDeviation with a scan of the box around each voxel.
+template<unsigned int Dimension>
+void CheckLocalIntensityDeviation(const unsigned int (&size)[Dimension], const double (&spacing)[Dimension],
+                                  double radius) {
+    typedef GridFunctions<double, Dimension> GridFunctionsType;
+    typedef typename GridFunctionsType::ImageType ImageType;
+    typedef typename GridFunctionsType::ImageIndexType ImageIndexType;
+
+    typename GridFunctionsType::ImageRegionType region;
+    typename GridFunctionsType::ImageSizeType imageSize;
+    typename GridFunctionsType::ImageSpacingType imageSpacing;
+    for (unsigned int d = 0; d < Dimension; ++d) {
+        imageSize[d] = size[d];
+        imageSpacing[d] = spacing[d];
+    }
+    region.SetSize(imageSize);
+
+    typename ImageType::Pointer img = ImageType::New();
+    img->SetRegions(region);
+    img->SetSpacing(imageSpacing);
+    img->Allocate();
+
+    /// Few intensity levels, so that uniform boxes are frequent.
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<int> level(0, 2);
+    itk::ImageRegionIteratorWithIndex<ImageType> it(img, region);
+    for (it.GoToBegin(); !it.IsAtEnd(); ++it) it.Set(level(generator));
+
+    typename ImageType::Pointer deviation = GridFunctionsType::LocalIntensityDeviation(img, radius);
+
+    long r[Dimension];
+    for (unsigned int d = 0; d < Dimension; ++d) r[d] = std::lround(radius / spacing[d]);
+
+    for (it.GoToBegin(); !it.IsAtEnd(); ++it) {
+        const ImageIndexType center = it.GetIndex();
+        double expected = 0.0;
+        itk::ImageRegionConstIteratorWithIndex<ImageType> box(img, region);
+        for (box.GoToBegin(); !box.IsAtEnd(); ++box) {
+            bool inside = true;
+            for (unsigned int d = 0; d < Dimension; ++d)
+                inside = inside && std::abs(box.GetIndex()[d] - center[d]) <= r[d];
+            if (inside) expected = std::max(expected, std::fabs(box.Get() - it.Get()));
+        }
+        ASSERT_EQ(deviation->GetPixel(center), expected) << "at " << center;
+    }
+}
+
+}
+
+void TestGridFunctions::SetUp() {
+    Test::SetUp();
+}
+
+TEST_F(TestGridFunctions, LocalIntensityDeviation2D) {
+    /// Radii of 2 and 5 voxels.
+    CheckLocalIntensityDeviation<2>({23, 17}, {1.0, 0.5}, 2.4);
+    /// Radius larger than the image.
+    CheckLocalIntensityDeviation<2>({7, 5}, {1.0, 1.0}, 20.0);
+}
+
+TEST_F(TestGridFunctions, LocalIntensityDeviation3D) {
+    /// Radii of 2, 1 and 3 voxels.
+    CheckLocalIntensityDeviation<3>({9, 11, 7}, {1.0, 2.0, 0.5}, 1.6);
+}
+
+}
+}
@@ -0,0 +1,71 @@
+/***************************************************************************************
+*                                                                                      *
+*                                     Deformetrica                                     *
+*                                                                                      *
+*    Copyright Inria and the University of Utah.  All rights reserved. This file is    *
+*    distributed under the terms of the Inria Non-Commercial License Agreement.        *
+*                                                                                      *
+*                                                                                      *
+****************************************************************************************/
+
+#include "TestProfiler.h"
+#include "Profiler.h"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+namespace def {
+namespace test {
+
+void TestProfiler::SetUp() {
+    Test::SetUp();
+}
+
+TEST_F(TestProfiler, SummaryAndTrace) {
+    using def::utils::Profiler;
+    using def::utils::ScopedProfile;
+    const def::utils::GeneralSettings saved = def::utils::settings;
+    const std::string traceFile = "TestProfilerTrace.json";
+
+    /// Nothing is recorded while the profiling is disabled.
+    def::utils::settings.profiling = false;
+    def::utils::settings.trace_filename = "";
+    { ScopedProfile scope("TestProfiler::Disabled"); }
+    std::ostringstream empty;
+    Profiler::instance()->PrintSummary(empty, 0);
+    ASSERT_EQ(empty.str().find("TestProfiler::Disabled"), std::string::npos);
+
+    def::utils::settings.profiling = true;
+    def::utils::settings.trace_filename = traceFile;
+    for (unsigned int i = 0; i < 3; ++i) { ScopedProfile scope("TestProfiler::Scope", 100 * (i + 1)); }
+    Profiler::instance()->AddCount("TestProfiler::Counter", 5);
+    Profiler::instance()->AddCount("TestProfiler::Counter", 2);
+
+    std::ostringstream summary;
+    Profiler::instance()->PrintSummary(summary, 1);
+    ASSERT_NE(summary.str().find("TestProfiler::Scope"), std::string::npos);
+    ASSERT_NE(summary.str().find("3 calls"), std::string::npos);
+    ASSERT_NE(summary.str().find("(max size 300)"), std::string::npos);
+    ASSERT_NE(summary.str().find("TestProfiler::Counter"), std::string::npos);
+
+    /// The summary covers the interval since the previous one.
+    std::ostringstream next;
+    Profiler::instance()->PrintSummary(next, 2);
+    ASSERT_EQ(next.str().find("TestProfiler::Scope"), std::string::npos);
+
+    Profiler::instance()->WriteTrace();
+    std::ifstream file(traceFile);
+    ASSERT_TRUE(file.is_open());
+    std::stringstream trace;
+    trace << file.rdbuf();
+    ASSERT_EQ(trace.str().find("{\"displayTimeUnit\":\"ms\",\"traceEvents\":["), 0u);
+    ASSERT_NE(trace.str().find("\"name\":\"TestProfiler::Scope\""), std::string::npos);
+    ASSERT_NE(trace.str().find("\"args\":{\"size\":300}"), std::string::npos);
+    ASSERT_NE(trace.str().find("\"ph\":\"C\",\"args\":{\"value\":7}"), std::string::npos);
+    std::remove(traceFile.c_str());
+
+    def::utils::settings = saved;
+}
+
+}
+}
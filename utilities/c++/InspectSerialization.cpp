@@ -22,6 +22,9 @@ int main(int argc, char **argv) {
 
   std::string filename(argv[1]);
 
+  const char *formats[] = {"text", "binary", "compressed binary"};
+  std::cout << "Format: " << formats[def::utils::DeformationState::detect_format(filename)] << std::endl;
+
   def::utils::DeformationState deformation_state;
   deformation_state.load(filename);
 